@@ -4,6 +4,17 @@
 
 using namespace MatrixMath;
 
+namespace {
+	// 行ベクトル (x, y, z, 1) に行列を掛けて w で割る
+	Vector3 TransformCoord(const Vector3& v, const Matrix4x4& m) {
+		const float x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + m.m[3][0];
+		const float y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + m.m[3][1];
+		const float z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + m.m[3][2];
+		const float w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + m.m[3][3];
+		return { x / w, y / w, z / w };
+	}
+}
+
 Camera::Camera()
 	: transform_({ {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -10.0f} })
 	, fovY_(0.45f)
@@ -18,12 +29,22 @@ void Camera::Update() {
 	// ワールド行列 (カメラ自体の位置・回転)
 	worldMatrix_ = MakeAffine(transform_.scale, transform_.rotate, transform_.translate);
 
-	// ビュー行列 (ワールド行列の逆行列)
-	viewMatrix_ = Inverse(worldMatrix_);
+	// ビュー行列 (ワールド行列の逆行列、カメラは拡縮しないので回転の転置で求める)
+	viewMatrix_ = InverseRigid(worldMatrix_);
 
 	// プロジェクション行列
 	projectionMatrix_ = PerspectiveFov(fovY_, aspectRatio_, nearClip_, farClip_);
 
 	// ビュープロジェクション行列 (合成)
 	viewProjectionMatrix_ = Multipty(viewMatrix_, projectionMatrix_);
+
+	// カリング用の視錐台 (描画側で毎回抽出しないようここで 1 回だけ求める)
+	frustum_ = Culling::ExtractFrustum(viewProjectionMatrix_);
+}
+
+Ray Camera::MakeScreenRay(float ndcX, float ndcY) const {
+	const Matrix4x4 inverseViewProjection = Inverse(viewProjectionMatrix_);
+	const Vector3 nearPoint = TransformCoord({ ndcX, ndcY, 0.0f }, inverseViewProjection);
+	const Vector3 farPoint = TransformCoord({ ndcX, ndcY, 1.0f }, inverseViewProjection);
+	return { nearPoint, { farPoint.x - nearPoint.x, farPoint.y - nearPoint.y, farPoint.z - nearPoint.z }, 1.0f };
 }
\ No newline at end of file
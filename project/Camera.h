@@ -1,5 +1,6 @@
 #pragma once
 #include "Matrix4x4.h"
+#include "Culling.h"
 
 class Camera {
 public:
@@ -21,8 +22,14 @@ public:
 	const Matrix4x4& GetViewMatrix() const { return viewMatrix_; }
 	const Matrix4x4& GetProjectionMatrix() const { return projectionMatrix_; }
 	const Matrix4x4& GetViewProjectionMatrix() const { return viewProjectionMatrix_; }
+	const Frustum& GetFrustum() const { return frustum_; }
 	const Vector3& GetRotate() const { return transform_.rotate; }
 	const Vector3& GetTranslate() const { return transform_.translate; }
+	float GetFovY() const { return fovY_; }
+
+	// 正規化デバイス座標 (-1〜1, 上が +y) からニアクリップ面〜ファークリップ面へ伸びる半直線
+	// direction は正規化しない (t = 1 がファークリップ面)
+	Ray MakeScreenRay(float ndcX, float ndcY) const;
 
 private:
 	Transform transform_;
@@ -30,6 +37,7 @@ private:
 	Matrix4x4 viewMatrix_;
 	Matrix4x4 projectionMatrix_;
 	Matrix4x4 viewProjectionMatrix_;
+	Frustum frustum_; // viewProjectionMatrix_ から抽出した視錐台
 
 	float fovY_;
 	float aspectRatio_;
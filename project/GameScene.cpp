@@ -5,7 +5,10 @@
 #include "TextureManager.h"
 #include "ModelManager.h"
 #include "ParticleManager.h"
+#include "PrimitiveGenerator.h"
+#include "StaticBatcher.h"
 #include "Audio.h"
+#include "FastMath.h"
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -190,6 +193,8 @@ void GameScene::Initialize() {
 
     primitivePreviewObjects_.clear();
     primitivePreviewObjects_.reserve(8);
+    std::vector<StaticBatcher::Instance> primitiveInstances;
+    primitiveInstances.reserve(8);
 
     auto createPrimitivePreview = [&](Model* model, const Vector3& translate, const Vector3& rotate, const Vector3& scale) {
         if (!model) {
@@ -205,6 +210,7 @@ void GameScene::Initialize() {
         preview->SetScale(scale);
         preview->SetEnvironmentMapEnabled(false);
         primitivePreviewObjects_.push_back(std::move(preview));
+        primitiveInstances.push_back({ &model->GetModelData(), MatrixMath::MakeAffine(scale, rotate, translate) });
         };
 
     createPrimitivePreview(modelManager->CreatePlane("PrimitivePlane"), { -4.5f, -1.0f, 3.0f }, { 0.0f, 0.0f, 0.0f }, { 1.4f, 1.4f, 1.4f });
@@ -220,6 +226,22 @@ void GameScene::Initialize() {
     createPrimitivePreview(modelManager->CreateCone("PrimitiveCone", 32), { 1.5f, 0.9f, 6.0f }, { 0.1f, 0.35f, 0.0f }, { 0.85f, 0.85f, 0.85f });
     createPrimitivePreview(modelManager->CreateTorus("PrimitiveTorus", 32, 16), { 4.5f, 0.9f, 6.0f }, { 0.6f, 0.3f, 0.0f }, { 1.0f, 1.0f, 1.0f });
 
+    // プレビューは動かないので、ワールド座標へ変換済みの 1 つのモデルにまとめておく (描画はテクスチャごとに 1 回)
+    // 全て同じブレンドモード・既定のマテリアルで描くので、テクスチャだけでまとめられる (ピッキングは元のプレビューで行う)
+    // 作り直すとテクスチャごとのマテリアルの表も変わるので、マテリアルを残す UpdatePrimitive ではなく作り直す
+    StaticBatcher::Stats primitiveBatchStats;
+    const Model::ModelData primitiveBatchData = StaticBatcher::Build(primitiveInstances.data(), primitiveInstances.size(), &primitiveBatchStats);
+    primitiveDrawCallCount_ = primitiveBatchStats.drawCallCountBefore;
+    primitiveBatchDrawCallCount_ = primitiveBatchStats.drawCallCountAfter;
+    primitivePreviewBatch_.reset();
+    if (Model* primitiveBatchModel = modelManager->CreatePrimitive("PrimitivePreviewBatch", primitiveBatchData)) {
+        primitivePreviewBatch_ = std::make_unique<Object3d>();
+        primitivePreviewBatch_->Initialize(object3dCommon);
+        primitivePreviewBatch_->SetModel(primitiveBatchModel);
+        primitivePreviewBatch_->SetCamera(camera_.get());
+        primitivePreviewBatch_->SetEnvironmentMapEnabled(false);
+    }
+
     ringEffectPlaneModel_ = modelManager->CreatePlane("RingEffectPlane");
     if (ringEffectPlaneModel_) {
         ringEffectPlaneModel_->SetTextureIndex(texManager->GetTextureIndexByFilePath("resources/particle/circle2.png"));
@@ -371,15 +393,18 @@ void GameScene::Update() {
 
     if (isRingAnimationEnabled_) {
         if (isRingAlphaAnimationEnabled_) {
-            float alphaWave = (std::sin(ringAnimationTime_ * ringAlphaAnimationSpeed_) + 1.0f) * 0.5f;
+            float alphaWave = (FastMath::Sin(ringAnimationTime_ * ringAlphaAnimationSpeed_, FastMath::GetTrigPrecision()) + 1.0f) * 0.5f;
             float animatedAlpha = std::lerp(ringAlphaAnimationMin_, ringAlphaAnimationMax_, alphaWave);
             ringStartAlpha_ = animatedAlpha;
             ringEndAlpha_ = animatedAlpha;
         }
 
         if (isRingRadiusAnimationEnabled_) {
-            float startWave = (std::sin(ringAnimationTime_ * ringRadiusAnimationSpeed_) + 1.0f) * 0.5f;
-            float endWave = (std::sin(ringAnimationTime_ * ringRadiusAnimationSpeed_ + std::numbers::pi_v<float> * 0.5f) + 1.0f) * 0.5f;
+            // sin(θ + π/2) = cos(θ) なので 1 回の SinCos で両方求める
+            float radiusSin, radiusCos;
+            FastMath::SinCos(ringAnimationTime_ * ringRadiusAnimationSpeed_, radiusSin, radiusCos, FastMath::GetTrigPrecision());
+            float startWave = (radiusSin + 1.0f) * 0.5f;
+            float endWave = (radiusCos + 1.0f) * 0.5f;
             ringShapeStartRadius_ = std::lerp(ringRadiusAnimationStartMin_, ringRadiusAnimationStartMax_, startWave);
             ringShapeEndRadius_ = std::lerp(ringRadiusAnimationEndMin_, ringRadiusAnimationEndMax_, endWave);
             isRingEffectModelDirty_ = true;
@@ -403,15 +428,15 @@ void GameScene::Update() {
     if (isRingEffectModelDirty_ && ringEffect_) {
         float startAngleRadians = ringShapeStartAngle_ * std::numbers::pi_v<float> / 180.0f;
         float endAngleRadians = ringShapeEndAngle_ * std::numbers::pi_v<float> / 180.0f;
-        ringEffectModel_ = modelManager->CreateRing(
-            "RingEffectRing",
+        // 毎フレーム形が変わるので、並べ替え・詳細度の段は作らずに既存のバッファへ書き込む
+        ringEffectModel_ = modelManager->UpdatePrimitive("RingEffectRing", PrimitiveGenerator::CreateRingData(
             kRingSubdivision,
             kRingInnerRadius,
             kRingOuterRadius,
             startAngleRadians,
             endAngleRadians,
             ringShapeStartRadius_,
-            ringShapeEndRadius_);
+            ringShapeEndRadius_));
         if (ringEffectModel_) {
             ringEffectModel_->SetTextureIndex(texManager->GetTextureIndexByFilePath("resources/particle/gradationLine.png"));
             if (auto* material = ringEffectModel_->GetMaterialData()) {
@@ -458,8 +483,10 @@ void GameScene::Update() {
     object3dSphere_->SetRandomPreview(isObjectRandomPreview_);
     object3dSphere_->SetRandomIntensity(objectRandomIntensity_);
     object3dSphere_->SetRandomTime(objectRandomTime_);
-    object3d_->Update();
-    object3dSphere_->Update();
+    // 行列計算は 1 回の UpdateBatch にまとめる
+    batchUpdateObjects_.clear();
+    batchUpdateObjects_.push_back(object3d_.get());
+    batchUpdateObjects_.push_back(object3dSphere_.get());
     if (effectCylinder_) {
         effectCylinderTime_ += 0.016f;
         if (effectCylinderModel_) {
@@ -480,11 +507,15 @@ void GameScene::Update() {
                 }
             }
         }
-        effectCylinder_->Update();
+        batchUpdateObjects_.push_back(effectCylinder_.get());
     }
     for (auto& primitivePreviewObject : primitivePreviewObjects_) {
-        primitivePreviewObject->Update();
+        batchUpdateObjects_.push_back(primitivePreviewObject.get());
     }
+    if (primitivePreviewBatch_) {
+        batchUpdateObjects_.push_back(primitivePreviewBatch_.get());
+    }
+    Object3d::UpdateBatch(batchUpdateObjects_);
     if (ringEffect_ || ringEffectCompareBillboard_ || ringEffectCompareWorld_) {
         if (ringEffectModel_) {
             Matrix4x4 uvTransform = MatrixMath::MakeIdentity4x4();
@@ -609,6 +640,21 @@ void GameScene::Update() {
     Vector2 spritePos = debugSprite_->GetPosition();
     ImGui::DragFloat2("Sprite Pos", &spritePos.x, 1.0f, -9999.0f, 9999.0f, "%4.1f");
     debugSprite_->SetPosition(spritePos);
+    ImGui::Text("Culled Objects : %zu / %zu", culledObjectCount_, cullingObjects_.size());
+
+    // 右クリックした位置の三角形を調べる
+    const ImGuiIO& io = ImGui::GetIO();
+    if (!io.WantCaptureMouse && ImGui::IsMouseClicked(ImGuiMouseButton_Right) && io.DisplaySize.x > 0.0f && io.DisplaySize.y > 0.0f) {
+        const float ndcX = io.MousePos.x / io.DisplaySize.x * 2.0f - 1.0f;
+        const float ndcY = 1.0f - io.MousePos.y / io.DisplaySize.y * 2.0f;
+        PickObject(camera_->MakeScreenRay(ndcX, ndcY));
+    }
+    if (pickedObject_) {
+        ImGui::Text("Picked : object %zu, triangle %u", pickedObjectIndex_, pickHit_.triangleIndex);
+        ImGui::Text("         t = %.4f, barycentric = (%.3f, %.3f, %.3f)", pickHit_.distance, 1.0f - pickHit_.u - pickHit_.v, pickHit_.u, pickHit_.v);
+    } else {
+        ImGui::Text("Picked : none (right click to pick)");
+    }
     ImGui::End();
 
     auto DrawEffectParamsUI = [](const char* label, ParticleManager::EffectParams& params) {
@@ -740,10 +786,10 @@ void GameScene::Update() {
         DrawCloudFlag("Camera Inside Cloud", cloudProjectedBounds_.isCameraInsideCloud, ImVec4(1.00f, 0.80f, 0.25f, 1.0f), ImVec4(0.45f, 0.85f, 1.00f, 1.0f));
         DrawCloudFlag("Near Plane Crossing", cloudProjectedBounds_.isNearPlaneCrossing, ImVec4(1.00f, 0.80f, 0.25f, 1.0f), ImVec4(0.45f, 0.85f, 1.00f, 1.0f));
 
-        const LONG scissorWidth = cloudProjectedBounds_.scissorRect.right - cloudProjectedBounds_.scissorRect.left;
-        const LONG scissorHeight = cloudProjectedBounds_.scissorRect.bottom - cloudProjectedBounds_.scissorRect.top;
-        ImGui::Text("Scissor Rect: L=%ld T=%ld R=%ld B=%ld", cloudProjectedBounds_.scissorRect.left, cloudProjectedBounds_.scissorRect.top, cloudProjectedBounds_.scissorRect.right, cloudProjectedBounds_.scissorRect.bottom);
-        ImGui::Text("Scissor Size: %ld x %ld", scissorWidth, scissorHeight);
+        const int32_t scissorWidth = cloudProjectedBounds_.scissorRect.right - cloudProjectedBounds_.scissorRect.left;
+        const int32_t scissorHeight = cloudProjectedBounds_.scissorRect.bottom - cloudProjectedBounds_.scissorRect.top;
+        ImGui::Text("Scissor Rect: L=%d T=%d R=%d B=%d", cloudProjectedBounds_.scissorRect.left, cloudProjectedBounds_.scissorRect.top, cloudProjectedBounds_.scissorRect.right, cloudProjectedBounds_.scissorRect.bottom);
+        ImGui::Text("Scissor Size: %d x %d", scissorWidth, scissorHeight);
         ImGui::TextColored(
             (cloudProjectedBounds_.scissorAreaRatio >= 0.90f) ? ImVec4(1.00f, 0.45f, 0.35f, 1.0f) : ImVec4(0.35f, 1.00f, 0.45f, 1.0f),
             "Scissor Area Ratio: %.3f (%.1f%%)",
@@ -922,6 +968,12 @@ void GameScene::Update() {
 
     ImGui::SeparatorText("Primitive Preview");
     ImGui::Checkbox("Show Primitive Preview", &isPrimitivePreviewVisible_);
+    ImGui::Checkbox("Static Batching", &isPrimitiveBatchEnabled_);
+    ImGui::Text("Draw Calls : %u -> %u", primitiveDrawCallCount_, primitiveBatchDrawCallCount_);
+    bool isFastTrig = FastMath::GetTrigPrecision() == FastMath::TrigPrecision::Fast;
+    if (ImGui::Checkbox("Fast Trig (Polynomial sin/cos)", &isFastTrig)) {
+        FastMath::SetTrigPrecision(isFastTrig ? FastMath::TrigPrecision::Fast : FastMath::TrigPrecision::Standard);
+    }
     ImGui::Text("Front Row : Plane / Circle / Ring / Triangle");
     ImGui::Text("Back Row  : Box / Cylinder / Cone / Torus");
     ImGui::Text("Ring uses gradationLine.png (AddressV = CLAMP)");
@@ -1191,6 +1243,8 @@ void GameScene::Draw() {
     auto particleManager = ParticleManager::GetInstance();
     auto spriteCommon = MyGame::GetInstance()->GetSpriteCommon();
 
+    CullObjects();
+
     if (isSkyboxVisible_) {
         skyboxCommon->CommonDrawSetting();
         skybox_->Draw();
@@ -1206,8 +1260,12 @@ void GameScene::Draw() {
         object3dCommon->CommonDrawSetting((Object3dCommon::BlendMode)currentBlendMode_);
     }
     if (isPrimitivePreviewVisible_) {
-        for (auto& primitivePreviewObject : primitivePreviewObjects_) {
-            primitivePreviewObject->Draw();
+        if (isPrimitiveBatchEnabled_ && primitivePreviewBatch_) {
+            primitivePreviewBatch_->Draw();
+        } else {
+            for (auto& primitivePreviewObject : primitivePreviewObjects_) {
+                primitivePreviewObject->Draw();
+            }
         }
     }
     if (isRingEffectVisible_) {
@@ -1255,3 +1313,79 @@ void GameScene::Draw() {
     spriteCommon->CommonDrawSetting();
     debugSprite_->Draw();
 }
+
+void GameScene::CullObjects() {
+    cullingObjects_.clear();
+
+    // モデルを持たないものは判定せず常に描画する
+    auto addCandidate = [this](Object3d* object) {
+        if (!object) {
+            return;
+        }
+        Aabb aabb;
+        if (!object->GetWorldAabb(aabb)) {
+            object->SetCulled(false);
+            return;
+        }
+        cullingObjects_.push_back(object);
+        object->SetCulled(true);
+
+        auto it = sceneProxies_.find(object);
+        if (it == sceneProxies_.end()) {
+            sceneProxies_.emplace(object, sceneTree_.CreateProxy(aabb, object));
+            return;
+        }
+        // 前フレームからの移動量を次フレームの予測に使う
+        const Aabb& previous = sceneTree_.GetAabb(it->second);
+        const Vector3 displacement = {
+            (aabb.min.x + aabb.max.x - previous.min.x - previous.max.x) * 0.5f,
+            (aabb.min.y + aabb.max.y - previous.min.y - previous.max.y) * 0.5f,
+            (aabb.min.z + aabb.max.z - previous.min.z - previous.max.z) * 0.5f
+        };
+        sceneTree_.MoveProxy(it->second, aabb, displacement);
+        };
+    addCandidate(object3d_.get());
+    addCandidate(object3dSphere_.get());
+    addCandidate(effectCylinder_.get());
+    addCandidate(ringEffectPlane_.get());
+    addCandidate(ringEffect_.get());
+    addCandidate(ringEffectComparePlaneBillboard_.get());
+    addCandidate(ringEffectCompareBillboard_.get());
+    addCandidate(ringEffectComparePlaneWorld_.get());
+    addCandidate(ringEffectCompareWorld_.get());
+    for (auto& primitivePreviewObject : primitivePreviewObjects_) {
+        addCandidate(primitivePreviewObject.get());
+    }
+
+    visibleProxies_.clear();
+    sceneTree_.QueryFrustum(camera_->GetFrustum(), visibleProxies_);
+    for (int32_t proxyId : visibleProxies_) {
+        static_cast<Object3d*>(sceneTree_.GetUserData(proxyId))->SetCulled(false);
+    }
+    culledObjectCount_ = cullingObjects_.size() - visibleProxies_.size();
+}
+
+bool GameScene::PickObject(const Ray& ray) {
+    pickedObject_ = nullptr;
+    Ray closestRay = ray;
+    for (size_t i = 0; i < cullingObjects_.size(); ++i) {
+        const Object3d* object = cullingObjects_[i];
+        if (object->IsCulled()) {
+            continue;
+        }
+        // AABB で外れるものは三角形を調べない
+        Aabb aabb;
+        float distance;
+        if (!object->GetWorldAabb(aabb) || !Culling::IntersectRay(closestRay, aabb, distance)) {
+            continue;
+        }
+        TriangleBvh::Hit hit;
+        if (object->RayCast(closestRay, hit)) {
+            pickedObject_ = object;
+            pickedObjectIndex_ = i;
+            pickHit_ = hit;
+            closestRay.maxDistance = hit.distance;
+        }
+    }
+    return pickedObject_ != nullptr;
+}
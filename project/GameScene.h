@@ -3,6 +3,7 @@
 #include "Model.h"
 #include "Camera.h"
 #include "CloudVolume.h"
+#include "DynamicAabbTree.h"
 #include "Object3d.h"
 #include "Skybox.h"
 #include "Sprite.h"
@@ -10,6 +11,7 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class GameScene : public IScene {
@@ -19,6 +21,12 @@ public:
     void Draw() override;
     void Finalize() override;
 
+private:
+    // 描画する Object3d を sceneTree_ に登録・更新し、視錐台クエリで見えないものに SetCulled(true) を設定する
+    void CullObjects();
+    // 描画中の Object3d から ray が最初に当たる三角形を探し、pick 系のメンバに結果を入れる
+    bool PickObject(const Ray& ray);
+
 private:
     std::unique_ptr<Camera> camera_;
     std::unique_ptr<CloudVolume> cloudVolume_;
@@ -34,6 +42,18 @@ private:
     std::unique_ptr<Object3d> ringEffectCompareWorld_;
     std::unique_ptr<Sprite> debugSprite_;
     std::vector<std::unique_ptr<Object3d>> primitivePreviewObjects_;
+    std::unique_ptr<Object3d> primitivePreviewBatch_; // 動かないプレビューをまとめたもの (StaticBatcher)
+    uint32_t primitiveDrawCallCount_ = 0;         // まとめる前の描画の回数
+    uint32_t primitiveBatchDrawCallCount_ = 0;    // まとめた後の描画の回数
+    std::vector<Object3d*> batchUpdateObjects_; // UpdateBatch に渡す一覧 (毎フレーム使い回す)
+    std::vector<Object3d*> cullingObjects_;     // カリング対象の一覧 (毎フレーム使い回す)
+    DynamicAabbTree sceneTree_;                 // カリング・ピッキング用の動的 AABB ツリー
+    std::unordered_map<const Object3d*, int32_t> sceneProxies_;
+    std::vector<int32_t> visibleProxies_;
+    size_t culledObjectCount_ = 0;
+    const Object3d* pickedObject_ = nullptr;
+    size_t pickedObjectIndex_ = 0; // cullingObjects_ 内の番号 (表示用)
+    TriangleBvh::Hit pickHit_{};
 
     Model* modelFence_ = nullptr;
     Model* modelSphere_ = nullptr;
@@ -73,6 +93,7 @@ private:
     float objectRandomIntensity_ = 1.0f;
     float objectRandomTime_ = 0.0f;
     bool isPrimitivePreviewVisible_ = true;
+    bool isPrimitiveBatchEnabled_ = true;
     bool isRingEffectVisible_ = true;
     bool isRingEffectPlaneVisible_ = true;
     bool isRingEffectCompareVisible_ = true;
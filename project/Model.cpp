@@ -1,80 +1,76 @@
 #include "Model.h"
+#include "BoundingVolume.h"
+#include "MeshCache.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
 #include "PrimitiveGenerator.h"
 #include "TextureManager.h"
+#include "WinApp.h"
+#include <algorithm>
 #include <cassert>
-#include <fstream>
-#include <sstream>
 #include <cmath>
+#include <cstring>
+#include <filesystem>
 
 using namespace std;
 using namespace MatrixMath;
 
 namespace {
-    constexpr float kPi = 3.14159265359f;
-
-    uint32_t GetPrimitiveTextureIndex() {
-        return TextureManager::GetInstance()->GetTextureIndexByFilePath("resources/obj/axis/uvChecker.png");
-    }
-
-    Vector3 SubtractVector(const Vector3& v1, const Vector3& v2) {
-        return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z };
-    }
-
-    float Length(const Vector3& v) {
-        return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-    }
-
-    Vector3 Normalize(const Vector3& v, const Vector3& fallback = { 0.0f, 1.0f, 0.0f }) {
-        float length = Length(v);
-        if (length <= 0.00001f) {
-            return fallback;
+    // 基本図形には確実に存在する「uvChecker.png」を割り当て、OBJ と同じように頂点を並べ替えて塊と詳細度の段を作っておく
+    Model::ModelData PreparePrimitive(Model::ModelData data) {
+        if (data.materials.empty()) {
+            data.materials.emplace_back();
         }
-        return { v.x / length, v.y / length, v.z / length };
-    }
-
-    Model::VertexData MakeVertex(float x, float y, float z, float u, float v, float nx, float ny, float nz) {
-        return { {x, y, z, 1.0f}, {u, v}, {nx, ny, nz} };
-    }
-
-    void PushTriangle(Model::ModelData& data,
-        const Model::VertexData& v0,
-        const Model::VertexData& v1,
-        const Model::VertexData& v2) {
-        data.vertices.push_back(v0);
-        data.vertices.push_back(v1);
-        data.vertices.push_back(v2);
-    }
-
-    void PushQuad(Model::ModelData& data,
-        const Model::VertexData& v00,
-        const Model::VertexData& v01,
-        const Model::VertexData& v10,
-        const Model::VertexData& v11) {
-        PushTriangle(data, v00, v01, v10);
-        PushTriangle(data, v01, v11, v10);
+        const uint32_t textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath("resources/obj/axis/uvChecker.png");
+        for (Model::MaterialData& material : data.materials) {
+            material.textureIndex = textureIndex;
+        }
+        MeshOptimizer::Optimize(data);
+        MeshletBuilder::Build(data);
+        MeshSimplifier::BuildLodChain(data);
+        return data;
     }
 }
 
-void Model::Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename) {
-    ModelData data = LoadObjFile(directoryPath, filename);
-    Initialize(modelCommon, data);
+void Model::Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename, VertexFormat vertexFormat) {
+    ModelData data = LoadModelFile(directoryPath, filename);
+    Initialize(modelCommon, data, vertexFormat);
 }
 
-void Model::Initialize(ModelCommon* modelCommon, const ModelData& modelData) {
+void Model::Initialize(ModelCommon* modelCommon, const ModelData& modelData, VertexFormat vertexFormat) {
     assert(modelCommon);
     modelCommon_ = modelCommon;
     modelData_ = modelData;
+    vertexFormat_ = vertexFormat;
 
-    // --- 頂点バッファ作成 ---
-    vertexResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(
-        sizeof(VertexData) * modelData_.vertices.size());
+    // サブメッシュやマテリアルの無いデータは、全体を 1 つのマテリアルで描く
+    if (modelData_.materials.empty()) {
+        modelData_.materials.emplace_back();
+    }
+    BuildMeshInfo();
 
-    vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
-    vertexBufferView_.SizeInBytes = UINT(sizeof(VertexData) * modelData_.vertices.size());
-    vertexBufferView_.StrideInBytes = sizeof(VertexData);
+    // --- MTL で指定されたテクスチャ (見つからなければ textureIndex をそのまま使う) ---
+    for (MaterialData& material : modelData_.materials) {
+        if (!material.textureFilePath.empty() && std::filesystem::exists(material.textureFilePath)) {
+            TextureManager::GetInstance()->LoadTexture(material.textureFilePath);
+            material.textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(material.textureFilePath);
+        }
+    }
+
+    // --- 頂点バッファ作成 ---
+    // 位置が half で表せないほど大きいモデルは、位置だけ float のままにする
+    if (vertexFormat_ == VertexFormat::kPackedHalf &&
+        !VertexQuantization::CanUseHalfPosition(modelData_.vertices.data(), modelData_.vertices.size())) {
+        vertexFormat_ = VertexFormat::kPackedFloat;
+    }
+    CreateVertexBuffer(modelData_.vertices.size());
+    WriteVertices(0, modelData_.vertices.size());
 
-    vertexResource_->Map(0, nullptr, reinterpret_cast<void**>(&vertexData_));
-    std::memcpy(vertexData_, modelData_.vertices.data(), sizeof(VertexData) * modelData_.vertices.size());
+    // --- インデックスバッファ作成 ---
+    CreateIndexBuffer(modelData_.indices.size(), modelData_.vertices.size() <= 0xffff);
+    WriteIndices(0, modelData_.indices.size());
 
     // --- マテリアルリソース作成 ---
     materialResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(sizeof(Material));
@@ -86,89 +82,284 @@ void Model::Initialize(ModelCommon* modelCommon, const ModelData& modelData) {
     materialData_->alphaReference = 0.5f;
 }
 
-void Model::Draw() {
-    ID3D12GraphicsCommandList* commandList = modelCommon_->GetDxCommon()->GetCommandList();
+void Model::UpdateVertices(const ModelData& modelData) {
+    assert(modelCommon_ && materialResource_);
+    // マテリアル (テクスチャの差し替えを含む) はそのまま使う
+    std::vector<VertexData> previousVertices = std::move(modelData_.vertices);
+    std::vector<uint32_t> previousIndices = std::move(modelData_.indices);
+    std::vector<MaterialData> materials = std::move(modelData_.materials);
+    modelData_ = modelData;
+    modelData_.materials = std::move(materials);
+    BuildMeshInfo();
+
+    // --- 頂点: 並びが変わるか容量が足りなければ作り直し、それ以外は変わった範囲だけ書く ---
+    VertexFormat vertexFormat = vertexFormat_;
+    if (vertexFormat == VertexFormat::kPackedHalf &&
+        !VertexQuantization::CanUseHalfPosition(modelData_.vertices.data(), modelData_.vertices.size())) {
+        vertexFormat = VertexFormat::kPackedFloat;
+    }
+    const size_t vertexCount = modelData_.vertices.size();
+    if (vertexFormat != vertexFormat_ || vertexCount > vertexCapacity_) {
+        vertexFormat_ = vertexFormat;
+        // 次に少し増えても作り直さずに済むよう余裕を持たせる
+        CreateVertexBuffer(vertexCount + vertexCount / 2);
+        WriteVertices(0, vertexCount);
+    } else {
+        const size_t commonCount = (std::min)(vertexCount, previousVertices.size());
+        size_t first = 0;
+        while (first < commonCount && std::memcmp(&modelData_.vertices[first], &previousVertices[first], sizeof(VertexData)) == 0) {
+            ++first;
+        }
+        size_t last = vertexCount;
+        while (last > first && last <= commonCount && std::memcmp(&modelData_.vertices[last - 1], &previousVertices[last - 1], sizeof(VertexData)) == 0) {
+            --last;
+        }
+        WriteVertices(first, last - first);
+        vertexBufferView_.SizeInBytes = UINT(VertexQuantization::GetVertexStride(vertexFormat_) * vertexCount);
+    }
 
-    commandList->IASetVertexBuffers(0, 1, &vertexBufferView_);
-    commandList->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
+    // --- 頂点番号: 同じく変わった範囲だけ (16 ビットに収まらなくなった場合も作り直す) ---
+    const size_t indexCount = modelData_.indices.size();
+    const bool isShortIndex = vertexCount <= 0xffff;
+    const bool wasShortIndex = indexBufferView_.Format == DXGI_FORMAT_R16_UINT;
+    if ((!isShortIndex && wasShortIndex) || indexCount > indexCapacity_) {
+        CreateIndexBuffer(indexCount + indexCount / 2, isShortIndex);
+        WriteIndices(0, indexCount);
+    } else {
+        const size_t commonCount = (std::min)(indexCount, previousIndices.size());
+        size_t first = 0;
+        while (first < commonCount && modelData_.indices[first] == previousIndices[first]) {
+            ++first;
+        }
+        size_t last = indexCount;
+        while (last > first && last <= commonCount && modelData_.indices[last - 1] == previousIndices[last - 1]) {
+            --last;
+        }
+        WriteIndices(first, last - first);
+        const size_t indexStride = (indexBufferView_.Format == DXGI_FORMAT_R16_UINT) ? sizeof(uint16_t) : sizeof(uint32_t);
+        indexBufferView_.SizeInBytes = UINT(indexStride * indexCount);
+    }
+}
 
-    // ★修正: 最新の textureIndex を使って描画する
-    commandList->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(modelData_.material.textureIndex));
+void Model::BuildMeshInfo() {
+    // 頂点番号の無いデータは、頂点を先頭から 3 つずつ三角形として扱う
+    if (modelData_.indices.empty()) {
+        modelData_.indices.resize(modelData_.vertices.size());
+        for (size_t i = 0; i < modelData_.indices.size(); ++i) {
+            modelData_.indices[i] = static_cast<uint32_t>(i);
+        }
+    }
+    // 詳細度を下げた段の頂点番号は元のメッシュの後ろに続く
+    size_t baseIndexCount = modelData_.indices.size();
+    for (const ModelData::Lod& lod : modelData_.lods) {
+        for (const Submesh& submesh : lod.submeshes) {
+            baseIndexCount = (std::min)(baseIndexCount, static_cast<size_t>(submesh.indexStart));
+        }
+    }
+    if (modelData_.submeshes.empty()) {
+        modelData_.submeshes.push_back({ "", 0, static_cast<uint32_t>(baseIndexCount), 0 });
+    }
+    for (const Submesh& submesh : modelData_.submeshes) {
+        assert(submesh.materialIndex < modelData_.materials.size());
+        assert(submesh.indexStart + submesh.indexCount <= baseIndexCount);
+    }
+    lodErrors_.assign(1, 0.0f);
+    for (const ModelData::Lod& lod : modelData_.lods) {
+        assert(lod.submeshes.size() == modelData_.submeshes.size());
+        for (const Submesh& submesh : lod.submeshes) {
+            assert(submesh.materialIndex < modelData_.materials.size());
+            assert(submesh.indexStart + submesh.indexCount <= modelData_.indices.size());
+        }
+        lodErrors_.push_back(lod.error);
+    }
+    // 塊はサブメッシュの順に並んでいるので、サブメッシュごとの塊の範囲を控える
+    meshletOffsets_.assign(modelData_.submeshes.size() + 1, 0);
+    meshletSpheres_.Clear();
+    meshletSpheres_.Reserve(modelData_.meshlets.size());
+    for (const ModelData::Meshlet& meshlet : modelData_.meshlets) {
+        assert(meshlet.submeshIndex < modelData_.submeshes.size());
+        assert(meshlet.indexStart >= modelData_.submeshes[meshlet.submeshIndex].indexStart);
+        assert(meshlet.indexStart + meshlet.triangleCount * 3 <=
+            modelData_.submeshes[meshlet.submeshIndex].indexStart + modelData_.submeshes[meshlet.submeshIndex].indexCount);
+        ++meshletOffsets_[meshlet.submeshIndex + 1];
+        meshletSpheres_.PushBack({ meshlet.center, meshlet.radius });
+    }
+    for (size_t i = 0; i < modelData_.submeshes.size(); ++i) {
+        meshletOffsets_[i + 1] += meshletOffsets_[i];
+    }
+    for (size_t i = 0; i < modelData_.meshlets.size(); ++i) {
+        assert(i == 0 || modelData_.meshlets[i - 1].submeshIndex <= modelData_.meshlets[i].submeshIndex);
+    }
 
-    commandList->DrawInstanced(static_cast<UINT>(modelData_.vertices.size()), 1, 0, 0);
+    // --- カリング用の AABB (毎フレーム使うので先に作る、他の境界・BVH は使うときに作る) ---
+    BoundingVolume::BuildAabb(modelData_);
+    baseIndexCount_ = baseIndexCount;
+    isBoundsDirty_ = true;
+    isBvhDirty_ = true;
 }
 
-Model::ModelData Model::CreateSphereData(uint32_t subdivision) {
-    ModelData data;
+const Model::Bounds& Model::GetLocalBounds() {
+    if (isBoundsDirty_) {
+        // 詳細度の選択 (球) 用の、全体とサブメッシュごとの境界
+        BoundingVolume::Build(modelData_);
+        isBoundsDirty_ = false;
+    }
+    return modelData_.bounds;
+}
+
+const Model::Bounds& Model::GetSubmeshBounds(size_t submeshIndex) {
+    GetLocalBounds();
+    return modelData_.submeshBounds[submeshIndex];
+}
+
+const TriangleBvh& Model::GetBvh() {
+    if (isBvhDirty_) {
+        // ピッキング用の三角形 BVH (詳細度を下げた段は含めない)
+        bvh_.Build(modelData_.vertices.data(), sizeof(VertexData), modelData_.vertices.size(), modelData_.indices.data(), baseIndexCount_);
+        isBvhDirty_ = false;
+    }
+    return bvh_;
+}
+
+void Model::CreateVertexBuffer(size_t capacity) {
+    const uint32_t vertexStride = VertexQuantization::GetVertexStride(vertexFormat_);
+    vertexCapacity_ = capacity;
+    vertexResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(vertexStride * capacity);
+
+    vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
+    vertexBufferView_.SizeInBytes = UINT(vertexStride * modelData_.vertices.size());
+    vertexBufferView_.StrideInBytes = vertexStride;
 
-    // ★修正: 初期値として、確実に存在する「uvChecker.png」のインデックスを取得してセットしておく
-    subdivision = (subdivision < 3) ? 3 : subdivision;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
+    // アップロードヒープなので、UpdateVertices で書けるようマップしたままにする
+    vertexResource_->Map(0, nullptr, &vertexData_);
+}
 
-    for (uint32_t lat = 0; lat < subdivision; ++lat) {
-        float latAngle0 = kPi * static_cast<float>(lat) / static_cast<float>(subdivision);
-        float latAngle1 = kPi * static_cast<float>(lat + 1) / static_cast<float>(subdivision);
+void Model::CreateIndexBuffer(size_t capacity, bool isShortIndex) {
+    const size_t indexStride = isShortIndex ? sizeof(uint16_t) : sizeof(uint32_t);
+    indexCapacity_ = capacity;
+    indexResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(indexStride * capacity);
 
-        float y0 = std::cos(latAngle0);
-        float r0 = std::sin(latAngle0);
-        float y1 = std::cos(latAngle1);
-        float r1 = std::sin(latAngle1);
+    indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+    indexBufferView_.SizeInBytes = UINT(indexStride * modelData_.indices.size());
+    indexBufferView_.Format = isShortIndex ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 
-        for (uint32_t lon = 0; lon < subdivision; ++lon) {
-            float lonAngle0 = 2.0f * kPi * static_cast<float>(lon) / static_cast<float>(subdivision);
-            float lonAngle1 = 2.0f * kPi * static_cast<float>(lon + 1) / static_cast<float>(subdivision);
+    indexResource_->Map(0, nullptr, &indexData_);
+}
 
-            float u0 = static_cast<float>(lon) / static_cast<float>(subdivision);
-            float u1 = static_cast<float>(lon + 1) / static_cast<float>(subdivision);
-            float v0 = static_cast<float>(lat) / static_cast<float>(subdivision);
-            float v1 = static_cast<float>(lat + 1) / static_cast<float>(subdivision);
+void Model::WriteVertices(size_t first, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    const uint32_t vertexStride = VertexQuantization::GetVertexStride(vertexFormat_);
+    VertexQuantization::Encode(vertexFormat_, modelData_.vertices.data() + first, count, static_cast<uint8_t*>(vertexData_) + vertexStride * first);
+}
 
-            VertexData v00 = { {r0 * std::cos(lonAngle0), y0, r0 * std::sin(lonAngle0), 1.0f}, {u0, v0}, {r0 * std::cos(lonAngle0), y0, r0 * std::sin(lonAngle0)} };
-            VertexData v10 = { {r1 * std::cos(lonAngle0), y1, r1 * std::sin(lonAngle0), 1.0f}, {u0, v1}, {r1 * std::cos(lonAngle0), y1, r1 * std::sin(lonAngle0)} };
-            VertexData v01 = { {r0 * std::cos(lonAngle1), y0, r0 * std::sin(lonAngle1), 1.0f}, {u1, v0}, {r0 * std::cos(lonAngle1), y0, r0 * std::sin(lonAngle1)} };
-            VertexData v11 = { {r1 * std::cos(lonAngle1), y1, r1 * std::sin(lonAngle1), 1.0f}, {u1, v1}, {r1 * std::cos(lonAngle1), y1, r1 * std::sin(lonAngle1)} };
+void Model::WriteIndices(size_t first, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (indexBufferView_.Format == DXGI_FORMAT_R16_UINT) {
+        uint16_t* shortIndices = static_cast<uint16_t*>(indexData_) + first;
+        for (size_t i = 0; i < count; ++i) {
+            shortIndices[i] = static_cast<uint16_t>(modelData_.indices[first + i]);
+        }
+    } else {
+        std::memcpy(static_cast<uint32_t*>(indexData_) + first, modelData_.indices.data() + first, sizeof(uint32_t) * count);
+    }
+}
+
+void Model::Draw(uint32_t lod, const uint64_t* meshletMask) {
+    assert(lod < lodErrors_.size());
+    // 塊は元のメッシュにしか無い
+    if (lod != 0) {
+        meshletMask = nullptr;
+    }
+    const std::vector<Submesh>& submeshes = (lod == 0) ? modelData_.submeshes : modelData_.lods[lod - 1].submeshes;
+
+    ID3D12GraphicsCommandList* commandList = modelCommon_->GetDxCommon()->GetCommandList();
+
+    commandList->IASetVertexBuffers(0, 1, &vertexBufferView_);
+    commandList->IASetIndexBuffer(&indexBufferView_);
+    commandList->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
 
-            PushQuad(data, v00, v01, v10, v11);
+    // ★修正: 最新の textureIndex を使って描画する
+    // 続くサブメッシュが同じテクスチャなら積み直さない
+    uint32_t boundTextureIndex = static_cast<uint32_t>(-1);
+    for (const Submesh& submesh : submeshes) {
+        const uint32_t textureIndex = modelData_.materials[submesh.materialIndex].textureIndex;
+        if (textureIndex != boundTextureIndex) {
+            commandList->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex));
+            boundTextureIndex = textureIndex;
+        }
+        if (!meshletMask) {
+            commandList->DrawIndexedInstanced(submesh.indexCount, 1, submesh.indexStart, 0, 0);
+            continue;
+        }
+        // 見える塊のうち、頂点番号の範囲が続いているものは 1 回で描く
+        const size_t submeshIndex = &submesh - submeshes.data();
+        uint32_t runStart = 0;
+        uint32_t runEnd = 0;
+        for (uint32_t m = meshletOffsets_[submeshIndex]; m < meshletOffsets_[submeshIndex + 1]; ++m) {
+            if (!Culling::TestMask(meshletMask, m)) {
+                continue;
+            }
+            const ModelData::Meshlet& meshlet = modelData_.meshlets[m];
+            if (meshlet.indexStart != runEnd) {
+                if (runEnd != runStart) {
+                    commandList->DrawIndexedInstanced(runEnd - runStart, 1, runStart, 0, 0);
+                }
+                runStart = meshlet.indexStart;
+            }
+            runEnd = meshlet.indexStart + meshlet.triangleCount * 3;
+        }
+        if (runEnd != runStart) {
+            commandList->DrawIndexedInstanced(runEnd - runStart, 1, runStart, 0, 0);
         }
     }
-    return data;
 }
 
-Model::ModelData Model::CreatePlaneData() {
-    ModelData data;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
+size_t Model::CullMeshlets(const Camera& camera, const Matrix4x4& worldMatrix, std::vector<uint64_t>& visibleMask,
+    const ClusterCulling::Settings& settings) const {
+    visibleMask.resize(Culling::GetMaskWordCount(modelData_.meshlets.size()));
+    if (modelData_.meshlets.empty()) {
+        return 0;
+    }
+    const ClusterCulling::LocalView view = ClusterCulling::MakeLocalView(worldMatrix, camera.GetViewProjectionMatrix(), camera.GetTranslate());
+    return ClusterCulling::Cull(modelData_.meshlets.data(), meshletSpheres_.GetStreams(), view, visibleMask.data(), settings);
+}
 
-    const Vector3 normal = { 0.0f, 1.0f, 0.0f };
-    PushQuad(data,
-        MakeVertex(-1.0f, 0.0f, 1.0f, 0.0f, 0.0f, normal.x, normal.y, normal.z),
-        MakeVertex(1.0f, 0.0f, 1.0f, 1.0f, 0.0f, normal.x, normal.y, normal.z),
-        MakeVertex(-1.0f, 0.0f, -1.0f, 0.0f, 1.0f, normal.x, normal.y, normal.z),
-        MakeVertex(1.0f, 0.0f, -1.0f, 1.0f, 1.0f, normal.x, normal.y, normal.z));
+uint32_t Model::SelectLod(const Camera& camera, const Matrix4x4& worldMatrix, uint32_t currentLod, const LodSelection::Settings& settings) {
+    if (lodErrors_.size() <= 1) {
+        return 0;
+    }
+    const BoundingSphere& localSphere = GetLocalBounds().sphere;
+    if (localSphere.radius <= 0.0f) {
+        return 0;
+    }
+    // 球の中心をワールドへ移し、半径は拡大率の最大の上限で広げる
+    const BoundingSphere sphere = Culling::TransformSphere(localSphere, worldMatrix);
 
-    return data;
+    const float projectedRadius = LodSelection::ComputeProjectedRadius(
+        sphere.center, sphere.radius, camera.GetTranslate(), std::tan(camera.GetFovY() * 0.5f), static_cast<float>(WinApp::kClientHeight));
+    return LodSelection::Select(lodErrors_.data(), lodErrors_.size(), projectedRadius / localSphere.radius, currentLod, settings);
 }
 
-Model::ModelData Model::CreateCircleData(uint32_t subdivision) {
-    ModelData data;
-    subdivision = (subdivision < 3) ? 3 : subdivision;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
-
-    for (uint32_t i = 0; i < subdivision; ++i) {
-        float angle0 = 2.0f * kPi * static_cast<float>(i) / static_cast<float>(subdivision);
-        float angle1 = 2.0f * kPi * static_cast<float>(i + 1) / static_cast<float>(subdivision);
-
-        float x0 = std::cos(angle0);
-        float z0 = std::sin(angle0);
-        float x1 = std::cos(angle1);
-        float z1 = std::sin(angle1);
-
-        VertexData center = MakeVertex(0.0f, 0.0f, 0.0f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f);
-        VertexData v0 = MakeVertex(x0, 0.0f, z0, x0 * 0.5f + 0.5f, -z0 * 0.5f + 0.5f, 0.0f, 1.0f, 0.0f);
-        VertexData v1 = MakeVertex(x1, 0.0f, z1, x1 * 0.5f + 0.5f, -z1 * 0.5f + 0.5f, 0.0f, 1.0f, 0.0f);
-        PushTriangle(data, center, v1, v0);
+void Model::SetTextureIndex(uint32_t index) {
+    for (MaterialData& material : modelData_.materials) {
+        material.textureIndex = index;
     }
+}
 
-    return data;
+Model::ModelData Model::CreateSphereData(uint32_t subdivision) {
+    return PreparePrimitive(PrimitiveGenerator::CreateSphereData(subdivision));
+}
+
+Model::ModelData Model::CreatePlaneData() {
+    return PreparePrimitive(PrimitiveGenerator::CreatePlaneData());
+}
+
+Model::ModelData Model::CreateCircleData(uint32_t subdivision) {
+    return PreparePrimitive(PrimitiveGenerator::CreateCircleData(subdivision));
 }
 
 Model::ModelData Model::CreateRingData(
@@ -179,296 +370,45 @@ Model::ModelData Model::CreateRingData(
     float endAngle,
     float startRadius,
     float endRadius) {
-    return PrimitiveGenerator::CreateRingData(subdivision, innerRadius, outerRadius, startAngle, endAngle, startRadius, endRadius);
+    return PreparePrimitive(PrimitiveGenerator::CreateRingData(subdivision, innerRadius, outerRadius, startAngle, endAngle, startRadius, endRadius));
 }
 
 Model::ModelData Model::CreateTorusData(uint32_t majorSubdivision, uint32_t minorSubdivision, float majorRadius, float minorRadius) {
-    ModelData data;
-    majorSubdivision = (majorSubdivision < 3) ? 3 : majorSubdivision;
-    minorSubdivision = (minorSubdivision < 3) ? 3 : minorSubdivision;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
-
-    auto MakeTorusVertex = [majorRadius, minorRadius](float theta, float phi, float u, float v) {
-        float cosTheta = std::cos(theta);
-        float sinTheta = std::sin(theta);
-        float cosPhi = std::cos(phi);
-        float sinPhi = std::sin(phi);
-        float radius = majorRadius + minorRadius * cosPhi;
-
-        float x = radius * cosTheta;
-        float y = minorRadius * sinPhi;
-        float z = radius * sinTheta;
-        Vector3 normal = Normalize({ cosPhi * cosTheta, sinPhi, cosPhi * sinTheta }, { 0.0f, 1.0f, 0.0f });
-        return MakeVertex(x, y, z, u, v, normal.x, normal.y, normal.z);
-        };
-
-    for (uint32_t major = 0; major < majorSubdivision; ++major) {
-        float theta0 = 2.0f * kPi * static_cast<float>(major) / static_cast<float>(majorSubdivision);
-        float theta1 = 2.0f * kPi * static_cast<float>(major + 1) / static_cast<float>(majorSubdivision);
-        float u0 = static_cast<float>(major) / static_cast<float>(majorSubdivision);
-        float u1 = static_cast<float>(major + 1) / static_cast<float>(majorSubdivision);
-
-        for (uint32_t minor = 0; minor < minorSubdivision; ++minor) {
-            float phi0 = 2.0f * kPi * static_cast<float>(minor) / static_cast<float>(minorSubdivision);
-            float phi1 = 2.0f * kPi * static_cast<float>(minor + 1) / static_cast<float>(minorSubdivision);
-            float v0 = static_cast<float>(minor) / static_cast<float>(minorSubdivision);
-            float v1 = static_cast<float>(minor + 1) / static_cast<float>(minorSubdivision);
-
-            PushQuad(data,
-                MakeTorusVertex(theta0, phi0, u0, v0),
-                MakeTorusVertex(theta1, phi0, u1, v0),
-                MakeTorusVertex(theta0, phi1, u0, v1),
-                MakeTorusVertex(theta1, phi1, u1, v1));
-        }
-    }
-
-    return data;
+    return PreparePrimitive(PrimitiveGenerator::CreateTorusData(majorSubdivision, minorSubdivision, majorRadius, minorRadius));
 }
 
 Model::ModelData Model::CreateCylinderData(uint32_t subdivision, float radius, float height) {
-    ModelData data;
-    subdivision = (subdivision < 3) ? 3 : subdivision;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
-
-    float halfHeight = height * 0.5f;
-
-    for (uint32_t i = 0; i < subdivision; ++i) {
-        float angle0 = 2.0f * kPi * static_cast<float>(i) / static_cast<float>(subdivision);
-        float angle1 = 2.0f * kPi * static_cast<float>(i + 1) / static_cast<float>(subdivision);
-
-        float x0 = std::cos(angle0) * radius;
-        float z0 = std::sin(angle0) * radius;
-        float x1 = std::cos(angle1) * radius;
-        float z1 = std::sin(angle1) * radius;
-        float u0 = static_cast<float>(i) / static_cast<float>(subdivision);
-        float u1 = static_cast<float>(i + 1) / static_cast<float>(subdivision);
-
-        Vector3 normal0 = Normalize({ std::cos(angle0), 0.0f, std::sin(angle0) }, { 1.0f, 0.0f, 0.0f });
-        Vector3 normal1 = Normalize({ std::cos(angle1), 0.0f, std::sin(angle1) }, { 1.0f, 0.0f, 0.0f });
-
-        PushQuad(data,
-            MakeVertex(x0, halfHeight, z0, u0, 0.0f, normal0.x, normal0.y, normal0.z),
-            MakeVertex(x1, halfHeight, z1, u1, 0.0f, normal1.x, normal1.y, normal1.z),
-            MakeVertex(x0, -halfHeight, z0, u0, 1.0f, normal0.x, normal0.y, normal0.z),
-            MakeVertex(x1, -halfHeight, z1, u1, 1.0f, normal1.x, normal1.y, normal1.z));
-
-        VertexData topCenter = MakeVertex(0.0f, halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f);
-        VertexData top0 = MakeVertex(x0, halfHeight, z0, x0 / (radius * 2.0f) + 0.5f, -z0 / (radius * 2.0f) + 0.5f, 0.0f, 1.0f, 0.0f);
-        VertexData top1 = MakeVertex(x1, halfHeight, z1, x1 / (radius * 2.0f) + 0.5f, -z1 / (radius * 2.0f) + 0.5f, 0.0f, 1.0f, 0.0f);
-        PushTriangle(data, topCenter, top1, top0);
-
-        VertexData bottomCenter = MakeVertex(0.0f, -halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, -1.0f, 0.0f);
-        VertexData bottom0 = MakeVertex(x0, -halfHeight, z0, x0 / (radius * 2.0f) + 0.5f, z0 / (radius * 2.0f) + 0.5f, 0.0f, -1.0f, 0.0f);
-        VertexData bottom1 = MakeVertex(x1, -halfHeight, z1, x1 / (radius * 2.0f) + 0.5f, z1 / (radius * 2.0f) + 0.5f, 0.0f, -1.0f, 0.0f);
-        PushTriangle(data, bottomCenter, bottom0, bottom1);
-    }
-
-    return data;
+    return PreparePrimitive(PrimitiveGenerator::CreateCylinderData(subdivision, radius, height));
 }
 
 Model::ModelData Model::CreateEffectCylinderData(uint32_t subdivision, float topRadius, float bottomRadius, float height) {
-    ModelData data;
-    subdivision = (subdivision < 3) ? 3 : subdivision;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
-
-    float radianPerDivide = 2.0f * kPi / static_cast<float>(subdivision);
-
-    for (uint32_t index = 0; index < subdivision; ++index) {
-        float sinVal = std::sin(index * radianPerDivide);
-        float cosVal = std::cos(index * radianPerDivide);
-        float sinNext = std::sin((index + 1) * radianPerDivide);
-        float cosNext = std::cos((index + 1) * radianPerDivide);
-        float u = static_cast<float>(index) / static_cast<float>(subdivision);
-        float uNext = static_cast<float>(index + 1) / static_cast<float>(subdivision);
-
-        float vTop = 1.0f; // Slide 3: flip v
-        float vBottom = 0.0f;
-
-        PushTriangle(data,
-            MakeVertex(-sinVal * topRadius, height, cosVal * topRadius, u, vTop, -sinVal, 0.0f, cosVal),
-            MakeVertex(-sinNext * topRadius, height, cosNext * topRadius, uNext, vTop, -sinNext, 0.0f, cosNext),
-            MakeVertex(-sinVal * bottomRadius, 0.0f, cosVal * bottomRadius, u, vBottom, -sinVal, 0.0f, cosVal));
-
-        PushTriangle(data,
-            MakeVertex(-sinVal * bottomRadius, 0.0f, cosVal * bottomRadius, u, vBottom, -sinVal, 0.0f, cosVal),
-            MakeVertex(-sinNext * topRadius, height, cosNext * topRadius, uNext, vTop, -sinNext, 0.0f, cosNext),
-            MakeVertex(-sinNext * bottomRadius, 0.0f, cosNext * bottomRadius, uNext, vBottom, -sinNext, 0.0f, cosNext));
-    }
-
-    return data;
+    return PreparePrimitive(PrimitiveGenerator::CreateEffectCylinderData(subdivision, topRadius, bottomRadius, height));
 }
 
 Model::ModelData Model::CreateConeData(uint32_t subdivision, float radius, float height) {
-    ModelData data;
-    subdivision = (subdivision < 3) ? 3 : subdivision;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
-
-    float halfHeight = height * 0.5f;
-    float slope = radius / height;
-
-    for (uint32_t i = 0; i < subdivision; ++i) {
-        float angle0 = 2.0f * kPi * static_cast<float>(i) / static_cast<float>(subdivision);
-        float angle1 = 2.0f * kPi * static_cast<float>(i + 1) / static_cast<float>(subdivision);
-        float midAngle = (angle0 + angle1) * 0.5f;
-
-        float x0 = std::cos(angle0) * radius;
-        float z0 = std::sin(angle0) * radius;
-        float x1 = std::cos(angle1) * radius;
-        float z1 = std::sin(angle1) * radius;
-        float u0 = static_cast<float>(i) / static_cast<float>(subdivision);
-        float u1 = static_cast<float>(i + 1) / static_cast<float>(subdivision);
-
-        Vector3 normal0 = Normalize({ std::cos(angle0), slope, std::sin(angle0) }, { 1.0f, 0.0f, 0.0f });
-        Vector3 normal1 = Normalize({ std::cos(angle1), slope, std::sin(angle1) }, { 1.0f, 0.0f, 0.0f });
-        Vector3 normalApex = Normalize({ std::cos(midAngle), slope, std::sin(midAngle) }, { 0.0f, 1.0f, 0.0f });
-
-        PushTriangle(data,
-            MakeVertex(0.0f, halfHeight, 0.0f, 0.5f, 0.0f, normalApex.x, normalApex.y, normalApex.z),
-            MakeVertex(x1, -halfHeight, z1, u1, 1.0f, normal1.x, normal1.y, normal1.z),
-            MakeVertex(x0, -halfHeight, z0, u0, 1.0f, normal0.x, normal0.y, normal0.z));
-
-        VertexData bottomCenter = MakeVertex(0.0f, -halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, -1.0f, 0.0f);
-        VertexData bottom0 = MakeVertex(x0, -halfHeight, z0, x0 / (radius * 2.0f) + 0.5f, z0 / (radius * 2.0f) + 0.5f, 0.0f, -1.0f, 0.0f);
-        VertexData bottom1 = MakeVertex(x1, -halfHeight, z1, x1 / (radius * 2.0f) + 0.5f, z1 / (radius * 2.0f) + 0.5f, 0.0f, -1.0f, 0.0f);
-        PushTriangle(data, bottomCenter, bottom0, bottom1);
-    }
-
-    return data;
+    return PreparePrimitive(PrimitiveGenerator::CreateConeData(subdivision, radius, height));
 }
 
 Model::ModelData Model::CreateTriangleData() {
-    ModelData data;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
-
-    const Vector3 normal = { 0.0f, 1.0f, 0.0f };
-    PushTriangle(data,
-        MakeVertex(-1.0f, 0.0f, -1.0f, 0.0f, 1.0f, normal.x, normal.y, normal.z),
-        MakeVertex(0.0f, 0.0f, 1.0f, 0.5f, 0.0f, normal.x, normal.y, normal.z),
-        MakeVertex(1.0f, 0.0f, -1.0f, 1.0f, 1.0f, normal.x, normal.y, normal.z));
-
-    return data;
+    return PreparePrimitive(PrimitiveGenerator::CreateTriangleData());
 }
 
 Model::ModelData Model::CreateBoxData() {
-    ModelData data;
-    data.material.textureIndex = GetPrimitiveTextureIndex();
-
-    const float min = -1.0f;
-    const float max = 1.0f;
-
-    PushQuad(data,
-        MakeVertex(min, max, max, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f),
-        MakeVertex(max, max, max, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f),
-        MakeVertex(min, min, max, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f),
-        MakeVertex(max, min, max, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f));
-
-    PushQuad(data,
-        MakeVertex(max, max, min, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f),
-        MakeVertex(min, max, min, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f),
-        MakeVertex(max, min, min, 0.0f, 1.0f, 0.0f, 0.0f, -1.0f),
-        MakeVertex(min, min, min, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f));
-
-    PushQuad(data,
-        MakeVertex(min, max, min, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f),
-        MakeVertex(min, max, max, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f),
-        MakeVertex(min, min, min, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f),
-        MakeVertex(min, min, max, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f));
-
-    PushQuad(data,
-        MakeVertex(max, max, max, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f),
-        MakeVertex(max, max, min, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f),
-        MakeVertex(max, min, max, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f),
-        MakeVertex(max, min, min, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f));
-
-    PushQuad(data,
-        MakeVertex(min, max, min, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f),
-        MakeVertex(max, max, min, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f),
-        MakeVertex(min, max, max, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f),
-        MakeVertex(max, max, max, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f));
-
-    PushQuad(data,
-        MakeVertex(min, min, max, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f),
-        MakeVertex(max, min, max, 1.0f, 0.0f, 0.0f, -1.0f, 0.0f),
-        MakeVertex(min, min, min, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f),
-        MakeVertex(max, min, min, 1.0f, 1.0f, 0.0f, -1.0f, 0.0f));
-
-    return data;
+    return PreparePrimitive(PrimitiveGenerator::CreateBoxData());
 }
 
-Model::MaterialData Model::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
-    MaterialData materialData;
-    std::string line;
-    std::ifstream file(directoryPath + "/" + filename);
-    if (!file.is_open()) return materialData;
-
-    while (std::getline(file, line)) {
-        std::string identifier;
-        std::istringstream s(line);
-        s >> identifier;
-        if (identifier == "map_Kd") {
-            std::string textureFilename;
-            s >> textureFilename;
-            materialData.textureFilePath = directoryPath + "/" + textureFilename;
-        }
-    }
-    return materialData;
+std::vector<Model::MaterialData> Model::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
+    return ObjLoader::LoadMaterialTemplateFile(directoryPath, filename);
 }
 
 Model::ModelData Model::LoadObjFile(const std::string& directoryPath, const std::string& filename) {
-    ModelData modelData;
-    std::vector<Vector4> positions;
-    std::vector<Vector3> normals;
-    std::vector<Vector2> texcoords;
-    std::string line;
-    std::ifstream file(directoryPath + "/" + filename);
-    assert(file.is_open());
-
-    while (std::getline(file, line)) {
-        std::string identifier;
-        std::istringstream s(line);
-        s >> identifier;
-
-        if (identifier == "v") {
-            Vector4 p{};
-            s >> p.x >> p.y >> p.z;
-            p.w = 1.0f;
-            positions.push_back(p);
-        } else if (identifier == "vt") {
-            Vector2 uv{};
-            s >> uv.x >> uv.y;
-            uv.y = 1.0f - uv.y;
-            texcoords.push_back(uv);
-        } else if (identifier == "vn") {
-            Vector3 n{};                                                 
-            s >> n.x >> n.y >> n.z;
-            n.x *= -1.0f;
-            normals.push_back(n);
-        } else if (identifier == "f") {
-            VertexData triangle[3]{};
-            for (int i = 0; i < 3; ++i) {
-                std::string vertexDefinition;
-                s >> vertexDefinition;
-                std::istringstream v(vertexDefinition);
-                uint32_t idx[3]{};
-                for (int e = 0; e < 3; ++e) {
-                    std::string indexStr;
-                    std::getline(v, indexStr, '/');
-                    idx[e] = static_cast<uint32_t>(std::stoi(indexStr));
-                }
-                Vector4 p = positions[idx[0] - 1];
-                Vector2 t = texcoords[idx[1] - 1];
-                Vector3 n = normals[idx[2] - 1];
-                p.x *= -1.0f;
-                triangle[i] = { p, t, n };
-            }
-            modelData.vertices.push_back(triangle[2]);
-            modelData.vertices.push_back(triangle[1]);
-            modelData.vertices.push_back(triangle[0]);
-        } else if (identifier == "mtllib") {
-            std::string materialFilename;
-            s >> materialFilename;
-            modelData.material = LoadMaterialTemplateFile(directoryPath, materialFilename);
-        }
-    }
-    return modelData;
+    return MeshCache::LoadObjFile(directoryPath, filename);
+}
+
+Model::ModelData Model::LoadGlbFile(const std::string& directoryPath, const std::string& filename) {
+    return MeshCache::LoadGlbFile(directoryPath, filename);
+}
+
+Model::ModelData Model::LoadModelFile(const std::string& directoryPath, const std::string& filename) {
+    return MeshCache::LoadModelFile(directoryPath, filename);
 }
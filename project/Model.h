@@ -1,6 +1,13 @@
 #pragma once
 #include "ModelCommon.h"
+#include "ModelData.h"
 #include "Matrix4x4.h"
+#include "Camera.h"
+#include "ClusterCulling.h"
+#include "Culling.h"
+#include "LodSelection.h"
+#include "TriangleBvh.h"
+#include "VertexQuantization.h"
 #include <string>
 #include <vector>
 #include <wrl.h>
@@ -8,21 +15,13 @@
 
 class Model {
 public:
-    struct VertexData {
-        Vector4 position;
-        Vector2 texcoord;
-        Vector3 normal;
-    };
-
-    struct MaterialData {
-        std::string textureFilePath;
-        uint32_t textureIndex = 0;
-    };
-
-    struct ModelData {
-        std::vector<VertexData> vertices;
-        MaterialData material;
-    };
+    // CPU 側のデータは ModelData.h (グラフィックス API に依存しない)
+    using VertexData = ::ModelData::VertexData;
+    using MaterialData = ::ModelData::MaterialData;
+    using Submesh = ::ModelData::Submesh;
+    using CacheMetrics = ::ModelData::CacheMetrics;
+    using Bounds = ::ModelData::Bounds;
+    using ModelData = ::ModelData;
 
     struct Material {
         Vector4 color;
@@ -34,19 +33,58 @@ public:
     };
 
 public:
-    void Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename);
+    // vertexFormat で GPU 上の頂点の並びを選ぶ (kPacked* は頂点バッファが 1/2 程度になる)
+    void Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename,
+        VertexFormat vertexFormat = VertexFormat::kFloat);
 
     // 生成済みのModelDataを直接渡す用
-    void Initialize(ModelCommon* modelCommon, const ModelData& modelData);
+    void Initialize(ModelCommon* modelCommon, const ModelData& modelData, VertexFormat vertexFormat = VertexFormat::kFloat);
 
-    void Draw();
+    // 形だけを差し替える (毎フレーム形の変わる基本図形用、マテリアル・テクスチャはそのまま使う)
+    // 頂点・頂点番号のバッファはマップしたままのものを使い回し、前回と違う範囲だけを書き込む
+    // 容量が足りない場合だけ、余裕を持たせて作り直す
+    void UpdateVertices(const ModelData& modelData);
 
-    void SetTextureIndex(uint32_t index) { modelData_.material.textureIndex = index; }
+    // 頂点・インデックスバッファは 1 度だけ積み、サブメッシュごとにテクスチャを替えて描く
+    // lod は詳細度の段 (0 が元のメッシュ、SelectLod で選ぶ)
+    // meshletMask を渡すと、元のメッシュはビットの立った塊だけを描く (CullMeshlets の結果、lod が 0 以外なら使わない)
+    void Draw(uint32_t lod = 0, const uint64_t* meshletMask = nullptr);
+
+    // 全てのマテリアルのテクスチャを差し替える
+    void SetTextureIndex(uint32_t index);
 
     Material* GetMaterialData() { return materialData_; }
+    // 頂点を包むローカル座標の AABB (カリング用)
+    const Aabb& GetLocalAabb() const { return modelData_.bounds.aabb; }
+    // 頂点を包むローカル座標の AABB・球・有向ボックス (BoundingVolume、形が変わった後に初めて呼ばれたときに作り直す)
+    const Bounds& GetLocalBounds();
+    const Bounds& GetSubmeshBounds(size_t submeshIndex);
+    // ローカル座標の三角形 BVH (レイピッキング用、形が変わった後に初めて呼ばれたときに構築し直す)
+    const TriangleBvh& GetBvh();
+
+    // 元のメッシュを含めた詳細度の段の数
+    uint32_t GetLodCount() const { return static_cast<uint32_t>(lodErrors_.size()); }
+    // カメラから見た大きさで段を選ぶ (currentLod は前のフレームの段、境目でのちらつきを抑えるのに使う)
+    uint32_t SelectLod(const Camera& camera, const Matrix4x4& worldMatrix, uint32_t currentLod,
+        const LodSelection::Settings& settings = {});
+    // 補ったサブメッシュを含めた CPU 側のデータ (StaticBatcher でまとめるときに使う、bounds は AABB 以外が古いことがある)
+    const ModelData& GetModelData() const { return modelData_; }
+    // 元のメッシュの塊 (MeshletBuilder) の数
+    uint32_t GetMeshletCount() const { return static_cast<uint32_t>(modelData_.meshlets.size()); }
+    // カメラの視錐台の外・裏向きの塊を除き、見える塊のビットを visibleMask に立てて、その数を返す
+    size_t CullMeshlets(const Camera& camera, const Matrix4x4& worldMatrix, std::vector<uint64_t>& visibleMask,
+        const ClusterCulling::Settings& settings = {}) const;
+    // 取り込み時の並べ替えの前後の頂点キャッシュの効率 (MeshOptimizer)
+    const CacheMetrics& GetCacheMetrics() const { return modelData_.cacheMetrics; }
+    // 描く前に Object3dCommon::SetVertexFormat でこの並びのパイプラインにする
+    VertexFormat GetVertexFormat() const { return vertexFormat_; }
 
-    static MaterialData LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename);
+    static std::vector<MaterialData> LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename);
+    // 2 回目以降は OBJ の隣に書き出したバイナリのキャッシュから読む (MeshCache)
     static ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename);
+    static ModelData LoadGlbFile(const std::string& directoryPath, const std::string& filename);
+    // 拡張子で OBJ / GLB を選んで読む
+    static ModelData LoadModelFile(const std::string& directoryPath, const std::string& filename);
 
     // 三角形ポリゴンで球のモデルデータを生成する関数
     static ModelData CreateSphereData(uint32_t subdivision = 16);
@@ -67,13 +105,46 @@ public:
     static ModelData CreateTriangleData();
     static ModelData CreateBoxData();
 
+private:
+    // 頂点番号・サブメッシュを補い、カリング・詳細度用の情報と AABB を modelData_ から作る
+    // 球・有向ボックス・BVH は重いので、作り直しが要る印だけを付ける (UpdateVertices で毎フレーム呼ばれるため)
+    void BuildMeshInfo();
+    // capacity 個分のバッファを作ってマップする (ビューの大きさは modelData_ の数)
+    void CreateVertexBuffer(size_t capacity);
+    void CreateIndexBuffer(size_t capacity, bool isShortIndex);
+    // modelData_ の [first, first + count) をマップしたバッファへ書く
+    void WriteVertices(size_t first, size_t count);
+    void WriteIndices(size_t first, size_t count);
+
 private:
     ModelCommon* modelCommon_ = nullptr;
     ModelData modelData_; // 読み込んだデータを保持
+    TriangleBvh bvh_;
+    // 形が変わってから bvh_ / modelData_.bounds の球・有向ボックス・サブメッシュの境界を作り直していない
+    bool isBvhDirty_ = true;
+    // 元のメッシュの頂点番号の数 (詳細度を下げた段の頂点番号はこの後ろ)
+    size_t baseIndexCount_ = 0;
+    bool isBoundsDirty_ = true;
+    // 詳細度の選択用 (段ごとの誤差、球は modelData_.bounds.sphere を使う)
+    std::vector<float> lodErrors_;
+    // サブメッシュ i の塊は modelData_.meshlets の [meshletOffsets_[i], meshletOffsets_[i + 1])
+    std::vector<uint32_t> meshletOffsets_;
+    // 塊を包む球 (視錐台の判定をまとめて行うための SoA)
+    SphereSoA meshletSpheres_;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_;
     D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
-    VertexData* vertexData_ = nullptr;
+    // vertexFormat_ の並び (kFloat 以外は modelData_.vertices を量子化したもの)
+    VertexFormat vertexFormat_ = VertexFormat::kFloat;
+    void* vertexData_ = nullptr;
+    // バッファに入る頂点・頂点番号の数 (UpdateVertices で増えた場合の余裕を含む)
+    size_t vertexCapacity_ = 0;
+    size_t indexCapacity_ = 0;
+
+    // 頂点が 65535 個以下なら 16 ビット、それ以外は 32 ビットの頂点番号
+    Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_;
+    D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+    void* indexData_ = nullptr;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> materialResource_;
     Material* materialData_ = nullptr;
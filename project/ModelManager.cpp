@@ -1,8 +1,23 @@
 #include "ModelManager.h"
+#include "Logger.h"
+#include <cassert>
+#include <cstdio>
 #include <filesystem>
+#include <utility>
 
 std::unique_ptr<ModelManager> ModelManager::instance_ = nullptr;
 
+namespace {
+    // "dir/name.obj" をディレクトリとファイル名に分ける
+    std::pair<std::string, std::string> SplitPath(const std::string& filePath) {
+        const size_t pos = filePath.find_last_of('/');
+        if (pos == std::string::npos) {
+            return { "", filePath };
+        }
+        return { filePath.substr(0, pos), filePath.substr(pos + 1) };
+    }
+}
+
 ModelManager* ModelManager::GetInstance()
 {
     if (!instance_) {
@@ -19,29 +34,40 @@ void ModelManager::Initialize(DirectXCommon* dxCommon)
 
 void ModelManager::Finalize()
 {
+    // 読み込み中のものは捨て、待っている future には nullptr を渡す
+    asyncLoader_.reset();
+    for (auto& [filePath, loadingModel] : loadingModels_) {
+        loadingModel.promise.set_value(nullptr);
+    }
+    loadingModels_.clear();
+    loadingPaths_.clear();
+    completedLoads_.clear();
+    takenLoads_.clear();
+    placeholderModel_ = nullptr;
     models_.clear();
 }
 
-void ModelManager::LoadModel(const std::string& filePath)
+void ModelManager::LoadModel(const std::string& filePath, VertexFormat vertexFormat)
 {
     if (models_.contains(filePath)) { return; }
 
+    // 非同期で読み込み中なら、それが終わるのを待つ
+    if (loadingModels_.contains(filePath)) {
+        while (loadingModels_.contains(filePath)) {
+            asyncLoader_->WaitForCompleted();
+            Update();
+        }
+        return;
+    }
+
     // ファイルが存在しない場合はクラッシュを防ぐためにスキップ
     if (!std::filesystem::exists(filePath)) { return; }
 
-    std::string directoryPath;
-    std::string filename;
-    size_t pos = filePath.find_last_of('/');
-    if (pos != std::string::npos) {
-        directoryPath = filePath.substr(0, pos);
-        filename = filePath.substr(pos + 1);
-    } else {
-        directoryPath = "";
-        filename = filePath;
-    }
+    const auto [directoryPath, filename] = SplitPath(filePath);
 
     std::unique_ptr<Model> model = std::make_unique<Model>();
-    model->Initialize(modelCommon_.get(), directoryPath, filename);
+    model->Initialize(modelCommon_.get(), directoryPath, filename, vertexFormat);
+    LogCacheMetrics(filePath, *model);
 
     models_.insert(std::make_pair(filePath, std::move(model)));
 }
@@ -51,9 +77,117 @@ Model* ModelManager::FindModel(const std::string& filePath)
     if (models_.contains(filePath)) {
         return models_.at(filePath).get();
     }
+    if (loadingModels_.contains(filePath)) {
+        return placeholderModel_;
+    }
     return nullptr;
 }
 
+std::shared_future<Model*> ModelManager::LoadModelAsync(const std::string& filePath, VertexFormat vertexFormat,
+    std::function<void(Model*)> onLoaded)
+{
+    // 読み込み済み・ファイルが無い場合は、その場で値の入った future を返す
+    auto MakeReadyFuture = [&](Model* model) {
+        std::promise<Model*> promise;
+        promise.set_value(model);
+        if (onLoaded) {
+            onLoaded(model);
+        }
+        return promise.get_future().share();
+    };
+    if (models_.contains(filePath)) {
+        return MakeReadyFuture(models_.at(filePath).get());
+    }
+
+    // 読み込み中なら同じ future を返し、完了時に呼ぶ関数を足す
+    auto it = loadingModels_.find(filePath);
+    if (it != loadingModels_.end()) {
+        if (onLoaded) {
+            it->second.onLoaded.push_back(std::move(onLoaded));
+        }
+        return it->second.future;
+    }
+
+    if (!std::filesystem::exists(filePath)) {
+        return MakeReadyFuture(nullptr);
+    }
+
+    if (!asyncLoader_) {
+        asyncLoader_ = std::make_unique<AsyncMeshLoader>();
+    }
+    const auto [directoryPath, filename] = SplitPath(filePath);
+    LoadingModel& loadingModel = loadingModels_[filePath];
+    loadingModel.ticket = asyncLoader_->Request(directoryPath, filename);
+    loadingModel.vertexFormat = vertexFormat;
+    loadingModel.future = loadingModel.promise.get_future().share();
+    if (onLoaded) {
+        loadingModel.onLoaded.push_back(std::move(onLoaded));
+    }
+    loadingPaths_.emplace(loadingModel.ticket, filePath);
+    return loadingModel.future;
+}
+
+void ModelManager::Update()
+{
+    if (asyncLoader_ && asyncLoader_->TakeCompleted(completedLoads_) != 0) {
+        for (AsyncMeshLoader::Result& result : completedLoads_) {
+            takenLoads_.emplace(result.ticket, std::move(result));
+        }
+        // 確保済みの領域は次の Update で使い回す
+        completedLoads_.clear();
+    }
+    // 頼んだ順に GPU バッファを作る
+    // 1 つずつ取り出してから処理するので、onLoaded から Update が呼ばれると残りはそちらで処理される
+    // (同じフレームに読み終わったモデルを onLoaded から LoadModel で待っても止まらない)
+    while (!takenLoads_.empty()) {
+        const AsyncMeshLoader::Result result = std::move(takenLoads_.extract(takenLoads_.begin()).mapped());
+        auto pathIt = loadingPaths_.find(result.ticket);
+        assert(pathIt != loadingPaths_.end());
+        const std::string filePath = pathIt->second;
+        loadingPaths_.erase(pathIt);
+
+        auto it = loadingModels_.find(filePath);
+        assert(it != loadingModels_.end());
+        LoadingModel loadingModel = std::move(it->second);
+        loadingModels_.erase(it);
+        CompleteLoad(filePath, loadingModel, result.modelData);
+    }
+}
+
+void ModelManager::WaitForAsyncLoads()
+{
+    while (!loadingModels_.empty()) {
+        asyncLoader_->WaitForCompleted();
+        Update();
+    }
+}
+
+Model* ModelManager::CompleteLoad(const std::string& filePath, LoadingModel& loadingModel, const Model::ModelData& modelData)
+{
+    std::unique_ptr<Model> model = std::make_unique<Model>();
+    model->Initialize(modelCommon_.get(), modelData, loadingModel.vertexFormat);
+    LogCacheMetrics(filePath, *model);
+
+    Model* loadedModel = model.get();
+    models_.insert(std::make_pair(filePath, std::move(model)));
+
+    loadingModel.promise.set_value(loadedModel);
+    for (std::function<void(Model*)>& onLoaded : loadingModel.onLoaded) {
+        onLoaded(loadedModel);
+    }
+    return loadedModel;
+}
+
+void ModelManager::LogCacheMetrics(const std::string& filePath, const Model& model)
+{
+    // 頂点の並べ替えの効果をアセットごとに記録する
+    const Model::CacheMetrics& metrics = model.GetCacheMetrics();
+    char message[256];
+    std::snprintf(message, sizeof(message), "%s: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+        filePath.c_str(), metrics.acmrBefore, metrics.acmrAfter, metrics.atvrBefore, metrics.atvrAfter);
+    Logger::Log(message);
+}
+
 Model* ModelManager::CreateSphere(const std::string& keyName, uint32_t subdivision)
 {
     return CreatePrimitive(keyName, Model::CreateSphereData(subdivision));
@@ -112,6 +246,16 @@ Model* ModelManager::CreateBox(const std::string& keyName)
     return CreatePrimitive(keyName, Model::CreateBoxData());
 }
 
+Model* ModelManager::UpdatePrimitive(const std::string& keyName, const Model::ModelData& modelData)
+{
+    if (!models_.contains(keyName)) {
+        return CreatePrimitive(keyName, modelData);
+    }
+    Model* model = models_.at(keyName).get();
+    model->UpdateVertices(modelData);
+    return model;
+}
+
 Model* ModelManager::CreatePrimitive(const std::string& keyName, const Model::ModelData& modelData)
 {
     if (models_.contains(keyName)) {
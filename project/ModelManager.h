@@ -1,7 +1,11 @@
 #pragma once
+#include <functional>
+#include <future>
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
+#include "AsyncMeshLoader.h"
 #include "Model.h"
 #include "ModelCommon.h"
 
@@ -23,9 +27,27 @@ public:
     void Initialize(DirectXCommon* dxCommon);
     void Finalize();
 
-    void LoadModel(const std::string& filePath);
+    // 拡張子が .glb なら GLB、それ以外は OBJ として読む
+    // vertexFormat は最初に読み込んだときのものが使われる
+    void LoadModel(const std::string& filePath, VertexFormat vertexFormat = VertexFormat::kFloat);
+    // 読み込み中のモデルは、代わりのモデル (SetPlaceholderModel) を返す
     Model* FindModel(const std::string& filePath);
 
+    // OBJ / GLB の読み込みと並べ替えはワーカースレッドで行い、GPU のバッファ作成だけを Update で描画スレッドで行う
+    // 返す future は Update で作り終えたときに値が入る (ファイルが無ければ nullptr)
+    // 描画スレッドで get() する場合は、先に WaitForAsyncLoads を呼ぶ (Update を待つことになるため)
+    // onLoaded も描画スレッドで呼ぶ (読み込み済み・ファイルが無い場合はその場で呼ぶ)
+    std::shared_future<Model*> LoadModelAsync(const std::string& filePath, VertexFormat vertexFormat = VertexFormat::kFloat,
+        std::function<void(Model*)> onLoaded = nullptr);
+    // 毎フレーム描画スレッドで呼び、読み終わったモデルの GPU バッファを作る
+    void Update();
+    // 非同期の読み込みが全て終わるまで待つ (ロード画面の終わりやシーンの切り替え前に使う)
+    void WaitForAsyncLoads();
+    bool IsLoading(const std::string& filePath) const { return loadingModels_.contains(filePath); }
+    size_t GetLoadingModelCount() const { return loadingModels_.size(); }
+    // 読み込み中に FindModel が返すモデル (nullptr なら読み込み中は nullptr を返す)
+    void SetPlaceholderModel(Model* model) { placeholderModel_ = model; }
+
     Model* CreateSphere(const std::string& keyName, uint32_t subdivision = 16);
     Model* CreatePlane(const std::string& keyName);
     Model* CreateCircle(const std::string& keyName, uint32_t subdivision = 32);
@@ -44,10 +66,35 @@ public:
     Model* CreateCone(const std::string& keyName, uint32_t subdivision = 32);
     Model* CreateTriangle(const std::string& keyName);
     Model* CreateBox(const std::string& keyName);
+    // keyName のモデルがあれば形だけを差し替え (Model::UpdateVertices、バッファとマテリアルは使い回す)、無ければ作る
+    // 形の変わるアニメーションで毎フレーム Create* を呼ぶとバッファを毎回作り直すので、こちらを使う
+    Model* UpdatePrimitive(const std::string& keyName, const Model::ModelData& modelData);
+    // 生成済みの ModelData から keyName のモデルを作る (あればマテリアルを含めて作り直す、StaticBatcher でまとめたモデルなど)
+    Model* CreatePrimitive(const std::string& keyName, const Model::ModelData& modelData);
 
 private:
-    Model* CreatePrimitive(const std::string& keyName, const Model::ModelData& modelData);
+    struct LoadingModel {
+        uint64_t ticket = 0;
+        VertexFormat vertexFormat = VertexFormat::kFloat;
+        std::promise<Model*> promise;
+        std::shared_future<Model*> future;
+        std::vector<std::function<void(Model*)>> onLoaded;
+    };
+
+    // 読み終わったデータから GPU バッファを作り、future と onLoaded に渡す
+    Model* CompleteLoad(const std::string& filePath, LoadingModel& loadingModel, const Model::ModelData& modelData);
+    void LogCacheMetrics(const std::string& filePath, const Model& model);
 
     std::map<std::string, std::unique_ptr<Model>> models_;
     std::unique_ptr<ModelCommon> modelCommon_;
+
+    // 非同期で読み込み中のモデル (ワーカースレッドは最初の LoadModelAsync で作る)
+    std::unique_ptr<AsyncMeshLoader> asyncLoader_;
+    std::map<std::string, LoadingModel> loadingModels_;
+    std::map<uint64_t, std::string> loadingPaths_;
+    std::vector<AsyncMeshLoader::Result> completedLoads_;
+    // 受け取ったがまだ GPU バッファを作っていない結果 (頼んだ順)
+    // onLoaded から LoadModel・WaitForAsyncLoads と呼び直されたときも、入れ子の Update がここから続きを処理する
+    std::map<uint64_t, AsyncMeshLoader::Result> takenLoads_;
+    Model* placeholderModel_ = nullptr;
 };
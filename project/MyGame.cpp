@@ -42,6 +42,9 @@ void MyGame::Initialize() {
 
     modelManager_ = ModelManager::GetInstance();
     modelManager_->Initialize(dxCommon_.get());
+    // モデルはワーカースレッドで読み、その間に他の初期化とテクスチャ・音の読み込みを進める
+    modelManager_->LoadModelAsync("resources/obj/fence/fence.obj");
+    modelManager_->LoadModelAsync("resources/obj/sphere/sphere.obj");
 
     input_ = std::make_unique<Input>();
     input_->Initialize(winApp_.get());
@@ -53,8 +56,6 @@ void MyGame::Initialize() {
     audio_->Initialize();
 
     // 事前ロード
-    modelManager_->LoadModel("resources/obj/fence/fence.obj");
-    modelManager_->LoadModel("resources/obj/sphere/sphere.obj");
     texManager_->LoadTexture("resources/obj/fence/fence.png");
     texManager_->LoadTexture("resources/obj/axis/uvChecker.png");
     texManager_->LoadTexture("resources/postEffect/noise0.png");
@@ -62,6 +63,8 @@ void MyGame::Initialize() {
     dxCommon_->SetDissolveNoiseTextureIndex(
         texManager_->GetTextureIndexByFilePath("resources/postEffect/noise0.png"));
     audio_->LoadAudio("resources/sounds/Alarm01.mp3");
+    // シーンは FindModel で読み込み済みのモデルを受け取るので、ここで読み込みを待つ
+    modelManager_->WaitForAsyncLoads();
 
     SceneManager::GetInstance()->ChangeScene(std::make_unique<TitleScene>());
 }
@@ -91,6 +94,8 @@ void MyGame::Run() {
 void MyGame::Update() {
     imguiManager_->Begin();
     input_->Update();
+    // 非同期で読み終わったモデルの GPU バッファを作る
+    modelManager_->Update();
     SceneManager::GetInstance()->Update();
     imguiManager_->End();
 }
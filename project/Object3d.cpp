@@ -1,10 +1,19 @@
 #include "Object3d.h"
 #include "DirectXCommon.h"
 #include "TextureManager.h"
+#include "TransformBatch.h"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 using namespace MatrixMath;
 
+namespace {
+    // UpdateBatch 用の作業領域 (毎フレームの確保を避けるため使い回す)
+    TransformSoA gBatchTransforms;
+    std::vector<Object3d::TransformationMatrix> gBatchMatrices;
+}
+
 void Object3d::Initialize(Object3dCommon* object3dCommon) {
     assert(object3dCommon);
     object3dCommon_ = object3dCommon;
@@ -20,28 +29,121 @@ void Object3d::Initialize(Object3dCommon* object3dCommon) {
 }
 
 void Object3d::Update() {
-    Matrix4x4 worldMatrix = MakeAffine(transform_.scale, transform_.rotate, transform_.translate);
+    Object3d* self = this;
+    UpdateRange(&self, 1);
+}
+
+void Object3d::UpdateBatch(const std::vector<Object3d*>& objects) {
+    size_t first = 0;
+    while (first < objects.size()) {
+        // 同じカメラを使うオブジェクトの区間をまとめる
+        size_t last = first + 1;
+        while (last < objects.size() && objects[last]->camera_ == objects[first]->camera_) {
+            ++last;
+        }
+        UpdateRange(objects.data() + first, last - first);
+        first = last;
+    }
+}
 
-    // 法線変換用の逆転置行列
-    Matrix4x4 worldInverse = Inverse(worldMatrix);
-    Matrix4x4 worldInverseTranspose = Transpoce(worldInverse);
+void Object3d::UpdateRange(Object3d* const* objects, size_t count) {
+    // objects はすべて同じカメラを参照している前提
+    Camera* camera = objects[0]->camera_;
 
-    if (camera_) {
-        const Matrix4x4& viewProjection = camera_->GetViewProjectionMatrix();
-        transformationMatrixData_->WVP = Multipty(worldMatrix, viewProjection);
+    gBatchTransforms.Resize(count);
+    gBatchMatrices.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        gBatchTransforms.Set(i, objects[i]->transform_);
+    }
 
-        if (directionalLightData_) {
-            directionalLightData_->cameraPosition = camera_->GetTranslate();
+    AffineBatchOutput output;
+    output.worlds = { &gBatchMatrices[0].World, sizeof(TransformationMatrix) };
+    // 法線変換用の逆転置行列 (アフィン行列なので 3x3 余因子で求める)
+    output.worldInverseTransposes = { &gBatchMatrices[0].WorldInverseTranspose, sizeof(TransformationMatrix) };
+    if (camera) {
+        output.wvps = { &gBatchMatrices[0].WVP, sizeof(TransformationMatrix) };
+    }
+    MakeAffineBatch(gBatchTransforms.GetStreams(), camera ? &camera->GetViewProjectionMatrix() : nullptr, nullptr, output);
+
+    for (size_t i = 0; i < count; ++i) {
+        Object3d* object = objects[i];
+        // アップロードバッファは読み戻しが遅いので CPU 側にも World を残す
+        object->worldMatrix_ = gBatchMatrices[i].World;
+        if (camera) {
+            if (object->directionalLightData_) {
+                object->directionalLightData_->cameraPosition = camera->GetTranslate();
+            }
+            if (object->model_) {
+                object->lodIndex_ = object->model_->SelectLod(*camera, object->worldMatrix_, object->lodIndex_, object->lodSettings_);
+            }
+        } else {
+            gBatchMatrices[i].WVP = MakeIdentity4x4();
+            object->lodIndex_ = 0;
         }
-    } else {
-        transformationMatrixData_->WVP = MakeIdentity4x4();
+        // 塊に分けたモデルを元のメッシュで描くときだけ、塊ごとに判定する
+        object->meshletMask_.clear();
+        object->visibleMeshletCount_ = object->model_ ? object->model_->GetMeshletCount() : 0;
+        if (camera && object->model_ && object->isClusterCullingEnabled_ && object->lodIndex_ == 0 && object->model_->GetMeshletCount() > 1) {
+            object->visibleMeshletCount_ = object->model_->CullMeshlets(*camera, object->worldMatrix_, object->meshletMask_, object->clusterCullingSettings_);
+        }
+        // マップ済みのアップロードバッファへは一度にまとめて書き込む
+        std::memcpy(object->transformationMatrixData_, &gBatchMatrices[i], sizeof(TransformationMatrix));
     }
+}
 
-    transformationMatrixData_->World = worldMatrix;
-    transformationMatrixData_->WorldInverseTranspose = worldInverseTranspose;
+bool Object3d::GetWorldAabb(Aabb& aabb) const {
+    if (!model_) {
+        return false;
+    }
+    aabb = Culling::TransformAabb(model_->GetLocalAabb(), worldMatrix_);
+    return true;
+}
+
+bool Object3d::GetWorldSphere(BoundingSphere& sphere) const {
+    if (!model_) {
+        return false;
+    }
+    sphere = Culling::TransformSphere(model_->GetLocalBounds().sphere, worldMatrix_);
+    return true;
+}
+
+bool Object3d::GetWorldObb(Obb& obb) const {
+    if (!model_) {
+        return false;
+    }
+    obb = Culling::TransformObb(model_->GetLocalBounds().obb, worldMatrix_);
+    return true;
+}
+
+bool Object3d::RayCast(const Ray& worldRay, TriangleBvh::Hit& hit) const {
+    if (!model_) {
+        return false;
+    }
+    // 半直線をモデルのローカル座標へ移す (方向は正規化しないので距離の単位は変わらない)
+    const Matrix4x4 inverseWorld = InverseAffine(worldMatrix_);
+    const Vector3& o = worldRay.origin;
+    const Vector3& d = worldRay.direction;
+    const float (*m)[4] = inverseWorld.m;
+    Ray localRay;
+    localRay.origin = {
+        o.x * m[0][0] + o.y * m[1][0] + o.z * m[2][0] + m[3][0],
+        o.x * m[0][1] + o.y * m[1][1] + o.z * m[2][1] + m[3][1],
+        o.x * m[0][2] + o.y * m[1][2] + o.z * m[2][2] + m[3][2]
+    };
+    localRay.direction = {
+        d.x * m[0][0] + d.y * m[1][0] + d.z * m[2][0],
+        d.x * m[0][1] + d.y * m[1][1] + d.z * m[2][1],
+        d.x * m[0][2] + d.y * m[1][2] + d.z * m[2][2]
+    };
+    localRay.maxDistance = worldRay.maxDistance;
+    return model_->GetBvh().RayCast(localRay, hit);
 }
 
 void Object3d::Draw() {
+    if (isCulled_) {
+        return;
+    }
+
     ID3D12GraphicsCommandList* commandList = object3dCommon_->GetDxCommon()->GetCommandList();
 
     commandList->SetGraphicsRootConstantBufferView(1, transformationMatrixResource_->GetGPUVirtualAddress());
@@ -59,7 +161,10 @@ void Object3d::Draw() {
     }
 
     if (model_) {
-        model_->Draw();
+        object3dCommon_->SetVertexFormat(model_->GetVertexFormat());
+        // SetModel で段の少ないモデルに替わった場合に備えて丸める (判定結果も塊の数が合うときだけ使う)
+        const bool hasMeshletMask = !meshletMask_.empty() && meshletMask_.size() == Culling::GetMaskWordCount(model_->GetMeshletCount());
+        model_->Draw((std::min)(lodIndex_, model_->GetLodCount() - 1), hasMeshletMask ? meshletMask_.data() : nullptr);
     }
 }
 
@@ -7,6 +7,7 @@
 #include <d3d12.h>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 class Object3d {
     struct EnvironmentMapData {
@@ -65,6 +66,9 @@ public:
     void Update();
     void Draw();
 
+    // 複数オブジェクトの行列をまとめて計算する (同じカメラが続く区間ごとに一括処理)
+    static void UpdateBatch(const std::vector<Object3d*>& objects);
+
     void SetModel(Model* model) { model_ = model; }
     void SetCamera(Camera* camera) { camera_ = camera; }
     void SetEnvironmentTextureIndex(uint32_t textureIndex) { environmentTextureIndex_ = textureIndex; }
@@ -96,10 +100,32 @@ public:
     void SetRotate(const Vector3& rotate) { transform_.rotate = rotate; }
     void SetTranslate(const Vector3& translate) { transform_.translate = translate; }
     Transform& GetTransform() { return transform_; }
+    const Matrix4x4& GetWorldMatrix() const { return worldMatrix_; }
+
+    // モデルのローカル AABB をワールド座標へ変換したもの (モデル未設定なら false)
+    bool GetWorldAabb(Aabb& aabb) const;
+    // モデルのローカルの球・有向ボックスをワールド座標へ変換したもの (モデル未設定なら false)
+    bool GetWorldSphere(BoundingSphere& sphere) const;
+    bool GetWorldObb(Obb& obb) const;
+    // ワールド座標の半直線とモデルの三角形の交差判定 (hit.distance はワールドの ray と同じ単位)
+    bool RayCast(const Ray& worldRay, TriangleBvh::Hit& hit) const;
+    // true の間は Draw を行わない (視錐台カリングの結果を設定する)
+    void SetCulled(bool isCulled) { isCulled_ = isCulled; }
+    bool IsCulled() const { return isCulled_; }
+    // 詳細度の段は Update でカメラからの見え方に合わせて選び直す
+    void SetLodSettings(const LodSelection::Settings& settings) { lodSettings_ = settings; }
+    uint32_t GetLodIndex() const { return lodIndex_; }
+    // 有効にすると、元のメッシュを描くときに Update でカメラから見えない塊 (メッシュレット) を除いて描く
+    void SetClusterCullingEnabled(bool isEnabled) { isClusterCullingEnabled_ = isEnabled; }
+    void SetClusterCullingSettings(const ClusterCulling::Settings& settings) { clusterCullingSettings_ = settings; }
+    // 前の Update で見えると判定した塊の数 (塊ごとの判定をしていなければ全ての塊の数)
+    size_t GetVisibleMeshletCount() const { return visibleMeshletCount_; }
 
     DirectionalLight* GetDirectionalLightData() { return directionalLightData_; }
 
 private:
+    static void UpdateRange(Object3d* const* objects, size_t count);
+
     void CreateTransformationMatrixResource();
     void CreateDirectionalLightResource();
     void CreateEnvironmentMapResource();
@@ -113,6 +139,15 @@ private:
     Camera* camera_ = nullptr;
 
     Transform transform_{ {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f} };
+    Matrix4x4 worldMatrix_ = MatrixMath::MakeIdentity4x4();
+    bool isCulled_ = false;
+    LodSelection::Settings lodSettings_;
+    uint32_t lodIndex_ = 0;
+    bool isClusterCullingEnabled_ = false;
+    ClusterCulling::Settings clusterCullingSettings_;
+    // 塊ごとの判定結果 (空なら全て描く)
+    std::vector<uint64_t> meshletMask_;
+    size_t visibleMeshletCount_ = 0;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource_;
     TransformationMatrix* transformationMatrixData_ = nullptr;
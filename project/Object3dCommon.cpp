@@ -131,11 +131,12 @@ void Object3dCommon::CreateGraphicsPipelineStates()
     // RootSignature生成
     CreateRootSignature();
 
-    // シェーダーコンパイル
+    // シェーダーコンパイル (量子化した頂点は法線の復元が要るので別の頂点シェーダー)
     auto vertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Object3d.VS.hlsl", L"vs_6_0");
+    auto packedVertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Object3dPacked.VS.hlsl", L"vs_6_0");
     auto pixelShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Object3d.PS.hlsl", L"ps_6_0");
 
-    // InputLayout
+    // InputLayout (VertexFormat ごと)
     D3D12_INPUT_ELEMENT_DESC inputElementDescs[3]{};
     inputElementDescs[0].SemanticName = "POSITION";
     inputElementDescs[0].SemanticIndex = 0;
@@ -152,9 +153,20 @@ void Object3dCommon::CreateGraphicsPipelineStates()
     inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
     inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 
-    D3D12_INPUT_LAYOUT_DESC inputLayoutDesc{};
-    inputLayoutDesc.pInputElementDescs = inputElementDescs;
-    inputLayoutDesc.NumElements = _countof(inputElementDescs);
+    // float3 / half4 の位置 (w は 1)、八面体符号化の法線、half2 の UV (VertexQuantization の並び)
+    D3D12_INPUT_ELEMENT_DESC packedFloatElementDescs[3]{};
+    packedFloatElementDescs[0] = { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+    packedFloatElementDescs[1] = { "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+    packedFloatElementDescs[2] = { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+    D3D12_INPUT_ELEMENT_DESC packedHalfElementDescs[3]{};
+    packedHalfElementDescs[0] = { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+    packedHalfElementDescs[1] = packedFloatElementDescs[1];
+    packedHalfElementDescs[2] = packedFloatElementDescs[2];
+
+    D3D12_INPUT_LAYOUT_DESC inputLayoutDescs[(size_t)VertexFormat::kCountOf]{};
+    inputLayoutDescs[(size_t)VertexFormat::kFloat] = { inputElementDescs, _countof(inputElementDescs) };
+    inputLayoutDescs[(size_t)VertexFormat::kPackedFloat] = { packedFloatElementDescs, _countof(packedFloatElementDescs) };
+    inputLayoutDescs[(size_t)VertexFormat::kPackedHalf] = { packedHalfElementDescs, _countof(packedHalfElementDescs) };
 
     // Rasterizer (★ここを NONE にしないと、裏面や板ポリが消えることがあります)
     D3D12_RASTERIZER_DESC rasterizerDesc{};
@@ -170,8 +182,6 @@ void Object3dCommon::CreateGraphicsPipelineStates()
     // PSO ベース設定
     D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDesc{};
     graphicsPipelineStateDesc.pRootSignature = rootSignature_.Get();
-    graphicsPipelineStateDesc.InputLayout = inputLayoutDesc;
-    graphicsPipelineStateDesc.VS = { vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize() };
     graphicsPipelineStateDesc.PS = { pixelShaderBlob->GetBufferPointer(), pixelShaderBlob->GetBufferSize() };
     graphicsPipelineStateDesc.RasterizerState = rasterizerDesc;
     graphicsPipelineStateDesc.DepthStencilState = depthStencilDesc;
@@ -183,18 +193,23 @@ void Object3dCommon::CreateGraphicsPipelineStates()
     graphicsPipelineStateDesc.SampleDesc.Count = 1;
     graphicsPipelineStateDesc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
 
-    // --- 各ブレンドモードの生成 ---
-    graphicsPipelineStates_.resize((size_t)BlendMode::kCountOf);
+    // --- 各ブレンドモード × 頂点の並びの生成 ---
+    graphicsPipelineStates_.resize((size_t)BlendMode::kCountOf * (size_t)VertexFormat::kCountOf);
 
     // Helper lambda
     auto CreatePSO = [&](BlendMode mode, const D3D12_BLEND_DESC& blendDesc) {
         graphicsPipelineStateDesc.BlendState = blendDesc;
         graphicsPipelineStateDesc.BlendState.RenderTarget[1].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
         graphicsPipelineStateDesc.BlendState.RenderTarget[1].BlendEnable = FALSE;
-        hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
-            &graphicsPipelineStateDesc,
-            IID_PPV_ARGS(&graphicsPipelineStates_[(size_t)mode]));
-        assert(SUCCEEDED(hr));
+        for (size_t format = 0; format < (size_t)VertexFormat::kCountOf; ++format) {
+            const auto& shaderBlob = (format == (size_t)VertexFormat::kFloat) ? vertexShaderBlob : packedVertexShaderBlob;
+            graphicsPipelineStateDesc.InputLayout = inputLayoutDescs[format];
+            graphicsPipelineStateDesc.VS = { shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize() };
+            hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
+                &graphicsPipelineStateDesc,
+                IID_PPV_ARGS(&graphicsPipelineStates_[GetPipelineIndex(mode, (VertexFormat)format)]));
+            assert(SUCCEEDED(hr));
+        }
         };
 
     // kNormal
@@ -275,8 +290,20 @@ void Object3dCommon::CommonDrawSetting(BlendMode blendMode)
 {
     // ルートシグネチャをセット
     dxCommon_->GetCommandList()->SetGraphicsRootSignature(rootSignature_.Get());
-    // 指定されたブレンドモードのPSOをセット
-    dxCommon_->GetCommandList()->SetPipelineState(graphicsPipelineStates_[(size_t)blendMode].Get());
+    // 指定されたブレンドモードのPSOをセット (頂点の並びは float から始める)
+    blendMode_ = blendMode;
+    vertexFormat_ = VertexFormat::kFloat;
+    dxCommon_->GetCommandList()->SetPipelineState(graphicsPipelineStates_[GetPipelineIndex(blendMode_, vertexFormat_)].Get());
     // プリミティブトポロジーをセット
     dxCommon_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
+
+void Object3dCommon::SetVertexFormat(VertexFormat vertexFormat)
+{
+    // 続くモデルが同じ並びなら PSO を積み直さない
+    if (vertexFormat == vertexFormat_) {
+        return;
+    }
+    vertexFormat_ = vertexFormat;
+    dxCommon_->GetCommandList()->SetPipelineState(graphicsPipelineStates_[GetPipelineIndex(blendMode_, vertexFormat_)].Get());
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "DirectXCommon.h"
+#include "VertexQuantization.h"
 #include <wrl.h>
 #include <vector>
 
@@ -24,6 +25,8 @@ public:
     // 共通描画設定
     // blendModeを指定できるように変更
     void CommonDrawSetting(BlendMode blendMode = BlendMode::kNormal);
+    // モデルの頂点の並びに合わせて PSO を切り替える (ブレンドモードは CommonDrawSetting のまま)
+    void SetVertexFormat(VertexFormat vertexFormat);
 
     // ゲッター
     DirectXCommon* GetDxCommon() const { return dxCommon_; }
@@ -33,11 +36,17 @@ private:
     void CreateRootSignature();
     // グラフィックスパイプラインの生成
     void CreateGraphicsPipelineStates();
+    static size_t GetPipelineIndex(BlendMode blendMode, VertexFormat vertexFormat) {
+        return (size_t)vertexFormat * (size_t)BlendMode::kCountOf + (size_t)blendMode;
+    }
 
 private:
     DirectXCommon* dxCommon_ = nullptr;
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
-    // ブレンドモードごとのPSOを配列で持つ
+    // ブレンドモード × 頂点の並びごとのPSOを配列で持つ
     std::vector<Microsoft::WRL::ComPtr<ID3D12PipelineState>> graphicsPipelineStates_;
+    // 今積んでいる PSO
+    BlendMode blendMode_ = BlendMode::kNormal;
+    VertexFormat vertexFormat_ = VertexFormat::kFloat;
 };
\ No newline at end of file
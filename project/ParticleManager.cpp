@@ -1,6 +1,5 @@
 #include "ParticleManager.h"
 #include "TextureManager.h"
-#include <random>
 #include <cassert>
 #include <vector>
 #include <string>
@@ -40,7 +39,8 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
 }
 
 void ParticleManager::Finalize() {
-    particles_.clear();
+    simulation_.Clear();
+    numInstance_ = 0;
 }
 
 void ParticleManager::SetTexture(const std::string& texturePath) {
@@ -59,40 +59,11 @@ void ParticleManager::Update(Camera* camera) {
     billboardMatrix.m[3][1] = 0.0f;
     billboardMatrix.m[3][2] = 0.0f;
 
-    uint32_t numInstance = 0;
-    for (auto it = particles_.begin(); it != particles_.end();) {
-        it->currentTime += 1.0f / 60.0f;
-        if (it->currentTime >= it->lifeTime) {
-            it = particles_.erase(it);
-            continue;
-        }
-
-        it->transform.translate.x += it->velocity.x;
-        it->transform.translate.y += it->velocity.y;
-        it->transform.translate.z += it->velocity.z;
-
-        float alpha = 1.0f - (it->currentTime / it->lifeTime);
-        it->color.w = alpha;
-
-        if (numInstance < kMaxInstance) {
-            Matrix4x4 scaleMat = MakeScale(it->transform.scale);
-            Matrix4x4 rotateMat = MakeRotateZ(it->transform.rotate.z);
-            Matrix4x4 transMat = MakeTranslate(it->transform.translate);
-            Matrix4x4 worldMat = Multipty(Multipty(Multipty(scaleMat, rotateMat), billboardMatrix), transMat);
-
-            instancingData_[numInstance].World = worldMat;
-            instancingData_[numInstance].WVP = Multipty(worldMat, viewProj);
-            instancingData_[numInstance].color = it->color;
-            numInstance++;
-        }
-        ++it;
-    }
+    numInstance_ = simulation_.Update(1.0f / 60.0f, viewProj, billboardMatrix, instancingData_, kMaxInstance);
 }
 
 void ParticleManager::Draw() {
-    uint32_t numInstance = static_cast<uint32_t>(particles_.size());
-    if (numInstance == 0) return;
-    if (numInstance > kMaxInstance) numInstance = kMaxInstance;
+    if (numInstance_ == 0) return;
 
     ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
     commandList->SetGraphicsRootSignature(rootSignature_.Get());
@@ -105,7 +76,7 @@ void ParticleManager::Draw() {
     uint32_t texIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureName_);
     commandList->SetGraphicsRootDescriptorTable(1, TextureManager::GetInstance()->GetSrvHandleGPU(texIndex));
 
-    commandList->DrawInstanced(4, numInstance, 0, 0);
+    commandList->DrawInstanced(4, numInstance_, 0, 0);
 }
 
 void ParticleManager::Emit(const std::string& name, const Vector3& pos, uint32_t count) {
@@ -114,157 +85,7 @@ void ParticleManager::Emit(const std::string& name, const Vector3& pos, uint32_t
         SetTexture(name);
     }
 
-    std::random_device rd;
-    std::mt19937 gen(rd()); // C++標準の正しい乱数エンジン
-    auto RandomRange = [&gen](float minValue, float maxValue) {
-        if (minValue > maxValue) {
-            std::swap(minValue, maxValue);
-        }
-        std::uniform_real_distribution<float> dist(minValue, maxValue);
-        return dist(gen);
-        };
-    auto Normalize = [](const Vector3& value) {
-        float lengthSq = value.x * value.x + value.y * value.y + value.z * value.z;
-        if (lengthSq <= 0.0001f) {
-            return Vector3{ 0.0f, 0.0f, 1.0f };
-        }
-        float invLength = 1.0f / std::sqrt(lengthSq);
-        return Vector3{ value.x * invLength, value.y * invLength, value.z * invLength };
-        };
-    auto RandomUnitDirection = [&]() {
-        return Normalize({
-            RandomRange(-1.0f, 1.0f),
-            RandomRange(-1.0f, 1.0f),
-            RandomRange(-1.0f, 1.0f)
-            });
-        };
-    auto RandomColor = [&](const EffectParams& params) {
-        return Vector4{
-            RandomRange(params.colorRRange.x, params.colorRRange.y),
-            RandomRange(params.colorGRange.x, params.colorGRange.y),
-            RandomRange(params.colorBRange.x, params.colorBRange.y),
-            1.0f
-        };
-        };
-    auto PushParticle = [&](const EffectParams& params, const Vector3& spawnPos, const Vector3& velocity, float scaleX, float scaleY, float rotateZ, const Vector4& color) {
-        Particle particle;
-        particle.transform = {
-            { scaleX, scaleY, 1.0f },
-            { 0.0f, 0.0f, rotateZ },
-            spawnPos
-        };
-        particle.velocity = velocity;
-        particle.color = color;
-        particle.lifeTime = RandomRange(params.lifeTimeRange.x, params.lifeTimeRange.y);
-        particle.currentTime = 0.0f;
-        particles_.push_back(particle);
-        };
-
-    if (name == "Hit") {
-        uint32_t emitCount = count > 0 ? count : hitEffectParams_.spawnCount;
-        for (uint32_t i = 0; i < emitCount; ++i) {
-            // Plane billboard particles are stretched into short-lived streaks
-            // and emitted radially to form the assignment-style hit effect.
-            Vector3 direction = RandomUnitDirection();
-            float speed = RandomRange(hitEffectParams_.speedRange.x, hitEffectParams_.speedRange.y);
-            PushParticle(
-                hitEffectParams_,
-                pos,
-                { direction.x * speed, direction.y * speed, direction.z * speed },
-                RandomRange(hitEffectParams_.scaleXRange.x, hitEffectParams_.scaleXRange.y),
-                RandomRange(hitEffectParams_.scaleYRange.x, hitEffectParams_.scaleYRange.y),
-                RandomRange(hitEffectParams_.rotateZRange.x, hitEffectParams_.rotateZRange.y),
-                RandomColor(hitEffectParams_));
-        }
-        return;
-    }
-
-    if (name == "Fireball") {
-        uint32_t emitCount = count > 0 ? count : fireballEffectParams_.spawnCount;
-        for (uint32_t i = 0; i < emitCount; ++i) {
-            bool isCore = i < (emitCount * 2 / 3);
-            Vector3 offset = {
-                RandomRange(-0.12f, 0.12f),
-                RandomRange(-0.12f, 0.12f),
-                RandomRange(-0.08f, 0.08f)
-            };
-            Vector3 direction = Normalize({
-                RandomRange(-0.28f, 0.28f),
-                RandomRange(-0.18f, 0.28f),
-                1.0f + RandomRange(0.0f, 0.35f)
-                });
-            float speed = RandomRange(fireballEffectParams_.speedRange.x, fireballEffectParams_.speedRange.y);
-            if (isCore) {
-                speed *= 0.45f;
-                offset.x *= 0.35f;
-                offset.y *= 0.35f;
-                offset.z *= 0.35f;
-            }
-
-            Vector4 color = RandomColor(fireballEffectParams_);
-            if (isCore) {
-                color.x = 1.0f;
-                color.y = (std::min)(1.0f, color.y + 0.2f);
-            }
-
-            float scaleX = RandomRange(fireballEffectParams_.scaleXRange.x, fireballEffectParams_.scaleXRange.y);
-            float scaleY = RandomRange(fireballEffectParams_.scaleYRange.x, fireballEffectParams_.scaleYRange.y);
-            if (!isCore) {
-                scaleX *= 0.55f;
-                scaleY *= 0.75f;
-            }
-
-            PushParticle(
-                fireballEffectParams_,
-                { pos.x + offset.x, pos.y + offset.y, pos.z + offset.z },
-                { direction.x * speed, direction.y * speed, direction.z * speed },
-                scaleX,
-                scaleY,
-                RandomRange(fireballEffectParams_.rotateZRange.x, fireballEffectParams_.rotateZRange.y),
-                color);
-        }
-        return;
-    }
-
-    if (name == "Wind") {
-        uint32_t emitCount = count > 0 ? count : windEffectParams_.spawnCount;
-        for (uint32_t i = 0; i < emitCount; ++i) {
-            Vector3 spawnPos = {
-                pos.x + RandomRange(-0.25f, 0.25f),
-                pos.y + RandomRange(-0.35f, 0.35f),
-                pos.z + RandomRange(-0.25f, 0.25f)
-            };
-            Vector3 direction = Normalize({
-                1.0f,
-                RandomRange(-0.15f, 0.15f),
-                RandomRange(-0.10f, 0.10f)
-                });
-            float speed = RandomRange(windEffectParams_.speedRange.x, windEffectParams_.speedRange.y);
-            PushParticle(
-                windEffectParams_,
-                spawnPos,
-                { direction.x * speed, direction.y * speed, direction.z * speed },
-                RandomRange(windEffectParams_.scaleXRange.x, windEffectParams_.scaleXRange.y),
-                RandomRange(windEffectParams_.scaleYRange.x, windEffectParams_.scaleYRange.y),
-                RandomRange(windEffectParams_.rotateZRange.x, windEffectParams_.rotateZRange.y),
-                RandomColor(windEffectParams_));
-        }
-        return;
-    }
-
-    std::uniform_real_distribution<float> distVelocity(-0.05f, 0.05f);
-    std::uniform_real_distribution<float> distColor(0.0f, 1.0f);
-    std::uniform_real_distribution<float> distTime(1.0f, 3.0f);
-
-    for (uint32_t i = 0; i < count; ++i) {
-        Particle particle;
-        particle.transform = { {1.0f, 1.0f, 1.0f}, {0,0,0}, pos };
-        particle.velocity = { distVelocity(gen), distVelocity(gen), distVelocity(gen) };
-        particle.color = { distColor(gen), distColor(gen), distColor(gen), 1.0f };
-        particle.lifeTime = distTime(gen);
-        particle.currentTime = 0.0f;
-        particles_.push_back(particle);
-    }
+    simulation_.Emit(name, pos, count);
 }
 
 void ParticleManager::CreateRootSignature() {
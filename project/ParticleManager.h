@@ -3,8 +3,9 @@
 #include "SrvManager.h"
 #include "Camera.h"
 #include "Matrix4x4.h"
+#include "ModelData.h"
+#include "ParticleSimulation.h"
 #include <wrl.h>
-#include <list>
 #include <string>
 #include <memory>
 
@@ -12,31 +13,10 @@ class ParticleManager {
     friend struct std::default_delete<ParticleManager>;
 
 public:
-    struct Particle {
-        Transform transform;
-        Vector3 velocity;
-        Vector4 color;
-        float lifeTime;
-        float currentTime;
-    };
-
-    struct EffectParams {
-        Vector2 scaleXRange{ 0.08f, 0.18f };
-        Vector2 scaleYRange{ 0.6f, 1.4f };
-        Vector2 rotateZRange{ 0.0f, 6.2831853f };
-        Vector2 lifeTimeRange{ 0.2f, 0.5f };
-        Vector2 speedRange{ 0.08f, 0.2f };
-        Vector2 colorRRange{ 1.0f, 1.0f };
-        Vector2 colorGRange{ 0.55f, 1.0f };
-        Vector2 colorBRange{ 0.15f, 0.35f };
-        uint32_t spawnCount = 24;
-    };
-
-    struct ParticleForGPU {
-        Matrix4x4 WVP;
-        Matrix4x4 World;
-        Vector4 color;
-    };
+    // 粒子の発生と移動は ParticleSimulation が行う
+    using Particle = ParticleSimulation::Particle;
+    using EffectParams = ParticleSimulation::EffectParams;
+    using ParticleForGPU = ParticleSimulation::ParticleForGPU;
 
 public:
     static ParticleManager* GetInstance();
@@ -47,9 +27,9 @@ public:
     void Finalize();
 
     void Emit(const std::string& name, const Vector3& pos, uint32_t count);
-    EffectParams& GetHitEffectParams() { return hitEffectParams_; }
-    EffectParams& GetFireballEffectParams() { return fireballEffectParams_; }
-    EffectParams& GetWindEffectParams() { return windEffectParams_; }
+    EffectParams& GetHitEffectParams() { return simulation_.GetHitEffectParams(); }
+    EffectParams& GetFireballEffectParams() { return simulation_.GetFireballEffectParams(); }
+    EffectParams& GetWindEffectParams() { return simulation_.GetWindEffectParams(); }
     void SetTexture(const std::string& texturePath);
     const std::string& GetTexture() const { return textureName_; }
 
@@ -68,16 +48,15 @@ private:
     DirectXCommon* dxCommon_ = nullptr;
     SrvManager* srvManager_ = nullptr;
 
-    std::list<Particle> particles_;
+    ParticleSimulation simulation_;
+    // 直近の Update で書き込んだ粒子の数
+    uint32_t numInstance_ = 0;
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState_;
 
-    struct VertexData {
-        Vector4 position;
-        Vector2 texcoord;
-        Vector3 normal;
-    };
+    // 頂点の並びは Model と同じ
+    using VertexData = ::ModelData::VertexData;
     Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_;
     D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
 
@@ -87,7 +66,4 @@ private:
     uint32_t srvIndex_ = 0;
     std::string textureName_;
     const uint32_t kMaxInstance = 100;
-    EffectParams hitEffectParams_{ {0.03f, 0.06f}, {1.5f, 2.8f}, {0.0f, 6.2831853f}, {0.08f, 0.14f}, {0.18f, 0.30f}, {1.0f, 1.0f}, {0.78f, 1.0f}, {0.12f, 0.25f}, 16 };
-    EffectParams fireballEffectParams_{ {0.14f, 0.28f}, {0.18f, 0.36f}, {0.0f, 6.2831853f}, {0.22f, 0.40f}, {0.06f, 0.14f}, {0.95f, 1.0f}, {0.35f, 0.65f}, {0.05f, 0.16f}, 16 };
-    EffectParams windEffectParams_{ {0.03f, 0.07f}, {0.7f, 1.5f}, {-0.2f, 0.2f}, {0.35f, 0.70f}, {0.12f, 0.24f}, {0.85f, 1.0f}, {0.90f, 1.0f}, {0.95f, 1.0f}, 20 };
 };
@@ -2,6 +2,7 @@
 #include "SpriteCommon.h"
 #include "Matrix4x4.h"
 #include "TextureManager.h"
+#include "TransformBatch.h"
 #include <cassert>
 
 using namespace MatrixMath;
@@ -73,15 +74,13 @@ void Sprite::Update() {
     transform_.rotate = { 0.0f, 0.0f, rotation_ };
     transform_.scale = { size_.x, size_.y, 1.0f };
 
-    Matrix4x4 world = MakeAffine(transform_.scale, transform_.rotate, transform_.translate);
     // スプライトは2D描画なので、基本的には正射影行列等を掛けるか、シェーダー内で調整します。
-    // （カメラを使わない場合、ViewProjは単位行列でOK）
-    Matrix4x4 vp = MakeIdentity4x4();
-    Matrix4x4 wvp = Multipty(world, vp);
-
+    // （カメラを使わない場合、ViewProjは単位行列でOK なので WVP は World と同じ）
     if (transformationMatrixData_) {
-        transformationMatrixData_->World = world;
-        transformationMatrixData_->WVP = wvp;
+        AffineBatchOutput output;
+        output.worlds = { &transformationMatrixData_->World };
+        output.wvps = { &transformationMatrixData_->WVP };
+        MakeAffineBatch(MakeTransformStreams(transform_), nullptr, nullptr, output);
     }
 
     if (vertexData_) {
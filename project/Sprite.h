@@ -1,5 +1,6 @@
 #pragma once
 #include "Matrix4x4.h"
+#include "ModelData.h"
 #include <Windows.h>
 #include "SpriteCommon.h"
 
@@ -51,11 +52,8 @@ private:
     // 共通部へのポインタ
     SpriteCommon* spriteCommon_ = nullptr;
 
-    struct VertexData {
-        Vector4 position;
-        Vector2 texcoord;
-        Vector3 normal;
-    };
+    // 頂点の並びは Model と同じ
+    using VertexData = ::ModelData::VertexData;
     // テクスチャの切り出し左上座標（ピクセル単位）
     Vector2 textureLeftTop_ = { 0.0f, 0.0f };
     // テクスチャの切り出しサイズ（ピクセル単位）
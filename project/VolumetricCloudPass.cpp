@@ -15,41 +15,6 @@ namespace {
     {
         return (size + 0xff) & ~static_cast<size_t>(0xff);
     }
-
-    struct FrustumPlane {
-        Vector4 coefficients;
-    };
-
-    float EvaluatePlane(const FrustumPlane& plane, const Vector3& point)
-    {
-        return
-            plane.coefficients.x * point.x +
-            plane.coefficients.y * point.y +
-            plane.coefficients.z * point.z +
-            plane.coefficients.w;
-    }
-
-    FrustumPlane NormalizePlane(const Vector4& coefficients)
-    {
-        const float lengthSquared =
-            coefficients.x * coefficients.x +
-            coefficients.y * coefficients.y +
-            coefficients.z * coefficients.z;
-
-        if (lengthSquared <= 0.000001f) {
-            return { coefficients };
-        }
-
-        const float inverseLength = 1.0f / std::sqrt(lengthSquared);
-        return {
-            {
-                coefficients.x * inverseLength,
-                coefficients.y * inverseLength,
-                coefficients.z * inverseLength,
-                coefficients.w * inverseLength
-            }
-        };
-    }
 }
 
 void VolumetricCloudPass::Initialize(DirectXCommon* dxCommon)
@@ -64,146 +29,21 @@ void VolumetricCloudPass::Initialize(DirectXCommon* dxCommon)
 
 VolumetricCloudPass::ProjectedBounds VolumetricCloudPass::BuildProjectedBounds(const Camera* camera, const CloudVolume* cloudVolume) const
 {
-    ProjectedBounds result{};
-    result.scissorRect = MakeFullScreenScissor();
-    result.scissorAreaRatio = 0.0f;
-
     if (!camera || !cloudVolume) {
+        ProjectedBounds result{};
+        result.scissorRect = CloudProjection::MakeFullScreenScissor(WinApp::kClientWidth, WinApp::kClientHeight);
+        result.scissorAreaRatio = 0.0f;
         return result;
     }
 
-    const CloudVolume::Parameters& parameters = cloudVolume->GetParameters();
-    const bool disableDistanceLod = (forceMode_ == ForceMode::ForceMaxQuality);
-    const float lodFactorScale = (forceMode_ == ForceMode::ForceAggressiveLod) ? 1.75f : 1.0f;
-    const float entryDistance = ComputeDistanceToAabb(camera->GetTranslate(), cloudVolume);
-    float densityScale = 1.0f;
-    ComputeDistanceLodScales(entryDistance, cloudVolume, lodFactorScale, disableDistanceLod, result.currentViewStepScale, densityScale);
-    result.currentLightStepScale = result.currentViewStepScale;
-    result.estimatedViewSteps = (std::max)(1u, static_cast<uint32_t>(static_cast<float>((std::max)(parameters.viewStepCount, 1u)) * result.currentViewStepScale + 0.5f));
-    result.estimatedLightSteps = (std::max)(1u, static_cast<uint32_t>(static_cast<float>((std::max)(parameters.lightStepCount, 1u)) * result.currentLightStepScale + 0.5f));
-
-    result.isCameraInsideCloud = cloudVolume->ContainsPoint(camera->GetTranslate());
-    if (result.isCameraInsideCloud) {
-        result.isVisible = true;
-        result.useFullScreenScissor = true;
-        result.isFullScreenFallback = true;
-        result.scissorAreaRatio = 1.0f;
-        result.isPassSkipped = !isEnabled_ || forceMode_ == ForceMode::ForceSkip;
-        return result;
-    }
-
-    const std::array<Vector3, 8> corners = cloudVolume->GetCorners();
-    const Matrix4x4& viewProjection = camera->GetViewProjectionMatrix();
-
-    const FrustumPlane planes[6] = {
-        // Row-vector convention uses the matrix columns for frustum plane extraction.
-        NormalizePlane({ viewProjection.m[0][3] + viewProjection.m[0][0], viewProjection.m[1][3] + viewProjection.m[1][0], viewProjection.m[2][3] + viewProjection.m[2][0], viewProjection.m[3][3] + viewProjection.m[3][0] }),
-        NormalizePlane({ viewProjection.m[0][3] - viewProjection.m[0][0], viewProjection.m[1][3] - viewProjection.m[1][0], viewProjection.m[2][3] - viewProjection.m[2][0], viewProjection.m[3][3] - viewProjection.m[3][0] }),
-        NormalizePlane({ viewProjection.m[0][3] + viewProjection.m[0][1], viewProjection.m[1][3] + viewProjection.m[1][1], viewProjection.m[2][3] + viewProjection.m[2][1], viewProjection.m[3][3] + viewProjection.m[3][1] }),
-        NormalizePlane({ viewProjection.m[0][3] - viewProjection.m[0][1], viewProjection.m[1][3] - viewProjection.m[1][1], viewProjection.m[2][3] - viewProjection.m[2][1], viewProjection.m[3][3] - viewProjection.m[3][1] }),
-        NormalizePlane({ viewProjection.m[0][2], viewProjection.m[1][2], viewProjection.m[2][2], viewProjection.m[3][2] }),
-        NormalizePlane({ viewProjection.m[0][3] - viewProjection.m[0][2], viewProjection.m[1][3] - viewProjection.m[1][2], viewProjection.m[2][3] - viewProjection.m[2][2], viewProjection.m[3][3] - viewProjection.m[3][2] }),
-    };
-
-    for (const FrustumPlane& plane : planes) {
-        bool isOutside = true;
-        for (const Vector3& corner : corners) {
-            if (EvaluatePlane(plane, corner) >= 0.0f) {
-                isOutside = false;
-                break;
-            }
-        }
-
-        if (isOutside) {
-            return result;
-        }
-    }
-
-    result.isVisible = true;
-
-    std::array<Vector4, 8> clipCorners{};
-    for (size_t i = 0; i < corners.size(); ++i) {
-        clipCorners[i] = TransformPoint(corners[i], viewProjection);
-
-        // TODO: If we later add edge clipping against the frustum, this fallback can become tighter.
-        // For now, any vertex behind the near plane uses full-screen scissor to avoid underestimating the rect.
-        if (clipCorners[i].w <= 0.0001f || clipCorners[i].z < 0.0f) {
-            result.isNearPlaneCrossing = true;
-        }
-    }
-
-    if (result.isNearPlaneCrossing) {
-        result.useFullScreenScissor = true;
-        result.isFullScreenFallback = true;
-        result.scissorAreaRatio = 1.0f;
-        result.isPassSkipped = !isEnabled_ || forceMode_ == ForceMode::ForceSkip;
-        return result;
-    }
-
-    float minNdcX = 1.0f;
-    float maxNdcX = -1.0f;
-    float minNdcY = 1.0f;
-    float maxNdcY = -1.0f;
-
-    for (const Vector4& clipCorner : clipCorners) {
-        const float inverseW = 1.0f / clipCorner.w;
-        const float ndcX = clipCorner.x * inverseW;
-        const float ndcY = clipCorner.y * inverseW;
-
-        minNdcX = (std::min)(minNdcX, ndcX);
-        maxNdcX = (std::max)(maxNdcX, ndcX);
-        minNdcY = (std::min)(minNdcY, ndcY);
-        maxNdcY = (std::max)(maxNdcY, ndcY);
-    }
-
-    minNdcX = std::clamp(minNdcX, -1.0f, 1.0f);
-    maxNdcX = std::clamp(maxNdcX, -1.0f, 1.0f);
-    minNdcY = std::clamp(minNdcY, -1.0f, 1.0f);
-    maxNdcY = std::clamp(maxNdcY, -1.0f, 1.0f);
-
-    const float width = static_cast<float>(WinApp::kClientWidth);
-    const float height = static_cast<float>(WinApp::kClientHeight);
-
-    const LONG left = static_cast<LONG>(std::floor((minNdcX * 0.5f + 0.5f) * width));
-    const LONG right = static_cast<LONG>(std::ceil((maxNdcX * 0.5f + 0.5f) * width));
-    const LONG top = static_cast<LONG>(std::floor((1.0f - (maxNdcY * 0.5f + 0.5f)) * height));
-    const LONG bottom = static_cast<LONG>(std::ceil((1.0f - (minNdcY * 0.5f + 0.5f)) * height));
-
-    result.scissorRect.left = std::clamp<LONG>(left, 0, WinApp::kClientWidth);
-    result.scissorRect.right = std::clamp<LONG>(right, 0, WinApp::kClientWidth);
-    result.scissorRect.top = std::clamp<LONG>(top, 0, WinApp::kClientHeight);
-    result.scissorRect.bottom = std::clamp<LONG>(bottom, 0, WinApp::kClientHeight);
-
-    if (result.scissorRect.right <= result.scissorRect.left || result.scissorRect.bottom <= result.scissorRect.top) {
-        result.isVisible = false;
-        result.scissorRect = MakeFullScreenScissor();
-        result.isPassSkipped = true;
-        return result;
-    }
-
-    const float screenArea = static_cast<float>(WinApp::kClientWidth * WinApp::kClientHeight);
-    const float scissorWidth = static_cast<float>(result.scissorRect.right - result.scissorRect.left);
-    const float scissorHeight = static_cast<float>(result.scissorRect.bottom - result.scissorRect.top);
-    result.scissorAreaRatio = (screenArea > 0.0f) ? ((scissorWidth * scissorHeight) / screenArea) : 1.0f;
-
-    result.useFullScreenScissor =
-        result.scissorRect.left == 0 &&
-        result.scissorRect.top == 0 &&
-        result.scissorRect.right == WinApp::kClientWidth &&
-        result.scissorRect.bottom == WinApp::kClientHeight;
-
-    if (forceMode_ == ForceMode::ForceFullscreen) {
-        result.useFullScreenScissor = true;
-        result.scissorRect = MakeFullScreenScissor();
-        result.scissorAreaRatio = 1.0f;
-    } else if (forceMode_ == ForceMode::ForceScissor) {
-        // TODO: For camera-inside / near-plane-crossing cases we intentionally keep the safe fullscreen fallback.
-        result.useFullScreenScissor = false;
-    }
-
-    result.isPassSkipped = !isEnabled_ || forceMode_ == ForceMode::ForceSkip;
+    CloudProjection::Settings settings;
+    settings.screenWidth = WinApp::kClientWidth;
+    settings.screenHeight = WinApp::kClientHeight;
+    settings.forceMode = forceMode_;
+    settings.isEnabled = isEnabled_;
 
-    return result;
+    // The frustum is extracted once per Camera::Update.
+    return CloudProjection::BuildProjectedBounds(*cloudVolume, camera->GetTranslate(), camera->GetViewProjectionMatrix(), camera->GetFrustum(), settings);
 }
 
 void VolumetricCloudPass::Render(const Camera* camera, const CloudVolume* cloudVolume, const ProjectedBounds& projectedBounds)
@@ -229,7 +69,12 @@ void VolumetricCloudPass::Render(const Camera* camera, const CloudVolume* cloudV
     const D3D12_RECT scissorRect =
         projectedBounds.useFullScreenScissor ?
         MakeFullScreenScissor() :
-        projectedBounds.scissorRect;
+        D3D12_RECT{
+            projectedBounds.scissorRect.left,
+            projectedBounds.scissorRect.top,
+            projectedBounds.scissorRect.right,
+            projectedBounds.scissorRect.bottom
+        };
     commandList->RSSetScissorRects(1, &scissorRect);
 
     ID3D12DescriptorHeap* descriptorHeaps[] = { dxCommon_->GetSrvDescriptorHeap() };
@@ -409,16 +254,6 @@ Vector3 VolumetricCloudPass::Normalize(const Vector3& value)
     };
 }
 
-Vector4 VolumetricCloudPass::TransformPoint(const Vector3& value, const Matrix4x4& matrix)
-{
-    return {
-        value.x * matrix.m[0][0] + value.y * matrix.m[1][0] + value.z * matrix.m[2][0] + matrix.m[3][0],
-        value.x * matrix.m[0][1] + value.y * matrix.m[1][1] + value.z * matrix.m[2][1] + matrix.m[3][1],
-        value.x * matrix.m[0][2] + value.y * matrix.m[1][2] + value.z * matrix.m[2][2] + matrix.m[3][2],
-        value.x * matrix.m[0][3] + value.y * matrix.m[1][3] + value.z * matrix.m[2][3] + matrix.m[3][3]
-    };
-}
-
 D3D12_RECT VolumetricCloudPass::MakeFullScreenScissor()
 {
     return {
@@ -428,43 +263,3 @@ D3D12_RECT VolumetricCloudPass::MakeFullScreenScissor()
         WinApp::kClientHeight
     };
 }
-
-float VolumetricCloudPass::ComputeDistanceToAabb(const Vector3& point, const CloudVolume* cloudVolume)
-{
-    assert(cloudVolume);
-
-    const Vector3 min = cloudVolume->GetMin();
-    const Vector3 max = cloudVolume->GetMax();
-
-    const float dx = (std::max)((std::max)(min.x - point.x, 0.0f), point.x - max.x);
-    const float dy = (std::max)((std::max)(min.y - point.y, 0.0f), point.y - max.y);
-    const float dz = (std::max)((std::max)(min.z - point.z, 0.0f), point.z - max.z);
-
-    return std::sqrt(dx * dx + dy * dy + dz * dz);
-}
-
-void VolumetricCloudPass::ComputeDistanceLodScales(float entryDistance, const CloudVolume* cloudVolume, float lodFactorScale, bool disableDistanceLod, float& viewStepScale, float& densityScale)
-{
-    assert(cloudVolume);
-
-    const CloudVolume::Parameters& parameters = cloudVolume->GetParameters();
-    const float volumeRadius =
-        (std::max)(
-            std::sqrt(
-                parameters.halfExtents.x * parameters.halfExtents.x +
-                parameters.halfExtents.y * parameters.halfExtents.y +
-                parameters.halfExtents.z * parameters.halfExtents.z),
-            0.0001f);
-
-    const float lodStart = (std::max)(volumeRadius * 0.75f, 8.0f);
-    const float lodEnd = lodStart + (std::max)(volumeRadius * 2.50f, 16.0f);
-    float lodFactor = 0.0f;
-
-    if (!disableDistanceLod) {
-        lodFactor = std::clamp((entryDistance - lodStart) / (std::max)(lodEnd - lodStart, 0.0001f), 0.0f, 1.0f);
-        lodFactor = std::clamp(lodFactor * lodFactorScale, 0.0f, 1.0f);
-    }
-
-    viewStepScale = 1.0f + (0.45f - 1.0f) * lodFactor;
-    densityScale = 1.0f + (0.65f - 1.0f) * lodFactor;
-}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Camera.h"
+#include "CloudProjection.h"
 #include "CloudVolume.h"
 #include "DirectXCommon.h"
 
@@ -10,20 +11,9 @@
 
 class VolumetricCloudPass {
 public:
-    struct ProjectedBounds {
-        bool isVisible = false;
-        bool isPassSkipped = true;
-        bool useFullScreenScissor = true;
-        bool isFullScreenFallback = false;
-        bool isCameraInsideCloud = false;
-        bool isNearPlaneCrossing = false;
-        float scissorAreaRatio = 1.0f;
-        float currentViewStepScale = 1.0f;
-        float currentLightStepScale = 1.0f;
-        uint32_t estimatedViewSteps = 0;
-        uint32_t estimatedLightSteps = 0;
-        D3D12_RECT scissorRect{};
-    };
+    // シザー矩形と距離 LOD の計算は CloudProjection が行う
+    using ProjectedBounds = CloudProjection::ProjectedBounds;
+    using ForceMode = CloudProjection::ForceMode;
 
     enum class DebugViewMode : uint32_t {
         Final = 0,
@@ -32,15 +22,6 @@ public:
         LightOnly = 3,
     };
 
-    enum class ForceMode : uint32_t {
-        None = 0,
-        ForceSkip = 1,
-        ForceFullscreen = 2,
-        ForceScissor = 3,
-        ForceMaxQuality = 4,
-        ForceAggressiveLod = 5,
-    };
-
 public:
     void Initialize(DirectXCommon* dxCommon);
     ProjectedBounds BuildProjectedBounds(const Camera* camera, const CloudVolume* cloudVolume) const;
@@ -96,10 +77,7 @@ private:
     void UpdateConstantBuffer(const Camera* camera, const CloudVolume* cloudVolume);
 
     static Vector3 Normalize(const Vector3& value);
-    static Vector4 TransformPoint(const Vector3& value, const Matrix4x4& matrix);
     static D3D12_RECT MakeFullScreenScissor();
-    static float ComputeDistanceToAabb(const Vector3& point, const CloudVolume* cloudVolume);
-    static void ComputeDistanceLodScales(float entryDistance, const CloudVolume* cloudVolume, float lodFactorScale, bool disableDistanceLod, float& viewStepScale, float& densityScale);
 
 private:
     DirectXCommon* dxCommon_ = nullptr;
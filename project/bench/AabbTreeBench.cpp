@@ -0,0 +1,194 @@
+// 動的 AABB ツリーのベンチマーク
+// 10k〜100k 個の動くオブジェクトで挿入・移動・視錐台・半直線・重なりクエリの ns を出力し、
+// 総当たりとの結果の一致とツリーの品質 (高さ・表面積比) を確かめる
+#include "Culling.h"
+#include "DynamicAabbTree.h"
+#include "Matrix4x4.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace MatrixMath;
+
+namespace {
+    constexpr size_t kRayCount = 1000;
+    constexpr size_t kOverlapCount = 1000;
+    constexpr int kFrameCount = 10;
+
+    // 最適化で消されないように結果を集計する
+    volatile size_t gSink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedNs(Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    Aabb MakeBox(const Vector3& center, const Vector3& extent) {
+        return { { center.x - extent.x, center.y - extent.y, center.z - extent.z }, { center.x + extent.x, center.y + extent.y, center.z + extent.z } };
+    }
+
+    bool Overlaps(const Aabb& a, const Aabb& b) {
+        return
+            a.min.x <= b.max.x && b.min.x <= a.max.x &&
+            a.min.y <= b.max.y && b.min.y <= a.max.y &&
+            a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+
+    void RunScene(size_t objectCount, bool isCompared) {
+        // 個数が増えても密度が変わらないように空間を広げる
+        const float worldSize = 40.0f * std::cbrt(static_cast<float>(objectCount) / 1000.0f);
+
+        std::mt19937 gen(24680);
+        std::uniform_real_distribution<float> positionDist(-worldSize, worldSize);
+        std::uniform_real_distribution<float> sizeDist(0.1f, 1.0f);
+        std::uniform_real_distribution<float> velocityDist(-0.05f, 0.05f);
+
+        std::vector<Vector3> centers(objectCount);
+        std::vector<Vector3> extents(objectCount);
+        std::vector<Vector3> velocities(objectCount);
+        std::vector<Aabb> boxes(objectCount);
+        for (size_t i = 0; i < objectCount; ++i) {
+            centers[i] = { positionDist(gen), positionDist(gen), positionDist(gen) };
+            extents[i] = { sizeDist(gen), sizeDist(gen), sizeDist(gen) };
+            velocities[i] = { velocityDist(gen), velocityDist(gen), velocityDist(gen) };
+            boxes[i] = MakeBox(centers[i], extents[i]);
+        }
+
+        DynamicAabbTree tree;
+        std::vector<int32_t> proxies(objectCount);
+        auto start = Clock::now();
+        for (size_t i = 0; i < objectCount; ++i) {
+            proxies[i] = tree.CreateProxy(boxes[i], reinterpret_cast<void*>(i));
+        }
+        const double insertNs = ElapsedNs(start) / static_cast<double>(objectCount);
+
+        // 毎フレーム全オブジェクトを動かす
+        size_t reinsertCount = 0;
+        start = Clock::now();
+        for (int frame = 0; frame < kFrameCount; ++frame) {
+            for (size_t i = 0; i < objectCount; ++i) {
+                Vector3& center = centers[i];
+                center.x += velocities[i].x;
+                center.y += velocities[i].y;
+                center.z += velocities[i].z;
+                boxes[i] = MakeBox(center, extents[i]);
+                reinsertCount += tree.MoveProxy(proxies[i], boxes[i], velocities[i]) ? 1 : 0;
+            }
+        }
+        const double moveNs = ElapsedNs(start) / static_cast<double>(objectCount * kFrameCount);
+
+        // 中央から見下ろすカメラの視錐台
+        const Matrix4x4 cameraWorld = MakeAffine({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.0f, 0.0f }, { 0.0f, 0.0f, -worldSize });
+        const Matrix4x4 viewProjection = Multipty(InverseRigid(cameraWorld), PerspectiveFov(0.45f, 16.0f / 9.0f, 0.1f, worldSize));
+        const Frustum frustum = Culling::ExtractFrustum(viewProjection);
+
+        std::vector<int32_t> visible;
+        visible.reserve(objectCount);
+        start = Clock::now();
+        for (int frame = 0; frame < kFrameCount; ++frame) {
+            visible.clear();
+            tree.QueryFrustum(frustum, visible);
+        }
+        const double frustumNs = ElapsedNs(start) / kFrameCount;
+
+        std::vector<Ray> rays(kRayCount);
+        std::uniform_real_distribution<float> directionDist(-1.0f, 1.0f);
+        for (Ray& ray : rays) {
+            const Vector3 direction = { directionDist(gen), directionDist(gen), directionDist(gen) };
+            const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+            ray = { { positionDist(gen), positionDist(gen), positionDist(gen) }, { direction.x / length, direction.y / length, direction.z / length }, worldSize };
+        }
+        std::vector<DynamicAabbTree::RayHit> hits(kRayCount);
+        start = Clock::now();
+        tree.RayCastBatch(rays.data(), rays.size(), hits.data());
+        const double rayNs = ElapsedNs(start) / kRayCount;
+
+        std::vector<Aabb> queries(kOverlapCount);
+        for (Aabb& query : queries) {
+            query = MakeBox({ positionDist(gen), positionDist(gen), positionDist(gen) }, { 2.0f, 2.0f, 2.0f });
+        }
+        std::vector<DynamicAabbTree::OverlapPair> pairs;
+        start = Clock::now();
+        tree.QueryOverlaps(queries.data(), queries.size(), pairs);
+        const double overlapNs = ElapsedNs(start) / kOverlapCount;
+
+        std::printf("%7zu %9.1f %9.1f %9zu %11.1f %9.1f %11.1f %6d %7.1f %5s",
+            objectCount, insertNs, moveNs, reinsertCount, frustumNs / 1000.0, rayNs, overlapNs,
+            tree.GetHeight(), tree.GetAreaRatio(), tree.Validate() ? "ok" : "NG");
+
+        if (!isCompared) {
+            std::printf("\n");
+            gSink = gSink + visible.size() + pairs.size();
+            return;
+        }
+
+        // 総当たりの結果と比較する
+        size_t mismatches = 0;
+
+        start = Clock::now();
+        size_t bruteVisible = 0;
+        for (size_t i = 0; i < objectCount; ++i) {
+            bruteVisible += Culling::IsVisible(frustum, boxes[i]) ? 1 : 0;
+        }
+        const double bruteFrustumNs = ElapsedNs(start);
+        if (bruteVisible != visible.size()) {
+            ++mismatches;
+        }
+
+        start = Clock::now();
+        for (size_t r = 0; r < kRayCount; ++r) {
+            float bestDistance = rays[r].maxDistance;
+            bool isHit = false;
+            for (size_t i = 0; i < objectCount; ++i) {
+                float distance;
+                if (Culling::IntersectRay(rays[r], boxes[i], distance) && distance <= bestDistance) {
+                    bestDistance = distance;
+                    isHit = true;
+                }
+            }
+            const bool isTreeHit = hits[r].proxyId != DynamicAabbTree::kNullNode;
+            if (isHit != isTreeHit || (isHit && std::fabs(bestDistance - hits[r].distance) > 1.0e-4f)) {
+                ++mismatches;
+            }
+        }
+        const double bruteRayNs = ElapsedNs(start) / kRayCount;
+
+        start = Clock::now();
+        size_t brutePairs = 0;
+        for (size_t q = 0; q < kOverlapCount; ++q) {
+            for (size_t i = 0; i < objectCount; ++i) {
+                brutePairs += Overlaps(queries[q], boxes[i]) ? 1 : 0;
+            }
+        }
+        const double bruteOverlapNs = ElapsedNs(start) / kOverlapCount;
+        if (brutePairs != pairs.size()) {
+            ++mismatches;
+        }
+
+        std::printf("   %11.1f %9.1f %11.1f %10zu\n", bruteFrustumNs / 1000.0, bruteRayNs, bruteOverlapNs, mismatches);
+        gSink = gSink + visible.size() + pairs.size();
+    }
+}
+
+int main(int argc, char** argv) {
+    // 総当たりとの比較は時間がかかるので、引数で打ち切る個数を指定できる
+    size_t compareLimit = 30000;
+    if (argc > 1) {
+        compareLimit = static_cast<size_t>(std::strtoull(argv[1], nullptr, 10));
+    }
+
+    std::printf("moving objects, %d frames; frustum in us/query, ray and overlap in ns/query\n", kFrameCount);
+    std::printf("%7s %9s %9s %9s %11s %9s %11s %6s %7s %5s   %11s %9s %11s %10s\n",
+        "objects", "insert", "move", "reinserts", "frustum(us)", "ray", "overlap", "height", "area", "valid",
+        "brute_frus", "brute_ray", "brute_over", "mismatches");
+    for (size_t objectCount : { 10000, 30000, 100000 }) {
+        RunScene(objectCount, objectCount <= compareLimit);
+    }
+    return gSink == 0xffffffff ? 1 : 0;
+}
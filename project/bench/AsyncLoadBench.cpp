@@ -0,0 +1,178 @@
+// モデルの非同期読み込み (AsyncMeshLoader) のベンチマーク
+// 合成した OBJ を何個か、描画スレッドで順に読んだ場合と、ワーカースレッドに頼んで毎フレーム受け取る場合を比べる
+//   total は全て受け取るまでの時間、stall は描画スレッドが読み込みのために止まった時間の合計と 1 フレームでの最大
+//   first はキャッシュが無い状態 (OBJ の読み込み・並べ替え・塊・詳細度の段)、cached は MeshCache から読む状態
+// 受け取った結果が順に読んだものと同じかも確かめる
+#include "AsyncMeshLoader.h"
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 緯度・経度で分けた球 (v / vt / vn を共有する)
+    void WriteSphereObj(const std::string& path, uint32_t segments) {
+        std::ofstream file(path);
+        file << "# generated by async_load_bench\n";
+        char buffer[128];
+        const float pi = 3.14159265f;
+        for (uint32_t lat = 0; lat <= segments; ++lat) {
+            for (uint32_t lon = 0; lon <= segments; ++lon) {
+                const float theta = pi * static_cast<float>(lat) / static_cast<float>(segments);
+                const float phi = 2.0f * pi * static_cast<float>(lon) / static_cast<float>(segments);
+                const float x = std::sin(theta) * std::cos(phi);
+                const float y = std::cos(theta);
+                const float z = std::sin(theta) * std::sin(phi);
+                std::snprintf(buffer, sizeof(buffer), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.4f %.4f %.4f\n", x, y, z,
+                    static_cast<float>(lon) / static_cast<float>(segments), 1.0f - static_cast<float>(lat) / static_cast<float>(segments), x, y, z);
+                file << buffer;
+            }
+        }
+        const uint32_t rowSize = segments + 1;
+        for (uint32_t lat = 0; lat < segments; ++lat) {
+            for (uint32_t lon = 0; lon < segments; ++lon) {
+                const uint32_t a = lat * rowSize + lon + 1;
+                const uint32_t b = a + rowSize;
+                const uint32_t c = a + 1;
+                const uint32_t d = b + 1;
+                std::snprintf(buffer, sizeof(buffer), "f %u/%u/%u %u/%u/%u %u/%u/%u\nf %u/%u/%u %u/%u/%u %u/%u/%u\n",
+                    a, a, a, b, b, b, c, c, c, c, c, c, b, b, b, d, d, d);
+                file << buffer;
+            }
+        }
+    }
+
+    bool IsSame(const ModelData& a, const ModelData& b) {
+        return a.vertices.size() == b.vertices.size() && a.indices == b.indices &&
+            a.meshlets.size() == b.meshlets.size() && a.lods.size() == b.lods.size() &&
+            std::memcmp(a.meshlets.data(), b.meshlets.data(), sizeof(ModelData::Meshlet) * a.meshlets.size()) == 0 &&
+            std::memcmp(a.vertices.data(), b.vertices.data(), sizeof(ModelData::VertexData) * a.vertices.size()) == 0;
+    }
+
+    struct Scene {
+        std::string directoryPath;
+        std::vector<std::string> filenames;
+    };
+
+    void RemoveCaches(const Scene& scene) {
+        std::error_code error;
+        for (const std::string& filename : scene.filenames) {
+            std::filesystem::remove(MeshCache::GetCachePath(scene.directoryPath, filename), error);
+        }
+    }
+
+    // 描画スレッドで順に読む
+    double LoadSerial(const Scene& scene, std::vector<ModelData>& models) {
+        models.clear();
+        const auto start = Clock::now();
+        for (const std::string& filename : scene.filenames) {
+            models.push_back(MeshCache::LoadObjFile(scene.directoryPath, filename));
+        }
+        return ElapsedMs(start);
+    }
+
+    struct AsyncTiming {
+        double totalMs = 0.0;
+        double stallMs = 0.0;
+        double maxFrameStallMs = 0.0;
+        uint32_t frameCount = 0;
+    };
+
+    // ワーカースレッドに頼み、1 ms のフレームごとに受け取る (受け取ったデータを移す時間も止まった時間に含める)
+    AsyncTiming LoadAsync(const Scene& scene, uint32_t threadCount, std::vector<ModelData>& models) {
+        AsyncTiming timing;
+        models.assign(scene.filenames.size(), ModelData{});
+        const auto start = Clock::now();
+        AsyncMeshLoader loader(threadCount);
+        std::vector<uint64_t> tickets;
+        auto frameStart = Clock::now();
+        for (const std::string& filename : scene.filenames) {
+            tickets.push_back(loader.Request(scene.directoryPath, filename));
+        }
+        std::vector<AsyncMeshLoader::Result> results;
+        for (;;) {
+            results.clear();
+            loader.TakeCompleted(results);
+            for (AsyncMeshLoader::Result& result : results) {
+                const size_t slot = std::find(tickets.begin(), tickets.end(), result.ticket) - tickets.begin();
+                models[slot] = std::move(result.modelData);
+            }
+            const double frameStall = ElapsedMs(frameStart);
+            timing.stallMs += frameStall;
+            timing.maxFrameStallMs = (std::max)(timing.maxFrameStallMs, frameStall);
+            ++timing.frameCount;
+            if (loader.GetPendingCount() == 0) {
+                break;
+            }
+            // 描画スレッドの他の仕事の代わり
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            frameStart = Clock::now();
+        }
+        timing.totalMs = ElapsedMs(start);
+        return timing;
+    }
+
+    void Run(const char* name, const Scene& scene, bool isCached) {
+        std::vector<ModelData> expected;
+        if (!isCached) {
+            RemoveCaches(scene);
+        }
+        const double serialMs = LoadSerial(scene, expected);
+        std::printf("%-10s %-7s %8s %10.2f %10.2f %10.2f %7s %6s\n", name, isCached ? "cached" : "first", "serial",
+            serialMs, serialMs, serialMs, "-", "-");
+
+        const uint32_t threadCounts[] = { 1u, 2u, 4u, 0u };
+        for (uint32_t threadCount : threadCounts) {
+            if (!isCached) {
+                RemoveCaches(scene);
+            }
+            std::vector<ModelData> models;
+            const AsyncTiming timing = LoadAsync(scene, threadCount, models);
+            bool isSame = models.size() == expected.size();
+            for (size_t i = 0; isSame && i < models.size(); ++i) {
+                isSame = IsSame(models[i], expected[i]);
+            }
+            const std::string threads = threadCount == 0 ? "default" : std::to_string(threadCount);
+            std::printf("%-10s %-7s %8s %10.2f %10.2f %10.3f %7u %6s\n", name, isCached ? "cached" : "first", threads.c_str(),
+                timing.totalMs, timing.stallMs, timing.maxFrameStallMs, timing.frameCount, isSame ? "yes" : "NO");
+        }
+    }
+}
+
+int main() {
+    // 大きさの違う球を何個か一時ディレクトリに書き出す
+    const std::filesystem::path temporaryDirectory = std::filesystem::temp_directory_path();
+    Scene scene;
+    scene.directoryPath = temporaryDirectory.string();
+    const uint32_t sphereSegments[] = { 32u, 64u, 96u, 128u, 160u, 192u, 224u, 256u };
+    for (uint32_t segments : sphereSegments) {
+        const std::string filename = "async_load_bench_sphere_" + std::to_string(segments) + ".obj";
+        WriteSphereObj((temporaryDirectory / filename).string(), segments);
+        scene.filenames.push_back(filename);
+    }
+
+    std::printf("%zu models (hardware threads: %u)\n", scene.filenames.size(), std::thread::hardware_concurrency());
+    std::printf("%-10s %-7s %8s %10s %10s %10s %7s %6s\n", "scene", "state", "threads", "total ms", "stall ms", "max frame", "frames", "same");
+    Run("spheres", scene, false);
+    Run("spheres", scene, true);
+
+    RemoveCaches(scene);
+    for (const std::string& filename : scene.filenames) {
+        std::filesystem::remove(temporaryDirectory / filename);
+    }
+    return 0;
+}
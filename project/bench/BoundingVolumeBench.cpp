@@ -0,0 +1,281 @@
+// 頂点を包む境界 (BoundingVolume) のベンチマーク
+// 大きなメッシュで AABB・球 (Ritter / 縮めて作り直したもの)・主成分の有向ボックスを作る時間と大きさを出力し、
+// 全ての頂点が境界の中にあるかを確かめる (球は AABB の中心から作る以前の方法とも比べる)
+// ワールドへの変換 (Culling::TransformAabb / TransformSphere / TransformObb) はスカラーと SSE の時間・結果の差を比べ、
+// 変換した頂点が変換した境界の中にあるかも確かめる (半分の行列は回転した子に不均一に拡大した親を掛け、せん断を含める)
+#include "BoundingVolume.h"
+#include "PrimitiveGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // 最適化で消されないように結果を集計する
+    volatile float gSink = 0.0f;
+
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 何度か繰り返し、最小の時間を採る
+    double MeasureMs(const std::function<void()>& function) {
+        double best = 1.0e30;
+        for (int i = 0; i < 3; ++i) {
+            const auto start = Clock::now();
+            function();
+            best = (std::min)(best, ElapsedMs(start));
+        }
+        return best;
+    }
+
+    Vector3 TransformPoint(const Vector3& p, const Matrix4x4& matrix) {
+        const float (*m)[4] = matrix.m;
+        return {
+            p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0],
+            p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1],
+            p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2] };
+    }
+
+    float Dot(const Vector3& a, const Vector3& b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    // 境界の大きさに対する許容誤差 tolerance で、全ての点が中にあるか
+    bool ContainsAll(const Aabb& aabb, const std::vector<Vector3>& points, float tolerance) {
+        for (const Vector3& p : points) {
+            if (p.x < aabb.min.x - tolerance || p.y < aabb.min.y - tolerance || p.z < aabb.min.z - tolerance ||
+                p.x > aabb.max.x + tolerance || p.y > aabb.max.y + tolerance || p.z > aabb.max.z + tolerance) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ContainsAll(const BoundingSphere& sphere, const std::vector<Vector3>& points, float tolerance) {
+        for (const Vector3& p : points) {
+            const Vector3 d = { p.x - sphere.center.x, p.y - sphere.center.y, p.z - sphere.center.z };
+            if (std::sqrt(Dot(d, d)) > sphere.radius + tolerance) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 変換後の軸は直交しないことがあるので、軸の双対 (逆行列の行) で箱の座標を求める
+    bool ContainsAll(const Obb& obb, const std::vector<Vector3>& points, float tolerance) {
+        const Vector3& a = obb.axis[0];
+        const Vector3& b = obb.axis[1];
+        const Vector3& c = obb.axis[2];
+        const Vector3 bc = { b.y * c.z - b.z * c.y, b.z * c.x - b.x * c.z, b.x * c.y - b.y * c.x };
+        const Vector3 ca = { c.y * a.z - c.z * a.y, c.z * a.x - c.x * a.z, c.x * a.y - c.y * a.x };
+        const Vector3 ab = { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+        const float determinant = Dot(a, bc);
+        const Vector3 dual[3] = { bc, ca, ab };
+        const float halfExtent[3] = { obb.halfExtent.x, obb.halfExtent.y, obb.halfExtent.z };
+        for (const Vector3& p : points) {
+            const Vector3 d = { p.x - obb.center.x, p.y - obb.center.y, p.z - obb.center.z };
+            for (int i = 0; i < 3; ++i) {
+                const float coordinate = Dot(d, dual[i]) / determinant;
+                // 軸に沿った距離の誤差が tolerance になるよう、軸の長さ 1 の単位で比べる
+                if (std::fabs(coordinate) > halfExtent[i] + tolerance) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    float Volume(const Aabb& aabb) {
+        return (aabb.max.x - aabb.min.x) * (aabb.max.y - aabb.min.y) * (aabb.max.z - aabb.min.z);
+    }
+
+    float Volume(const Obb& obb) {
+        return 8.0f * obb.halfExtent.x * obb.halfExtent.y * obb.halfExtent.z;
+    }
+
+    float Volume(const BoundingSphere& sphere) {
+        return 4.18879020f * sphere.radius * sphere.radius * sphere.radius;
+    }
+
+    // 以前の Model の球 (AABB の中心から最も遠い頂点まで)
+    BoundingSphere ComputeAabbCenterSphere(const std::vector<Vector3>& points) {
+        const Aabb aabb = BoundingVolume::ComputeAabb(points.data(), points.size());
+        BoundingSphere sphere = { { (aabb.min.x + aabb.max.x) * 0.5f, (aabb.min.y + aabb.max.y) * 0.5f, (aabb.min.z + aabb.max.z) * 0.5f }, 0.0f };
+        float radiusSq = 0.0f;
+        for (const Vector3& p : points) {
+            const Vector3 d = { p.x - sphere.center.x, p.y - sphere.center.y, p.z - sphere.center.z };
+            radiusSq = (std::max)(radiusSq, Dot(d, d));
+        }
+        sphere.radius = std::sqrt(radiusSq);
+        return sphere;
+    }
+
+    struct Case {
+        std::string name;
+        ModelData data;
+    };
+
+    // 形の頂点を回転・不均一に拡大して、軸に沿わない細長い形にする
+    ModelData Skew(ModelData data, const Vector3& scale, const Vector3& rotate) {
+        const Matrix4x4 matrix = MatrixMath::MakeAffine(scale, rotate, { 0.3f, -0.2f, 0.1f });
+        for (ModelData::VertexData& vertex : data.vertices) {
+            const Vector3 p = TransformPoint({ vertex.position.x, vertex.position.y, vertex.position.z }, matrix);
+            vertex.position = { p.x, p.y, p.z, 1.0f };
+        }
+        return data;
+    }
+}
+
+int main() {
+    std::vector<Case> cases;
+    cases.push_back({ "sphere 256", PrimitiveGenerator::CreateSphereData(256) });
+    cases.push_back({ "sphere 1024", PrimitiveGenerator::CreateSphereData(1024) });
+    cases.push_back({ "torus 1024x512", PrimitiveGenerator::CreateTorusData(1024, 512) });
+    cases.push_back({ "cone 65536", PrimitiveGenerator::CreateConeData(65536) });
+    cases.push_back({ "rod 4096", Skew(PrimitiveGenerator::CreateCylinderData(4096), { 0.2f, 4.0f, 0.5f }, { 0.7f, 0.4f, 1.1f }) });
+    cases.push_back({ "torus tilted", Skew(PrimitiveGenerator::CreateTorusData(512, 256), { 2.0f, 1.0f, 0.5f }, { 0.3f, 1.2f, 0.5f }) });
+
+    // --- 作る時間と大きさ ---
+    std::printf("%-16s %9s | %8s %8s %8s %8s %8s | %8s %8s %8s | %8s %8s %8s | %s\n",
+        "mesh", "vertices", "aabb ms", "ritter", "refined", "obb ms", "build ms",
+        "r(aabbc)", "r(ritt)", "r(refn)", "V(aabb)", "V(obb)", "V(sph)", "contains");
+    for (Case& c : cases) {
+        // 2 つのサブメッシュに分け、サブメッシュごとの境界も作る
+        const uint32_t half = static_cast<uint32_t>(c.data.indices.size() / 6 * 3);
+        c.data.submeshes = { { "", 0, half, 0 }, { "", half, static_cast<uint32_t>(c.data.indices.size()) - half, 0 } };
+
+        std::vector<Vector3> points;
+        for (const ModelData::VertexData& vertex : c.data.vertices) {
+            points.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+        }
+        std::vector<Vector3> work = points;
+
+        Aabb aabb{};
+        BoundingSphere ritter{}, refined{};
+        Obb obb{};
+        const double aabbMs = MeasureMs([&]() { aabb = BoundingVolume::ComputeAabb(points.data(), points.size()); });
+        const double ritterMs = MeasureMs([&]() { ritter = BoundingVolume::ComputeSphere(work.data(), work.size(), 0); });
+        const double refinedMs = MeasureMs([&]() { refined = BoundingVolume::ComputeSphere(work.data(), work.size()); });
+        const double obbMs = MeasureMs([&]() { obb = BoundingVolume::ComputeObb(points.data(), points.size()); });
+        const double buildMs = MeasureMs([&]() { BoundingVolume::Build(c.data); });
+        const BoundingSphere aabbCenter = ComputeAabbCenterSphere(points);
+
+        // 大きさの 1e-5 までの丸めの誤差は許す
+        const float tolerance = refined.radius * 1.0e-5f;
+        bool contains = ContainsAll(aabb, points, tolerance) && ContainsAll(ritter, points, tolerance) &&
+            ContainsAll(refined, points, tolerance) && ContainsAll(obb, points, tolerance);
+        contains = contains && c.data.submeshBounds.size() == 2;
+        for (size_t s = 0; s < c.data.submeshBounds.size(); ++s) {
+            std::vector<Vector3> submeshPoints;
+            const ModelData::Submesh& submesh = c.data.submeshes[s];
+            for (uint32_t k = 0; k < submesh.indexCount; ++k) {
+                submeshPoints.push_back(points[c.data.indices[submesh.indexStart + k]]);
+            }
+            const ModelData::Bounds& bounds = c.data.submeshBounds[s];
+            contains = contains && ContainsAll(bounds.aabb, submeshPoints, tolerance) &&
+                ContainsAll(bounds.sphere, submeshPoints, tolerance) && ContainsAll(bounds.obb, submeshPoints, tolerance);
+        }
+
+        std::printf("%-16s %9zu | %8.3f %8.3f %8.3f %8.3f %8.3f | %8.4f %8.4f %8.4f | %8.3f %8.3f %8.3f | %s\n",
+            c.name.c_str(), points.size(), aabbMs, ritterMs, refinedMs, obbMs, buildMs,
+            aabbCenter.radius, ritter.radius, refined.radius, Volume(aabb), Volume(obb), Volume(refined), contains ? "yes" : "NO");
+    }
+
+    // --- ワールドへの変換 (頂点を使わず、境界と行列だけで求める) ---
+    const size_t transformCount = 1 << 20;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> scaleDistribution(0.2f, 3.0f);
+    std::uniform_real_distribution<float> angleDistribution(-3.14159265f, 3.14159265f);
+    std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+    std::vector<Matrix4x4> matrices(transformCount);
+    for (size_t i = 0; i < transformCount; ++i) {
+        matrices[i] = MatrixMath::MakeAffine(
+            { scaleDistribution(random), scaleDistribution(random), scaleDistribution(random) },
+            { angleDistribution(random), angleDistribution(random), angleDistribution(random) },
+            { positionDistribution(random), positionDistribution(random), positionDistribution(random) });
+        if (i % 2 == 1) {
+            const Matrix4x4 child = MatrixMath::MakeAffine(
+                { 1.0f, 1.0f, 1.0f }, { angleDistribution(random), angleDistribution(random), angleDistribution(random) }, { 0.0f, 0.0f, 0.0f });
+            matrices[i] = MatrixMath::Multipty(child, matrices[i]);
+        }
+    }
+    const ModelData::Bounds& local = cases.back().data.bounds;
+
+    std::vector<Aabb> aabbs[2];
+    std::vector<BoundingSphere> spheres[2];
+    std::vector<Obb> obbs[2];
+    double aabbMs[2], sphereMs[2], obbMs[2];
+    const MatrixMath::SimdLevel levels[2] = { MatrixMath::SimdLevel::Scalar, MatrixMath::GetMaxSimdLevel() };
+    for (int l = 0; l < 2; ++l) {
+        MatrixMath::SetSimdLevel(levels[l]);
+        aabbs[l].resize(transformCount);
+        spheres[l].resize(transformCount);
+        obbs[l].resize(transformCount);
+        aabbMs[l] = MeasureMs([&]() {
+            for (size_t i = 0; i < transformCount; ++i) {
+                aabbs[l][i] = Culling::TransformAabb(local.aabb, matrices[i]);
+            }
+            gSink = gSink + aabbs[l].back().max.x;
+            });
+        sphereMs[l] = MeasureMs([&]() {
+            for (size_t i = 0; i < transformCount; ++i) {
+                spheres[l][i] = Culling::TransformSphere(local.sphere, matrices[i]);
+            }
+            gSink = gSink + spheres[l].back().radius;
+            });
+        obbMs[l] = MeasureMs([&]() {
+            for (size_t i = 0; i < transformCount; ++i) {
+                obbs[l][i] = Culling::TransformObb(local.obb, matrices[i]);
+            }
+            gSink = gSink + obbs[l].back().halfExtent.x;
+            });
+    }
+    MatrixMath::SetSimdLevel(MatrixMath::GetMaxSimdLevel());
+
+    // スカラーと SSE の結果の差 (境界の大きさに対する比)
+    float maxDifference = 0.0f;
+    for (size_t i = 0; i < transformCount; ++i) {
+        const float scale = (std::max)(spheres[0][i].radius, 1.0e-6f);
+        auto difference = [&](const Vector3& a, const Vector3& b) {
+            maxDifference = (std::max)(maxDifference, (std::max)({ std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z) }) / scale);
+            };
+        difference(aabbs[0][i].min, aabbs[1][i].min);
+        difference(aabbs[0][i].max, aabbs[1][i].max);
+        difference(spheres[0][i].center, spheres[1][i].center);
+        difference({ spheres[0][i].radius, 0.0f, 0.0f }, { spheres[1][i].radius, 0.0f, 0.0f });
+        difference(obbs[0][i].center, obbs[1][i].center);
+        difference(obbs[0][i].halfExtent, obbs[1][i].halfExtent);
+        for (int a = 0; a < 3; ++a) {
+            difference(obbs[0][i].axis[a], obbs[1][i].axis[a]);
+        }
+    }
+
+    // 変換した頂点が変換した境界の中にあるか (いくつかの行列で調べる)
+    bool worldContains = true;
+    std::vector<Vector3> worldPoints;
+    for (size_t i = 0; i < transformCount; i += transformCount / 16 + 1) {
+        worldPoints.clear();
+        for (const ModelData::VertexData& vertex : cases.back().data.vertices) {
+            worldPoints.push_back(TransformPoint({ vertex.position.x, vertex.position.y, vertex.position.z }, matrices[i]));
+        }
+        const float tolerance = spheres[1][i].radius * 1.0e-5f;
+        worldContains = worldContains && ContainsAll(aabbs[1][i], worldPoints, tolerance) &&
+            ContainsAll(spheres[1][i], worldPoints, tolerance) && ContainsAll(obbs[1][i], worldPoints, tolerance);
+    }
+
+    std::printf("\nworld bounds from %zu transforms (ns per transform, scalar / simd)\n", transformCount);
+    std::printf("  aabb   : %6.2f / %6.2f\n", aabbMs[0] * 1.0e6 / transformCount, aabbMs[1] * 1.0e6 / transformCount);
+    std::printf("  sphere : %6.2f / %6.2f\n", sphereMs[0] * 1.0e6 / transformCount, sphereMs[1] * 1.0e6 / transformCount);
+    std::printf("  obb    : %6.2f / %6.2f\n", obbMs[0] * 1.0e6 / transformCount, obbMs[1] * 1.0e6 / transformCount);
+    std::printf("  max scalar/simd difference : %g (relative)\n", maxDifference);
+    std::printf("  world vertices inside      : %s\n", worldContains ? "yes" : "NO");
+    return 0;
+}
@@ -0,0 +1,126 @@
+// 視錐台カリングのベンチマーク
+// 1 個ずつの IsVisible と CullAabbs / CullSpheres (命令セットごと) の ns/object と結果の一致を出力する
+#include "Culling.h"
+#include "Matrix4x4.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace MatrixMath;
+
+namespace {
+    constexpr size_t kObjectCount = 10000;
+
+    // 最適化で消されないように結果を集計する
+    volatile size_t gSink = 0;
+
+    const char* ToString(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX: return "AVX";
+        case SimdLevel::SSE2: return "SSE2";
+        default: return "Scalar";
+        }
+    }
+
+    template <typename Func>
+    double MeasureNsPerObject(size_t iterations, Func&& func) {
+        // ウォームアップ
+        func();
+
+        const auto start = std::chrono::steady_clock::now();
+        size_t objects = 0;
+        while (objects < iterations) {
+            func();
+            objects += kObjectCount;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(objects);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = 20'000'000;
+    if (argc > 1) {
+        iterations = static_cast<size_t>(std::strtoull(argv[1], nullptr, 10));
+    }
+
+    // Camera と同じ手順でビュープロジェクション行列を作る
+    const Matrix4x4 cameraWorld = MakeAffine({ 1.0f, 1.0f, 1.0f }, { 0.2f, 0.6f, 0.0f }, { 0.0f, 5.0f, -40.0f });
+    const Matrix4x4 viewProjection = Multipty(InverseRigid(cameraWorld), PerspectiveFov(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+    const Frustum frustum = Culling::ExtractFrustum(viewProjection);
+
+    std::mt19937 gen(97531);
+    std::uniform_real_distribution<float> positionDist(-80.0f, 80.0f);
+    std::uniform_real_distribution<float> sizeDist(0.1f, 4.0f);
+    std::vector<Aabb> aabbs(kObjectCount);
+    std::vector<BoundingSphere> spheres(kObjectCount);
+    AabbSoA aabbSoA;
+    SphereSoA sphereSoA;
+    for (size_t i = 0; i < kObjectCount; ++i) {
+        const Vector3 center = { positionDist(gen), positionDist(gen) * 0.25f, positionDist(gen) };
+        const Vector3 extent = { sizeDist(gen), sizeDist(gen), sizeDist(gen) };
+        aabbs[i] = { { center.x - extent.x, center.y - extent.y, center.z - extent.z }, { center.x + extent.x, center.y + extent.y, center.z + extent.z } };
+        spheres[i] = { center, extent.x };
+        aabbSoA.PushBack(aabbs[i]);
+        sphereSoA.PushBack(spheres[i]);
+    }
+
+    std::vector<uint64_t> mask(Culling::GetMaskWordCount(kObjectCount));
+    std::vector<uint8_t> expectedAabb(kObjectCount);
+    std::vector<uint8_t> expectedSphere(kObjectCount);
+    size_t expectedAabbCount = 0;
+    for (size_t i = 0; i < kObjectCount; ++i) {
+        expectedAabb[i] = Culling::IsVisible(frustum, aabbs[i]) ? 1 : 0;
+        expectedSphere[i] = Culling::IsVisible(frustum, spheres[i]) ? 1 : 0;
+        expectedAabbCount += expectedAabb[i];
+    }
+    std::printf("objects %zu, visible aabbs %zu\n\n", kObjectCount, expectedAabbCount);
+
+    std::printf("%-24s %10s %10s\n", "culling", "ns/object", "mismatch");
+    const double perObjectNs = MeasureNsPerObject(iterations, [&]() {
+        size_t visible = 0;
+        for (const Aabb& aabb : aabbs) {
+            visible += Culling::IsVisible(frustum, aabb) ? 1 : 0;
+        }
+        gSink = gSink + visible;
+        });
+    std::printf("%-24s %10.3f %10s\n", "IsVisible(aabb)", perObjectNs, "-");
+
+    const SimdLevel defaultLevel = GetSimdLevel();
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX }) {
+        if (level > GetMaxSimdLevel()) {
+            continue;
+        }
+        SetSimdLevel(level);
+
+        const double aabbNs = MeasureNsPerObject(iterations, [&]() {
+            gSink = gSink + Culling::CullAabbs(frustum, aabbSoA.GetStreams(), mask.data());
+            });
+        size_t aabbMismatch = 0;
+        Culling::CullAabbs(frustum, aabbSoA.GetStreams(), mask.data());
+        for (size_t i = 0; i < kObjectCount; ++i) {
+            aabbMismatch += (Culling::TestMask(mask.data(), i) != (expectedAabb[i] != 0)) ? 1 : 0;
+        }
+
+        const double sphereNs = MeasureNsPerObject(iterations, [&]() {
+            gSink = gSink + Culling::CullSpheres(frustum, sphereSoA.GetStreams(), mask.data());
+            });
+        size_t sphereMismatch = 0;
+        Culling::CullSpheres(frustum, sphereSoA.GetStreams(), mask.data());
+        for (size_t i = 0; i < kObjectCount; ++i) {
+            sphereMismatch += (Culling::TestMask(mask.data(), i) != (expectedSphere[i] != 0)) ? 1 : 0;
+        }
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "CullAabbs(%s)", ToString(level));
+        std::printf("%-24s %10.3f %10zu\n", name, aabbNs, aabbMismatch);
+        std::snprintf(name, sizeof(name), "CullSpheres(%s)", ToString(level));
+        std::printf("%-24s %10.3f %10zu\n", name, sphereNs, sphereMismatch);
+    }
+    SetSimdLevel(defaultLevel);
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+// エンジンの CPU 処理をサブシステムごとに計測するベンチマーク
+// 結果は 1 行 1 件の JSON (JSON Lines) で標準出力へ書き出す
+//   {"subsystem":"primitive","case":"sphere_256","iterations":...,"ns_per_op":...,"items_per_op":...,"ns_per_item":...,"bytes_per_op":...,"mb_per_s":...}
+// items_per_op は 1 回の処理で扱う要素数 (三角形の頂点番号・粒子・行列など)、bytes_per_op は読み込んだバイト数 (ファイル読み込みのみ)
+// 使い方: engine_bench [--filter=<subsystem>] [--resources=<dir>] [--min-ms=<ms>]
+#include "CloudProjection.h"
+#include "CloudVolume.h"
+#include "Culling.h"
+#include "FastMath.h"
+#include "Matrix4x4.h"
+#include "ObjLoader.h"
+#include "ParticleSimulation.h"
+#include "PrimitiveGenerator.h"
+#include "TransformBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace MatrixMath;
+
+namespace {
+    // 最適化で消されないように結果を集計する
+    volatile size_t gSink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string filter;
+        std::string resourceDirectory = "resources";
+        double minMs = 100.0;
+    };
+
+    Options gOptions;
+
+    // 1 件の計測
+    // 処理時間が minMs を超えるまで回数を倍にし、同じ回数で 3 回計った最小値を採る
+    void Run(const char* subsystem, const std::string& caseName, size_t itemsPerOp, size_t bytesPerOp, const std::function<void()>& body) {
+        if (!gOptions.filter.empty() && gOptions.filter != subsystem) {
+            return;
+        }
+
+        body();
+
+        auto Measure = [&](size_t iterations) {
+            const auto start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                body();
+            }
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        };
+
+        size_t iterations = 1;
+        double elapsedNs = Measure(iterations);
+        while (elapsedNs < gOptions.minMs * 1.0e6 && iterations < (size_t(1) << 30)) {
+            iterations *= 2;
+            elapsedNs = Measure(iterations);
+        }
+        for (int i = 0; i < 2; ++i) {
+            elapsedNs = (std::min)(elapsedNs, Measure(iterations));
+        }
+
+        const double nsPerOp = elapsedNs / static_cast<double>(iterations);
+        std::printf("{\"subsystem\":\"%s\",\"case\":\"%s\",\"iterations\":%zu,\"ns_per_op\":%.3f,\"items_per_op\":%zu,\"ns_per_item\":%.4f",
+            subsystem, caseName.c_str(), iterations, nsPerOp, itemsPerOp, itemsPerOp > 0 ? nsPerOp / static_cast<double>(itemsPerOp) : 0.0);
+        if (bytesPerOp > 0) {
+            std::printf(",\"bytes_per_op\":%zu,\"mb_per_s\":%.2f", bytesPerOp, static_cast<double>(bytesPerOp) / nsPerOp * 1.0e3);
+        }
+        std::printf("}\n");
+        std::fflush(stdout);
+    }
+
+    Transform RandomTransform(std::mt19937& gen) {
+        std::uniform_real_distribution<float> scaleDist(0.5f, 2.0f);
+        std::uniform_real_distribution<float> angleDist(-3.14159265f, 3.14159265f);
+        std::uniform_real_distribution<float> positionDist(-50.0f, 50.0f);
+        return {
+            { scaleDist(gen), scaleDist(gen), scaleDist(gen) },
+            { angleDist(gen), angleDist(gen), angleDist(gen) },
+            { positionDist(gen), positionDist(gen), positionDist(gen) }
+        };
+    }
+
+    // 固定のカメラ (原点から +z を向く 16:9 の透視投影)
+    Matrix4x4 MakeViewProjection(const Vector3& rotate, const Vector3& translate) {
+        const Matrix4x4 cameraWorld = MakeAffine({ 1.0f, 1.0f, 1.0f }, rotate, translate);
+        return Multipty(InverseRigid(cameraWorld), PerspectiveFov(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+    }
+
+    void BenchMath() {
+        std::mt19937 gen(12345);
+        std::vector<Transform> transforms(1024);
+        for (Transform& transform : transforms) {
+            transform = RandomTransform(gen);
+        }
+        std::vector<Matrix4x4> matrices(transforms.size());
+        for (size_t i = 0; i < transforms.size(); ++i) {
+            matrices[i] = MakeAffine(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+        }
+        std::vector<Matrix4x4> results(transforms.size());
+        const Matrix4x4 viewProjection = MakeViewProjection({ 0.3f, 0.0f, 0.0f }, { 0.0f, 5.0f, -20.0f });
+
+        Run("math", "multiply_1024", matrices.size(), 0, [&]() {
+            for (size_t i = 0; i < matrices.size(); ++i) {
+                results[i] = Multipty(matrices[i], viewProjection);
+            }
+            gSink = gSink + static_cast<size_t>(results[0].m[0][0]);
+        });
+        Run("math", "inverse_1024", matrices.size(), 0, [&]() {
+            for (size_t i = 0; i < matrices.size(); ++i) {
+                results[i] = Inverse(matrices[i]);
+            }
+            gSink = gSink + static_cast<size_t>(results[0].m[0][0]);
+        });
+        Run("math", "inverse_affine_1024", matrices.size(), 0, [&]() {
+            for (size_t i = 0; i < matrices.size(); ++i) {
+                results[i] = InverseAffine(matrices[i]);
+            }
+            gSink = gSink + static_cast<size_t>(results[0].m[0][0]);
+        });
+        Run("math", "make_affine_1024", transforms.size(), 0, [&]() {
+            for (size_t i = 0; i < transforms.size(); ++i) {
+                results[i] = MakeAffine(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+            }
+            gSink = gSink + static_cast<size_t>(results[0].m[0][0]);
+        });
+
+        TransformSoA soa;
+        for (const Transform& transform : transforms) {
+            soa.PushBack(transform);
+        }
+        std::vector<Matrix4x4> wvps(transforms.size());
+        Run("math", "make_affine_batch_1024", transforms.size(), 0, [&]() {
+            AffineBatchOutput output;
+            output.worlds = { results.data(), sizeof(Matrix4x4) };
+            output.wvps = { wvps.data(), sizeof(Matrix4x4) };
+            MakeAffineBatch(soa.GetStreams(), &viewProjection, nullptr, output);
+            gSink = gSink + static_cast<size_t>(wvps[0].m[0][0]);
+        });
+
+        std::vector<float> angles(4096), sinValues(angles.size()), cosValues(angles.size());
+        std::uniform_real_distribution<float> angleDist(-100.0f, 100.0f);
+        for (float& angle : angles) {
+            angle = angleDist(gen);
+        }
+        Run("math", "sincos_array_4096", angles.size(), 0, [&]() {
+            FastMath::SinCosArray(angles.data(), sinValues.data(), cosValues.data(), angles.size());
+            gSink = gSink + static_cast<size_t>(sinValues[0] + 2.0f);
+        });
+    }
+
+    void BenchObj() {
+        const std::string directory = gOptions.resourceDirectory + "/obj";
+        for (const char* name : { "axis", "fence", "multiMaterial", "multiMesh", "plane" }) {
+            const std::string modelDirectory = directory + "/" + name;
+            const std::string filename = std::string(name) + ".obj";
+            std::error_code error;
+            const uintmax_t fileSize = std::filesystem::file_size(modelDirectory + "/" + filename, error);
+            if (error) {
+                std::fprintf(stderr, "engine_bench: %s/%s not found\n", modelDirectory.c_str(), filename.c_str());
+                continue;
+            }
+            const size_t indexCount = ObjLoader::LoadObjFile(modelDirectory, filename).indices.size();
+            Run("obj", std::string("load_") + name, indexCount, static_cast<size_t>(fileSize), [&]() {
+                gSink = gSink + ObjLoader::LoadObjFile(modelDirectory, filename).indices.size();
+            });
+        }
+    }
+
+    void BenchPrimitive() {
+        auto RunPrimitive = [](const char* caseName, const std::function<ModelData()>& create) {
+            const size_t indexCount = create().indices.size();
+            Run("primitive", caseName, indexCount, 0, [&]() {
+                gSink = gSink + create().indices.size();
+            });
+        };
+
+        RunPrimitive("sphere_16", []() { return PrimitiveGenerator::CreateSphereData(16); });
+        RunPrimitive("sphere_256", []() { return PrimitiveGenerator::CreateSphereData(256); });
+        RunPrimitive("plane", []() { return PrimitiveGenerator::CreatePlaneData(); });
+        RunPrimitive("circle_32", []() { return PrimitiveGenerator::CreateCircleData(32); });
+        RunPrimitive("ring_32", []() { return PrimitiveGenerator::CreateRingData(32); });
+        RunPrimitive("ring_1024", []() { return PrimitiveGenerator::CreateRingData(1024); });
+        RunPrimitive("torus_32x16", []() { return PrimitiveGenerator::CreateTorusData(32, 16); });
+        RunPrimitive("torus_256x128", []() { return PrimitiveGenerator::CreateTorusData(256, 128); });
+        RunPrimitive("cylinder_32", []() { return PrimitiveGenerator::CreateCylinderData(32); });
+        RunPrimitive("effect_cylinder_32", []() { return PrimitiveGenerator::CreateEffectCylinderData(32); });
+        RunPrimitive("cone_32", []() { return PrimitiveGenerator::CreateConeData(32); });
+        RunPrimitive("triangle", []() { return PrimitiveGenerator::CreateTriangleData(); });
+        RunPrimitive("box", []() { return PrimitiveGenerator::CreateBoxData(); });
+    }
+
+    void BenchParticle() {
+        const Matrix4x4 viewProjection = MakeViewProjection({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -10.0f });
+        const Matrix4x4 billboard = MakeIdentity4x4();
+
+        // エフェクト名以外は汎用の粒子になる
+        for (const char* effect : { "Hit", "Fireball", "Wind", "Default" }) {
+            ParticleSimulation simulation;
+            simulation.SetSeed(2468);
+            Run("particle", std::string("emit_") + effect + "_64", 64, 0, [&]() {
+                simulation.Emit(effect, { 0.0f, 0.0f, 0.0f }, 64);
+                simulation.Clear();
+            });
+        }
+
+        // 毎フレーム一定数を出しながら進める (寿命が尽きると消えるので粒子数はほぼ一定になる)
+        for (uint32_t maxInstance : { 100u, 10000u }) {
+            ParticleSimulation simulation;
+            simulation.SetSeed(1357);
+            std::vector<ParticleSimulation::ParticleForGPU> instances(maxInstance);
+            for (int frame = 0; frame < 60; ++frame) {
+                simulation.Emit("Wind", { 0.0f, 0.0f, 0.0f }, 200);
+                simulation.Update(1.0f / 60.0f, viewProjection, billboard, instances.data(), maxInstance);
+            }
+            const size_t particleCount = simulation.GetParticleCount();
+            Run("particle", "emit200_update_max" + std::to_string(maxInstance), particleCount, 0, [&]() {
+                simulation.Emit("Wind", { 0.0f, 0.0f, 0.0f }, 200);
+                gSink = gSink + simulation.Update(1.0f / 60.0f, viewProjection, billboard, instances.data(), maxInstance);
+            });
+        }
+    }
+
+    void BenchCloud() {
+        CloudVolume cloudVolume;
+        Run("cloud", "volume_update", 1, 0, [&]() {
+            cloudVolume.Update(1.0f / 60.0f);
+            gSink = gSink + static_cast<size_t>(cloudVolume.GetElapsedTime());
+        });
+
+        // 雲の周りを回るカメラ (遠景・近景・内部を含む)
+        constexpr size_t kCameraCount = 256;
+        std::vector<Vector3> positions(kCameraCount);
+        std::vector<Matrix4x4> viewProjections(kCameraCount);
+        std::vector<Frustum> frustums(kCameraCount);
+        const Vector3 center = cloudVolume.GetParameters().center;
+        for (size_t i = 0; i < kCameraCount; ++i) {
+            const float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(kCameraCount);
+            const float distance = 4.0f + 60.0f * static_cast<float>(i % 16) / 15.0f;
+            positions[i] = { center.x - std::sin(angle) * distance, center.y + 2.0f, center.z - std::cos(angle) * distance };
+            viewProjections[i] = MakeViewProjection({ 0.0f, angle, 0.0f }, positions[i]);
+            frustums[i] = Culling::ExtractFrustum(viewProjections[i]);
+        }
+
+        for (CloudProjection::ForceMode forceMode : { CloudProjection::ForceMode::None, CloudProjection::ForceMode::ForceAggressiveLod }) {
+            CloudProjection::Settings settings;
+            settings.screenWidth = 1280;
+            settings.screenHeight = 720;
+            settings.forceMode = forceMode;
+            Run("cloud", forceMode == CloudProjection::ForceMode::None ? "projected_bounds_256" : "projected_bounds_aggressive_lod_256", kCameraCount, 0, [&]() {
+                size_t visibleCount = 0;
+                for (size_t i = 0; i < kCameraCount; ++i) {
+                    visibleCount += CloudProjection::BuildProjectedBounds(cloudVolume, positions[i], viewProjections[i], frustums[i], settings).isVisible ? 1 : 0;
+                }
+                gSink = gSink + visibleCount;
+            });
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument.rfind("--filter=", 0) == 0) {
+            gOptions.filter = argument.substr(9);
+        } else if (argument.rfind("--resources=", 0) == 0) {
+            gOptions.resourceDirectory = argument.substr(12);
+        } else if (argument.rfind("--min-ms=", 0) == 0) {
+            gOptions.minMs = std::strtod(argument.c_str() + 9, nullptr);
+        } else {
+            std::fprintf(stderr, "usage: engine_bench [--filter=math|obj|primitive|particle|cloud] [--resources=<dir>] [--min-ms=<ms>]\n");
+            return 2;
+        }
+    }
+
+    BenchMath();
+    BenchObj();
+    BenchPrimitive();
+    BenchParticle();
+    BenchCloud();
+    return gSink == 0xffffffff ? 1 : 0;
+}
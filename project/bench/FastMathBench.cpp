@@ -0,0 +1,142 @@
+// FastMath の sin / cos と libm (std::sin / std::cos) の比較
+// 入力範囲ごとの最大絶対誤差 (倍精度の std::sin / std::cos 基準) と ns/value を出力する
+#include "FastMath.h"
+#include "Matrix4x4.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace MatrixMath;
+
+namespace {
+    constexpr size_t kValueCount = 4096;
+
+    // 最適化で消されないように結果を集計する
+    volatile float gSink = 0.0f;
+
+    template <typename Func>
+    double MeasureNsPerValue(size_t iterations, Func&& func) {
+        // ウォームアップ
+        func();
+
+        const auto start = std::chrono::steady_clock::now();
+        size_t values = 0;
+        while (values < iterations) {
+            func();
+            values += kValueCount;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(values);
+    }
+
+    struct ErrorResult {
+        double sinError = 0.0;
+        double cosError = 0.0;
+    };
+
+    // [-range, range] を均等に刻んで最大絶対誤差を求める
+    ErrorResult MeasureError(float range, size_t samples) {
+        std::vector<float> x(samples), s(samples), c(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            x[i] = -range + 2.0f * range * static_cast<float>(i) / static_cast<float>(samples - 1);
+        }
+        FastMath::SinCosArray(x.data(), s.data(), c.data(), samples);
+
+        ErrorResult result;
+        for (size_t i = 0; i < samples; ++i) {
+            // スカラー版と SIMD 版で同じ結果になるかも確認する
+            float scalarSin, scalarCos;
+            FastMath::SinCos(x[i], scalarSin, scalarCos);
+            const double xd = static_cast<double>(x[i]);
+            result.sinError = (std::max)({ result.sinError, std::fabs(s[i] - std::sin(xd)), std::fabs(scalarSin - std::sin(xd)) });
+            result.cosError = (std::max)({ result.cosError, std::fabs(c[i] - std::cos(xd)), std::fabs(scalarCos - std::cos(xd)) });
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = 20'000'000;
+    if (argc > 1) {
+        iterations = static_cast<size_t>(std::strtoull(argv[1], nullptr, 10));
+    }
+
+    std::printf("%-16s %12s %12s %12s\n", "range", "libm_sin", "fast_sin", "fast_cos");
+    for (float range : { 3.14159265f, 100.0f, 8192.0f, 65536.0f }) {
+        const ErrorResult fast = MeasureError(range, 1'000'000);
+        double libmError = 0.0;
+        for (size_t i = 0; i < 1'000'000; i += 7) {
+            const float x = -range + 2.0f * range * static_cast<float>(i) / 999'999.0f;
+            libmError = (std::max)(libmError, std::fabs(std::sin(x) - std::sin(static_cast<double>(x))));
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "|x|<=%g", range);
+        std::printf("%-16s %12.3g %12.3g %12.3g\n", name, libmError, fast.sinError, fast.cosError);
+    }
+
+    std::mt19937 gen(2468);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::vector<float> x(kValueCount), s(kValueCount), c(kValueCount);
+    for (float& value : x) {
+        value = dist(gen);
+    }
+
+    std::printf("\n%-24s %10s\n", "sincos", "ns/value");
+    const double libmNs = MeasureNsPerValue(iterations, [&]() {
+        for (size_t i = 0; i < kValueCount; ++i) {
+            s[i] = std::sin(x[i]);
+            c[i] = std::cos(x[i]);
+        }
+        gSink = gSink + s[kValueCount / 2] + c[kValueCount / 3];
+        });
+    std::printf("%-24s %10.2f\n", "std::sin + std::cos", libmNs);
+
+    const double scalarNs = MeasureNsPerValue(iterations, [&]() {
+        for (size_t i = 0; i < kValueCount; ++i) {
+            FastMath::SinCos(x[i], s[i], c[i]);
+        }
+        gSink = gSink + s[kValueCount / 2] + c[kValueCount / 3];
+        });
+    std::printf("%-24s %10.2f\n", "FastMath::SinCos", scalarNs);
+
+    const double wide4Ns = MeasureNsPerValue(iterations, [&]() {
+        for (size_t i = 0; i < kValueCount; i += 4) {
+            FastMath::SinCos4(&x[i], &s[i], &c[i]);
+        }
+        gSink = gSink + s[kValueCount / 2] + c[kValueCount / 3];
+        });
+    std::printf("%-24s %10.2f\n", "FastMath::SinCos4", wide4Ns);
+
+    const double wide8Ns = MeasureNsPerValue(iterations, [&]() {
+        for (size_t i = 0; i < kValueCount; i += 8) {
+            FastMath::SinCos8(&x[i], &s[i], &c[i]);
+        }
+        gSink = gSink + s[kValueCount / 2] + c[kValueCount / 3];
+        });
+    std::printf("%-24s %10.2f\n", "FastMath::SinCos8", wide8Ns);
+
+    // 配列版は命令セットごとに計測する
+    const SimdLevel defaultLevel = GetSimdLevel();
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX }) {
+        if (level > GetMaxSimdLevel()) {
+            continue;
+        }
+        SetSimdLevel(level);
+        const double arrayNs = MeasureNsPerValue(iterations, [&]() {
+            FastMath::SinCosArray(x.data(), s.data(), c.data(), kValueCount);
+            gSink = gSink + s[kValueCount / 2] + c[kValueCount / 3];
+            });
+        const char* levelName = level == SimdLevel::AVX ? "AVX" : (level == SimdLevel::SSE2 ? "SSE2" : "Scalar");
+        char name[32];
+        std::snprintf(name, sizeof(name), "SinCosArray(%s)", levelName);
+        std::printf("%-24s %10.2f\n", name, arrayNs);
+    }
+    SetSimdLevel(defaultLevel);
+
+    return 0;
+}
@@ -0,0 +1,298 @@
+// GLB の読み込み (GltfLoader) のベンチマーク
+// 同じ球を OBJ と GLB で書き出し、ObjLoader と GltfLoader で読む時間と MB/s (ファイルの大きさ基準) を比べる
+//   open はファイルをマップして JSON を読み、POSITION の accessor を取るだけ (頂点はコピーしない) の時間
+// 三角形の角ごとの頂点 (位置・法線・UV) が OBJ と同じかと、ノードの変換 (平行移動・回転・拡大、鏡映) を焼き込んだ結果が
+// 手で計算したものと同じで、面の向き (巻き順) が OBJ と揃っているかも確かめる
+#include "GltfLoader.h"
+#include "MeshCache.h"
+#include "ObjLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    // 最適化で消されないように結果を集計する
+    volatile size_t gSink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 何度か繰り返し、最小の時間を採る
+    template<typename Function>
+    double MeasureMs(Function&& function, int repeat) {
+        double best = 1.0e30;
+        for (int i = 0; i < repeat; ++i) {
+            const auto start = Clock::now();
+            function();
+            best = (std::min)(best, ElapsedMs(start));
+        }
+        return best;
+    }
+
+    // 緯度・経度で分けた球 (文字にした値を読み直して、OBJ と GLB で同じ float にする)
+    struct Sphere {
+        // 1 頂点に位置 3・法線 3・UV 2 (GLB の並びのまま)
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        std::string objText;
+    };
+
+    Sphere MakeSphere(uint32_t segments) {
+        Sphere sphere;
+        char buffer[256];
+        const float pi = 3.14159265f;
+        sphere.objText = "# generated by gltf_bench\n";
+        for (uint32_t lat = 0; lat <= segments; ++lat) {
+            for (uint32_t lon = 0; lon <= segments; ++lon) {
+                const float theta = pi * static_cast<float>(lat) / static_cast<float>(segments);
+                const float phi = 2.0f * pi * static_cast<float>(lon) / static_cast<float>(segments);
+                const float x = std::sin(theta) * std::cos(phi);
+                const float y = std::cos(theta);
+                const float z = std::sin(theta) * std::sin(phi);
+                const float u = static_cast<float>(lon) / static_cast<float>(segments);
+                const float v = 1.0f - static_cast<float>(lat) / static_cast<float>(segments);
+                std::snprintf(buffer, sizeof(buffer), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.4f %.4f %.4f\n", x, y, z, u, v, x, y, z);
+                sphere.objText += buffer;
+
+                char* cursor = buffer + 2;
+                float values[8];
+                for (int i = 0; i < 8; ++i) {
+                    // "vt " / "vn " の分を読み飛ばす
+                    while (*cursor == '\n' || *cursor == 'v' || *cursor == 't' || *cursor == 'n' || *cursor == ' ') {
+                        ++cursor;
+                    }
+                    values[i] = std::strtof(cursor, &cursor);
+                }
+                // GLB の UV は左上が原点 (OBJ の読み込みと同じく 1 - v)
+                sphere.vertices.insert(sphere.vertices.end(), { values[0], values[1], values[2], values[5], values[6], values[7], values[3], 1.0f - values[4] });
+            }
+        }
+        const uint32_t rowSize = segments + 1;
+        for (uint32_t lat = 0; lat < segments; ++lat) {
+            for (uint32_t lon = 0; lon < segments; ++lon) {
+                const uint32_t a = lat * rowSize + lon;
+                const uint32_t b = a + rowSize;
+                const uint32_t c = a + 1;
+                const uint32_t d = b + 1;
+                std::snprintf(buffer, sizeof(buffer), "f %u/%u/%u %u/%u/%u %u/%u/%u\nf %u/%u/%u %u/%u/%u %u/%u/%u\n",
+                    a + 1, a + 1, a + 1, b + 1, b + 1, b + 1, c + 1, c + 1, c + 1, c + 1, c + 1, c + 1, b + 1, b + 1, b + 1, d + 1, d + 1, d + 1);
+                sphere.objText += buffer;
+                sphere.indices.insert(sphere.indices.end(), { a, b, c, c, b, d });
+            }
+        }
+        return sphere;
+    }
+
+    void AppendU32(std::string& out, uint32_t value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // 頂点は位置・法線・UV を交互に並べた 1 つの bufferView (byteStride 32)、頂点番号は uint32_t
+    // nodeJson はノード 0 の mesh 以外のメンバー
+    void WriteSphereGlb(const std::string& path, const Sphere& sphere, const std::string& nodeJson) {
+        const size_t vertexCount = sphere.vertices.size() / 8;
+        const size_t vertexBytes = sphere.vertices.size() * sizeof(float);
+        const size_t indexBytes = sphere.indices.size() * sizeof(uint32_t);
+        char json[2048];
+        std::snprintf(json, sizeof(json),
+            "{\"asset\":{\"version\":\"2.0\",\"generator\":\"gltf_bench\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+            "\"nodes\":[{\"mesh\":0%s}],"
+            "\"meshes\":[{\"name\":\"sphere\",\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3,\"material\":0}]}],"
+            "\"materials\":[{\"name\":\"white\",\"pbrMetallicRoughness\":{\"baseColorFactor\":[1,1,1,1]}}],"
+            "\"buffers\":[{\"byteLength\":%zu}],"
+            "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":%zu,\"byteStride\":32,\"target\":34962},"
+            "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu,\"target\":34963}],"
+            "\"accessors\":[{\"bufferView\":0,\"byteOffset\":0,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\",\"min\":[-1,-1,-1],\"max\":[1,1,1]},"
+            "{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\"},"
+            "{\"bufferView\":0,\"byteOffset\":24,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC2\"},"
+            "{\"bufferView\":1,\"componentType\":5125,\"count\":%zu,\"type\":\"SCALAR\"}]}",
+            nodeJson.c_str(), vertexBytes + indexBytes, vertexBytes, vertexBytes, indexBytes,
+            vertexCount, vertexCount, vertexCount, sphere.indices.size());
+
+        // チャンクは 4 バイト境界 (JSON は空白で詰める)
+        std::string jsonChunk = json;
+        jsonChunk.resize((jsonChunk.size() + 3) & ~size_t(3), ' ');
+        const size_t binaryLength = vertexBytes + indexBytes;
+        std::string out;
+        AppendU32(out, 0x46546c67);
+        AppendU32(out, 2);
+        AppendU32(out, static_cast<uint32_t>(12 + 8 + jsonChunk.size() + 8 + binaryLength));
+        AppendU32(out, static_cast<uint32_t>(jsonChunk.size()));
+        AppendU32(out, 0x4e4f534a);
+        out += jsonChunk;
+        AppendU32(out, static_cast<uint32_t>(binaryLength));
+        AppendU32(out, 0x004e4942);
+        out.append(reinterpret_cast<const char*>(sphere.vertices.data()), vertexBytes);
+        out.append(reinterpret_cast<const char*>(sphere.indices.data()), indexBytes);
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    }
+
+    bool IsNear(float a, float b) {
+        return std::fabs(a - b) <= 1.0e-4f * (std::max)(1.0f, std::fabs(a));
+    }
+
+    // 三角形の角ごとの頂点の比較 (頂点の並びや重複の除き方には依らない)
+    // expected は元の頂点から期待する頂点を作る
+    template<typename Expected>
+    bool IsSameCorners(const ModelData& actual, const ModelData& source, Expected&& expected) {
+        if (actual.indices.size() != source.indices.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < actual.indices.size(); ++i) {
+            const ModelData::VertexData& a = actual.vertices[actual.indices[i]];
+            const ModelData::VertexData e = expected(source.vertices[source.indices[i]]);
+            if (!IsNear(a.position.x, e.position.x) || !IsNear(a.position.y, e.position.y) || !IsNear(a.position.z, e.position.z) ||
+                a.position.w != e.position.w || !IsNear(a.normal.x, e.normal.x) || !IsNear(a.normal.y, e.normal.y) ||
+                !IsNear(a.normal.z, e.normal.z) || !IsNear(a.texcoord.x, e.texcoord.x) || !IsNear(a.texcoord.y, e.texcoord.y)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 面の法線 (巻き順から) が頂点の法線と同じ側を向いている三角形の数
+    size_t CountFrontFacing(const ModelData& data) {
+        size_t count = 0;
+        for (size_t i = 0; i + 2 < data.indices.size(); i += 3) {
+            const Vector4& p0 = data.vertices[data.indices[i]].position;
+            const Vector4& p1 = data.vertices[data.indices[i + 1]].position;
+            const Vector4& p2 = data.vertices[data.indices[i + 2]].position;
+            const Vector3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+            const Vector3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+            const Vector3 face = { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+            const Vector3& n = data.vertices[data.indices[i]].normal;
+            count += (face.x * n.x + face.y * n.y + face.z * n.z) > 0.0f ? 1 : 0;
+        }
+        return count;
+    }
+
+    double FileMegabytes(const std::string& path) {
+        return std::filesystem::file_size(path) / (1024.0 * 1024.0);
+    }
+
+    void Report(const std::string& directoryPath, uint32_t segments) {
+        const Sphere sphere = MakeSphere(segments);
+        const std::string objName = "gltf_bench_sphere.obj";
+        const std::string glbName = "gltf_bench_sphere.glb";
+        {
+            std::ofstream file(directoryPath + "/" + objName);
+            file << sphere.objText;
+        }
+        WriteSphereGlb(directoryPath + "/" + glbName, sphere, "");
+
+        const ModelData obj = ObjLoader::LoadObjFile(directoryPath, objName);
+        const ModelData glb = GltfLoader::LoadGlbFile(directoryPath, glbName);
+        const bool isSame = !glb.indices.empty() && IsSameCorners(glb, obj, [](const ModelData::VertexData& v) { return v; });
+        const bool isFacingSame = CountFrontFacing(glb) == CountFrontFacing(obj);
+
+        const int repeat = segments >= 512 ? 3 : 7;
+        const double objMs = MeasureMs([&]() { gSink = gSink + ObjLoader::LoadObjFile(directoryPath, objName).indices.size(); }, repeat);
+        const double glbMs = MeasureMs([&]() { gSink = gSink + GltfLoader::LoadGlbFile(directoryPath, glbName).indices.size(); }, repeat);
+        const double openMs = MeasureMs([&]() {
+            GltfLoader::GlbFile file;
+            GltfLoader::AccessorView positions;
+            if (file.Open(directoryPath + "/" + glbName) && file.GetAccessor(0, positions)) {
+                gSink = gSink + positions.count + positions.GetElement(positions.count - 1)[0];
+            }
+        }, repeat);
+
+        // 拡張子で選ばれ、キャッシュが書き出されること
+        const std::string cachePath = MeshCache::GetCachePath(directoryPath, glbName);
+        std::error_code error;
+        std::filesystem::remove(cachePath, error);
+        const ModelData imported = MeshCache::LoadModelFile(directoryPath, glbName);
+        // 頂点番号の後ろには詳細度の段の分が続くので、元のメッシュのサブメッシュで比べる
+        const bool isCached = imported.submeshes.size() == 1 && imported.submeshes[0].indexCount == glb.indices.size() &&
+            std::filesystem::exists(cachePath);
+
+        const double objMegabytes = FileMegabytes(directoryPath + "/" + objName);
+        const double glbMegabytes = FileMegabytes(directoryPath + "/" + glbName);
+        std::printf("sphere %-5u %9zu %8.2f %8.2f %9.3f %9.3f %9.3f %9.1f %9.1f %7.1fx %6s %6s %6s\n",
+            segments, obj.indices.size() / 3, objMegabytes, glbMegabytes, objMs, glbMs, openMs,
+            objMegabytes * 1000.0 / objMs, glbMegabytes * 1000.0 / glbMs, objMs / glbMs,
+            isSame ? "yes" : "NO", isFacingSame ? "yes" : "NO", isCached ? "yes" : "NO");
+
+        std::filesystem::remove(cachePath, error);
+        std::filesystem::remove(directoryPath + "/" + objName, error);
+        std::filesystem::remove(directoryPath + "/" + glbName, error);
+    }
+
+    // ノードの変換を焼き込んだ結果を、変換しない GLB から手で計算したものと比べる
+    void ReportNodeTransform(const std::string& directoryPath) {
+        const Sphere sphere = MakeSphere(32);
+        const std::string plainName = "gltf_bench_plain.glb";
+        const std::string trsName = "gltf_bench_trs.glb";
+        const std::string mirrorName = "gltf_bench_mirror.glb";
+        const std::string matrixName = "gltf_bench_matrix.glb";
+        WriteSphereGlb(directoryPath + "/" + plainName, sphere, "");
+        // y 軸まわりに 90 度回し、2 倍して (1, 2, 3) へ動かす
+        WriteSphereGlb(directoryPath + "/" + trsName, sphere,
+            ",\"translation\":[1,2,3],\"rotation\":[0,0.70710678,0,0.70710678],\"scale\":[2,2,2]");
+        WriteSphereGlb(directoryPath + "/" + mirrorName, sphere, ",\"scale\":[-1,1,1]");
+        // TRS と同じ変換を列優先の行列で
+        WriteSphereGlb(directoryPath + "/" + matrixName, sphere, ",\"matrix\":[0,0,-2,0, 0,2,0,0, 2,0,0,0, 1,2,3,1]");
+
+        const ModelData plain = GltfLoader::LoadGlbFile(directoryPath, plainName);
+        const ModelData trs = GltfLoader::LoadGlbFile(directoryPath, trsName);
+        const ModelData mirror = GltfLoader::LoadGlbFile(directoryPath, mirrorName);
+        const ModelData matrix = GltfLoader::LoadGlbFile(directoryPath, matrixName);
+
+        // glTF (右手系) の (x, y, z) は読み込み後 (-x, y, z)
+        // 回転後は (z, y, -x) なので、読み込み後の p からは (-(2 * p.z + 1), 2 * p.y + 2, 2 * p.x + 3)
+        const auto trsExpected = [](const ModelData::VertexData& v) {
+            ModelData::VertexData e = v;
+            e.position = { -(2.0f * v.position.z + 1.0f), 2.0f * v.position.y + 2.0f, 2.0f * v.position.x + 3.0f, 1.0f };
+            e.normal = { -v.normal.z, v.normal.y, v.normal.x };
+            return e;
+        };
+        const auto mirrorExpected = [](const ModelData::VertexData& v) {
+            ModelData::VertexData e = v;
+            e.position.x = -v.position.x;
+            e.normal.x = -v.normal.x;
+            return e;
+        };
+        const size_t facing = CountFrontFacing(plain);
+        std::printf("%-8s %6s %6s\n", "node", "same", "facing");
+        std::printf("%-8s %6s %6s\n", "trs", IsSameCorners(trs, plain, trsExpected) ? "yes" : "NO", CountFrontFacing(trs) == facing ? "yes" : "NO");
+        std::printf("%-8s %6s %6s\n", "matrix", IsSameCorners(matrix, plain, trsExpected) ? "yes" : "NO", CountFrontFacing(matrix) == facing ? "yes" : "NO");
+        // 鏡映では巻き順をそのままにするので、三角形の角の順を戻してから比べる
+        ModelData mirrorReordered = mirror;
+        for (size_t i = 0; i + 2 < mirrorReordered.indices.size(); i += 3) {
+            std::swap(mirrorReordered.indices[i], mirrorReordered.indices[i + 2]);
+        }
+        const bool isMirrorSame = IsSameCorners(mirrorReordered, plain, mirrorExpected);
+        std::printf("%-8s %6s %6s\n", "mirror", isMirrorSame ? "yes" : "NO", CountFrontFacing(mirror) == facing ? "yes" : "NO");
+
+        std::error_code error;
+        for (const std::string& name : { plainName, trsName, mirrorName, matrixName }) {
+            std::filesystem::remove(directoryPath + "/" + name, error);
+        }
+    }
+}
+
+int main() {
+    const std::string directoryPath = std::filesystem::temp_directory_path().string();
+
+    std::printf("%-12s %9s %8s %8s %9s %9s %9s %9s %9s %8s %6s %6s %6s\n",
+        "mesh", "triangles", "obj MB", "glb MB", "obj ms", "glb ms", "open ms", "obj MB/s", "glb MB/s", "speedup", "same", "facing", "cache");
+    for (uint32_t segments : { 64u, 256u, 512u }) {
+        Report(directoryPath, segments);
+    }
+    std::printf("\n");
+    ReportNodeTransform(directoryPath);
+    return gSink == 0xffffffff ? 1 : 0;
+}
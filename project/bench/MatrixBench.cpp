@@ -0,0 +1,364 @@
+// MatrixMath カーネルのマイクロベンチマーク
+// 各命令セットで Multipty / Inverse / Transpoce の ns/op とスカラー版との最大誤差を出力する
+// アフィン専用の逆行列は汎用 Inverse との最大誤差と ns/op を出力する
+// MakeAffineBatch は 1 個ずつ作る場合との ns/object と最大誤差を出力する
+// クォータニオンはオイラー角の MakeAffine との ns/op と最大誤差を出力する
+#include "FastMath.h"
+#include "Matrix4x4.h"
+#include "Matrix4x4Simd.h"
+#include "Quaternion.h"
+#include "TransformBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace MatrixMath;
+
+namespace {
+    constexpr size_t kMatrixCount = 1024;
+
+    const char* ToString(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX: return "AVX";
+        case SimdLevel::SSE2: return "SSE2";
+        default: return "Scalar";
+        }
+    }
+
+    // 逆行列を持つ (対角優位な) ランダム行列を作る
+    std::vector<Matrix4x4> MakeMatrices(size_t count) {
+        std::mt19937 gen(12345);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<Matrix4x4> matrices(count);
+        for (Matrix4x4& m : matrices) {
+            for (int row = 0; row < 4; ++row) {
+                for (int col = 0; col < 4; ++col) {
+                    m.m[row][col] = dist(gen);
+                }
+                m.m[row][row] += 4.0f;
+            }
+        }
+        return matrices;
+    }
+
+    // ランダムな SRT とそのアフィン行列を作る
+    std::vector<Transform> MakeTransforms(size_t count, bool isUnitScale) {
+        std::mt19937 gen(6789);
+        std::uniform_real_distribution<float> scaleDist(0.25f, 4.0f);
+        std::uniform_real_distribution<float> angleDist(-3.14159265f, 3.14159265f);
+        std::uniform_real_distribution<float> translateDist(-50.0f, 50.0f);
+        std::vector<Transform> transforms(count);
+        for (Transform& t : transforms) {
+            t.scale = isUnitScale ? Vector3{ 1.0f, 1.0f, 1.0f } : Vector3{ scaleDist(gen), scaleDist(gen), scaleDist(gen) };
+            t.rotate = { angleDist(gen), angleDist(gen), angleDist(gen) };
+            t.translate = { translateDist(gen), translateDist(gen), translateDist(gen) };
+        }
+        return transforms;
+    }
+
+    // 誤差評価用の倍精度逆行列 (部分ピボット選択付き掃き出し法)
+    Matrix4x4 InverseReference(const Matrix4x4& m) {
+        double aug[4][8] = {};
+        for (int row = 0; row < 4; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                aug[row][col] = m.m[row][col];
+            }
+            aug[row][row + 4] = 1.0;
+        }
+        for (int i = 0; i < 4; ++i) {
+            int pivotRow = i;
+            for (int j = i + 1; j < 4; ++j) {
+                if (std::fabs(aug[j][i]) > std::fabs(aug[pivotRow][i])) {
+                    pivotRow = j;
+                }
+            }
+            for (int k = 0; k < 8; ++k) {
+                std::swap(aug[i][k], aug[pivotRow][k]);
+            }
+            const double pivot = aug[i][i];
+            for (int k = 0; k < 8; ++k) {
+                aug[i][k] /= pivot;
+            }
+            for (int j = 0; j < 4; ++j) {
+                if (j != i) {
+                    const double factor = aug[j][i];
+                    for (int k = 0; k < 8; ++k) {
+                        aug[j][k] -= factor * aug[i][k];
+                    }
+                }
+            }
+        }
+        Matrix4x4 result;
+        for (int row = 0; row < 4; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                result.m[row][col] = static_cast<float>(aug[row][col + 4]);
+            }
+        }
+        return result;
+    }
+
+    float MaxAbsDiff(const Matrix4x4& a, const Matrix4x4& b) {
+        float maxDiff = 0.0f;
+        for (int row = 0; row < 4; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                maxDiff = (std::max)(maxDiff, std::fabs(a.m[row][col] - b.m[row][col]));
+            }
+        }
+        return maxDiff;
+    }
+
+    // 最適化で消されないように結果を集計する
+    volatile float gSink = 0.0f;
+
+    template <typename Func>
+    double MeasureNsPerOp(size_t iterations, Func&& func) {
+        // ウォームアップ
+        func(kMatrixCount);
+
+        const auto start = std::chrono::steady_clock::now();
+        size_t ops = 0;
+        while (ops < iterations) {
+            func(kMatrixCount);
+            ops += kMatrixCount;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = 2'000'000;
+    if (argc > 1) {
+        iterations = static_cast<size_t>(std::strtoull(argv[1], nullptr, 10));
+    }
+
+    const std::vector<Matrix4x4> lhs = MakeMatrices(kMatrixCount);
+    const std::vector<Matrix4x4> rhs = MakeMatrices(kMatrixCount + 1);
+    std::vector<Matrix4x4> out(kMatrixCount);
+
+    std::printf("max simd level: %s\n", ToString(GetMaxSimdLevel()));
+    std::printf("%-10s %-8s %10s %12s\n", "kernel", "level", "ns/op", "max_err");
+
+    const SimdLevel defaultLevel = GetSimdLevel();
+    for (int levelIndex = 0; levelIndex <= static_cast<int>(GetMaxSimdLevel()); ++levelIndex) {
+        const SimdLevel level = static_cast<SimdLevel>(levelIndex);
+        SetSimdLevel(level);
+
+        float errMultipty = 0.0f;
+        float errInverse = 0.0f;
+        float errTranspoce = 0.0f;
+        for (size_t i = 0; i < kMatrixCount; ++i) {
+            errMultipty = (std::max)(errMultipty, MaxAbsDiff(Multipty(lhs[i], rhs[i]), Kernels::MultiptyScalar(lhs[i], rhs[i])));
+            errInverse = (std::max)(errInverse, MaxAbsDiff(Inverse(lhs[i]), Kernels::InverseScalar(lhs[i])));
+            errTranspoce = (std::max)(errTranspoce, MaxAbsDiff(Transpoce(lhs[i]), Kernels::TranspoceScalar(lhs[i])));
+        }
+
+        const double multiptyNs = MeasureNsPerOp(iterations, [&](size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = Multipty(lhs[i], rhs[i]);
+            }
+            gSink = gSink + out[count / 2].m[1][2];
+            });
+        const double inverseNs = MeasureNsPerOp(iterations, [&](size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = Inverse(lhs[i]);
+            }
+            gSink = gSink + out[count / 2].m[1][2];
+            });
+        const double transpoceNs = MeasureNsPerOp(iterations, [&](size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = Transpoce(lhs[i]);
+            }
+            gSink = gSink + out[count / 2].m[1][2];
+            });
+
+        std::printf("%-10s %-8s %10.2f %12.3g\n", "Multipty", ToString(level), multiptyNs, errMultipty);
+        std::printf("%-10s %-8s %10.2f %12.3g\n", "Inverse", ToString(level), inverseNs, errInverse);
+        std::printf("%-10s %-8s %10.2f %12.3g\n", "Transpoce", ToString(level), transpoceNs, errTranspoce);
+    }
+    SetSimdLevel(defaultLevel);
+
+    // アフィン専用の逆行列 (基準は汎用の Inverse / Transpoce)
+    const std::vector<Transform> transforms = MakeTransforms(kMatrixCount, false);
+    const std::vector<Transform> rigidTransforms = MakeTransforms(kMatrixCount, true);
+    std::vector<Matrix4x4> worlds(kMatrixCount);
+    std::vector<Matrix4x4> rigidWorlds(kMatrixCount);
+    for (size_t i = 0; i < kMatrixCount; ++i) {
+        worlds[i] = MakeAffine(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+        rigidWorlds[i] = MakeAffine(rigidTransforms[i].scale, rigidTransforms[i].rotate, rigidTransforms[i].translate);
+    }
+
+    // 誤差は倍精度の逆行列を基準にし、比較のため現在の Inverse の誤差も出す
+    float errInverse = 0.0f;
+    float errInverseAffine = 0.0f;
+    float errInverseAffineSrt = 0.0f;
+    float errInverseRigid = 0.0f;
+    float errInverseTranspose = 0.0f;
+    for (size_t i = 0; i < kMatrixCount; ++i) {
+        const Transform& t = transforms[i];
+        const Matrix4x4 reference = InverseReference(worlds[i]);
+        const Matrix4x4 referenceTranspose = Transpoce(reference);
+        errInverse = (std::max)(errInverse, MaxAbsDiff(Inverse(worlds[i]), reference));
+        errInverseAffine = (std::max)(errInverseAffine, MaxAbsDiff(InverseAffine(worlds[i]), reference));
+        errInverseAffineSrt = (std::max)(errInverseAffineSrt, MaxAbsDiff(InverseAffine(t.scale, t.rotate, t.translate), reference));
+        errInverseTranspose = (std::max)(errInverseTranspose, MaxAbsDiff(InverseTransposeAffine(worlds[i]), referenceTranspose));
+        errInverseRigid = (std::max)(errInverseRigid, MaxAbsDiff(InverseRigid(rigidWorlds[i]), InverseReference(rigidWorlds[i])));
+    }
+
+    const double inverseTransposeNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Transpoce(Inverse(worlds[i]));
+        }
+        gSink = gSink + out[count / 2].m[1][2];
+        });
+    const double inverseAffineNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = InverseAffine(worlds[i]);
+        }
+        gSink = gSink + out[count / 2].m[1][2];
+        });
+    const double inverseRigidNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = InverseRigid(rigidWorlds[i]);
+        }
+        gSink = gSink + out[count / 2].m[1][2];
+        });
+    const double inverseTransposeAffineNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = InverseTransposeAffine(worlds[i]);
+        }
+        gSink = gSink + out[count / 2].m[1][2];
+        });
+
+    std::printf("\n%-26s %10s %12s\n", "affine kernel", "ns/op", "max_err");
+    std::printf("%-26s %10.2f %12.3g\n", "Transpoce(Inverse(m))", inverseTransposeNs, errInverse);
+    std::printf("%-26s %10.2f %12.3g\n", "InverseAffine(m)", inverseAffineNs, errInverseAffine);
+    std::printf("%-26s %10s %12.3g\n", "InverseAffine(srt)", "-", errInverseAffineSrt);
+    std::printf("%-26s %10.2f %12.3g\n", "InverseRigid(m)", inverseRigidNs, errInverseRigid);
+    std::printf("%-26s %10.2f %12.3g\n", "InverseTransposeAffine(m)", inverseTransposeAffineNs, errInverseTranspose);
+
+    // World / WVP / WorldInverseTranspose を 1 個ずつ作る場合とまとめて作る場合
+    struct TransformationMatrix {
+        Matrix4x4 WVP;
+        Matrix4x4 World;
+        Matrix4x4 WorldInverseTranspose;
+    };
+    const Matrix4x4 viewProjection = MakeMatrices(1)[0];
+    TransformSoA soa;
+    soa.Reserve(kMatrixCount);
+    for (const Transform& t : transforms) {
+        soa.PushBack(t);
+    }
+    std::vector<TransformationMatrix> expected(kMatrixCount);
+    std::vector<TransformationMatrix> batched(kMatrixCount);
+    AffineBatchOutput batchOutput;
+    batchOutput.wvps = { &batched[0].WVP, sizeof(TransformationMatrix) };
+    batchOutput.worlds = { &batched[0].World, sizeof(TransformationMatrix) };
+    batchOutput.worldInverseTransposes = { &batched[0].WorldInverseTranspose, sizeof(TransformationMatrix) };
+
+    const double perObjectNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const Transform& t = transforms[i];
+            TransformationMatrix& m = expected[i];
+            m.World = MakeAffine(t.scale, t.rotate, t.translate);
+            m.WVP = Multipty(m.World, viewProjection);
+            m.WorldInverseTranspose = InverseTransposeAffine(m.World);
+        }
+        gSink = gSink + expected[count / 2].WVP.m[1][2];
+        });
+
+    std::printf("\n%-26s %10s %12s\n", "transform batch", "ns/object", "max_err");
+    std::printf("%-26s %10.2f %12s\n", "per-object", perObjectNs, "-");
+    // 回転の sin / cos は FastMath の精度の設定に従う (Standard は 1 個ずつ作る場合と同じ std::sin / std::cos)
+    const FastMath::TrigPrecision defaultPrecision = FastMath::GetTrigPrecision();
+    for (FastMath::TrigPrecision precision : { FastMath::TrigPrecision::Standard, FastMath::TrigPrecision::Fast }) {
+        FastMath::SetTrigPrecision(precision);
+        for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2 }) {
+            if (level > GetMaxSimdLevel()) {
+                continue;
+            }
+            SetSimdLevel(level);
+            const double batchNs = MeasureNsPerOp(iterations, [&](size_t count) {
+                MakeAffineBatch(soa.GetStreams(), &viewProjection, nullptr, batchOutput);
+                gSink = gSink + batched[count / 2].WVP.m[1][2];
+                });
+            float errBatch = 0.0f;
+            for (size_t i = 0; i < kMatrixCount; ++i) {
+                errBatch = (std::max)(errBatch, MaxAbsDiff(batched[i].World, expected[i].World));
+                errBatch = (std::max)(errBatch, MaxAbsDiff(batched[i].WVP, expected[i].WVP));
+                errBatch = (std::max)(errBatch, MaxAbsDiff(batched[i].WorldInverseTranspose, expected[i].WorldInverseTranspose));
+            }
+            char name[40];
+            std::snprintf(name, sizeof(name), "MakeAffineBatch(%s,%s)", ToString(level),
+                precision == FastMath::TrigPrecision::Fast ? "fast" : "std");
+            std::printf("%-26s %10.2f %12.3g\n", name, batchNs, errBatch);
+        }
+    }
+    FastMath::SetTrigPrecision(defaultPrecision);
+    SetSimdLevel(defaultLevel);
+
+    // クォータニオン (基準はオイラー角から作った行列)
+    std::vector<QuaternionTransform> quaternionTransforms(kMatrixCount);
+    float errQuaternionAffine = 0.0f;
+    float errQuaternionMultiply = 0.0f;
+    float errSlerp = 0.0f;
+    for (size_t i = 0; i < kMatrixCount; ++i) {
+        quaternionTransforms[i] = QuaternionMath::MakeQuaternionTransform(transforms[i]);
+    }
+    for (size_t i = 0; i < kMatrixCount; ++i) {
+        errQuaternionAffine = (std::max)(errQuaternionAffine, MaxAbsDiff(QuaternionMath::MakeAffine(quaternionTransforms[i]), worlds[i]));
+
+        // 積の順序が行列の積と対応しているか
+        const Quaternion& q0 = quaternionTransforms[i].rotate;
+        const Quaternion& q1 = quaternionTransforms[(i + 1) % kMatrixCount].rotate;
+        errQuaternionMultiply = (std::max)(errQuaternionMultiply, MaxAbsDiff(
+            QuaternionMath::MakeRotateMatrix(QuaternionMath::Multiply(q0, q1)),
+            Multipty(QuaternionMath::MakeRotateMatrix(q1), QuaternionMath::MakeRotateMatrix(q0))));
+
+        // 端点と正規性
+        errSlerp = (std::max)(errSlerp, MaxAbsDiff(
+            QuaternionMath::MakeRotateMatrix(QuaternionMath::Slerp(q0, q1, 1.0f)), QuaternionMath::MakeRotateMatrix(q1)));
+        errSlerp = (std::max)(errSlerp, std::fabs(QuaternionMath::Norm(QuaternionMath::Slerp(q0, q1, 0.3f)) - 1.0f));
+    }
+
+    const double eulerAffineNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const Transform& t = transforms[i];
+            out[i] = MakeAffine(t.scale, t.rotate, t.translate);
+        }
+        gSink = gSink + out[count / 2].m[1][2];
+        });
+    const double quaternionAffineNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = QuaternionMath::MakeAffine(quaternionTransforms[i]);
+        }
+        gSink = gSink + out[count / 2].m[1][2];
+        });
+    std::vector<Quaternion> interpolated(kMatrixCount);
+    const double slerpNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            interpolated[i] = QuaternionMath::Slerp(quaternionTransforms[i].rotate, quaternionTransforms[count - 1 - i].rotate, 0.3f);
+        }
+        gSink = gSink + interpolated[count / 2].x;
+        });
+    const double nlerpNs = MeasureNsPerOp(iterations, [&](size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            interpolated[i] = QuaternionMath::Nlerp(quaternionTransforms[i].rotate, quaternionTransforms[count - 1 - i].rotate, 0.3f);
+        }
+        gSink = gSink + interpolated[count / 2].x;
+        });
+
+    std::printf("\n%-26s %10s %12s\n", "quaternion", "ns/op", "max_err");
+    std::printf("%-26s %10.2f %12s\n", "MakeAffine(euler)", eulerAffineNs, "-");
+    std::printf("%-26s %10.2f %12.3g\n", "MakeAffine(quaternion)", quaternionAffineNs, errQuaternionAffine);
+    std::printf("%-26s %10s %12.3g\n", "Multiply", "-", errQuaternionMultiply);
+    std::printf("%-26s %10.2f %12.3g\n", "Slerp", slerpNs, errSlerp);
+    std::printf("%-26s %10.2f %12s\n", "Nlerp", nlerpNs, "-");
+
+    return 0;
+}
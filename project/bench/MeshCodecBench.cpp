@@ -0,0 +1,188 @@
+// 頂点・頂点番号の圧縮 (MeshCodec) の縮み具合と復元の速さのベンチマーク
+// 取り込み時と同じく並べ替え・塊・詳細度の段を作ったメッシュで、元の大きさに対する割合と復元の GB/s (復元後の大きさ) を出力する
+// 比較として memcpy の GB/s と、MeshCache に縮めずに / 縮めて書いた場合のファイルの大きさと読み込み時間も出力する
+#include "MeshCache.h"
+#include "MeshCodec.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+#include "PrimitiveGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    // 最適化で消されないように結果を集計する
+    volatile size_t gSink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 1 回が短いものは何度か繰り返し、最小の時間を採る
+    template<typename Function>
+    double MeasureMs(Function&& function) {
+        double best = 1.0e30;
+        for (int i = 0; i < 7; ++i) {
+            const auto start = Clock::now();
+            int repeat = 0;
+            do {
+                function();
+                ++repeat;
+            } while (ElapsedMs(start) < 5.0);
+            best = (std::min)(best, ElapsedMs(start) / repeat);
+        }
+        return best;
+    }
+
+    double GigabytesPerSecond(size_t bytes, double ms) {
+        return static_cast<double>(bytes) / (ms * 1.0e6);
+    }
+
+    // 取り込み時と同じ処理をしておく (キャッシュに書かれるのはこの結果)
+    ModelData Prepare(ModelData data) {
+        if (data.materials.empty()) {
+            data.materials.emplace_back();
+        }
+        MeshOptimizer::Optimize(data);
+        MeshletBuilder::Build(data);
+        MeshSimplifier::BuildLodChain(data);
+        return data;
+    }
+
+    void Report(const char* name, const ModelData& data) {
+        const size_t vertexStride = sizeof(ModelData::VertexData);
+        const size_t vertexBytes = vertexStride * data.vertices.size();
+        const size_t indexBytes = sizeof(uint32_t) * data.indices.size();
+
+        std::vector<uint8_t> vertexBlob;
+        std::vector<uint8_t> indexBlob;
+        MeshCodec::EncodeVertexBuffer(vertexBlob, data.vertices.data(), data.vertices.size(), vertexStride);
+        MeshCodec::EncodeIndexBuffer(indexBlob, data.indices.data(), data.indices.size());
+
+        std::vector<ModelData::VertexData> vertices(data.vertices.size());
+        std::vector<uint32_t> indices(data.indices.size());
+        bool isSame = MeshCodec::DecodeVertexBuffer(vertices.data(), vertices.size(), vertexStride, vertexBlob.data(), vertexBlob.size()) &&
+            MeshCodec::DecodeIndexBuffer(indices.data(), indices.size(), indexBlob.data(), indexBlob.size());
+        isSame = isSame && std::memcmp(vertices.data(), data.vertices.data(), vertexBytes) == 0 && indices == data.indices;
+        // 途中で切れたデータは受け付けないこと
+        if (vertexBlob.size() > 1) {
+            isSame = isSame && !MeshCodec::DecodeVertexBuffer(vertices.data(), vertices.size(), vertexStride, vertexBlob.data(), vertexBlob.size() - 1);
+        }
+
+        const double vertexMs = MeasureMs([&]() {
+            MeshCodec::DecodeVertexBuffer(vertices.data(), vertices.size(), vertexStride, vertexBlob.data(), vertexBlob.size());
+            gSink = gSink + vertices[0].position.x;
+        });
+        const double indexMs = MeasureMs([&]() {
+            MeshCodec::DecodeIndexBuffer(indices.data(), indices.size(), indexBlob.data(), indexBlob.size());
+            gSink = gSink + indices.back();
+        });
+        const double copyMs = MeasureMs([&]() {
+            std::memcpy(vertices.data(), data.vertices.data(), vertexBytes);
+            gSink = gSink + vertices[0].position.x;
+        });
+        const double encodeMs = MeasureMs([&]() {
+            std::vector<uint8_t> blob;
+            MeshCodec::EncodeVertexBuffer(blob, data.vertices.data(), data.vertices.size(), vertexStride);
+            MeshCodec::EncodeIndexBuffer(blob, data.indices.data(), data.indices.size());
+            gSink = gSink + blob.size();
+        });
+
+        const double triangleCount = static_cast<double>(data.indices.size()) / 3.0;
+        std::printf("%-16s %9zu %9zu %9.1f %8.1f%% %8.2f %8.1f%% %8.1f%% %9.2f %9.2f %9.2f %9.2f %6s\n",
+            name, data.vertices.size(), data.indices.size(), (vertexBytes + indexBytes) / 1024.0,
+            100.0 * vertexBlob.size() / vertexBytes, indexBlob.size() / triangleCount, 100.0 * indexBlob.size() / indexBytes,
+            100.0 * (vertexBlob.size() + indexBlob.size()) / (vertexBytes + indexBytes),
+            GigabytesPerSecond(vertexBytes, vertexMs), GigabytesPerSecond(indexBytes, indexMs), GigabytesPerSecond(vertexBytes, copyMs),
+            encodeMs, isSame ? "yes" : "NO");
+    }
+
+    // MeshCache に書いて読む (依存ファイルは一時ディレクトリに置いた小さなファイル)
+    void ReportCache(const char* name, const ModelData& data) {
+        const std::string directoryPath = std::filesystem::temp_directory_path().string();
+        const std::string sourceName = "codec_bench_source.txt";
+        {
+            std::ofstream source(directoryPath + "/" + sourceName);
+            source << name;
+        }
+        const std::vector<std::string> dependencies{ sourceName };
+        uint64_t sourceHash = 0;
+        MeshCache::HashSourceFiles(directoryPath, dependencies, sourceHash);
+
+        const std::string cachePath = directoryPath + "/codec_bench.meshcache";
+        double fileKilobytes[2] = {};
+        double readMs[2] = {};
+        bool isSame = true;
+        const MeshCache::Compression compressions[2] = { MeshCache::Compression::kNone, MeshCache::Compression::kMeshCodec };
+        for (int i = 0; i < 2; ++i) {
+            MeshCache::Write(cachePath, directoryPath, data, dependencies, sourceHash, compressions[i]);
+            fileKilobytes[i] = std::filesystem::file_size(cachePath) / 1024.0;
+            ModelData loaded;
+            isSame = isSame && MeshCache::Read(cachePath, directoryPath, loaded) && loaded.indices == data.indices &&
+                loaded.vertices.size() == data.vertices.size() &&
+                std::memcmp(loaded.vertices.data(), data.vertices.data(), sizeof(ModelData::VertexData) * data.vertices.size()) == 0;
+            readMs[i] = MeasureMs([&]() {
+                ModelData result;
+                MeshCache::Read(cachePath, directoryPath, result);
+                gSink = gSink + result.vertices.size();
+            });
+        }
+        std::printf("%-16s %10.1f %10.1f %8.1f%% %10.3f %10.3f %6s\n", name, fileKilobytes[0], fileKilobytes[1],
+            100.0 * fileKilobytes[1] / fileKilobytes[0], readMs[0], readMs[1], isSame ? "yes" : "NO");
+
+        std::error_code error;
+        std::filesystem::remove(cachePath, error);
+        std::filesystem::remove(directoryPath + "/" + sourceName, error);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string resourceDirectory = "resources/obj";
+    if (argc > 1) {
+        resourceDirectory = argv[1];
+    }
+
+    struct Mesh {
+        std::string name;
+        ModelData data;
+    };
+    std::vector<Mesh> meshes;
+    const char* const bundledNames[] = { "axis", "fence", "multiMaterial", "multiMesh", "plane" };
+    for (const char* name : bundledNames) {
+        const std::string directoryPath = resourceDirectory + "/" + name;
+        if (std::filesystem::exists(directoryPath + "/" + name + ".obj")) {
+            meshes.push_back({ name, Prepare(ObjLoader::LoadObjFile(directoryPath, std::string(name) + ".obj")) });
+        }
+    }
+    meshes.push_back({ "sphere 64", Prepare(PrimitiveGenerator::CreateSphereData(64)) });
+    meshes.push_back({ "torus 128x64", Prepare(PrimitiveGenerator::CreateTorusData(128, 64)) });
+    meshes.push_back({ "cylinder 256", Prepare(PrimitiveGenerator::CreateCylinderData(256)) });
+    meshes.push_back({ "sphere 256", Prepare(PrimitiveGenerator::CreateSphereData(256)) });
+    meshes.push_back({ "sphere 1024", Prepare(PrimitiveGenerator::CreateSphereData(1024)) });
+    // 並べ替えをしていない場合 (頂点番号の差が大きくなる)
+    ModelData raw = PrimitiveGenerator::CreateSphereData(256);
+    raw.materials.emplace_back();
+    meshes.push_back({ "sphere 256 raw", raw });
+
+    std::printf("%-16s %9s %9s %9s %9s %8s %9s %9s %9s %9s %9s %9s %6s\n",
+        "mesh", "vertices", "indices", "raw KB", "vertex", "idx B/tri", "index", "total", "vtx GB/s", "idx GB/s", "copy GB/s", "enc ms", "same");
+    for (const Mesh& mesh : meshes) {
+        Report(mesh.name.c_str(), mesh.data);
+    }
+
+    std::printf("\n%-16s %10s %10s %9s %10s %10s %6s\n", "mesh cache", "none KB", "codec KB", "ratio", "none ms", "codec ms", "same");
+    for (const Mesh& mesh : meshes) {
+        ReportCache(mesh.name.c_str(), mesh.data);
+    }
+    return gSink == 0xffffffff ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+// 頂点の重複除去 (インデックス化) でどれだけ頂点とメモリが減るかを出力する
+// 以前の描画は三角形の頂点をそのまま並べていたので、その頂点数 (= 頂点番号の数) と比べる
+// GPU に置くバイト数は Model と同じく、頂点が 65535 個以下なら 16 ビットの頂点番号で数える
+#include "ObjLoader.h"
+#include "PrimitiveGenerator.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+namespace {
+    struct Total {
+        size_t flatBytes = 0;
+        size_t indexedBytes = 0;
+    };
+
+    void Report(const char* name, const ModelData& data, Total& total) {
+        const size_t flatVertexCount = data.indices.size();
+        const size_t indexSize = data.vertices.size() <= 0xffff ? sizeof(uint16_t) : sizeof(uint32_t);
+        const size_t flatBytes = flatVertexCount * sizeof(ModelData::VertexData);
+        const size_t indexedBytes = data.vertices.size() * sizeof(ModelData::VertexData) + data.indices.size() * indexSize;
+        total.flatBytes += flatBytes;
+        total.indexedBytes += indexedBytes;
+
+        std::printf("%-20s %10zu %10zu %7.1f%% %12zu %12zu %7.1f%%\n",
+            name, flatVertexCount, data.vertices.size(),
+            flatVertexCount ? 100.0 * (1.0 - static_cast<double>(data.vertices.size()) / static_cast<double>(flatVertexCount)) : 0.0,
+            flatBytes, indexedBytes,
+            flatBytes ? 100.0 * (1.0 - static_cast<double>(indexedBytes) / static_cast<double>(flatBytes)) : 0.0);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string resourceDirectory = "resources/obj";
+    if (argc > 1) {
+        resourceDirectory = argv[1];
+    }
+
+    std::printf("%-20s %10s %10s %8s %12s %12s %8s\n",
+        "mesh", "flat vtx", "unique vtx", "vtx -", "flat bytes", "idx bytes", "bytes -");
+
+    Total total;
+    for (const char* name : { "axis", "fence", "multiMaterial", "multiMesh", "plane" }) {
+        const std::string directoryPath = resourceDirectory + "/" + name;
+        const std::string filename = std::string(name) + ".obj";
+        if (!std::filesystem::exists(directoryPath + "/" + filename)) {
+            std::printf("%-20s (not found)\n", name);
+            continue;
+        }
+        Report(name, ObjLoader::LoadObjFile(directoryPath, filename), total);
+    }
+
+    // 基本図形は Model::Create*Data の既定の分割数で作る
+    Report("sphere", PrimitiveGenerator::CreateSphereData(), total);
+    Report("plane (primitive)", PrimitiveGenerator::CreatePlaneData(), total);
+    Report("circle", PrimitiveGenerator::CreateCircleData(), total);
+    Report("ring", PrimitiveGenerator::CreateRingData(), total);
+    Report("torus", PrimitiveGenerator::CreateTorusData(), total);
+    Report("cylinder", PrimitiveGenerator::CreateCylinderData(), total);
+    Report("effect cylinder", PrimitiveGenerator::CreateEffectCylinderData(), total);
+    Report("cone", PrimitiveGenerator::CreateConeData(), total);
+    Report("triangle", PrimitiveGenerator::CreateTriangleData(), total);
+    Report("box", PrimitiveGenerator::CreateBoxData(), total);
+
+    std::printf("%-20s %10s %10s %8s %12zu %12zu %7.1f%%\n", "total", "", "", "",
+        total.flatBytes, total.indexedBytes,
+        total.flatBytes ? 100.0 * (1.0 - static_cast<double>(total.indexedBytes) / static_cast<double>(total.flatBytes)) : 0.0);
+    return 0;
+}
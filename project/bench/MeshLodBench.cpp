@@ -0,0 +1,152 @@
+// 詳細度の段 (MeshSimplifier) の三角形の数・誤差・作る時間と、距離による段の選択 (LodSelection) を出力する
+// 選択は球を遠ざけてから近づけ、段が切り替わる距離が行きと帰りでずれる (ちらつかない) ことを確かめる
+#include "LodSelection.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+#include "PrimitiveGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+    // 頂点を包む球の半径 (AABB の中心から)
+    float ComputeRadius(const ModelData& data) {
+        Vector3 minimum = { 1.0e30f, 1.0e30f, 1.0e30f };
+        Vector3 maximum = { -1.0e30f, -1.0e30f, -1.0e30f };
+        for (const ModelData::VertexData& vertex : data.vertices) {
+            minimum = { (std::min)(minimum.x, vertex.position.x), (std::min)(minimum.y, vertex.position.y), (std::min)(minimum.z, vertex.position.z) };
+            maximum = { (std::max)(maximum.x, vertex.position.x), (std::max)(maximum.y, vertex.position.y), (std::max)(maximum.z, vertex.position.z) };
+        }
+        const Vector3 center = { (minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f };
+        float radiusSq = 0.0f;
+        for (const ModelData::VertexData& vertex : data.vertices) {
+            const float dx = vertex.position.x - center.x, dy = vertex.position.y - center.y, dz = vertex.position.z - center.z;
+            radiusSq = (std::max)(radiusSq, dx * dx + dy * dy + dz * dz);
+        }
+        return std::sqrt(radiusSq);
+    }
+
+    // 段の頂点番号が範囲内で、潰れた三角形が無いか
+    bool IsValid(const ModelData& data, const std::vector<ModelData::Submesh>& submeshes) {
+        for (const ModelData::Submesh& submesh : submeshes) {
+            if (submesh.indexCount % 3 != 0 || submesh.indexStart + submesh.indexCount > data.indices.size()) {
+                return false;
+            }
+            for (uint32_t i = submesh.indexStart; i < submesh.indexStart + submesh.indexCount; i += 3) {
+                const uint32_t v0 = data.indices[i], v1 = data.indices[i + 1], v2 = data.indices[i + 2];
+                if (v0 >= data.vertices.size() || v1 >= data.vertices.size() || v2 >= data.vertices.size() ||
+                    v0 == v1 || v1 == v2 || v0 == v2) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    size_t CountTriangles(const std::vector<ModelData::Submesh>& submeshes, size_t fallbackIndexCount) {
+        if (submeshes.empty()) {
+            return fallbackIndexCount / 3;
+        }
+        size_t count = 0;
+        for (const ModelData::Submesh& submesh : submeshes) {
+            count += submesh.indexCount / 3;
+        }
+        return count;
+    }
+
+    void Report(const char* name, ModelData data) {
+        MeshOptimizer::Optimize(data);
+        const size_t baseIndexCount = data.indices.size();
+        const auto start = std::chrono::steady_clock::now();
+        MeshSimplifier::BuildLodChain(data);
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const float radius = ComputeRadius(data);
+        const size_t baseTriangleCount = CountTriangles(data.submeshes, baseIndexCount);
+        std::printf("%-16s %4s %10zu %8s %10s %10s %9.2f\n", name, "0", baseTriangleCount, "100.0%", "0", "0", milliseconds);
+        for (size_t i = 0; i < data.lods.size(); ++i) {
+            const ModelData::Lod& lod = data.lods[i];
+            const size_t triangleCount = CountTriangles(lod.submeshes, 0);
+            std::printf("%-16s %4zu %10zu %7.1f%% %10.3g %9.3f%% %9s %s\n", "", i + 1, triangleCount,
+                100.0 * static_cast<double>(triangleCount) / static_cast<double>(baseTriangleCount),
+                lod.error, radius > 0.0f ? 100.0 * lod.error / radius : 0.0, "", IsValid(data, lod.submeshes) ? "" : "INVALID");
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string resourceDirectory = "resources/obj";
+    if (argc > 1) {
+        resourceDirectory = argv[1];
+    }
+
+    std::printf("%-16s %4s %10s %8s %10s %10s %9s\n", "mesh", "lod", "triangles", "ratio", "error", "err/radius", "build ms");
+    for (const char* name : { "axis", "fence", "multiMaterial", "multiMesh", "plane" }) {
+        const std::string directoryPath = resourceDirectory + "/" + name;
+        const std::string filename = std::string(name) + ".obj";
+        if (!std::filesystem::exists(directoryPath + "/" + filename)) {
+            std::printf("%-16s (not found)\n", name);
+            continue;
+        }
+        Report(name, ObjLoader::LoadObjFile(directoryPath, filename));
+    }
+    Report("sphere", PrimitiveGenerator::CreateSphereData());
+    Report("torus", PrimitiveGenerator::CreateTorusData());
+    Report("cylinder", PrimitiveGenerator::CreateCylinderData());
+    Report("sphere 64", PrimitiveGenerator::CreateSphereData(64));
+    Report("torus 128x64", PrimitiveGenerator::CreateTorusData(128, 64));
+    Report("sphere 256", PrimitiveGenerator::CreateSphereData(256));
+
+    // 半径 1 の球 (分割 64) を 2 〜 200 まで遠ざけてから戻す (縦 720 ピクセル、縦の画角 0.45 ラジアン)
+    ModelData sphere = PrimitiveGenerator::CreateSphereData(64);
+    MeshOptimizer::Optimize(sphere);
+    MeshSimplifier::BuildLodChain(sphere);
+    std::vector<float> lodErrors{ 0.0f };
+    std::vector<size_t> lodTriangles{ CountTriangles(sphere.submeshes, sphere.indices.size()) };
+    for (const ModelData::Lod& lod : sphere.lods) {
+        lodErrors.push_back(lod.error);
+        lodTriangles.push_back(CountTriangles(lod.submeshes, 0));
+    }
+    const float radius = ComputeRadius(sphere);
+    const float tanHalfFovY = std::tan(0.45f * 0.5f);
+    const float viewportHeight = 720.0f;
+
+    std::printf("\nsphere 64 switching distances (max pixel error 1, hysteresis 0.25)\n%8s %12s %12s\n", "lod", "going out", "coming back");
+    std::vector<float> outDistances(lodErrors.size(), 0.0f);
+    std::vector<float> backDistances(lodErrors.size(), 0.0f);
+    uint32_t lod = 0;
+    size_t fullTriangles = 0;
+    size_t drawnTriangles = 0;
+    for (int step = 0; step <= 1980; ++step) {
+        const float distance = 2.0f + 0.1f * static_cast<float>(step);
+        const float projectedRadius = LodSelection::ComputeProjectedRadius({ 0.0f, 0.0f, distance }, radius, { 0.0f, 0.0f, 0.0f }, tanHalfFovY, viewportHeight);
+        const uint32_t next = LodSelection::Select(lodErrors.data(), lodErrors.size(), projectedRadius / radius, lod);
+        if (next > lod) {
+            outDistances[next] = distance;
+        }
+        lod = next;
+        fullTriangles += lodTriangles[0];
+        drawnTriangles += lodTriangles[lod];
+    }
+    for (int step = 1980; step >= 0; --step) {
+        const float distance = 2.0f + 0.1f * static_cast<float>(step);
+        const float projectedRadius = LodSelection::ComputeProjectedRadius({ 0.0f, 0.0f, distance }, radius, { 0.0f, 0.0f, 0.0f }, tanHalfFovY, viewportHeight);
+        const uint32_t next = LodSelection::Select(lodErrors.data(), lodErrors.size(), projectedRadius / radius, lod);
+        if (next < lod) {
+            backDistances[lod] = distance;
+        }
+        lod = next;
+    }
+    for (size_t i = 1; i < lodErrors.size(); ++i) {
+        std::printf("%8zu %12.1f %12.1f\n", i, outDistances[i], backDistances[i]);
+    }
+    std::printf("triangles drawn over the sweep: %.1f%% of always drawing lod 0\n",
+        100.0 * static_cast<double>(drawnTriangles) / static_cast<double>(fullTriangles));
+    return 0;
+}
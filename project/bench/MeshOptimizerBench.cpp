@@ -0,0 +1,106 @@
+// 取り込み時の並べ替え (MeshOptimizer) の前後の ACMR / ATVR と、かかった時間を出力する
+// 同梱の OBJ と基本図形に加えて、三角形の順番を混ぜた細かい球 (最悪に近い入力) でも測る
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "PrimitiveGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+
+namespace {
+    // 並べ替えで三角形の集合 (各三角形の頂点の中身) が変わっていないか
+    bool HasSameTriangles(const ModelData& a, const ModelData& b) {
+        if (a.indices.size() != b.indices.size() || a.submeshes.size() != b.submeshes.size()) {
+            return false;
+        }
+        auto Collect = [](const ModelData& data, uint32_t start, uint32_t count) {
+            std::vector<std::string> triangles;
+            for (uint32_t i = start; i < start + count; i += 3) {
+                std::string key;
+                for (uint32_t c = 0; c < 3; ++c) {
+                    const ModelData::VertexData& vertex = data.vertices[data.indices[i + c]];
+                    key.append(reinterpret_cast<const char*>(&vertex), sizeof(vertex));
+                }
+                triangles.push_back(std::move(key));
+            }
+            std::sort(triangles.begin(), triangles.end());
+            return triangles;
+        };
+        if (a.submeshes.empty()) {
+            return Collect(a, 0, static_cast<uint32_t>(a.indices.size())) == Collect(b, 0, static_cast<uint32_t>(b.indices.size()));
+        }
+        for (size_t s = 0; s < a.submeshes.size(); ++s) {
+            const ModelData::Submesh& submesh = a.submeshes[s];
+            if (submesh.indexStart != b.submeshes[s].indexStart || submesh.indexCount != b.submeshes[s].indexCount ||
+                Collect(a, submesh.indexStart, submesh.indexCount) != Collect(b, submesh.indexStart, submesh.indexCount)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Report(const char* name, const ModelData& source) {
+        ModelData data = source;
+        const auto start = std::chrono::steady_clock::now();
+        MeshOptimizer::Optimize(data);
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const ModelData::CacheMetrics& metrics = data.cacheMetrics;
+        std::printf("%-20s %9zu %9zu %7.3f %7.3f %7.3f %7.3f %10.3f %5s\n",
+            name, data.indices.size() / 3, data.vertices.size(),
+            metrics.acmrBefore, metrics.acmrAfter, metrics.atvrBefore, metrics.atvrAfter,
+            milliseconds, HasSameTriangles(source, data) ? "yes" : "NO");
+    }
+
+    // 三角形の順番と各三角形の頂点の開始位置を混ぜる (巻き順は保つ)
+    ModelData Shuffle(ModelData data) {
+        std::mt19937 random(12345);
+        const size_t triangleCount = data.indices.size() / 3;
+        std::vector<uint32_t> order(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            order[t] = static_cast<uint32_t>(t);
+        }
+        std::shuffle(order.begin(), order.end(), random);
+        std::vector<uint32_t> indices(data.indices.size());
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const uint32_t rotation = random() % 3;
+            for (uint32_t c = 0; c < 3; ++c) {
+                indices[t * 3 + c] = data.indices[order[t] * 3 + (c + rotation) % 3];
+            }
+        }
+        data.indices = std::move(indices);
+        return data;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string resourceDirectory = "resources/obj";
+    if (argc > 1) {
+        resourceDirectory = argv[1];
+    }
+
+    std::printf("%-20s %9s %9s %7s %7s %7s %7s %10s %5s\n",
+        "mesh", "triangles", "vertices", "ACMR", "-> ACMR", "ATVR", "-> ATVR", "time [ms]", "same");
+
+    for (const char* name : { "axis", "fence", "multiMaterial", "multiMesh", "plane" }) {
+        const std::string directoryPath = resourceDirectory + "/" + name;
+        const std::string filename = std::string(name) + ".obj";
+        if (!std::filesystem::exists(directoryPath + "/" + filename)) {
+            std::printf("%-20s (not found)\n", name);
+            continue;
+        }
+        Report(name, ObjLoader::LoadObjFile(directoryPath, filename));
+    }
+
+    Report("sphere", PrimitiveGenerator::CreateSphereData());
+    Report("torus", PrimitiveGenerator::CreateTorusData());
+    Report("cylinder", PrimitiveGenerator::CreateCylinderData());
+    Report("box", PrimitiveGenerator::CreateBoxData());
+    Report("sphere 256", PrimitiveGenerator::CreateSphereData(256));
+    Report("sphere 256 shuffled", Shuffle(PrimitiveGenerator::CreateSphereData(256)));
+    return 0;
+}
@@ -0,0 +1,268 @@
+// メッシュレット (MeshletBuilder) の大きさ・作る時間と、塊ごとの判定 (ClusterCulling) で除ける三角形の割合・判定の時間を出力する
+// 除いた塊は全ての三角形について、視錐台の外か裏向きであることをワールド座標で確かめる (非一様な拡大を含む)
+#include "ClusterCulling.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "PrimitiveGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace MatrixMath;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    Vector3 TransformPoint(const Vector4& p, const Matrix4x4& matrix) {
+        const float (*m)[4] = matrix.m;
+        return {
+            p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0],
+            p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1],
+            p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2]
+        };
+    }
+
+    Vector3 Sub(const Vector3& a, const Vector3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    float Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    Vector3 Normalize(const Vector3& v) {
+        const float length = std::sqrt(Dot(v, v));
+        return { v.x / length, v.y / length, v.z / length };
+    }
+
+    // 左手系の注視行列 (行ベクトル規約)
+    Matrix4x4 MakeLookAt(const Vector3& eye, const Vector3& target) {
+        const Vector3 z = Normalize(Sub(target, eye));
+        const Vector3 up = std::fabs(z.y) > 0.99f ? Vector3{ 0.0f, 0.0f, 1.0f } : Vector3{ 0.0f, 1.0f, 0.0f };
+        const Vector3 x = Normalize(Cross(up, z));
+        const Vector3 y = Cross(z, x);
+        return { {
+            { x.x, y.x, z.x, 0.0f },
+            { x.y, y.y, z.y, 0.0f },
+            { x.z, y.z, z.z, 0.0f },
+            { -Dot(x, eye), -Dot(y, eye), -Dot(z, eye), 1.0f }
+        } };
+    }
+
+    // 三角形の番号の並びに関係なく、同じ三角形の集合か (塊に分けた前後で三角形が欠けていないか)
+    std::vector<std::array<uint32_t, 3>> SortedTriangles(const ModelData& data) {
+        // 頂点の並び替えにも関係なく比べられるよう、位置と UV のハッシュで表す
+        std::vector<std::array<uint32_t, 3>> triangles;
+        const size_t indexCount = data.indices.size();
+        for (size_t t = 0; t + 2 < indexCount; t += 3) {
+            std::array<uint32_t, 3> keys;
+            for (int c = 0; c < 3; ++c) {
+                const Vector4& p = data.vertices[data.indices[t + c]].position;
+                const Vector2& uv = data.vertices[data.indices[t + c]].texcoord;
+                uint32_t bits[5];
+                std::memcpy(&bits[0], &p.x, 4);
+                std::memcpy(&bits[1], &p.y, 4);
+                std::memcpy(&bits[2], &p.z, 4);
+                std::memcpy(&bits[3], &uv.x, 4);
+                std::memcpy(&bits[4], &uv.y, 4);
+                uint32_t hash = 2166136261u;
+                for (uint32_t b : bits) {
+                    hash = (hash ^ b) * 16777619u;
+                }
+                keys[c] = hash;
+            }
+            // 巻き方向を保ったまま最小の番号から始める
+            const int first = static_cast<int>(std::min_element(keys.begin(), keys.end()) - keys.begin());
+            triangles.push_back({ keys[first], keys[(first + 1) % 3], keys[(first + 2) % 3] });
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // 塊が上限を守り、サブメッシュを隙間なく覆っているか
+    bool IsValid(const ModelData& data, const MeshletBuilder::Options& options) {
+        std::vector<uint32_t> stamps(data.vertices.size(), 0xffffffffu);
+        uint32_t expectedStart = 0;
+        uint32_t previousSubmesh = 0xffffffffu;
+        for (uint32_t m = 0; m < data.meshlets.size(); ++m) {
+            const ModelData::Meshlet& meshlet = data.meshlets[m];
+            if (meshlet.triangleCount == 0 || meshlet.triangleCount > options.maxTriangleCount || meshlet.vertexCount > options.maxVertexCount) {
+                return false;
+            }
+            if (meshlet.submeshIndex != previousSubmesh) {
+                expectedStart = data.submeshes.empty() ? 0 : data.submeshes[meshlet.submeshIndex].indexStart;
+                previousSubmesh = meshlet.submeshIndex;
+            }
+            if (meshlet.indexStart != expectedStart) {
+                return false;
+            }
+            expectedStart += meshlet.triangleCount * 3;
+            uint32_t vertexCount = 0;
+            for (uint32_t i = meshlet.indexStart; i < meshlet.indexStart + meshlet.triangleCount * 3; ++i) {
+                if (stamps[data.indices[i]] != m) {
+                    stamps[data.indices[i]] = m;
+                    ++vertexCount;
+                }
+            }
+            if (vertexCount != meshlet.vertexCount) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Report(const char* name, ModelData data) {
+        MeshOptimizer::Optimize(data);
+        const ModelData before = data;
+        const MeshOptimizer::CacheStatistics cacheBefore = MeshOptimizer::AnalyzeVertexCache(data);
+        const MeshletBuilder::Options options;
+        const auto start = Clock::now();
+        MeshletBuilder::Build(data, options);
+        const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        const MeshOptimizer::CacheStatistics cacheAfter = MeshOptimizer::AnalyzeVertexCache(data);
+
+        size_t triangleCount = 0;
+        size_t vertexCount = 0;
+        size_t coneCount = 0;
+        for (const ModelData::Meshlet& meshlet : data.meshlets) {
+            triangleCount += meshlet.triangleCount;
+            vertexCount += meshlet.vertexCount;
+            coneCount += meshlet.coneCutoff < 1.0f ? 1 : 0;
+        }
+        const double meshletCount = static_cast<double>((std::max)(data.meshlets.size(), size_t{ 1 }));
+        const bool isSame = SortedTriangles(before) == SortedTriangles(data);
+        std::printf("%-16s %9zu %8zu %8.1f %8.1f %7.1f%% %7.1f%% %7.3f %7.3f %9.2f %6s\n", name, triangleCount, data.meshlets.size(),
+            static_cast<double>(vertexCount) / meshletCount, static_cast<double>(triangleCount) / meshletCount,
+            100.0 * static_cast<double>(triangleCount) / (meshletCount * options.maxTriangleCount),
+            100.0 * static_cast<double>(coneCount) / meshletCount, cacheBefore.acmr, cacheAfter.acmr, milliseconds,
+            isSame && IsValid(data, options) ? "yes" : "NO");
+    }
+
+    // 視点を変えて判定し、除いた三角形の割合・描画の回数・判定の時間と、除いた塊の誤り (見える三角形を含む) の数を出す
+    void ReportCulling(const char* name, ModelData data, const Matrix4x4& worldMatrix) {
+        MeshOptimizer::Optimize(data);
+        MeshletBuilder::Build(data);
+        SphereSoA spheres;
+        for (const ModelData::Meshlet& meshlet : data.meshlets) {
+            spheres.PushBack({ meshlet.center, meshlet.radius });
+        }
+        std::vector<Vector3> worldPositions(data.vertices.size());
+        for (size_t v = 0; v < data.vertices.size(); ++v) {
+            worldPositions[v] = TransformPoint(data.vertices[v].position, worldMatrix);
+        }
+        const Matrix4x4 projection = PerspectiveFov(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+        const Vector3 center = TransformPoint({ 0.0f, 0.0f, 0.0f, 1.0f }, worldMatrix);
+
+        struct View {
+            const char* label;
+            Vector3 eye;
+            Vector3 target;
+        };
+        const View views[] = {
+            { "far front", { center.x, center.y, center.z - 8.0f }, center },
+            { "far above", { center.x + 2.0f, center.y + 6.0f, center.z - 3.0f }, center },
+            { "near side", { center.x + 2.5f, center.y, center.z }, center },
+            { "near grazing", { center.x - 1.0f, center.y + 0.2f, center.z - 2.2f }, { center.x + 1.5f, center.y, center.z } },
+        };
+        const size_t totalTriangles = data.indices.size() / 3;
+        for (const ClusterCulling::Settings& settings : { ClusterCulling::Settings{ true, false }, ClusterCulling::Settings{ true, true } }) {
+            for (const View& view : views) {
+                const Matrix4x4 viewProjection = Multipty(MakeLookAt(view.eye, view.target), projection);
+                const ClusterCulling::LocalView localView = ClusterCulling::MakeLocalView(worldMatrix, viewProjection, view.eye);
+                std::vector<uint64_t> mask(Culling::GetMaskWordCount(data.meshlets.size()));
+
+                const int repeat = 2000;
+                size_t visibleCount = 0;
+                const auto start = Clock::now();
+                for (int r = 0; r < repeat; ++r) {
+                    visibleCount = ClusterCulling::Cull(data.meshlets.data(), spheres.GetStreams(), localView, mask.data(), settings);
+                }
+                const double microseconds = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / repeat;
+
+                // Model::Draw と同じく、続いている塊をまとめた描画の回数
+                size_t drawnTriangles = 0;
+                size_t drawCount = 0;
+                uint32_t runEnd = 0xffffffffu;
+                const Frustum worldFrustum = Culling::ExtractFrustum(viewProjection);
+                size_t wrongCount = 0;
+                for (uint32_t m = 0; m < data.meshlets.size(); ++m) {
+                    const ModelData::Meshlet& meshlet = data.meshlets[m];
+                    if (Culling::TestMask(mask.data(), m)) {
+                        drawnTriangles += meshlet.triangleCount;
+                        drawCount += meshlet.indexStart == runEnd ? 0 : 1;
+                        runEnd = meshlet.indexStart + meshlet.triangleCount * 3;
+                        continue;
+                    }
+                    // 除いた塊の三角形は、どれかの平面の外にあるか、視点が三角形の平面の裏側にあること
+                    for (uint32_t i = meshlet.indexStart; i < meshlet.indexStart + meshlet.triangleCount * 3; i += 3) {
+                        const ModelData::VertexData* v[3] = { &data.vertices[data.indices[i]], &data.vertices[data.indices[i + 1]], &data.vertices[data.indices[i + 2]] };
+                        const Vector3 p[3] = { worldPositions[data.indices[i]], worldPositions[data.indices[i + 1]], worldPositions[data.indices[i + 2]] };
+                        bool isOutside = false;
+                        for (size_t plane = 0; plane < Frustum::kPlaneCount && !isOutside; ++plane) {
+                            const Vector3 normal = { worldFrustum.normalX[plane], worldFrustum.normalY[plane], worldFrustum.normalZ[plane] };
+                            isOutside = Dot(normal, p[0]) + worldFrustum.distance[plane] < 0.0f &&
+                                Dot(normal, p[1]) + worldFrustum.distance[plane] < 0.0f &&
+                                Dot(normal, p[2]) + worldFrustum.distance[plane] < 0.0f;
+                        }
+                        if (isOutside) {
+                            continue;
+                        }
+                        // 表側 (頂点の法線の側) の点をワールドへ移し、視点がその反対側にあれば裏向き
+                        const Vector3 localEdge1 = { v[1]->position.x - v[0]->position.x, v[1]->position.y - v[0]->position.y, v[1]->position.z - v[0]->position.z };
+                        const Vector3 localEdge2 = { v[2]->position.x - v[0]->position.x, v[2]->position.y - v[0]->position.y, v[2]->position.z - v[0]->position.z };
+                        Vector3 localNormal = Cross(localEdge1, localEdge2);
+                        const Vector3 normalSum = { v[0]->normal.x + v[1]->normal.x + v[2]->normal.x, v[0]->normal.y + v[1]->normal.y + v[2]->normal.y, v[0]->normal.z + v[1]->normal.z + v[2]->normal.z };
+                        if (Dot(localNormal, normalSum) < 0.0f) {
+                            localNormal = { -localNormal.x, -localNormal.y, -localNormal.z };
+                        }
+                        const Vector3 front = TransformPoint({ v[0]->position.x + localNormal.x, v[0]->position.y + localNormal.y, v[0]->position.z + localNormal.z, 1.0f }, worldMatrix);
+                        const Vector3 worldNormal = Cross(Sub(p[1], p[0]), Sub(p[2], p[0]));
+                        const float eyeSide = Dot(worldNormal, Sub(view.eye, p[0]));
+                        const float frontSide = Dot(worldNormal, Sub(front, p[0]));
+                        if (eyeSide * frontSide > 1.0e-6f * std::fabs(frontSide)) {
+                            ++wrongCount;
+                        }
+                    }
+                }
+                std::printf("%-16s %-9s %-13s %8zu/%-6zu %8.1f%% %6zu %9.2f %6zu\n", name, settings.cullBackfaces ? "+backface" : "frustum", view.label,
+                    visibleCount, data.meshlets.size(), 100.0 * static_cast<double>(totalTriangles - drawnTriangles) / static_cast<double>(totalTriangles),
+                    drawCount, microseconds, wrongCount);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string resourceDirectory = "resources/obj";
+    if (argc > 1) {
+        resourceDirectory = argv[1];
+    }
+
+    std::printf("%-16s %9s %8s %8s %8s %8s %8s %7s %7s %9s %6s\n", "mesh", "triangles", "meshlets", "verts", "tris", "fill", "cone", "acmr", "->", "build ms", "valid");
+    for (const char* name : { "axis", "fence", "multiMaterial", "multiMesh", "plane" }) {
+        const std::string directoryPath = resourceDirectory + "/" + name;
+        const std::string filename = std::string(name) + ".obj";
+        if (!std::filesystem::exists(directoryPath + "/" + filename)) {
+            std::printf("%-16s (not found)\n", name);
+            continue;
+        }
+        Report(name, ObjLoader::LoadObjFile(directoryPath, filename));
+    }
+    Report("sphere", PrimitiveGenerator::CreateSphereData());
+    Report("torus", PrimitiveGenerator::CreateTorusData());
+    Report("cylinder", PrimitiveGenerator::CreateCylinderData());
+    Report("box", PrimitiveGenerator::CreateBoxData());
+    Report("sphere 64", PrimitiveGenerator::CreateSphereData(64));
+    Report("torus 128x64", PrimitiveGenerator::CreateTorusData(128, 64));
+    Report("sphere 256", PrimitiveGenerator::CreateSphereData(256));
+    Report("sphere 1024", PrimitiveGenerator::CreateSphereData(1024));
+
+    std::printf("\n%-16s %-9s %-13s %15s %9s %6s %9s %6s\n", "mesh", "culling", "view", "visible", "culled", "draws", "cull us", "wrong");
+    ReportCulling("sphere 256", PrimitiveGenerator::CreateSphereData(256), MakeIdentity4x4());
+    ReportCulling("torus 128x64", PrimitiveGenerator::CreateTorusData(128, 64), MakeAffine({ 1.0f, 1.0f, 1.0f }, { 0.6f, 0.3f, 0.0f }, { 0.0f, 0.0f, 0.0f }));
+    // 非一様な拡大 (ローカル座標で判定しても、ワールドで確かめて誤りが無いこと)
+    ReportCulling("sphere 256 xyz", PrimitiveGenerator::CreateSphereData(256), MakeAffine({ 2.0f, 0.5f, 1.0f }, { 0.0f, 0.7f, 0.2f }, { 0.3f, -0.2f, 0.5f }));
+    return 0;
+}
@@ -0,0 +1,374 @@
+// OBJ 読み込みのベンチマーク
+// 以前の istringstream による読み込みと、メモリマップ + from_chars の ObjLoader を比べる
+// resources/obj の OBJ と、合成した大きな OBJ で MB/s と頂点が一致するかを出力する
+// 続いて MeshCache (バイナリのキャッシュ) からの読み込みを OBJ の読み込みと比べる
+//   warm はファイルがページキャッシュに載った状態、cold はページキャッシュから追い出した状態 (Linux のみ)
+#include "MeshCache.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // 最適化で消されないように結果を集計する
+    volatile size_t gSink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 以前の Model::LoadObjFile (比較用にそのまま残したもの)
+    ModelData::MaterialData LegacyLoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
+        ModelData::MaterialData materialData;
+        std::string line;
+        std::ifstream file(directoryPath + "/" + filename);
+        if (!file.is_open()) return materialData;
+
+        while (std::getline(file, line)) {
+            std::string identifier;
+            std::istringstream s(line);
+            s >> identifier;
+            if (identifier == "map_Kd") {
+                std::string textureFilename;
+                s >> textureFilename;
+                materialData.textureFilePath = directoryPath + "/" + textureFilename;
+            }
+        }
+        return materialData;
+    }
+
+    ModelData LegacyLoadObjFile(const std::string& directoryPath, const std::string& filename) {
+        ModelData modelData;
+        std::vector<Vector4> positions;
+        std::vector<Vector3> normals;
+        std::vector<Vector2> texcoords;
+        std::string line;
+        std::ifstream file(directoryPath + "/" + filename);
+        assert(file.is_open());
+
+        while (std::getline(file, line)) {
+            std::string identifier;
+            std::istringstream s(line);
+            s >> identifier;
+
+            if (identifier == "v") {
+                Vector4 p{};
+                s >> p.x >> p.y >> p.z;
+                p.w = 1.0f;
+                positions.push_back(p);
+            } else if (identifier == "vt") {
+                Vector2 uv{};
+                s >> uv.x >> uv.y;
+                uv.y = 1.0f - uv.y;
+                texcoords.push_back(uv);
+            } else if (identifier == "vn") {
+                Vector3 n{};
+                s >> n.x >> n.y >> n.z;
+                n.x *= -1.0f;
+                normals.push_back(n);
+            } else if (identifier == "f") {
+                ModelData::VertexData triangle[3]{};
+                for (int i = 0; i < 3; ++i) {
+                    std::string vertexDefinition;
+                    s >> vertexDefinition;
+                    std::istringstream v(vertexDefinition);
+                    uint32_t idx[3]{};
+                    for (int e = 0; e < 3; ++e) {
+                        std::string indexStr;
+                        std::getline(v, indexStr, '/');
+                        idx[e] = static_cast<uint32_t>(std::stoi(indexStr));
+                    }
+                    Vector4 p = positions[idx[0] - 1];
+                    Vector2 t = texcoords[idx[1] - 1];
+                    Vector3 n = normals[idx[2] - 1];
+                    p.x *= -1.0f;
+                    triangle[i] = { p, t, n };
+                }
+                modelData.vertices.push_back(triangle[2]);
+                modelData.vertices.push_back(triangle[1]);
+                modelData.vertices.push_back(triangle[0]);
+            } else if (identifier == "mtllib") {
+                std::string materialFilename;
+                s >> materialFilename;
+                modelData.materials = { LegacyLoadMaterialTemplateFile(directoryPath, materialFilename) };
+            }
+        }
+        return modelData;
+    }
+
+    // 番号から辿った三角形の頂点が、以前の読み込み結果とビット単位で一致するか
+    // 以前は MTL の最後の map_Kd だけを持っていたので、それがマテリアル表にあるかを見る
+    bool IsSame(const ModelData& legacy, const ModelData& indexed) {
+        if (legacy.vertices.size() != indexed.indices.size()) {
+            return false;
+        }
+        if (!legacy.materials.empty() && !legacy.materials[0].textureFilePath.empty() &&
+            std::none_of(indexed.materials.begin(), indexed.materials.end(), [&](const ModelData::MaterialData& material) {
+                return material.textureFilePath == legacy.materials[0].textureFilePath;
+            })) {
+            return false;
+        }
+        for (size_t i = 0; i < indexed.indices.size(); ++i) {
+            if (std::memcmp(&legacy.vertices[i], &indexed.vertices[indexed.indices[i]], sizeof(ModelData::VertexData)) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 緯度経度で分割した球の OBJ を書き出す (三角形数 = 2 * segments^2)
+    // v / vt / vn を共有する、DCC ツールの出力に近い形
+    // 64 行ごとに o / usemtl で区切る (並列読み込みで範囲をまたぐサブメッシュを確かめる)
+    void WriteSphereObj(const std::string& path, uint32_t segments) {
+        std::ofstream file(path);
+        file << "# generated by obj_bench\n";
+        char buffer[128];
+        const float pi = 3.14159265f;
+        for (uint32_t lat = 0; lat <= segments; ++lat) {
+            for (uint32_t lon = 0; lon <= segments; ++lon) {
+                const float theta = pi * static_cast<float>(lat) / static_cast<float>(segments);
+                const float phi = 2.0f * pi * static_cast<float>(lon) / static_cast<float>(segments);
+                const float x = std::sin(theta) * std::cos(phi);
+                const float y = std::cos(theta);
+                const float z = std::sin(theta) * std::sin(phi);
+                std::snprintf(buffer, sizeof(buffer), "v %.6f %.6f %.6f\n", x, y, z);
+                file << buffer;
+                std::snprintf(buffer, sizeof(buffer), "vt %.6f %.6f\n", static_cast<float>(lon) / static_cast<float>(segments), 1.0f - static_cast<float>(lat) / static_cast<float>(segments));
+                file << buffer;
+                std::snprintf(buffer, sizeof(buffer), "vn %.4f %.4f %.4f\n", x, y, z);
+                file << buffer;
+            }
+        }
+        const uint32_t rowSize = segments + 1;
+        for (uint32_t lat = 0; lat < segments; ++lat) {
+            if (lat % 64 == 0) {
+                std::snprintf(buffer, sizeof(buffer), "o band%u\nusemtl material%u\n", lat / 64, lat / 64 % 3);
+                file << buffer;
+            }
+            for (uint32_t lon = 0; lon < segments; ++lon) {
+                const uint32_t a = lat * rowSize + lon + 1;
+                const uint32_t b = a + rowSize;
+                const uint32_t c = a + 1;
+                const uint32_t d = b + 1;
+                std::snprintf(buffer, sizeof(buffer), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+                file << buffer;
+                std::snprintf(buffer, sizeof(buffer), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", c, c, c, b, b, b, d, d, d);
+                file << buffer;
+            }
+        }
+    }
+
+    // 何度か読んで最小の時間を採る (ファイルはページキャッシュに載った状態で比べる)
+    template<typename Loader>
+    double MeasureMs(Loader&& loader, int repeat) {
+        double best = 1.0e30;
+        for (int i = 0; i < repeat; ++i) {
+            const auto start = Clock::now();
+            const ModelData data = loader();
+            best = (std::min)(best, ElapsedMs(start));
+            gSink = gSink + data.vertices.size();
+        }
+        return best;
+    }
+
+    // ファイルをページキャッシュから追い出す (書いたばかりのページは先に書き出す)
+    void EvictFromPageCache(const std::string& path) {
+#if !defined(_WIN32)
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+#else
+        (void)path;
+#endif
+    }
+
+    // 読み込む前に毎回ファイルを追い出して計る
+    template<typename Loader>
+    double MeasureColdMs(const std::vector<std::string>& paths, Loader&& loader) {
+        double best = 1.0e30;
+        for (int i = 0; i < 3; ++i) {
+            for (const std::string& path : paths) {
+                EvictFromPageCache(path);
+            }
+            const auto start = Clock::now();
+            const ModelData data = loader();
+            best = (std::min)(best, ElapsedMs(start));
+            gSink = gSink + data.vertices.size();
+        }
+        return best;
+    }
+
+    bool IsSameIndexed(const ModelData& a, const ModelData& b) {
+        auto IsSameSubmesh = [](const ModelData::Submesh& x, const ModelData::Submesh& y) {
+            return x.name == y.name && x.indexStart == y.indexStart && x.indexCount == y.indexCount && x.materialIndex == y.materialIndex;
+        };
+        auto IsSameMaterial = [](const ModelData::MaterialData& x, const ModelData::MaterialData& y) {
+            return x.name == y.name && x.textureFilePath == y.textureFilePath;
+        };
+        auto IsSameLod = [&](const ModelData::Lod& x, const ModelData::Lod& y) {
+            return x.error == y.error &&
+                std::equal(x.submeshes.begin(), x.submeshes.end(), y.submeshes.begin(), y.submeshes.end(), IsSameSubmesh);
+        };
+        return a.vertices.size() == b.vertices.size() && a.indices == b.indices &&
+            a.meshlets.size() == b.meshlets.size() &&
+            std::memcmp(a.meshlets.data(), b.meshlets.data(), sizeof(ModelData::Meshlet) * a.meshlets.size()) == 0 &&
+            std::equal(a.lods.begin(), a.lods.end(), b.lods.begin(), b.lods.end(), IsSameLod) &&
+            std::equal(a.submeshes.begin(), a.submeshes.end(), b.submeshes.begin(), b.submeshes.end(), IsSameSubmesh) &&
+            std::equal(a.materials.begin(), a.materials.end(), b.materials.begin(), b.materials.end(), IsSameMaterial) &&
+            std::memcmp(a.vertices.data(), b.vertices.data(), sizeof(ModelData::VertexData) * a.vertices.size()) == 0;
+    }
+
+    // OBJ の読み込みとキャッシュからの読み込みを比べる
+    void RunCache(const char* name, const std::string& directoryPath, const std::string& filename) {
+        const std::string sourcePath = directoryPath + "/" + filename;
+        const std::string cachePath = MeshCache::GetCachePath(directoryPath, filename);
+        std::vector<std::string> dependencies{ filename };
+        // キャッシュには取り込み時に並べ替え、塊と詳細度の段を作った結果が入る
+        ModelData source = ObjLoader::LoadObjFile(directoryPath, filename, &dependencies);
+        MeshOptimizer::Optimize(source);
+        MeshletBuilder::Build(source);
+        MeshSimplifier::BuildLodChain(source);
+        std::vector<std::string> paths;
+        for (const std::string& dependency : dependencies) {
+            paths.push_back(directoryPath + "/" + dependency);
+        }
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(sourcePath, error);
+        const int repeat = fileSize > (size_t(1) << 20) ? 3 : 50;
+
+        // 初回 (OBJ を読んでキャッシュを書き出す)
+        std::filesystem::remove(cachePath, error);
+        const auto firstStart = Clock::now();
+        const ModelData first = MeshCache::LoadObjFile(directoryPath, filename);
+        const double firstMs = ElapsedMs(firstStart);
+        const uintmax_t cacheSize = std::filesystem::file_size(cachePath, error);
+        if (error) {
+            std::printf("%-16s (cache not written)\n", name);
+            return;
+        }
+
+        ModelData cached;
+        const bool isRead = MeshCache::Read(cachePath, directoryPath, cached);
+        const double objMs = MeasureMs([&]() { return ObjLoader::LoadObjFile(directoryPath, filename); }, repeat);
+        const double cacheMs = MeasureMs([&]() {
+            ModelData data;
+            MeshCache::Read(cachePath, directoryPath, data);
+            return data;
+        }, repeat);
+
+        const double coldObjMs = MeasureColdMs(paths, [&]() { return ObjLoader::LoadObjFile(directoryPath, filename); });
+        std::vector<std::string> cachePaths = paths;
+        cachePaths.push_back(cachePath);
+        const double coldCacheMs = MeasureColdMs(cachePaths, [&]() {
+            ModelData data;
+            MeshCache::Read(cachePath, directoryPath, data);
+            return data;
+        });
+
+        std::printf("%-16s %10.2f %10.2f %12.2f %12.2f %10.3f %8.1fx %12.2f %12.2f %8.1fx %6s\n",
+            name, static_cast<double>(fileSize) / (1024.0 * 1024.0), static_cast<double>(cacheSize) / (1024.0 * 1024.0),
+            firstMs, objMs, cacheMs, objMs / cacheMs, coldObjMs, coldCacheMs, coldObjMs / coldCacheMs,
+            isRead && IsSameIndexed(source, first) && IsSameIndexed(source, cached) ? "yes" : "NO");
+        std::filesystem::remove(cachePath, error);
+    }
+
+    // 並列読み込みをスレッド数ごとに計り、1 つの順で読んだ結果と比べる
+    void RunParallel(const char* name, const std::string& directoryPath, const std::string& filename) {
+        const ModelData serial = ObjLoader::LoadObjFile(directoryPath, filename);
+        const double serialMs = MeasureMs([&]() { return ObjLoader::LoadObjFile(directoryPath, filename); }, 3);
+        std::printf("%-16s %8s %12.2f %9s %6s\n", name, "serial", serialMs, "1.00x", "-");
+        for (uint32_t threadCount : { 1u, 2u, 4u, 8u, 16u }) {
+            const ModelData parallel = ObjLoader::LoadObjFileParallel(directoryPath, filename, threadCount);
+            const double parallelMs = MeasureMs([&]() { return ObjLoader::LoadObjFileParallel(directoryPath, filename, threadCount); }, 3);
+            std::printf("%-16s %8u %12.2f %8.2fx %6s\n", name, threadCount, parallelMs, serialMs / parallelMs,
+                IsSameIndexed(serial, parallel) ? "yes" : "NO");
+        }
+    }
+
+    void Run(const char* name, const std::string& directoryPath, const std::string& filename) {
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(directoryPath + "/" + filename, error);
+        if (error) {
+            std::printf("%-16s (not found)\n", name);
+            return;
+        }
+
+        const ModelData legacy = LegacyLoadObjFile(directoryPath, filename);
+        const ModelData current = ObjLoader::LoadObjFile(directoryPath, filename);
+
+        const int repeat = fileSize > (size_t(1) << 20) ? 3 : 50;
+        const double legacyMs = MeasureMs([&]() { return LegacyLoadObjFile(directoryPath, filename); }, repeat);
+        const double currentMs = MeasureMs([&]() { return ObjLoader::LoadObjFile(directoryPath, filename); }, repeat);
+
+        const double megabytes = static_cast<double>(fileSize) / (1024.0 * 1024.0);
+        std::printf("%-16s %10.2f %9zu %9zu %12.2f %12.2f %12.1f %12.1f %8.2fx %6s\n",
+            name, megabytes, current.indices.size(), current.vertices.size(), legacyMs, currentMs,
+            megabytes / (legacyMs / 1000.0), megabytes / (currentMs / 1000.0), legacyMs / currentMs,
+            IsSame(legacy, current) ? "yes" : "NO");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string resourceDirectory = "resources/obj";
+    if (argc > 1) {
+        resourceDirectory = argv[1];
+    }
+
+    std::printf("%-16s %10s %9s %9s %12s %12s %12s %12s %9s %6s\n",
+        "mesh", "size(MB)", "indices", "vertices", "legacy(ms)", "mapped(ms)", "legacy MB/s", "mapped MB/s", "speedup", "same");
+
+    const char* const bundledNames[] = { "axis", "fence", "multiMaterial", "multiMesh", "plane" };
+    for (const char* name : bundledNames) {
+        Run(name, resourceDirectory + "/" + name, std::string(name) + ".obj");
+    }
+
+    // 大きな OBJ は一時ディレクトリに書き出して読む
+    const std::filesystem::path temporaryDirectory = std::filesystem::temp_directory_path();
+    const uint32_t sphereSegments[] = { 256u, 1024u };
+    auto SphereFilename = [](uint32_t segments) { return "obj_bench_sphere_" + std::to_string(segments) + ".obj"; };
+    auto SphereName = [](uint32_t segments) { return "sphere " + std::to_string(2 * segments * segments / 1000) + "k"; };
+    for (uint32_t segments : sphereSegments) {
+        WriteSphereObj((temporaryDirectory / SphereFilename(segments)).string(), segments);
+        Run(SphereName(segments).c_str(), temporaryDirectory.string(), SphereFilename(segments));
+    }
+
+    std::printf("\n%-16s %10s %10s %12s %12s %10s %9s %12s %12s %9s %6s\n",
+        "mesh", "obj(MB)", "cache(MB)", "first(ms)", "obj(ms)", "cache(ms)", "warm", "cold obj", "cold cache", "cold", "same");
+    for (const char* name : bundledNames) {
+        RunCache(name, resourceDirectory + "/" + name, std::string(name) + ".obj");
+    }
+    for (uint32_t segments : sphereSegments) {
+        RunCache(SphereName(segments).c_str(), temporaryDirectory.string(), SphereFilename(segments));
+    }
+
+    std::printf("\n%-16s %8s %12s %9s %6s (hardware threads: %u)\n", "mesh", "threads", "load(ms)", "speedup", "same", std::thread::hardware_concurrency());
+    for (uint32_t segments : sphereSegments) {
+        RunParallel(SphereName(segments).c_str(), temporaryDirectory.string(), SphereFilename(segments));
+        std::filesystem::remove(temporaryDirectory / SphereFilename(segments));
+    }
+    return gSink == 0xffffffff ? 1 : 0;
+}
@@ -0,0 +1,416 @@
+// 基本図形の生成 (PrimitiveGenerator) のベンチマーク
+// 以前の MeshBuilder (四角形ごとに 6 頂点を渡し、ハッシュで重複を除く) による生成と、角度の表から格子の頂点を直接書く生成を比べる
+//   legacy / create は ModelData を作る時間、write は用意した書き込み先 (頂点が 65536 個以下なら 16 ビットの頂点番号) へ書くだけの時間
+// 三角形の角ごとの頂点が以前と (sin / cos の求め方の違いの誤差の範囲で) 同じかも確かめる
+#include "MeshBuilder.h"
+#include "FastMath.h"
+#include "PrimitiveGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+    // 最適化で消されないように結果を集計する
+    volatile size_t gSink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 1 回が短いものは何度か繰り返し、最小の時間を採る
+    template<typename Function>
+    double MeasureMs(Function&& function) {
+        double best = 1.0e30;
+        for (int i = 0; i < 5; ++i) {
+            const auto start = Clock::now();
+            int repeat = 0;
+            do {
+                function();
+                ++repeat;
+            } while (ElapsedMs(start) < 20.0);
+            best = (std::min)(best, ElapsedMs(start) / repeat);
+        }
+        return best;
+    }
+
+    // 以前の PrimitiveGenerator (比較用にそのまま残したもの)
+    namespace Legacy {
+        constexpr float kPi = 3.14159265359f;
+
+        float Length(const Vector3& v) {
+            return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        }
+
+        Vector3 Normalize(const Vector3& v, const Vector3& fallback = { 0.0f, 1.0f, 0.0f }) {
+            float length = Length(v);
+            if (length <= 0.00001f) {
+                return fallback;
+            }
+            return { v.x / length, v.y / length, v.z / length };
+        }
+
+        ModelData::VertexData MakeVertex(float x, float y, float z, float u, float v, float nx, float ny, float nz) {
+            return { {x, y, z, 1.0f}, {u, v}, {nx, ny, nz} };
+        }
+
+        void PushTriangle(MeshBuilder& builder,
+            const ModelData::VertexData& v0,
+            const ModelData::VertexData& v1,
+            const ModelData::VertexData& v2) {
+            builder.AddTriangle(v0, v1, v2);
+        }
+
+        void PushQuad(MeshBuilder& builder,
+            const ModelData::VertexData& v00,
+            const ModelData::VertexData& v01,
+            const ModelData::VertexData& v10,
+            const ModelData::VertexData& v11) {
+            PushTriangle(builder, v00, v01, v10);
+            PushTriangle(builder, v01, v11, v10);
+        }
+
+        ModelData CreateSphereData(uint32_t subdivision) {
+            ModelData data;
+            subdivision = (subdivision < 3) ? 3 : subdivision;
+            MeshBuilder builder(data, static_cast<size_t>(subdivision + 1) * (subdivision + 1));
+
+            // 緯度・経度ごとの sin / cos を先にまとめて求める (精度は FastMath のポリシーに従う)
+            std::vector<float> latAngles(subdivision + 1), latSin(subdivision + 1), latCos(subdivision + 1);
+            std::vector<float> lonAngles(subdivision + 1), lonSin(subdivision + 1), lonCos(subdivision + 1);
+            for (uint32_t i = 0; i <= subdivision; ++i) {
+                latAngles[i] = kPi * static_cast<float>(i) / static_cast<float>(subdivision);
+                lonAngles[i] = 2.0f * kPi * static_cast<float>(i) / static_cast<float>(subdivision);
+            }
+            const FastMath::TrigPrecision precision = FastMath::GetTrigPrecision();
+            FastMath::SinCosArray(latAngles.data(), latSin.data(), latCos.data(), latAngles.size(), precision);
+            FastMath::SinCosArray(lonAngles.data(), lonSin.data(), lonCos.data(), lonAngles.size(), precision);
+
+            for (uint32_t lat = 0; lat < subdivision; ++lat) {
+                float y0 = latCos[lat];
+                float r0 = latSin[lat];
+                float y1 = latCos[lat + 1];
+                float r1 = latSin[lat + 1];
+
+                for (uint32_t lon = 0; lon < subdivision; ++lon) {
+                    float cosLon0 = lonCos[lon];
+                    float sinLon0 = lonSin[lon];
+                    float cosLon1 = lonCos[lon + 1];
+                    float sinLon1 = lonSin[lon + 1];
+
+                    float u0 = static_cast<float>(lon) / static_cast<float>(subdivision);
+                    float u1 = static_cast<float>(lon + 1) / static_cast<float>(subdivision);
+                    float v0 = static_cast<float>(lat) / static_cast<float>(subdivision);
+                    float v1 = static_cast<float>(lat + 1) / static_cast<float>(subdivision);
+
+                    ModelData::VertexData v00 = { {r0 * cosLon0, y0, r0 * sinLon0, 1.0f}, {u0, v0}, {r0 * cosLon0, y0, r0 * sinLon0} };
+                    ModelData::VertexData v10 = { {r1 * cosLon0, y1, r1 * sinLon0, 1.0f}, {u0, v1}, {r1 * cosLon0, y1, r1 * sinLon0} };
+                    ModelData::VertexData v01 = { {r0 * cosLon1, y0, r0 * sinLon1, 1.0f}, {u1, v0}, {r0 * cosLon1, y0, r0 * sinLon1} };
+                    ModelData::VertexData v11 = { {r1 * cosLon1, y1, r1 * sinLon1, 1.0f}, {u1, v1}, {r1 * cosLon1, y1, r1 * sinLon1} };
+
+                    PushQuad(builder, v00, v01, v10, v11);
+                }
+            }
+            return data;
+        }
+
+        ModelData CreateRingData(
+            uint32_t subdivision,
+            float innerRadius,
+            float outerRadius,
+            float startAngle,
+            float endAngle,
+            float startRadius,
+            float endRadius) {
+            ModelData data;
+            MeshBuilder builder(data);
+            subdivision = (subdivision < 3) ? 3 : subdivision;
+            if (innerRadius < 0.0f) {
+                innerRadius = 0.0f;
+            }
+            if (outerRadius <= innerRadius) {
+                outerRadius = innerRadius + 0.5f;
+            }
+            if (endAngle < startAngle) {
+                std::swap(startAngle, endAngle);
+            }
+            startRadius = (std::max)(0.0f, startRadius);
+            endRadius = (std::max)(0.0f, endRadius);
+
+            // 分割点ごとの sin / cos を先にまとめて求める (精度は FastMath のポリシーに従う)
+            std::vector<float> angles(subdivision + 1), sinValues(subdivision + 1), cosValues(subdivision + 1);
+            for (uint32_t i = 0; i <= subdivision; ++i) {
+                angles[i] = std::lerp(startAngle, endAngle, static_cast<float>(i) / static_cast<float>(subdivision));
+            }
+            FastMath::SinCosArray(angles.data(), sinValues.data(), cosValues.data(), angles.size(), FastMath::GetTrigPrecision());
+
+            for (uint32_t i = 0; i < subdivision; ++i) {
+                float t0 = static_cast<float>(i) / static_cast<float>(subdivision);
+                float t1 = static_cast<float>(i + 1) / static_cast<float>(subdivision);
+                float radiusScale0 = std::lerp(startRadius, endRadius, t0);
+                float radiusScale1 = std::lerp(startRadius, endRadius, t1);
+
+                float outerX0 = -sinValues[i] * (outerRadius * radiusScale0);
+                float outerY0 = cosValues[i] * (outerRadius * radiusScale0);
+                float outerX1 = -sinValues[i + 1] * (outerRadius * radiusScale1);
+                float outerY1 = cosValues[i + 1] * (outerRadius * radiusScale1);
+                float innerX0 = -sinValues[i] * (innerRadius * radiusScale0);
+                float innerY0 = cosValues[i] * (innerRadius * radiusScale0);
+                float innerX1 = -sinValues[i + 1] * (innerRadius * radiusScale1);
+                float innerY1 = cosValues[i + 1] * (innerRadius * radiusScale1);
+
+                auto MakeRingVertex = [](float x, float y, float u, float v) {
+                    return MakeVertex(
+                        x, y, 0.0f,
+                        u, v,
+                        0.0f, 0.0f, -1.0f);
+                    };
+
+                PushQuad(builder,
+                    MakeRingVertex(innerX0, innerY0, t0, 1.0f),
+                    MakeRingVertex(outerX0, outerY0, t0, 0.0f),
+                    MakeRingVertex(innerX1, innerY1, t1, 1.0f),
+                    MakeRingVertex(outerX1, outerY1, t1, 0.0f));
+            }
+
+            return data;
+        }
+
+        ModelData CreateTorusData(uint32_t majorSubdivision, uint32_t minorSubdivision, float majorRadius, float minorRadius) {
+            ModelData data;
+            majorSubdivision = (majorSubdivision < 3) ? 3 : majorSubdivision;
+            minorSubdivision = (minorSubdivision < 3) ? 3 : minorSubdivision;
+            MeshBuilder builder(data, static_cast<size_t>(majorSubdivision + 1) * (minorSubdivision + 1));
+
+            // 大円・小円方向の sin / cos を先にまとめて求める (精度は FastMath のポリシーに従う)
+            std::vector<float> thetas(majorSubdivision + 1), thetaSin(majorSubdivision + 1), thetaCos(majorSubdivision + 1);
+            std::vector<float> phis(minorSubdivision + 1), phiSin(minorSubdivision + 1), phiCos(minorSubdivision + 1);
+            for (uint32_t major = 0; major <= majorSubdivision; ++major) {
+                thetas[major] = 2.0f * kPi * static_cast<float>(major) / static_cast<float>(majorSubdivision);
+            }
+            for (uint32_t minor = 0; minor <= minorSubdivision; ++minor) {
+                phis[minor] = 2.0f * kPi * static_cast<float>(minor) / static_cast<float>(minorSubdivision);
+            }
+            const FastMath::TrigPrecision precision = FastMath::GetTrigPrecision();
+            FastMath::SinCosArray(thetas.data(), thetaSin.data(), thetaCos.data(), thetas.size(), precision);
+            FastMath::SinCosArray(phis.data(), phiSin.data(), phiCos.data(), phis.size(), precision);
+
+            auto MakeTorusVertex = [&](uint32_t major, uint32_t minor, float u, float v) {
+                float cosTheta = thetaCos[major];
+                float sinTheta = thetaSin[major];
+                float cosPhi = phiCos[minor];
+                float sinPhi = phiSin[minor];
+                float radius = majorRadius + minorRadius * cosPhi;
+
+                float x = radius * cosTheta;
+                float y = minorRadius * sinPhi;
+                float z = radius * sinTheta;
+                Vector3 normal = Normalize({ cosPhi * cosTheta, sinPhi, cosPhi * sinTheta }, { 0.0f, 1.0f, 0.0f });
+                return MakeVertex(x, y, z, u, v, normal.x, normal.y, normal.z);
+                };
+
+            for (uint32_t major = 0; major < majorSubdivision; ++major) {
+                float u0 = static_cast<float>(major) / static_cast<float>(majorSubdivision);
+                float u1 = static_cast<float>(major + 1) / static_cast<float>(majorSubdivision);
+
+                for (uint32_t minor = 0; minor < minorSubdivision; ++minor) {
+                    float v0 = static_cast<float>(minor) / static_cast<float>(minorSubdivision);
+                    float v1 = static_cast<float>(minor + 1) / static_cast<float>(minorSubdivision);
+
+                    PushQuad(builder,
+                        MakeTorusVertex(major, minor, u0, v0),
+                        MakeTorusVertex(major + 1, minor, u1, v0),
+                        MakeTorusVertex(major, minor + 1, u0, v1),
+                        MakeTorusVertex(major + 1, minor + 1, u1, v1));
+                }
+            }
+
+            return data;
+        }
+
+        ModelData CreateCylinderData(uint32_t subdivision, float radius, float height) {
+            ModelData data;
+            MeshBuilder builder(data);
+            subdivision = (subdivision < 3) ? 3 : subdivision;
+
+            float halfHeight = height * 0.5f;
+
+            for (uint32_t i = 0; i < subdivision; ++i) {
+                float angle0 = 2.0f * kPi * static_cast<float>(i) / static_cast<float>(subdivision);
+                float angle1 = 2.0f * kPi * static_cast<float>(i + 1) / static_cast<float>(subdivision);
+
+                float x0 = std::cos(angle0) * radius;
+                float z0 = std::sin(angle0) * radius;
+                float x1 = std::cos(angle1) * radius;
+                float z1 = std::sin(angle1) * radius;
+                float u0 = static_cast<float>(i) / static_cast<float>(subdivision);
+                float u1 = static_cast<float>(i + 1) / static_cast<float>(subdivision);
+
+                Vector3 normal0 = Normalize({ std::cos(angle0), 0.0f, std::sin(angle0) }, { 1.0f, 0.0f, 0.0f });
+                Vector3 normal1 = Normalize({ std::cos(angle1), 0.0f, std::sin(angle1) }, { 1.0f, 0.0f, 0.0f });
+
+                PushQuad(builder,
+                    MakeVertex(x0, halfHeight, z0, u0, 0.0f, normal0.x, normal0.y, normal0.z),
+                    MakeVertex(x1, halfHeight, z1, u1, 0.0f, normal1.x, normal1.y, normal1.z),
+                    MakeVertex(x0, -halfHeight, z0, u0, 1.0f, normal0.x, normal0.y, normal0.z),
+                    MakeVertex(x1, -halfHeight, z1, u1, 1.0f, normal1.x, normal1.y, normal1.z));
+
+                ModelData::VertexData topCenter = MakeVertex(0.0f, halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f);
+                ModelData::VertexData top0 = MakeVertex(x0, halfHeight, z0, x0 / (radius * 2.0f) + 0.5f, -z0 / (radius * 2.0f) + 0.5f, 0.0f, 1.0f, 0.0f);
+                ModelData::VertexData top1 = MakeVertex(x1, halfHeight, z1, x1 / (radius * 2.0f) + 0.5f, -z1 / (radius * 2.0f) + 0.5f, 0.0f, 1.0f, 0.0f);
+                PushTriangle(builder, topCenter, top1, top0);
+
+                ModelData::VertexData bottomCenter = MakeVertex(0.0f, -halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, -1.0f, 0.0f);
+                ModelData::VertexData bottom0 = MakeVertex(x0, -halfHeight, z0, x0 / (radius * 2.0f) + 0.5f, z0 / (radius * 2.0f) + 0.5f, 0.0f, -1.0f, 0.0f);
+                ModelData::VertexData bottom1 = MakeVertex(x1, -halfHeight, z1, x1 / (radius * 2.0f) + 0.5f, z1 / (radius * 2.0f) + 0.5f, 0.0f, -1.0f, 0.0f);
+                PushTriangle(builder, bottomCenter, bottom0, bottom1);
+            }
+
+            return data;
+        }
+
+        ModelData CreateConeData(uint32_t subdivision, float radius, float height) {
+            ModelData data;
+            MeshBuilder builder(data);
+            subdivision = (subdivision < 3) ? 3 : subdivision;
+
+            float halfHeight = height * 0.5f;
+            float slope = radius / height;
+
+            for (uint32_t i = 0; i < subdivision; ++i) {
+                float angle0 = 2.0f * kPi * static_cast<float>(i) / static_cast<float>(subdivision);
+                float angle1 = 2.0f * kPi * static_cast<float>(i + 1) / static_cast<float>(subdivision);
+                float midAngle = (angle0 + angle1) * 0.5f;
+
+                float x0 = std::cos(angle0) * radius;
+                float z0 = std::sin(angle0) * radius;
+                float x1 = std::cos(angle1) * radius;
+                float z1 = std::sin(angle1) * radius;
+                float u0 = static_cast<float>(i) / static_cast<float>(subdivision);
+                float u1 = static_cast<float>(i + 1) / static_cast<float>(subdivision);
+
+                Vector3 normal0 = Normalize({ std::cos(angle0), slope, std::sin(angle0) }, { 1.0f, 0.0f, 0.0f });
+                Vector3 normal1 = Normalize({ std::cos(angle1), slope, std::sin(angle1) }, { 1.0f, 0.0f, 0.0f });
+                Vector3 normalApex = Normalize({ std::cos(midAngle), slope, std::sin(midAngle) }, { 0.0f, 1.0f, 0.0f });
+
+                PushTriangle(builder,
+                    MakeVertex(0.0f, halfHeight, 0.0f, 0.5f, 0.0f, normalApex.x, normalApex.y, normalApex.z),
+                    MakeVertex(x1, -halfHeight, z1, u1, 1.0f, normal1.x, normal1.y, normal1.z),
+                    MakeVertex(x0, -halfHeight, z0, u0, 1.0f, normal0.x, normal0.y, normal0.z));
+
+                ModelData::VertexData bottomCenter = MakeVertex(0.0f, -halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, -1.0f, 0.0f);
+                ModelData::VertexData bottom0 = MakeVertex(x0, -halfHeight, z0, x0 / (radius * 2.0f) + 0.5f, z0 / (radius * 2.0f) + 0.5f, 0.0f, -1.0f, 0.0f);
+                ModelData::VertexData bottom1 = MakeVertex(x1, -halfHeight, z1, x1 / (radius * 2.0f) + 0.5f, z1 / (radius * 2.0f) + 0.5f, 0.0f, -1.0f, 0.0f);
+                PushTriangle(builder, bottomCenter, bottom0, bottom1);
+            }
+
+            return data;
+        }
+    }
+
+    bool IsNear(float a, float b) {
+        return std::fabs(a - b) <= 1.0e-4f;
+    }
+
+    // 三角形の角ごとの頂点の比較 (頂点の並びや重複の除き方には依らない)
+    bool IsSameCorners(const ModelData& a, const ModelData& b) {
+        if (a.indices.size() != b.indices.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.indices.size(); ++i) {
+            const ModelData::VertexData& va = a.vertices[a.indices[i]];
+            const ModelData::VertexData& vb = b.vertices[b.indices[i]];
+            if (!IsNear(va.position.x, vb.position.x) || !IsNear(va.position.y, vb.position.y) || !IsNear(va.position.z, vb.position.z) ||
+                va.position.w != vb.position.w || !IsNear(va.texcoord.x, vb.texcoord.x) || !IsNear(va.texcoord.y, vb.texcoord.y) ||
+                !IsNear(va.normal.x, vb.normal.x) || !IsNear(va.normal.y, vb.normal.y) || !IsNear(va.normal.z, vb.normal.z)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct Case {
+        std::string name;
+        std::function<ModelData()> legacy;
+        std::function<ModelData()> create;
+        PrimitiveGenerator::MeshSize size;
+        std::function<void(const PrimitiveGenerator::MeshOutput&)> write;
+    };
+
+    void Report(const Case& primitive) {
+        const ModelData legacy = primitive.legacy();
+        const ModelData created = primitive.create();
+        const bool isSizeSame = created.vertices.size() == primitive.size.vertexCount && created.indices.size() == primitive.size.indexCount;
+
+        // 書き込み先は 1 度だけ確保して使い回す
+        const bool isShortIndex = primitive.size.vertexCount <= 0x10000;
+        std::vector<ModelData::VertexData> vertices(primitive.size.vertexCount);
+        std::vector<uint16_t> shortIndices(isShortIndex ? primitive.size.indexCount : 0);
+        std::vector<uint32_t> indices(isShortIndex ? 0 : primitive.size.indexCount);
+        const PrimitiveGenerator::MeshOutput output = {
+            vertices.data(), isShortIndex ? static_cast<void*>(shortIndices.data()) : static_cast<void*>(indices.data()), isShortIndex, 0 };
+        primitive.write(output);
+        ModelData written;
+        written.vertices = vertices;
+        written.indices = isShortIndex ? std::vector<uint32_t>(shortIndices.begin(), shortIndices.end()) : indices;
+        const bool isSame = isSizeSame && IsSameCorners(legacy, created) && IsSameCorners(created, written);
+
+        const double legacyMs = MeasureMs([&]() { gSink = gSink + primitive.legacy().indices.size(); });
+        const double createMs = MeasureMs([&]() { gSink = gSink + primitive.create().indices.size(); });
+        const double writeMs = MeasureMs([&]() {
+            primitive.write(output);
+            gSink = gSink + static_cast<size_t>(vertices.back().position.x);
+        });
+        const double kilobytes = (sizeof(ModelData::VertexData) * vertices.size() +
+            (isShortIndex ? sizeof(uint16_t) : sizeof(uint32_t)) * primitive.size.indexCount) / 1024.0;
+        std::printf("%-18s %9zu %9zu %9zu %3s %9.1f %9.3f %9.3f %9.3f %8.1fx %8.1fx %6s\n",
+            primitive.name.c_str(), legacy.vertices.size(), created.vertices.size(), created.indices.size(), isShortIndex ? "16" : "32",
+            kilobytes, legacyMs, createMs, writeMs, legacyMs / createMs, legacyMs / writeMs, isSame ? "yes" : "NO");
+    }
+}
+
+int main() {
+    using PG = PrimitiveGenerator;
+    std::vector<Case> cases;
+    for (uint32_t subdivision : { 16u, 256u, 1024u }) {
+        cases.push_back({ "sphere " + std::to_string(subdivision),
+            [=]() { return Legacy::CreateSphereData(subdivision); }, [=]() { return PG::CreateSphereData(subdivision); },
+            PG::GetSphereSize(subdivision), [=](const PG::MeshOutput& output) { PG::WriteSphereData(output, subdivision); } });
+    }
+    for (uint32_t subdivision : { 32u, 1024u, 65536u }) {
+        // アニメーションと同じく扇形で、半径も変える
+        cases.push_back({ "ring " + std::to_string(subdivision),
+            [=]() { return Legacy::CreateRingData(subdivision, 0.45f, 1.0f, 0.5f, 4.0f, 0.8f, 1.2f); },
+            [=]() { return PG::CreateRingData(subdivision, 0.45f, 1.0f, 0.5f, 4.0f, 0.8f, 1.2f); },
+            PG::GetRingSize(subdivision), [=](const PG::MeshOutput& output) { PG::WriteRingData(output, subdivision, 0.45f, 1.0f, 0.5f, 4.0f, 0.8f, 1.2f); } });
+    }
+    for (uint32_t subdivision : { 32u, 256u, 1024u }) {
+        const uint32_t minor = subdivision / 2;
+        cases.push_back({ "torus " + std::to_string(subdivision) + "x" + std::to_string(minor),
+            [=]() { return Legacy::CreateTorusData(subdivision, minor, 0.7f, 0.3f); }, [=]() { return PG::CreateTorusData(subdivision, minor); },
+            PG::GetTorusSize(subdivision, minor), [=](const PG::MeshOutput& output) { PG::WriteTorusData(output, subdivision, minor); } });
+    }
+    for (uint32_t subdivision : { 32u, 4096u, 65536u }) {
+        cases.push_back({ "cylinder " + std::to_string(subdivision),
+            [=]() { return Legacy::CreateCylinderData(subdivision, 1.0f, 2.0f); }, [=]() { return PG::CreateCylinderData(subdivision); },
+            PG::GetCylinderSize(subdivision), [=](const PG::MeshOutput& output) { PG::WriteCylinderData(output, subdivision); } });
+    }
+    for (uint32_t subdivision : { 32u, 4096u, 65536u }) {
+        cases.push_back({ "cone " + std::to_string(subdivision),
+            [=]() { return Legacy::CreateConeData(subdivision, 1.0f, 2.0f); }, [=]() { return PG::CreateConeData(subdivision); },
+            PG::GetConeSize(subdivision), [=](const PG::MeshOutput& output) { PG::WriteConeData(output, subdivision); } });
+    }
+
+    std::printf("%-18s %9s %9s %9s %3s %9s %9s %9s %9s %9s %9s %6s\n",
+        "primitive", "old verts", "vertices", "indices", "idx", "out KB", "legacy ms", "create ms", "write ms", "create", "write", "same");
+    for (const Case& primitive : cases) {
+        Report(primitive);
+    }
+    return gSink == 0xffffffff ? 1 : 0;
+}
@@ -0,0 +1,180 @@
+// 動かないオブジェクトをまとめる (StaticBatcher) のベンチマーク
+// 球・トーラスを不均一な拡大・回転でたくさん置き、まとめる前後の描画の回数と、まとめる時間を出力する
+// 球の法線を楕円体の解析的な法線と比べ、逆転置行列による変換 (batch) と、ワールド行列をそのまま使う変換 (naive) の誤差を出す
+// まとめた頂点番号が同じテクスチャのオブジェクトの頂点だけを指しているかも確かめる
+// 一部のオブジェクトは x を負に拡大 (鏡映) し、まとめた三角形の巻き順が法線と同じ側を表にしているかも確かめる
+#include "PrimitiveGenerator.h"
+#include "StaticBatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    constexpr uint32_t kTextureCount = 4;
+
+    Vector3 Normalize(const Vector3& v) {
+        const float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        return { v.x / length, v.y / length, v.z / length };
+    }
+
+    // 行ベクトルとして 3x3 の部分を掛ける
+    Vector3 TransformDirection(const Vector3& v, const Matrix4x4& m) {
+        return {
+            v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0],
+            v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1],
+            v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] };
+    }
+
+    float AngleDegree(const Vector3& a, const Vector3& b) {
+        const float dot = (std::clamp)(a.x * b.x + a.y * b.y + a.z * b.z, -1.0f, 1.0f);
+        return std::acos(dot) * 57.2957795f;
+    }
+
+    // 三角形の巻き順から求めた面の向きと、3 つの角の法線の和との内積 (正なら巻き順と法線の表が一致)
+    // 球の極のような潰れた三角形は向きが丸め誤差で決まるので 0 を返す
+    float GetFacing(const ModelData& data, const uint32_t* corner) {
+        const Vector4& a = data.vertices[corner[0]].position;
+        const Vector4& b = data.vertices[corner[1]].position;
+        const Vector4& c = data.vertices[corner[2]].position;
+        const Vector3 ab = { b.x - a.x, b.y - a.y, b.z - a.z };
+        const Vector3 ac = { c.x - a.x, c.y - a.y, c.z - a.z };
+        const Vector3 cross = { ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x };
+        Vector3 normal = { 0.0f, 0.0f, 0.0f };
+        for (int k = 0; k < 3; ++k) {
+            const Vector3& n = data.vertices[corner[k]].normal;
+            normal = { normal.x + n.x, normal.y + n.y, normal.z + n.z };
+        }
+        const float crossSq = cross.x * cross.x + cross.y * cross.y + cross.z * cross.z;
+        // 面積を最も長い辺の長さの 2 乗と比べる (極では 2 つの角がほぼ同じ位置にあり、短い辺の向きは当てにならない)
+        const float bcSq = (c.x - b.x) * (c.x - b.x) + (c.y - b.y) * (c.y - b.y) + (c.z - b.z) * (c.z - b.z);
+        const float edgeSq = (std::max)({ ab.x * ab.x + ab.y * ab.y + ab.z * ab.z, ac.x * ac.x + ac.y * ac.y + ac.z * ac.z, bcSq });
+        if (crossSq <= edgeSq * edgeSq * 1.0e-6f) {
+            return 0.0f;
+        }
+        return cross.x * normal.x + cross.y * normal.y + cross.z * normal.z;
+    }
+
+    struct Placement {
+        Vector3 scale;
+        Vector3 rotate;
+        Vector3 translate;
+    };
+}
+
+int main() {
+    // テクスチャごとに 1 つのマテリアル・サブメッシュを持つ元のメッシュ
+    std::vector<ModelData> sources;
+    for (uint32_t texture = 0; texture < kTextureCount; ++texture) {
+        ModelData data = (texture % 2 == 0) ? PrimitiveGenerator::CreateSphereData(32) : PrimitiveGenerator::CreateTorusData(32, 16);
+        data.materials.emplace_back().textureIndex = texture;
+        data.submeshes.push_back({ "", 0, static_cast<uint32_t>(data.indices.size()), 0 });
+        sources.push_back(std::move(data));
+    }
+    // 元のメッシュの巻き順の表が法線の側か (まとめた後も同じであればよい)
+    std::vector<bool> sourceFacings;
+    for (const ModelData& source : sources) {
+        double facing = 0.0;
+        for (size_t t = 0; t + 2 < source.indices.size(); t += 3) {
+            facing += GetFacing(source, &source.indices[t]);
+        }
+        sourceFacings.push_back(facing > 0.0);
+    }
+
+    std::printf("%-10s %10s %10s %10s %12s %10s %10s %10s\n", "instances", "before", "after", "vertices", "build ms", "grouped", "mirrored", "facing");
+    for (uint32_t instanceCount : { 64u, 512u, 4096u }) {
+        std::mt19937 random(instanceCount);
+        std::uniform_real_distribution<float> scaleDistribution(0.3f, 3.0f);
+        std::uniform_real_distribution<float> angleDistribution(-3.14159265f, 3.14159265f);
+        std::uniform_real_distribution<float> positionDistribution(-50.0f, 50.0f);
+        std::vector<Placement> placements(instanceCount);
+        std::vector<StaticBatcher::Instance> instances(instanceCount);
+        for (uint32_t i = 0; i < instanceCount; ++i) {
+            Placement& placement = placements[i];
+            placement.scale = { scaleDistribution(random), scaleDistribution(random), scaleDistribution(random) };
+            placement.rotate = { angleDistribution(random), angleDistribution(random), angleDistribution(random) };
+            placement.translate = { positionDistribution(random), positionDistribution(random), positionDistribution(random) };
+            // 7 個に 1 個は鏡映 (球とトーラスの両方に当たるようテクスチャの数と互いに素な間隔にする)
+            if (i % 7 == 6) {
+                placement.scale.x = -placement.scale.x;
+            }
+            instances[i].modelData = &sources[i % kTextureCount];
+            instances[i].worldMatrix = MatrixMath::MakeAffine(placement.scale, placement.rotate, placement.translate);
+        }
+
+        double bestMs = 1.0e30;
+        StaticBatcher::Stats stats;
+        ModelData batch;
+        for (int repeat = 0; repeat < 3; ++repeat) {
+            const auto start = Clock::now();
+            batch = StaticBatcher::Build(instances.data(), instances.size(), &stats);
+            bestMs = (std::min)(bestMs, ElapsedMs(start));
+        }
+
+        // 頂点ごとに元のオブジェクトのテクスチャを求め、サブメッシュの頂点番号が全て同じテクスチャを指すか調べる
+        std::vector<uint32_t> vertexTextures;
+        for (uint32_t i = 0; i < instanceCount; ++i) {
+            vertexTextures.insert(vertexTextures.end(), instances[i].modelData->vertices.size(), i % kTextureCount);
+        }
+        bool isGrouped = batch.submeshes.size() == kTextureCount;
+        for (const ModelData::Submesh& submesh : batch.submeshes) {
+            const uint32_t textureIndex = batch.materials[submesh.materialIndex].textureIndex;
+            for (uint32_t k = 0; k < submesh.indexCount; ++k) {
+                isGrouped = isGrouped && vertexTextures[batch.indices[submesh.indexStart + k]] == textureIndex;
+            }
+        }
+        // 鏡映したオブジェクトも含め、全ての三角形の表が元のメッシュと同じ側か (潰れた三角形は除く)
+        bool isFacingKept = true;
+        for (size_t t = 0; t + 2 < batch.indices.size(); t += 3) {
+            const float facing = GetFacing(batch, &batch.indices[t]);
+            if (facing != 0.0f) {
+                isFacingKept = isFacingKept && (facing > 0.0f) == sourceFacings[vertexTextures[batch.indices[t]]];
+            }
+        }
+
+        std::printf("%-10u %10u %10u %10zu %12.3f %10s %10u %10s\n", instanceCount, stats.drawCallCountBefore, stats.drawCallCountAfter,
+            stats.vertexCount, bestMs, isGrouped ? "yes" : "NO", (instanceCount + 1) / 7, isFacingKept ? "yes" : "NO");
+
+        if (instanceCount != 512) {
+            continue;
+        }
+        // 半径 1 の球の点 p を拡大すると楕円体の法線は (px / sx, py / sy, pz / sz) の向きになり、それを回転する
+        double batchError = 0.0, naiveError = 0.0;
+        float batchMaxError = 0.0f, naiveMaxError = 0.0f;
+        size_t normalCount = 0;
+        uint32_t baseVertex = 0;
+        for (uint32_t i = 0; i < instanceCount; ++i) {
+            const ModelData& source = *instances[i].modelData;
+            if (i % kTextureCount % 2 == 0) {
+                const Placement& placement = placements[i];
+                const Matrix4x4 rotation = MatrixMath::MakeAffine({ 1.0f, 1.0f, 1.0f }, placement.rotate, { 0.0f, 0.0f, 0.0f });
+                for (size_t v = 0; v < source.vertices.size(); ++v) {
+                    const Vector4& p = source.vertices[v].position;
+                    const Vector3 expected = Normalize(TransformDirection(
+                        { p.x / placement.scale.x, p.y / placement.scale.y, p.z / placement.scale.z }, rotation));
+                    const float batchAngle = AngleDegree(batch.vertices[baseVertex + v].normal, expected);
+                    const float naiveAngle = AngleDegree(Normalize(TransformDirection(source.vertices[v].normal, instances[i].worldMatrix)), expected);
+                    batchError += batchAngle;
+                    naiveError += naiveAngle;
+                    batchMaxError = (std::max)(batchMaxError, batchAngle);
+                    naiveMaxError = (std::max)(naiveMaxError, naiveAngle);
+                    ++normalCount;
+                }
+            }
+            baseVertex += static_cast<uint32_t>(source.vertices.size());
+        }
+        std::printf("\nellipsoid normal error over %zu vertices (degrees)\n", normalCount);
+        std::printf("  batch (inverse transpose) : mean %8.4f  max %8.4f\n", batchError / normalCount, batchMaxError);
+        std::printf("  naive (world matrix)      : mean %8.4f  max %8.4f\n\n", naiveError / normalCount, naiveMaxError);
+    }
+    return 0;
+}
@@ -0,0 +1,243 @@
+// 三角形 BVH のベンチマーク
+// resources/obj の OBJ と合成した 100 万三角形のメッシュで、構築時間・ノード数・レイの処理量を出力し、
+// 一部のレイで総当たりの結果と一致するか確かめる
+#include "Culling.h"
+#include "Matrix4x4.h"
+#include "TriangleBvh.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr size_t kRayCount = 200000;
+    constexpr size_t kCheckRayCount = 200;
+
+    // 最適化で消されないように結果を集計する
+    volatile size_t gSink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Model::LoadObjFile と同じ向き (x 反転・巻き順反転) で座標だけを読む
+    bool LoadObjPositions(const std::string& path, std::vector<Vector3>& vertices) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::vector<Vector3> positions;
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream s(line);
+            std::string identifier;
+            s >> identifier;
+            if (identifier == "v") {
+                Vector3 p{};
+                s >> p.x >> p.y >> p.z;
+                p.x *= -1.0f;
+                positions.push_back(p);
+            } else if (identifier == "f") {
+                Vector3 triangle[3];
+                for (int i = 0; i < 3; ++i) {
+                    std::string vertexDefinition;
+                    s >> vertexDefinition;
+                    triangle[i] = positions[std::stoul(vertexDefinition.substr(0, vertexDefinition.find('/'))) - 1];
+                }
+                vertices.push_back(triangle[2]);
+                vertices.push_back(triangle[1]);
+                vertices.push_back(triangle[0]);
+            }
+        }
+        return true;
+    }
+
+    // 緯度経度で分割した球 (三角形数 = 2 * segments^2)
+    std::vector<Vector3> CreateSphere(uint32_t segments) {
+        std::vector<Vector3> vertices;
+        vertices.reserve(static_cast<size_t>(segments) * segments * 6);
+        const float pi = 3.14159265f;
+        auto Point = [&](uint32_t lat, uint32_t lon) {
+            const float theta = pi * static_cast<float>(lat) / static_cast<float>(segments);
+            const float phi = 2.0f * pi * static_cast<float>(lon) / static_cast<float>(segments);
+            return Vector3{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+        };
+        for (uint32_t lat = 0; lat < segments; ++lat) {
+            for (uint32_t lon = 0; lon < segments; ++lon) {
+                const Vector3 a = Point(lat, lon);
+                const Vector3 b = Point(lat + 1, lon);
+                const Vector3 c = Point(lat, lon + 1);
+                const Vector3 d = Point(lat + 1, lon + 1);
+                vertices.insert(vertices.end(), { a, b, c, c, b, d });
+            }
+        }
+        return vertices;
+    }
+
+    // 立方体の中に散らばった小さな三角形 (偏りのないバラバラの配置)
+    std::vector<Vector3> CreateTriangleSoup(size_t triangleCount) {
+        std::mt19937 gen(13579);
+        std::uniform_real_distribution<float> positionDist(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> offsetDist(-0.01f, 0.01f);
+        std::vector<Vector3> vertices(triangleCount * 3);
+        for (size_t i = 0; i < triangleCount; ++i) {
+            const Vector3 center = { positionDist(gen), positionDist(gen), positionDist(gen) };
+            for (size_t k = 0; k < 3; ++k) {
+                vertices[i * 3 + k] = { center.x + offsetDist(gen), center.y + offsetDist(gen), center.z + offsetDist(gen) };
+            }
+        }
+        return vertices;
+    }
+
+    // メッシュの外側からメッシュの範囲へ向かうレイ
+    std::vector<Ray> CreateRays(const std::vector<Vector3>& vertices, size_t count) {
+        Aabb bounds = { vertices[0], vertices[0] };
+        for (const Vector3& v : vertices) {
+            bounds.min = { (std::min)(bounds.min.x, v.x), (std::min)(bounds.min.y, v.y), (std::min)(bounds.min.z, v.z) };
+            bounds.max = { (std::max)(bounds.max.x, v.x), (std::max)(bounds.max.y, v.y), (std::max)(bounds.max.z, v.z) };
+        }
+        const Vector3 center = { (bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f };
+        const float radius = std::sqrt(
+            (bounds.max.x - center.x) * (bounds.max.x - center.x) +
+            (bounds.max.y - center.y) * (bounds.max.y - center.y) +
+            (bounds.max.z - center.z) * (bounds.max.z - center.z)) + 0.01f;
+
+        std::mt19937 gen(86420);
+        std::uniform_real_distribution<float> unitDist(-1.0f, 1.0f);
+        std::vector<Ray> rays(count);
+        for (Ray& ray : rays) {
+            Vector3 direction;
+            float length;
+            do {
+                direction = { unitDist(gen), unitDist(gen), unitDist(gen) };
+                length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+            } while (length < 0.1f || length > 1.0f);
+            const Vector3 origin = { center.x + direction.x / length * radius * 2.0f, center.y + direction.y / length * radius * 2.0f, center.z + direction.z / length * radius * 2.0f };
+            const Vector3 target = { center.x + unitDist(gen) * radius * 0.5f, center.y + unitDist(gen) * radius * 0.5f, center.z + unitDist(gen) * radius * 0.5f };
+            ray = { origin, { target.x - origin.x, target.y - origin.y, target.z - origin.z }, 2.0f };
+        }
+        return rays;
+    }
+
+    // 総当たりで最も近い三角形を求める (両面の Möller-Trumbore)
+    bool BruteForceRayCast(const std::vector<Vector3>& vertices, const Ray& ray, float& closest) {
+        bool isHit = false;
+        closest = ray.maxDistance;
+        const Vector3& d = ray.direction;
+        for (size_t i = 0; i + 2 < vertices.size(); i += 3) {
+            const Vector3& p0 = vertices[i];
+            const Vector3 e1 = { vertices[i + 1].x - p0.x, vertices[i + 1].y - p0.y, vertices[i + 1].z - p0.z };
+            const Vector3 e2 = { vertices[i + 2].x - p0.x, vertices[i + 2].y - p0.y, vertices[i + 2].z - p0.z };
+            const Vector3 p = MatrixMath::Cross(d, e2);
+            const float determinant = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+            if (std::fabs(determinant) < 1.0e-12f) {
+                continue;
+            }
+            const float inverse = 1.0f / determinant;
+            const Vector3 s = { ray.origin.x - p0.x, ray.origin.y - p0.y, ray.origin.z - p0.z };
+            const float u = (s.x * p.x + s.y * p.y + s.z * p.z) * inverse;
+            if (u < 0.0f || u > 1.0f) {
+                continue;
+            }
+            const Vector3 q = MatrixMath::Cross(s, e1);
+            const float v = (d.x * q.x + d.y * q.y + d.z * q.z) * inverse;
+            if (v < 0.0f || u + v > 1.0f) {
+                continue;
+            }
+            const float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * inverse;
+            if (t >= 0.0f && t < closest) {
+                closest = t;
+                isHit = true;
+            }
+        }
+        return isHit;
+    }
+
+    void RunMesh(const char* name, const std::vector<Vector3>& vertices) {
+        if (vertices.size() < 3) {
+            std::printf("%-14s (empty)\n", name);
+            return;
+        }
+
+        TriangleBvh bvh;
+        auto start = Clock::now();
+        bvh.Build(vertices.data(), sizeof(Vector3), vertices.size());
+        const double buildMs = ElapsedMs(start);
+
+        const std::vector<Ray> rays = CreateRays(vertices, kRayCount);
+        std::vector<TriangleBvh::Hit> hits(rays.size());
+        std::unique_ptr<bool[]> isHits(new bool[rays.size()]);
+        start = Clock::now();
+        const size_t hitCount = bvh.RayCastBatch(rays.data(), rays.size(), hits.data(), isHits.get());
+        const double rayMs = ElapsedMs(start);
+
+        // 一部のレイを総当たりと比べる (距離と、重心座標から戻した当たり位置)
+        size_t mismatches = 0;
+        for (size_t r = 0; r < kCheckRayCount; ++r) {
+            const size_t index = r * (rays.size() / kCheckRayCount);
+            float closest;
+            const bool isBruteHit = BruteForceRayCast(vertices, rays[index], closest);
+            if (isBruteHit != isHits[index]) {
+                ++mismatches;
+                continue;
+            }
+            if (!isBruteHit) {
+                continue;
+            }
+            const TriangleBvh::Hit& hit = hits[index];
+            const Vector3& p0 = vertices[hit.triangleIndex * 3];
+            const Vector3& p1 = vertices[hit.triangleIndex * 3 + 1];
+            const Vector3& p2 = vertices[hit.triangleIndex * 3 + 2];
+            const float w = 1.0f - hit.u - hit.v;
+            const Vector3 point = {
+                w * p0.x + hit.u * p1.x + hit.v * p2.x,
+                w * p0.y + hit.u * p1.y + hit.v * p2.y,
+                w * p0.z + hit.u * p1.z + hit.v * p2.z
+            };
+            const Ray& ray = rays[index];
+            const Vector3 expected = { ray.origin.x + ray.direction.x * hit.distance, ray.origin.y + ray.direction.y * hit.distance, ray.origin.z + ray.direction.z * hit.distance };
+            const float pointError = std::fabs(point.x - expected.x) + std::fabs(point.y - expected.y) + std::fabs(point.z - expected.z);
+            if (std::fabs(closest - hit.distance) > 1.0e-5f || pointError > 1.0e-3f) {
+                ++mismatches;
+            }
+        }
+
+        std::printf("%-14s %9zu %9zu %10.2f %12.2f %8.1f %10zu\n",
+            name, bvh.GetTriangleCount(), bvh.GetNodeCount(), buildMs,
+            static_cast<double>(rays.size()) / (rayMs * 1000.0), 100.0 * static_cast<double>(hitCount) / static_cast<double>(rays.size()), mismatches);
+        gSink = gSink + hitCount;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string resourceDirectory = "resources/obj";
+    if (argc > 1) {
+        resourceDirectory = argv[1];
+    }
+
+    std::printf("%zu rays per mesh, %zu checked against brute force\n", kRayCount, kCheckRayCount);
+    std::printf("%-14s %9s %9s %10s %12s %8s %10s\n", "mesh", "triangles", "nodes", "build(ms)", "Mrays/s", "hit(%)", "mismatches");
+
+    for (const char* name : { "axis", "fence", "multiMaterial", "multiMesh", "plane" }) {
+        std::vector<Vector3> vertices;
+        if (!LoadObjPositions(resourceDirectory + "/" + name + "/" + name + ".obj", vertices)) {
+            std::printf("%-14s (not found)\n", name);
+            continue;
+        }
+        RunMesh(name, vertices);
+    }
+
+    RunMesh("sphere 1M", CreateSphere(708));
+    RunMesh("soup 1M", CreateTriangleSoup(1000000));
+    return gSink == 0xffffffff ? 1 : 0;
+}
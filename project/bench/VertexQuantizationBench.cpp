@@ -0,0 +1,110 @@
+// 頂点の量子化 (VertexQuantization) の大きさと誤差、符号化の速さを出力する
+// 続いて half の変換が全ての値で往復するか、ランダムな法線での八面体符号化の最大誤差を確かめる
+#include "ObjLoader.h"
+#include "PrimitiveGenerator.h"
+#include "VertexQuantization.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* GetFormatName(VertexFormat format) {
+        switch (format) {
+        case VertexFormat::kFloat:
+            return "float";
+        case VertexFormat::kPackedFloat:
+            return "packed float";
+        case VertexFormat::kPackedHalf:
+            return "packed half";
+        default:
+            return "?";
+        }
+    }
+
+    void Report(const char* name, const ModelData& data) {
+        const size_t floatBytes = sizeof(ModelData::VertexData) * data.vertices.size();
+        for (VertexFormat format : { VertexFormat::kPackedFloat, VertexFormat::kPackedHalf }) {
+            if (format == VertexFormat::kPackedHalf && !VertexQuantization::CanUseHalfPosition(data.vertices.data(), data.vertices.size())) {
+                std::printf("%-16s %-13s (position out of half range)\n", name, GetFormatName(format));
+                continue;
+            }
+            const size_t bytes = static_cast<size_t>(VertexQuantization::GetVertexStride(format)) * data.vertices.size();
+            std::vector<uint8_t> encoded(bytes);
+            const int repeat = data.vertices.size() > 10000 ? 5 : 200;
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeat; ++i) {
+                VertexQuantization::Encode(format, data.vertices.data(), data.vertices.size(), encoded.data());
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeat;
+            const VertexQuantization::QuantizationError error =
+                VertexQuantization::MeasureError(format, data.vertices.data(), data.vertices.size());
+
+            std::printf("%-16s %-13s %8zu %10zu %10zu %6.1f%% %12.3g %10.5f %12.3g %10.1f\n",
+                name, GetFormatName(format), data.vertices.size(), floatBytes, bytes,
+                100.0 * static_cast<double>(bytes) / static_cast<double>(floatBytes),
+                error.position, error.normalDegrees, error.texcoord,
+                static_cast<double>(data.vertices.size()) / seconds / 1.0e6);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string resourceDirectory = "resources/obj";
+    if (argc > 1) {
+        resourceDirectory = argv[1];
+    }
+
+    std::printf("%-16s %-13s %8s %10s %10s %7s %12s %10s %12s %10s\n",
+        "mesh", "format", "vertices", "float B", "packed B", "size", "pos err", "nrm deg", "uv err", "Mvtx/s");
+    for (const char* name : { "axis", "fence", "multiMaterial", "multiMesh", "plane" }) {
+        const std::string directoryPath = resourceDirectory + "/" + name;
+        const std::string filename = std::string(name) + ".obj";
+        if (!std::filesystem::exists(directoryPath + "/" + filename)) {
+            std::printf("%-16s (not found)\n", name);
+            continue;
+        }
+        Report(name, ObjLoader::LoadObjFile(directoryPath, filename));
+    }
+    Report("sphere", PrimitiveGenerator::CreateSphereData());
+    Report("torus", PrimitiveGenerator::CreateTorusData());
+    Report("ring", PrimitiveGenerator::CreateRingData());
+    Report("sphere 256", PrimitiveGenerator::CreateSphereData(256));
+
+    // half -> float -> half が NaN 以外の全ての値で元に戻るか
+    uint32_t mismatchCount = 0;
+    for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+        const uint16_t half = static_cast<uint16_t>(bits);
+        const bool isNan = (half & 0x7c00) == 0x7c00 && (half & 0x03ff) != 0;
+        if (!isNan && VertexQuantization::FloatToHalf(VertexQuantization::HalfToFloat(half)) != half) {
+            ++mismatchCount;
+        }
+    }
+    std::printf("\nhalf round trip mismatches: %u / 65536\n", mismatchCount);
+
+    // 球面上の一様な向きでの八面体符号化の最大誤差
+    std::mt19937 random(12345);
+    std::normal_distribution<float> distribution;
+    float maxDegrees = 0.0f;
+    double sumDegrees = 0.0;
+    constexpr size_t kNormalCount = 1000000;
+    std::vector<ModelData::VertexData> vertices(kNormalCount);
+    for (ModelData::VertexData& vertex : vertices) {
+        vertex.position = { 0.0f, 0.0f, 0.0f, 1.0f };
+        vertex.texcoord = { 0.0f, 0.0f };
+        vertex.normal = { distribution(random), distribution(random), distribution(random) };
+    }
+    for (const ModelData::VertexData& vertex : vertices) {
+        const VertexQuantization::QuantizationError error = VertexQuantization::MeasureError(VertexFormat::kPackedFloat, &vertex, 1);
+        maxDegrees = (std::max)(maxDegrees, error.normalDegrees);
+        sumDegrees += error.normalDegrees;
+    }
+    std::printf("octahedral snorm16 normal error: max %.5f deg, mean %.5f deg (%zu random directions)\n",
+        maxDegrees, sumDegrees / kNormalCount, kNormalCount);
+    return mismatchCount == 0 ? 0 : 1;
+}
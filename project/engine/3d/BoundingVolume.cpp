@@ -0,0 +1,286 @@
+#include "BoundingVolume.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+    float DistanceSquared(const Vector3& a, const Vector3& b) {
+        const float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // 球の外の点 p を含むように、p の反対側の端を残して球を広げる
+    void GrowSphere(BoundingSphere& sphere, const Vector3& p) {
+        const float distanceSq = DistanceSquared(sphere.center, p);
+        if (distanceSq <= sphere.radius * sphere.radius) {
+            return;
+        }
+        const float distance = std::sqrt(distanceSq);
+        const float radius = (sphere.radius + distance) * 0.5f;
+        const float t = (radius - sphere.radius) / distance;
+        sphere.center = {
+            sphere.center.x + (p.x - sphere.center.x) * t,
+            sphere.center.y + (p.y - sphere.center.y) * t,
+            sphere.center.z + (p.z - sphere.center.z) * t };
+        sphere.radius = radius;
+    }
+
+    // 軸ごとに最小・最大の点の組のうち最も離れた組を直径にして、全ての点を含むまで広げる
+    BoundingSphere ComputeRitterSphere(const Vector3* points, size_t count) {
+        size_t minIndex[3] = { 0, 0, 0 };
+        size_t maxIndex[3] = { 0, 0, 0 };
+        float minValue[3] = { points[0].x, points[0].y, points[0].z };
+        float maxValue[3] = { points[0].x, points[0].y, points[0].z };
+        for (size_t i = 1; i < count; ++i) {
+            const float value[3] = { points[i].x, points[i].y, points[i].z };
+            for (int axis = 0; axis < 3; ++axis) {
+                if (value[axis] < minValue[axis]) {
+                    minValue[axis] = value[axis];
+                    minIndex[axis] = i;
+                }
+                if (value[axis] > maxValue[axis]) {
+                    maxValue[axis] = value[axis];
+                    maxIndex[axis] = i;
+                }
+            }
+        }
+        int bestAxis = 0;
+        float bestDistanceSq = -1.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            const float distanceSq = DistanceSquared(points[minIndex[axis]], points[maxIndex[axis]]);
+            if (distanceSq > bestDistanceSq) {
+                bestDistanceSq = distanceSq;
+                bestAxis = axis;
+            }
+        }
+        const Vector3& a = points[minIndex[bestAxis]];
+        const Vector3& b = points[maxIndex[bestAxis]];
+        BoundingSphere sphere = { { (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f }, std::sqrt(bestDistanceSq) * 0.5f };
+        for (size_t i = 0; i < count; ++i) {
+            GrowSphere(sphere, points[i]);
+        }
+        return sphere;
+    }
+
+    // 対称な 3x3 行列 a を Jacobi 法で対角化する (a の対角が固有値、vectors の列が固有ベクトルになる)
+    void DiagonalizeSymmetric(double a[3][3], double vectors[3][3]) {
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                vectors[i][j] = (i == j) ? 1.0 : 0.0;
+            }
+        }
+        for (int iteration = 0; iteration < 32; ++iteration) {
+            // 絶対値が最大の非対角成分を消す回転を掛ける
+            int p = 0, q = 1;
+            for (int i = 0; i < 3; ++i) {
+                for (int j = i + 1; j < 3; ++j) {
+                    if (std::fabs(a[i][j]) > std::fabs(a[p][q])) {
+                        p = i;
+                        q = j;
+                    }
+                }
+            }
+            const double diagonal = std::fabs(a[0][0]) + std::fabs(a[1][1]) + std::fabs(a[2][2]);
+            if (std::fabs(a[p][q]) <= diagonal * 1.0e-12) {
+                return;
+            }
+            const double r = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+            const double t = (r >= 0.0) ? 1.0 / (r + std::sqrt(1.0 + r * r)) : -1.0 / (-r + std::sqrt(1.0 + r * r));
+            const double c = 1.0 / std::sqrt(1.0 + t * t);
+            const double s = t * c;
+            // a = J^T a J, vectors = vectors J (J は p, q 平面の回転)
+            for (int k = 0; k < 3; ++k) {
+                const double akp = a[k][p], akq = a[k][q];
+                a[k][p] = c * akp - s * akq;
+                a[k][q] = s * akp + c * akq;
+            }
+            for (int k = 0; k < 3; ++k) {
+                const double apk = a[p][k], aqk = a[q][k];
+                a[p][k] = c * apk - s * aqk;
+                a[q][k] = s * apk + c * aqk;
+            }
+            for (int k = 0; k < 3; ++k) {
+                const double vkp = vectors[k][p], vkq = vectors[k][q];
+                vectors[k][p] = c * vkp - s * vkq;
+                vectors[k][q] = s * vkp + c * vkq;
+            }
+        }
+    }
+
+    Vector3 Normalize(const Vector3& v, const Vector3& fallback) {
+        const float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        return length > 1.0e-20f ? Vector3{ v.x / length, v.y / length, v.z / length } : fallback;
+    }
+
+    ModelData::Bounds ComputeBounds(std::vector<Vector3>& points) {
+        ModelData::Bounds bounds;
+        if (points.empty()) {
+            return bounds;
+        }
+        bounds.aabb = BoundingVolume::ComputeAabb(points.data(), points.size());
+        bounds.obb = BoundingVolume::ComputeObb(points.data(), points.size());
+        // 球は点を並べ替えるので最後に作る
+        bounds.sphere = BoundingVolume::ComputeSphere(points.data(), points.size());
+        return bounds;
+    }
+}
+
+Aabb BoundingVolume::ComputeAabb(const Vector3* points, size_t count) {
+    if (count == 0) {
+        return { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+    }
+    Aabb aabb = { points[0], points[0] };
+    for (size_t i = 1; i < count; ++i) {
+        aabb.min = { (std::min)(aabb.min.x, points[i].x), (std::min)(aabb.min.y, points[i].y), (std::min)(aabb.min.z, points[i].z) };
+        aabb.max = { (std::max)(aabb.max.x, points[i].x), (std::max)(aabb.max.y, points[i].y), (std::max)(aabb.max.z, points[i].z) };
+    }
+    return aabb;
+}
+
+BoundingSphere BoundingVolume::ComputeSphere(Vector3* points, size_t count, uint32_t refineIterationCount) {
+    if (count == 0) {
+        return { { 0.0f, 0.0f, 0.0f }, 0.0f };
+    }
+    BoundingSphere sphere = ComputeRitterSphere(points, count);
+
+    // 半径を 5% 縮めた球から、ばらばらに並べた点で広げ直し、小さくなったものを残す
+    // 並べ替えは毎回同じ結果になるよう固定の種の xorshift で行う
+    BoundingSphere candidate = sphere;
+    uint32_t state = 0x9E3779B9u;
+    for (uint32_t iteration = 0; iteration < refineIterationCount; ++iteration) {
+        candidate.radius *= 0.95f;
+        for (size_t i = 0; i < count; ++i) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            std::swap(points[i], points[i + state % (count - i)]);
+            GrowSphere(candidate, points[i]);
+        }
+        if (candidate.radius < sphere.radius) {
+            sphere = candidate;
+        }
+    }
+
+    // 広げるときの丸めの誤差で外に出た点も含める
+    float radiusSq = sphere.radius * sphere.radius;
+    for (size_t i = 0; i < count; ++i) {
+        radiusSq = (std::max)(radiusSq, DistanceSquared(sphere.center, points[i]));
+    }
+    sphere.radius = std::sqrt(radiusSq);
+    return sphere;
+}
+
+Obb BoundingVolume::ComputeObb(const Vector3* points, size_t count) {
+    Obb obb = { { 0.0f, 0.0f, 0.0f }, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { 0.0f, 0.0f, 0.0f } };
+    if (count == 0) {
+        return obb;
+    }
+
+    // --- 平均と共分散行列 (桁落ちを避けるため double で足す) ---
+    double mean[3] = { 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < count; ++i) {
+        mean[0] += points[i].x;
+        mean[1] += points[i].y;
+        mean[2] += points[i].z;
+    }
+    for (double& value : mean) {
+        value /= static_cast<double>(count);
+    }
+    double covariance[3][3] = {};
+    for (size_t i = 0; i < count; ++i) {
+        const double d[3] = { points[i].x - mean[0], points[i].y - mean[1], points[i].z - mean[2] };
+        for (int row = 0; row < 3; ++row) {
+            for (int col = row; col < 3; ++col) {
+                covariance[row][col] += d[row] * d[col];
+            }
+        }
+    }
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < row; ++col) {
+            covariance[row][col] = covariance[col][row];
+        }
+    }
+
+    // --- 主成分を軸にして、点を軸へ投影した範囲を箱にする ---
+    double vectors[3][3];
+    DiagonalizeSymmetric(covariance, vectors);
+    Vector3 axis[3];
+    axis[0] = Normalize({ static_cast<float>(vectors[0][0]), static_cast<float>(vectors[1][0]), static_cast<float>(vectors[2][0]) }, { 1.0f, 0.0f, 0.0f });
+    axis[1] = Normalize({ static_cast<float>(vectors[0][1]), static_cast<float>(vectors[1][1]), static_cast<float>(vectors[2][1]) }, { 0.0f, 1.0f, 0.0f });
+    // 丸めで直交からずれないよう、3 本目は外積で作る (右手系の並びにもなる)
+    axis[2] = Normalize(MatrixMath::Cross(axis[0], axis[1]), { 0.0f, 0.0f, 1.0f });
+    axis[1] = MatrixMath::Cross(axis[2], axis[0]);
+
+    float minimum[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+    float maximum[3] = { -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() };
+    const Vector3 origin = { static_cast<float>(mean[0]), static_cast<float>(mean[1]), static_cast<float>(mean[2]) };
+    for (size_t i = 0; i < count; ++i) {
+        const Vector3 d = { points[i].x - origin.x, points[i].y - origin.y, points[i].z - origin.z };
+        for (int a = 0; a < 3; ++a) {
+            const float projection = d.x * axis[a].x + d.y * axis[a].y + d.z * axis[a].z;
+            minimum[a] = (std::min)(minimum[a], projection);
+            maximum[a] = (std::max)(maximum[a], projection);
+        }
+    }
+    obb.center = origin;
+    for (int a = 0; a < 3; ++a) {
+        const float middle = (minimum[a] + maximum[a]) * 0.5f;
+        obb.center = { obb.center.x + axis[a].x * middle, obb.center.y + axis[a].y * middle, obb.center.z + axis[a].z * middle };
+        obb.axis[a] = axis[a];
+    }
+    obb.halfExtent = { (maximum[0] - minimum[0]) * 0.5f, (maximum[1] - minimum[1]) * 0.5f, (maximum[2] - minimum[2]) * 0.5f };
+
+    // 箱のような形では主成分が辺に沿わないことがあるので、AABB の方が小さければ AABB を使う
+    const Aabb aabb = ComputeAabb(points, count);
+    const Vector3 aabbHalfExtent = { (aabb.max.x - aabb.min.x) * 0.5f, (aabb.max.y - aabb.min.y) * 0.5f, (aabb.max.z - aabb.min.z) * 0.5f };
+    if (aabbHalfExtent.x * aabbHalfExtent.y * aabbHalfExtent.z <= obb.halfExtent.x * obb.halfExtent.y * obb.halfExtent.z) {
+        obb.center = { (aabb.min.x + aabb.max.x) * 0.5f, (aabb.min.y + aabb.max.y) * 0.5f, (aabb.min.z + aabb.max.z) * 0.5f };
+        obb.axis[0] = { 1.0f, 0.0f, 0.0f };
+        obb.axis[1] = { 0.0f, 1.0f, 0.0f };
+        obb.axis[2] = { 0.0f, 0.0f, 1.0f };
+        obb.halfExtent = aabbHalfExtent;
+    }
+    return obb;
+}
+
+void BoundingVolume::Build(ModelData& modelData) {
+    std::vector<Vector3> points;
+    points.reserve(modelData.vertices.size());
+    for (const ModelData::VertexData& vertex : modelData.vertices) {
+        points.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+    }
+    modelData.bounds = ComputeBounds(points);
+
+    // サブメッシュの頂点は、頂点ごとに最後に集めたサブメッシュの番号を覚えて重複を除く
+    modelData.submeshBounds.assign(modelData.submeshes.size(), {});
+    std::vector<uint32_t> lastSubmesh(modelData.vertices.size(), UINT32_MAX);
+    for (uint32_t s = 0; s < modelData.submeshes.size(); ++s) {
+        const ModelData::Submesh& submesh = modelData.submeshes[s];
+        points.clear();
+        for (uint32_t k = 0; k < submesh.indexCount; ++k) {
+            const uint32_t index = modelData.indices[submesh.indexStart + k];
+            if (lastSubmesh[index] != s) {
+                lastSubmesh[index] = s;
+                const Vector4& position = modelData.vertices[index].position;
+                points.push_back({ position.x, position.y, position.z });
+            }
+        }
+        modelData.submeshBounds[s] = ComputeBounds(points);
+    }
+}
+
+void BoundingVolume::BuildAabb(ModelData& modelData) {
+    if (modelData.vertices.empty()) {
+        modelData.bounds.aabb = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+        return;
+    }
+    const Vector4& first = modelData.vertices[0].position;
+    Aabb aabb = { { first.x, first.y, first.z }, { first.x, first.y, first.z } };
+    for (const ModelData::VertexData& vertex : modelData.vertices) {
+        const Vector4& p = vertex.position;
+        aabb.min = { (std::min)(aabb.min.x, p.x), (std::min)(aabb.min.y, p.y), (std::min)(aabb.min.z, p.z) };
+        aabb.max = { (std::max)(aabb.max.x, p.x), (std::max)(aabb.max.y, p.y), (std::max)(aabb.max.z, p.z) };
+    }
+    modelData.bounds.aabb = aabb;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "ModelData.h"
+#include <cstddef>
+#include <cstdint>
+
+// 頂点を包む境界 (AABB・球・有向ボックス) を作る
+// 球は Ritter の方法で作った球を、点の順を入れ替えて少し小さい球から作り直すことを繰り返して縮める (最小の球に近くなる)
+// 有向ボックスは頂点の分布の主成分 (共分散行列の固有ベクトル) を軸にする (AABB の方が小さければ AABB を使う)
+// ワールド座標への変換は Culling::TransformAabb / TransformSphere / TransformObb で行う
+namespace BoundingVolume {
+    Aabb ComputeAabb(const Vector3* points, size_t count);
+    // points は並べ替える (refineIterationCount が 0 なら Ritter の球のまま)
+    BoundingSphere ComputeSphere(Vector3* points, size_t count, uint32_t refineIterationCount = 8);
+    Obb ComputeObb(const Vector3* points, size_t count);
+
+    // modelData.bounds と、サブメッシュごとに頂点番号が指す頂点だけを包む modelData.submeshBounds を作る
+    void Build(ModelData& modelData);
+    // modelData.bounds.aabb だけを作り直す (球・有向ボックス・サブメッシュの境界はそのまま、毎フレーム形の変わるメッシュ用)
+    void BuildAabb(ModelData& modelData);
+}
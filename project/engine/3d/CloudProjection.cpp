@@ -0,0 +1,185 @@
+#include "CloudProjection.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    Vector4 TransformPoint(const Vector3& value, const Matrix4x4& matrix)
+    {
+        return {
+            value.x * matrix.m[0][0] + value.y * matrix.m[1][0] + value.z * matrix.m[2][0] + matrix.m[3][0],
+            value.x * matrix.m[0][1] + value.y * matrix.m[1][1] + value.z * matrix.m[2][1] + matrix.m[3][1],
+            value.x * matrix.m[0][2] + value.y * matrix.m[1][2] + value.z * matrix.m[2][2] + matrix.m[3][2],
+            value.x * matrix.m[0][3] + value.y * matrix.m[1][3] + value.z * matrix.m[2][3] + matrix.m[3][3]
+        };
+    }
+}
+
+CloudProjection::ProjectedBounds CloudProjection::BuildProjectedBounds(const CloudVolume& cloudVolume, const Vector3& cameraPosition, const Matrix4x4& viewProjection, const Frustum& frustum, const Settings& settings)
+{
+    const int32_t screenWidth = settings.screenWidth;
+    const int32_t screenHeight = settings.screenHeight;
+    const ForceMode forceMode = settings.forceMode;
+
+    ProjectedBounds result{};
+    result.scissorRect = MakeFullScreenScissor(screenWidth, screenHeight);
+    result.scissorAreaRatio = 0.0f;
+
+    const CloudVolume::Parameters& parameters = cloudVolume.GetParameters();
+    const bool disableDistanceLod = (forceMode == ForceMode::ForceMaxQuality);
+    const float lodFactorScale = (forceMode == ForceMode::ForceAggressiveLod) ? 1.75f : 1.0f;
+    const float entryDistance = ComputeDistanceToAabb(cameraPosition, cloudVolume);
+    float densityScale = 1.0f;
+    ComputeDistanceLodScales(entryDistance, cloudVolume, lodFactorScale, disableDistanceLod, result.currentViewStepScale, densityScale);
+    result.currentLightStepScale = result.currentViewStepScale;
+    result.estimatedViewSteps = (std::max)(1u, static_cast<uint32_t>(static_cast<float>((std::max)(parameters.viewStepCount, 1u)) * result.currentViewStepScale + 0.5f));
+    result.estimatedLightSteps = (std::max)(1u, static_cast<uint32_t>(static_cast<float>((std::max)(parameters.lightStepCount, 1u)) * result.currentLightStepScale + 0.5f));
+
+    result.isCameraInsideCloud = cloudVolume.ContainsPoint(cameraPosition);
+    if (result.isCameraInsideCloud) {
+        result.isVisible = true;
+        result.useFullScreenScissor = true;
+        result.isFullScreenFallback = true;
+        result.scissorAreaRatio = 1.0f;
+        result.isPassSkipped = !settings.isEnabled || forceMode == ForceMode::ForceSkip;
+        return result;
+    }
+
+    const std::array<Vector3, 8> corners = cloudVolume.GetCorners();
+
+    if (!Culling::IsVisible(frustum, Aabb{ cloudVolume.GetMin(), cloudVolume.GetMax() })) {
+        return result;
+    }
+
+    result.isVisible = true;
+
+    std::array<Vector4, 8> clipCorners{};
+    for (size_t i = 0; i < corners.size(); ++i) {
+        clipCorners[i] = TransformPoint(corners[i], viewProjection);
+
+        // TODO: If we later add edge clipping against the frustum, this fallback can become tighter.
+        // For now, any vertex behind the near plane uses full-screen scissor to avoid underestimating the rect.
+        if (clipCorners[i].w <= 0.0001f || clipCorners[i].z < 0.0f) {
+            result.isNearPlaneCrossing = true;
+        }
+    }
+
+    if (result.isNearPlaneCrossing) {
+        result.useFullScreenScissor = true;
+        result.isFullScreenFallback = true;
+        result.scissorAreaRatio = 1.0f;
+        result.isPassSkipped = !settings.isEnabled || forceMode == ForceMode::ForceSkip;
+        return result;
+    }
+
+    float minNdcX = 1.0f;
+    float maxNdcX = -1.0f;
+    float minNdcY = 1.0f;
+    float maxNdcY = -1.0f;
+
+    for (const Vector4& clipCorner : clipCorners) {
+        const float inverseW = 1.0f / clipCorner.w;
+        const float ndcX = clipCorner.x * inverseW;
+        const float ndcY = clipCorner.y * inverseW;
+
+        minNdcX = (std::min)(minNdcX, ndcX);
+        maxNdcX = (std::max)(maxNdcX, ndcX);
+        minNdcY = (std::min)(minNdcY, ndcY);
+        maxNdcY = (std::max)(maxNdcY, ndcY);
+    }
+
+    minNdcX = std::clamp(minNdcX, -1.0f, 1.0f);
+    maxNdcX = std::clamp(maxNdcX, -1.0f, 1.0f);
+    minNdcY = std::clamp(minNdcY, -1.0f, 1.0f);
+    maxNdcY = std::clamp(maxNdcY, -1.0f, 1.0f);
+
+    const float width = static_cast<float>(screenWidth);
+    const float height = static_cast<float>(screenHeight);
+
+    const int32_t left = static_cast<int32_t>(std::floor((minNdcX * 0.5f + 0.5f) * width));
+    const int32_t right = static_cast<int32_t>(std::ceil((maxNdcX * 0.5f + 0.5f) * width));
+    const int32_t top = static_cast<int32_t>(std::floor((1.0f - (maxNdcY * 0.5f + 0.5f)) * height));
+    const int32_t bottom = static_cast<int32_t>(std::ceil((1.0f - (minNdcY * 0.5f + 0.5f)) * height));
+
+    result.scissorRect.left = std::clamp<int32_t>(left, 0, screenWidth);
+    result.scissorRect.right = std::clamp<int32_t>(right, 0, screenWidth);
+    result.scissorRect.top = std::clamp<int32_t>(top, 0, screenHeight);
+    result.scissorRect.bottom = std::clamp<int32_t>(bottom, 0, screenHeight);
+
+    if (result.scissorRect.right <= result.scissorRect.left || result.scissorRect.bottom <= result.scissorRect.top) {
+        result.isVisible = false;
+        result.scissorRect = MakeFullScreenScissor(screenWidth, screenHeight);
+        result.isPassSkipped = true;
+        return result;
+    }
+
+    const float screenArea = static_cast<float>(screenWidth * screenHeight);
+    const float scissorWidth = static_cast<float>(result.scissorRect.right - result.scissorRect.left);
+    const float scissorHeight = static_cast<float>(result.scissorRect.bottom - result.scissorRect.top);
+    result.scissorAreaRatio = (screenArea > 0.0f) ? ((scissorWidth * scissorHeight) / screenArea) : 1.0f;
+
+    result.useFullScreenScissor =
+        result.scissorRect.left == 0 &&
+        result.scissorRect.top == 0 &&
+        result.scissorRect.right == screenWidth &&
+        result.scissorRect.bottom == screenHeight;
+
+    if (forceMode == ForceMode::ForceFullscreen) {
+        result.useFullScreenScissor = true;
+        result.scissorRect = MakeFullScreenScissor(screenWidth, screenHeight);
+        result.scissorAreaRatio = 1.0f;
+    } else if (forceMode == ForceMode::ForceScissor) {
+        // TODO: For camera-inside / near-plane-crossing cases we intentionally keep the safe fullscreen fallback.
+        result.useFullScreenScissor = false;
+    }
+
+    result.isPassSkipped = !settings.isEnabled || forceMode == ForceMode::ForceSkip;
+
+    return result;
+}
+
+CloudProjection::ScissorRect CloudProjection::MakeFullScreenScissor(int32_t screenWidth, int32_t screenHeight)
+{
+    return {
+        0,
+        0,
+        screenWidth,
+        screenHeight
+    };
+}
+
+float CloudProjection::ComputeDistanceToAabb(const Vector3& point, const CloudVolume& cloudVolume)
+{
+    const Vector3 min = cloudVolume.GetMin();
+    const Vector3 max = cloudVolume.GetMax();
+
+    const float dx = (std::max)((std::max)(min.x - point.x, 0.0f), point.x - max.x);
+    const float dy = (std::max)((std::max)(min.y - point.y, 0.0f), point.y - max.y);
+    const float dz = (std::max)((std::max)(min.z - point.z, 0.0f), point.z - max.z);
+
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void CloudProjection::ComputeDistanceLodScales(float entryDistance, const CloudVolume& cloudVolume, float lodFactorScale, bool disableDistanceLod, float& viewStepScale, float& densityScale)
+{
+    const CloudVolume::Parameters& parameters = cloudVolume.GetParameters();
+    const float volumeRadius =
+        (std::max)(
+            std::sqrt(
+                parameters.halfExtents.x * parameters.halfExtents.x +
+                parameters.halfExtents.y * parameters.halfExtents.y +
+                parameters.halfExtents.z * parameters.halfExtents.z),
+            0.0001f);
+
+    const float lodStart = (std::max)(volumeRadius * 0.75f, 8.0f);
+    const float lodEnd = lodStart + (std::max)(volumeRadius * 2.50f, 16.0f);
+    float lodFactor = 0.0f;
+
+    if (!disableDistanceLod) {
+        lodFactor = std::clamp((entryDistance - lodStart) / (std::max)(lodEnd - lodStart, 0.0001f), 0.0f, 1.0f);
+        lodFactor = std::clamp(lodFactor * lodFactorScale, 0.0f, 1.0f);
+    }
+
+    viewStepScale = 1.0f + (0.45f - 1.0f) * lodFactor;
+    densityScale = 1.0f + (0.65f - 1.0f) * lodFactor;
+}
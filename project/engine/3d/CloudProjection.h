@@ -0,0 +1,55 @@
+#pragma once
+#include "CloudVolume.h"
+#include "Culling.h"
+#include "Matrix4x4.h"
+#include <cstdint>
+
+// 雲ボリュームの画面上の範囲 (シザー矩形) と距離 LOD を求める
+// VolumetricCloudPass の描画前の CPU 処理 (グラフィックス API に依存しない)
+namespace CloudProjection {
+    // D3D12_RECT と同じ並びの矩形 (ピクセル単位)
+    struct ScissorRect {
+        int32_t left = 0;
+        int32_t top = 0;
+        int32_t right = 0;
+        int32_t bottom = 0;
+    };
+
+    struct ProjectedBounds {
+        bool isVisible = false;
+        bool isPassSkipped = true;
+        bool useFullScreenScissor = true;
+        bool isFullScreenFallback = false;
+        bool isCameraInsideCloud = false;
+        bool isNearPlaneCrossing = false;
+        float scissorAreaRatio = 1.0f;
+        float currentViewStepScale = 1.0f;
+        float currentLightStepScale = 1.0f;
+        uint32_t estimatedViewSteps = 0;
+        uint32_t estimatedLightSteps = 0;
+        ScissorRect scissorRect{};
+    };
+
+    enum class ForceMode : uint32_t {
+        None = 0,
+        ForceSkip = 1,
+        ForceFullscreen = 2,
+        ForceScissor = 3,
+        ForceMaxQuality = 4,
+        ForceAggressiveLod = 5,
+    };
+
+    struct Settings {
+        int32_t screenWidth = 0;
+        int32_t screenHeight = 0;
+        ForceMode forceMode = ForceMode::None;
+        bool isEnabled = true;
+    };
+
+    // frustum は viewProjection から取り出したもの (Camera::GetFrustum)
+    ProjectedBounds BuildProjectedBounds(const CloudVolume& cloudVolume, const Vector3& cameraPosition, const Matrix4x4& viewProjection, const Frustum& frustum, const Settings& settings);
+
+    ScissorRect MakeFullScreenScissor(int32_t screenWidth, int32_t screenHeight);
+    float ComputeDistanceToAabb(const Vector3& point, const CloudVolume& cloudVolume);
+    void ComputeDistanceLodScales(float entryDistance, const CloudVolume& cloudVolume, float lodFactorScale, bool disableDistanceLod, float& viewStepScale, float& densityScale);
+}
@@ -0,0 +1,67 @@
+#include "ClusterCulling.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace MatrixMath;
+
+ClusterCulling::LocalView ClusterCulling::MakeLocalView(const Matrix4x4& worldMatrix, const Matrix4x4& viewProjection, const Vector3& eyePosition) {
+    LocalView view;
+    // ローカル → クリップの行列から取り出せば、平面はローカル座標で正規化される
+    view.frustum = Culling::ExtractFrustum(Multipty(worldMatrix, viewProjection));
+    const Matrix4x4 inverseWorld = InverseAffine(worldMatrix);
+    const float (*m)[4] = inverseWorld.m;
+    const Vector3& e = eyePosition;
+    view.eyePosition = {
+        e.x * m[0][0] + e.y * m[1][0] + e.z * m[2][0] + m[3][0],
+        e.x * m[0][1] + e.y * m[1][1] + e.z * m[2][1] + m[3][1],
+        e.x * m[0][2] + e.y * m[1][2] + e.z * m[2][2] + m[3][2]
+    };
+    return view;
+}
+
+bool ClusterCulling::IsBackfacing(const ModelData::Meshlet& meshlet, const Vector3& eyePosition) {
+    if (meshlet.coneCutoff >= 1.0f) {
+        return false;
+    }
+    // 球の中の全ての点 p について、視点から p への向きと円錐の軸のなす角が 90 度 - 半角 以下なら、
+    // 円錐の中のどの法線とも 90 度以下になる (視点が全ての三角形の平面の裏側にある)
+    // 中心までの距離を L、半径を r として dot(軸, 中心 - 視点) >= sin(半角) * (L + r) + r なら十分
+    const Vector3 offset = { meshlet.center.x - eyePosition.x, meshlet.center.y - eyePosition.y, meshlet.center.z - eyePosition.z };
+    const float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+    const float projection = offset.x * meshlet.coneAxis.x + offset.y * meshlet.coneAxis.y + offset.z * meshlet.coneAxis.z;
+    return projection >= meshlet.coneCutoff * (distance + meshlet.radius) + meshlet.radius;
+}
+
+size_t ClusterCulling::Cull(const ModelData::Meshlet* meshlets, const SphereStreams& spheres, const LocalView& view,
+    uint64_t* visibleMask, const Settings& settings) {
+    const size_t count = spheres.count;
+    const size_t wordCount = Culling::GetMaskWordCount(count);
+    size_t visibleCount = count;
+    if (settings.cullFrustum) {
+        visibleCount = Culling::CullSpheres(view.frustum, spheres, visibleMask);
+    } else {
+        for (size_t w = 0; w < wordCount; ++w) {
+            const size_t bitCount = (std::min)(count - w * 64, size_t{ 64 });
+            visibleMask[w] = bitCount == 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << bitCount) - 1;
+        }
+    }
+    if (!settings.cullBackfaces) {
+        return visibleCount;
+    }
+
+    // 視錐台に残った塊だけ円錐で判定する
+    for (size_t w = 0; w < wordCount; ++w) {
+        uint64_t bits = visibleMask[w];
+        while (bits != 0) {
+            const uint64_t lowest = bits & (~bits + 1);
+            bits ^= lowest;
+            const size_t index = w * 64 + static_cast<size_t>(std::countr_zero(lowest));
+            if (IsBackfacing(meshlets[index], view.eyePosition)) {
+                visibleMask[w] ^= lowest;
+                --visibleCount;
+            }
+        }
+    }
+    return visibleCount;
+}
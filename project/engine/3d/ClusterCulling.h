@@ -0,0 +1,33 @@
+#pragma once
+#include "Culling.h"
+#include "ModelData.h"
+#include <cstddef>
+#include <cstdint>
+
+// メッシュレット (ModelData::Meshlet) を描く前に CPU で判定し、見えない塊を除く
+// 判定はモデルのローカル座標で行う (非一様な拡大でも、平面のどちら側に視点があるかは変わらない)
+namespace ClusterCulling {
+    struct Settings {
+        // 視錐台の外にある塊を除く
+        bool cullFrustum = true;
+        // 全ての三角形が視点から裏を向いている塊を除く (裏側も見せる板などでは false にする)
+        bool cullBackfaces = true;
+    };
+
+    // モデルのローカル座標での視錐台と視点
+    struct LocalView {
+        Frustum frustum;
+        Vector3 eyePosition;
+    };
+
+    // ワールド行列 (アフィン) と、カメラのビュープロジェクション行列・ワールド座標の位置から作る
+    LocalView MakeLocalView(const Matrix4x4& worldMatrix, const Matrix4x4& viewProjection, const Vector3& eyePosition);
+
+    // 包む球と面の向きの円錐から、塊の全ての三角形が eyePosition から裏を向いていると言えるか
+    bool IsBackfacing(const ModelData::Meshlet& meshlet, const Vector3& eyePosition);
+
+    // 見える塊のビットを立て、その数を返す (visibleMask は Culling::GetMaskWordCount(spheres.count) 要素)
+    // spheres は meshlets の包む球を SoA に写したもの (視錐台の判定を Culling::CullSpheres でまとめて行う)
+    size_t Cull(const ModelData::Meshlet* meshlets, const SphereStreams& spheres, const LocalView& view,
+        uint64_t* visibleMask, const Settings& settings = {});
+}
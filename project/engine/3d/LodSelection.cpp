@@ -0,0 +1,45 @@
+#include "LodSelection.h"
+#include <cmath>
+#include <limits>
+
+float LodSelection::ComputeProjectedRadius(const Vector3& center, float radius, const Vector3& eyePosition, float tanHalfFovY, float viewportHeight) {
+    const float dx = center.x - eyePosition.x;
+    const float dy = center.y - eyePosition.y;
+    const float dz = center.z - eyePosition.z;
+    const float distanceSq = dx * dx + dy * dy + dz * dz;
+    if (distanceSq <= radius * radius) {
+        return (std::numeric_limits<float>::max)();
+    }
+    // 球に接する円錐の半角 θ について tan θ = r / sqrt(d^2 - r^2)
+    const float tangent = radius / std::sqrt(distanceSq - radius * radius);
+    return tangent / tanHalfFovY * (viewportHeight * 0.5f);
+}
+
+uint32_t LodSelection::Select(const float* lodErrors, size_t lodCount, float pixelsPerUnit, uint32_t currentLod, const Settings& settings) {
+    if (lodCount == 0) {
+        return 0;
+    }
+    if (currentLod >= lodCount) {
+        currentLod = static_cast<uint32_t>(lodCount - 1);
+    }
+    auto ProjectedError = [&](uint32_t lod) { return lodErrors[lod] * pixelsPerUnit; };
+
+    // ちらつきを考えない場合の段
+    uint32_t target = 0;
+    while (target + 1 < lodCount && ProjectedError(target + 1) <= settings.maxPixelError) {
+        ++target;
+    }
+
+    if (target > currentLod) {
+        // 粗くするのは、余裕を持って閾値を下回る段まで
+        while (target > currentLod && ProjectedError(target) > settings.maxPixelError * (1.0f - settings.hysteresis)) {
+            --target;
+        }
+    } else if (target < currentLod) {
+        // 今の段が閾値を少し超えた程度なら留まる
+        if (ProjectedError(currentLod) <= settings.maxPixelError * (1.0f + settings.hysteresis)) {
+            target = currentLod;
+        }
+    }
+    return target;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Matrix4x4.h"
+#include <cstddef>
+#include <cstdint>
+
+// 画面上の大きさから詳細度の段を選ぶ
+// 段の誤差 (ModelData::Lod::error) を画面へ投影したピクセル数が maxPixelError 以下になる最も粗い段を選ぶ
+// 投影した誤差 = 誤差 / 包む球の半径 × 画面上の球の半径 (ピクセル) なので、球が小さく映るほど粗い段になる
+namespace LodSelection {
+    struct Settings {
+        // 許す画面上のずれ (ピクセル)
+        float maxPixelError = 1.0f;
+        // 段の境目でのちらつきを防ぐ幅 (maxPixelError に対する割合)
+        // 粗くするのは (1 - hysteresis) 倍を下回ったとき、細かくするのは今の段が (1 + hysteresis) 倍を超えたとき
+        float hysteresis = 0.25f;
+    };
+
+    // ワールド座標の球が画面上で何ピクセルの半径に映るか
+    // tanHalfFovY は縦の画角の半分の tan、viewportHeight は画面の縦のピクセル数
+    // 視点が球の中にある場合は非常に大きい値を返す
+    float ComputeProjectedRadius(const Vector3& center, float radius, const Vector3& eyePosition, float tanHalfFovY, float viewportHeight);
+
+    // lodErrors[i] は段 i の誤差 (lodErrors[0] は元のメッシュで 0、粗い段ほど大きい)
+    // pixelsPerUnit はモデルのローカル座標の長さ 1 が画面上で何ピクセルになるか (投影した半径 / ローカルの半径)
+    uint32_t Select(const float* lodErrors, size_t lodCount, float pixelsPerUnit, uint32_t currentLod, const Settings& settings = {});
+}
@@ -0,0 +1,203 @@
+#include "MeshBuilder.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr uint32_t kEmptySlot = 0xffffffffu;
+
+    // 頂点のビット列のハッシュ (FNV-1a を 32 ビット単位で回し、最後に混ぜる)
+    uint64_t HashVertex(const ModelData::VertexData& vertex) {
+        static_assert(sizeof(ModelData::VertexData) % sizeof(uint32_t) == 0);
+        uint32_t words[sizeof(ModelData::VertexData) / sizeof(uint32_t)];
+        std::memcpy(words, &vertex, sizeof(words));
+
+        uint64_t hash = 14695981039346656037ull;
+        for (uint32_t word : words) {
+            hash = (hash ^ word) * 1099511628211ull;
+        }
+        hash ^= hash >> 29;
+        hash *= 0xbf58476d1ce4e5b9ull;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    bool IsSameVertex(const ModelData::VertexData& a, const ModelData::VertexData& b) {
+        return std::memcmp(&a, &b, sizeof(ModelData::VertexData)) == 0;
+    }
+
+    // 並列で重複を除くときの、ハッシュの上位ビットで分ける組の数
+    constexpr uint32_t kShardBits = 8;
+    constexpr size_t kShardCount = size_t(1) << kShardBits;
+    // 1 つの処理で扱う頂点数
+    constexpr size_t kBlockSize = 64 * 1024;
+}
+
+MeshBuilder::MeshBuilder(ModelData& data, size_t expectedVertexCount)
+    : data_(data) {
+    data_.vertices.reserve(expectedVertexCount);
+    // 埋まり具合が半分を超えないように 2 のべき乗で確保する
+    size_t slotCount = 64;
+    const size_t required = (expectedVertexCount > data_.vertices.size() ? expectedVertexCount : data_.vertices.size()) * 2;
+    while (slotCount < required) {
+        slotCount *= 2;
+    }
+    Rehash(slotCount);
+}
+
+void MeshBuilder::Rehash(size_t slotCount) {
+    slots_.assign(slotCount, kEmptySlot);
+    slotMask_ = slotCount - 1;
+
+    // 既にある頂点を入れ直す (同じ頂点が複数あれば最初のものを使う)
+    for (size_t index = 0; index < data_.vertices.size(); ++index) {
+        const ModelData::VertexData& vertex = data_.vertices[index];
+        size_t slot = static_cast<size_t>(HashVertex(vertex)) & slotMask_;
+        while (slots_[slot] != kEmptySlot) {
+            if (IsSameVertex(data_.vertices[slots_[slot]], vertex)) {
+                break;
+            }
+            slot = (slot + 1) & slotMask_;
+        }
+        if (slots_[slot] == kEmptySlot) {
+            slots_[slot] = static_cast<uint32_t>(index);
+        }
+    }
+}
+
+uint32_t MeshBuilder::AddVertex(const ModelData::VertexData& vertex) {
+    size_t slot = static_cast<size_t>(HashVertex(vertex)) & slotMask_;
+    while (slots_[slot] != kEmptySlot) {
+        const uint32_t index = slots_[slot];
+        if (IsSameVertex(data_.vertices[index], vertex)) {
+            return index;
+        }
+        slot = (slot + 1) & slotMask_;
+    }
+
+    const uint32_t index = static_cast<uint32_t>(data_.vertices.size());
+    data_.vertices.push_back(vertex);
+    slots_[slot] = index;
+
+    if (data_.vertices.size() * 2 > slots_.size()) {
+        Rehash(slots_.size() * 2);
+    }
+    return index;
+}
+
+void MeshBuilder::AddTriangle(const ModelData::VertexData& v0, const ModelData::VertexData& v1, const ModelData::VertexData& v2) {
+    const uint32_t i0 = AddVertex(v0);
+    const uint32_t i1 = AddVertex(v1);
+    const uint32_t i2 = AddVertex(v2);
+    data_.indices.push_back(i0);
+    data_.indices.push_back(i1);
+    data_.indices.push_back(i2);
+}
+
+void MeshBuilder::AddTriangleList(const ModelData::VertexData* vertices, size_t count) {
+    data_.indices.reserve(data_.indices.size() + count);
+    for (size_t i = 0; i + 2 < count; i += 3) {
+        AddTriangle(vertices[i], vertices[i + 1], vertices[i + 2]);
+    }
+}
+
+ModelData MeshBuilder::MakeIndexed(const std::vector<ModelData::VertexData>& triangleList) {
+    ModelData data;
+    MeshBuilder builder(data, triangleList.size() / 2);
+    builder.AddTriangleList(triangleList.data(), triangleList.size());
+    return data;
+}
+
+void MeshBuilder::BuildIndexedParallel(const ModelData::VertexData* triangleList, size_t count, ModelData& data, uint32_t threadCount) {
+    const size_t blockCount = (count + kBlockSize - 1) / kBlockSize;
+    auto BlockBegin = [count](size_t block) { return (std::min)(block * kBlockSize, count); };
+
+    // 1. 頂点ごとのハッシュと、ブロック × 組ごとの頂点数
+    std::vector<uint64_t> hashes(count);
+    std::vector<uint32_t> shardCounts(blockCount * kShardCount, 0);
+    Parallel::For(blockCount, threadCount, [&](size_t block) {
+        uint32_t* counts = &shardCounts[block * kShardCount];
+        for (size_t i = BlockBegin(block); i < BlockBegin(block + 1); ++i) {
+            hashes[i] = HashVertex(triangleList[i]);
+            ++counts[hashes[i] >> (64 - kShardBits)];
+        }
+    });
+
+    // 2. 組ごとに頂点番号を並べる (組の中では元の順のまま)
+    std::vector<size_t> shardOffsets(blockCount * kShardCount + 1);
+    std::vector<size_t> shardBegins(kShardCount + 1);
+    size_t offset = 0;
+    for (size_t shard = 0; shard < kShardCount; ++shard) {
+        shardBegins[shard] = offset;
+        for (size_t block = 0; block < blockCount; ++block) {
+            shardOffsets[block * kShardCount + shard] = offset;
+            offset += shardCounts[block * kShardCount + shard];
+        }
+    }
+    shardBegins[kShardCount] = offset;
+
+    std::vector<uint32_t> shardItems(count);
+    Parallel::For(blockCount, threadCount, [&](size_t block) {
+        size_t* offsets = &shardOffsets[block * kShardCount];
+        for (size_t i = BlockBegin(block); i < BlockBegin(block + 1); ++i) {
+            shardItems[offsets[hashes[i] >> (64 - kShardBits)]++] = static_cast<uint32_t>(i);
+        }
+    });
+
+    // 3. 組ごとに、同じ頂点の中で最初に現れたものの番号を求める
+    std::vector<uint32_t> firstOccurrence(count);
+    Parallel::For(kShardCount, threadCount, [&](size_t shard) {
+        const size_t begin = shardBegins[shard];
+        const size_t end = shardBegins[shard + 1];
+        size_t slotCount = 16;
+        while (slotCount < (end - begin) * 2) {
+            slotCount *= 2;
+        }
+        const size_t slotMask = slotCount - 1;
+        std::vector<uint32_t> slots(slotCount, kEmptySlot);
+        for (size_t item = begin; item < end; ++item) {
+            const uint32_t index = shardItems[item];
+            size_t slot = static_cast<size_t>(hashes[index]) & slotMask;
+            while (slots[slot] != kEmptySlot && !IsSameVertex(triangleList[slots[slot]], triangleList[index])) {
+                slot = (slot + 1) & slotMask;
+            }
+            if (slots[slot] == kEmptySlot) {
+                slots[slot] = index;
+            }
+            firstOccurrence[index] = slots[slot];
+        }
+    });
+
+    // 4. 最初に現れた頂点に、現れた順で番号を振る
+    std::vector<uint32_t> blockVertexStarts(blockCount + 1, 0);
+    Parallel::For(blockCount, threadCount, [&](size_t block) {
+        uint32_t uniqueCount = 0;
+        for (size_t i = BlockBegin(block); i < BlockBegin(block + 1); ++i) {
+            uniqueCount += firstOccurrence[i] == i ? 1 : 0;
+        }
+        blockVertexStarts[block + 1] = uniqueCount;
+    });
+    for (size_t block = 0; block < blockCount; ++block) {
+        blockVertexStarts[block + 1] += blockVertexStarts[block];
+    }
+
+    // 最初に現れた頂点は、自分の番号の場所に頂点番号を入れておく
+    data.vertices.resize(blockVertexStarts[blockCount]);
+    data.indices.resize(count);
+    Parallel::For(blockCount, threadCount, [&](size_t block) {
+        uint32_t vertexIndex = blockVertexStarts[block];
+        for (size_t i = BlockBegin(block); i < BlockBegin(block + 1); ++i) {
+            if (firstOccurrence[i] == i) {
+                data.vertices[vertexIndex] = triangleList[i];
+                data.indices[i] = vertexIndex++;
+            }
+        }
+    });
+    Parallel::For(blockCount, threadCount, [&](size_t block) {
+        for (size_t i = BlockBegin(block); i < BlockBegin(block + 1); ++i) {
+            if (firstOccurrence[i] != i) {
+                data.indices[i] = data.indices[firstOccurrence[i]];
+            }
+        }
+    });
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "ModelData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 三角形を追加しながら、同じ頂点 (位置・UV・法線がビット単位で一致するもの) を 1 つにまとめて
+// ModelData の vertices / indices を作る
+class MeshBuilder {
+public:
+    // data の vertices / indices へ追記する (既にある頂点もまとめる対象に含める)
+    // expectedVertexCount は重複を除いた頂点数の見込み (表の大きさの初期値)
+    explicit MeshBuilder(ModelData& data, size_t expectedVertexCount = 0);
+
+    // 頂点を追加して番号を返す (同じ頂点があればその番号)
+    uint32_t AddVertex(const ModelData::VertexData& vertex);
+    void AddTriangle(const ModelData::VertexData& v0, const ModelData::VertexData& v1, const ModelData::VertexData& v2);
+    // 3 つずつで三角形になる頂点の並びを追加する
+    void AddTriangleList(const ModelData::VertexData* vertices, size_t count);
+
+    // 3 つずつで三角形になる頂点の並びから、頂点をまとめた ModelData を作る
+    static ModelData MakeIndexed(const std::vector<ModelData::VertexData>& triangleList);
+    // MakeIndexed と同じ結果 (頂点は最初に現れた順) を複数のスレッドで作り、data の vertices / indices を置き換える
+    // ハッシュの上位ビットで頂点を分け、分けた組ごとに重複を除く
+    static void BuildIndexedParallel(const ModelData::VertexData* triangleList, size_t count, ModelData& data, uint32_t threadCount = 0);
+
+private:
+    void Rehash(size_t slotCount);
+
+private:
+    ModelData& data_;
+    // 頂点番号のハッシュ表 (開番地法、kEmptySlot は空き)
+    std::vector<uint32_t> slots_;
+    size_t slotMask_ = 0;
+};
@@ -0,0 +1,325 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+    constexpr uint32_t kInvalidIndex = 0xffffffffu;
+
+    // FIFO の頂点キャッシュ
+    // 頂点ごとに入った時刻を持ち、その後の追加が cacheSize 回未満ならまだ残っている
+    class FifoCache {
+    public:
+        FifoCache(size_t vertexCount, uint32_t cacheSize)
+            : stamps_(vertexCount, 0), cacheSize_(cacheSize) {}
+
+        // 無ければ追加して true (変換が必要)
+        bool Touch(uint32_t vertex) {
+            if (stamps_[vertex] != 0 && time_ < stamps_[vertex] + cacheSize_) {
+                return false;
+            }
+            stamps_[vertex] = ++time_;
+            return true;
+        }
+
+        // 全て追い出す
+        void Flush() {
+            time_ += cacheSize_;
+        }
+
+    private:
+        std::vector<uint64_t> stamps_;
+        uint64_t time_ = 0;
+        uint64_t cacheSize_;
+    };
+
+    Vector3 Subtract(const Vector4& a, const Vector4& b) {
+        return { a.x - b.x, a.y - b.y, a.z - b.z };
+    }
+
+    float Dot(const Vector3& a, const Vector3& b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+}
+
+MeshOptimizer::CacheStatistics MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+    CacheStatistics statistics;
+    if (indexCount < 3 || vertexCount == 0) {
+        return statistics;
+    }
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> isReferenced(vertexCount, false);
+    size_t referencedCount = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        const uint32_t vertex = indices[i];
+        statistics.transformedVertexCount += cache.Touch(vertex) ? 1 : 0;
+        if (!isReferenced[vertex]) {
+            isReferenced[vertex] = true;
+            ++referencedCount;
+        }
+    }
+    statistics.acmr = static_cast<float>(statistics.transformedVertexCount) / static_cast<float>(indexCount / 3);
+    statistics.atvr = static_cast<float>(statistics.transformedVertexCount) / static_cast<float>(referencedCount);
+    return statistics;
+}
+
+MeshOptimizer::CacheStatistics MeshOptimizer::AnalyzeVertexCache(const ModelData& modelData, uint32_t cacheSize) {
+    return AnalyzeVertexCache(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size(), cacheSize);
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize,
+    std::vector<uint32_t>* clusterStarts) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // 頂点ごとの、それを使う三角形の一覧 (まだ出していない三角形の数 = liveCounts)
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++adjacencyOffsets[indices[i] + 1];
+    }
+    std::vector<uint32_t> liveCounts(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        liveCounts[v] = adjacencyOffsets[v + 1];
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    const std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+    std::vector<bool> isEmitted(triangleCount, false);
+    // 頂点がキャッシュに入った時刻 (time - cacheTimes[v] > cacheSize なら入っていない)
+    std::vector<uint32_t> cacheTimes(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    size_t inputCursor = 0;
+    size_t outputIndex = 0;
+
+    // 行き止まりになったら、最近出した頂点 → 元の並びの順で、三角形の残っている頂点を探す
+    auto SkipDeadEnd = [&]() -> uint32_t {
+        while (!deadEnds.empty()) {
+            const uint32_t vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveCounts[vertex] > 0) {
+                return vertex;
+            }
+        }
+        while (inputCursor < source.size()) {
+            const uint32_t vertex = source[inputCursor++];
+            if (liveCounts[vertex] > 0) {
+                return vertex;
+            }
+        }
+        return kInvalidIndex;
+    };
+
+    if (clusterStarts) {
+        clusterStarts->push_back(0);
+    }
+    uint32_t fanningVertex = SkipDeadEnd();
+    while (fanningVertex != kInvalidIndex) {
+        // 扇の中心の頂点を使う三角形を全て出す
+        candidates.clear();
+        for (uint32_t a = adjacencyOffsets[fanningVertex]; a < adjacencyOffsets[fanningVertex + 1]; ++a) {
+            const uint32_t triangle = adjacency[a];
+            if (isEmitted[triangle]) {
+                continue;
+            }
+            isEmitted[triangle] = true;
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t vertex = source[triangle * 3 + c];
+                indices[outputIndex++] = vertex;
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                --liveCounts[vertex];
+                if (time - cacheTimes[vertex] > cacheSize) {
+                    cacheTimes[vertex] = time++;
+                }
+            }
+        }
+
+        // 次の中心は、扇を出し切ってもキャッシュに残る頂点のうち最も古いもの
+        uint32_t nextVertex = kInvalidIndex;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates) {
+            if (liveCounts[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            if (time - cacheTimes[vertex] + 2 * liveCounts[vertex] <= cacheSize) {
+                priority = time - cacheTimes[vertex];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                nextVertex = vertex;
+            }
+        }
+        if (nextVertex == kInvalidIndex) {
+            nextVertex = SkipDeadEnd();
+            if (clusterStarts && nextVertex != kInvalidIndex) {
+                clusterStarts->push_back(static_cast<uint32_t>(outputIndex / 3));
+            }
+        }
+        fanningVertex = nextVertex;
+    }
+}
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* indices, size_t indexCount, const ModelData::VertexData* vertices, size_t vertexCount,
+    const std::vector<uint32_t>& clusterStarts, uint32_t cacheSize, float threshold) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || clusterStarts.empty()) {
+        return;
+    }
+
+    // 1. 途切れた位置で分けたまとまりを、ACMR が threshold 倍を超えない範囲でさらに細かく分ける
+    std::vector<uint32_t> starts;
+    FifoCache cache(vertexCount, cacheSize);
+    for (size_t c = 0; c < clusterStarts.size(); ++c) {
+        const uint32_t begin = clusterStarts[c];
+        const uint32_t end = (c + 1 < clusterStarts.size()) ? clusterStarts[c + 1] : static_cast<uint32_t>(triangleCount);
+
+        uint32_t clusterMisses = 0;
+        cache.Flush();
+        for (uint32_t t = begin; t < end; ++t) {
+            for (int i = 0; i < 3; ++i) {
+                clusterMisses += cache.Touch(indices[t * 3 + i]) ? 1 : 0;
+            }
+        }
+        const float limit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        starts.push_back(begin);
+        uint32_t start = begin;
+        uint32_t misses = 0;
+        cache.Flush();
+        for (uint32_t t = begin; t + 1 < end; ++t) {
+            for (int i = 0; i < 3; ++i) {
+                misses += cache.Touch(indices[t * 3 + i]) ? 1 : 0;
+            }
+            if (static_cast<float>(misses) <= limit * static_cast<float>(t + 1 - start)) {
+                start = t + 1;
+                starts.push_back(start);
+                misses = 0;
+                cache.Flush();
+            }
+        }
+    }
+
+    // 2. まとまりごとの重心と向き (面積で重み付け)
+    struct Cluster {
+        uint32_t begin;
+        uint32_t end;
+        Vector3 centroid;
+        Vector3 normal;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters(starts.size());
+    Vector3 meshCentroid = { 0.0f, 0.0f, 0.0f };
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < starts.size(); ++c) {
+        Cluster& cluster = clusters[c];
+        cluster.begin = starts[c];
+        cluster.end = (c + 1 < starts.size()) ? starts[c + 1] : static_cast<uint32_t>(triangleCount);
+        cluster.centroid = { 0.0f, 0.0f, 0.0f };
+        Vector3 faceNormal = { 0.0f, 0.0f, 0.0f };
+        Vector3 vertexNormal = { 0.0f, 0.0f, 0.0f };
+        float area = 0.0f;
+        for (uint32_t t = cluster.begin; t < cluster.end; ++t) {
+            const ModelData::VertexData& v0 = vertices[indices[t * 3 + 0]];
+            const ModelData::VertexData& v1 = vertices[indices[t * 3 + 1]];
+            const ModelData::VertexData& v2 = vertices[indices[t * 3 + 2]];
+            const Vector3 cross = MatrixMath::Cross(Subtract(v1.position, v0.position), Subtract(v2.position, v0.position));
+            const float triangleArea = std::sqrt(Dot(cross, cross)) * 0.5f;
+            const float weight = triangleArea / 3.0f;
+            cluster.centroid.x += (v0.position.x + v1.position.x + v2.position.x) * weight;
+            cluster.centroid.y += (v0.position.y + v1.position.y + v2.position.y) * weight;
+            cluster.centroid.z += (v0.position.z + v1.position.z + v2.position.z) * weight;
+            faceNormal = { faceNormal.x + cross.x, faceNormal.y + cross.y, faceNormal.z + cross.z };
+            vertexNormal.x += (v0.normal.x + v1.normal.x + v2.normal.x) * triangleArea;
+            vertexNormal.y += (v0.normal.y + v1.normal.y + v2.normal.y) * triangleArea;
+            vertexNormal.z += (v0.normal.z + v1.normal.z + v2.normal.z) * triangleArea;
+            area += triangleArea;
+        }
+        meshCentroid = { meshCentroid.x + cluster.centroid.x, meshCentroid.y + cluster.centroid.y, meshCentroid.z + cluster.centroid.z };
+        meshArea += area;
+        if (area > 0.0f) {
+            cluster.centroid = { cluster.centroid.x / area, cluster.centroid.y / area, cluster.centroid.z / area };
+        }
+        // 頂点の法線があればそれを使う (巻き順の向きに依らない)
+        cluster.normal = (Dot(vertexNormal, vertexNormal) > 1.0e-12f) ? vertexNormal : faceNormal;
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid = { meshCentroid.x / meshArea, meshCentroid.y / meshArea, meshCentroid.z / meshArea };
+    }
+
+    // 3. 中心から外を向いているまとまりほど先に描く (手前の面が後ろの面を隠しやすい)
+    for (Cluster& cluster : clusters) {
+        const float length = std::sqrt(Dot(cluster.normal, cluster.normal));
+        const Vector3 offset = { cluster.centroid.x - meshCentroid.x, cluster.centroid.y - meshCentroid.y, cluster.centroid.z - meshCentroid.z };
+        cluster.sortKey = (length > 0.0f) ? Dot(offset, cluster.normal) / length : 0.0f;
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    const std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+    size_t outputIndex = 0;
+    for (const Cluster& cluster : clusters) {
+        for (uint32_t i = cluster.begin * 3; i < cluster.end * 3; ++i) {
+            indices[outputIndex++] = source[i];
+        }
+    }
+}
+
+void MeshOptimizer::OptimizeVertexFetch(ModelData& modelData) {
+    std::vector<uint32_t> remap(modelData.vertices.size(), kInvalidIndex);
+    uint32_t nextIndex = 0;
+    for (uint32_t& index : modelData.indices) {
+        if (remap[index] == kInvalidIndex) {
+            remap[index] = nextIndex++;
+        }
+        index = remap[index];
+    }
+    for (uint32_t& index : remap) {
+        if (index == kInvalidIndex) {
+            index = nextIndex++;
+        }
+    }
+
+    std::vector<ModelData::VertexData> vertices(modelData.vertices.size());
+    for (size_t v = 0; v < modelData.vertices.size(); ++v) {
+        vertices[remap[v]] = modelData.vertices[v];
+    }
+    modelData.vertices = std::move(vertices);
+}
+
+void MeshOptimizer::Optimize(ModelData& modelData, const Options& options) {
+    const CacheStatistics before = AnalyzeVertexCache(modelData, options.cacheSize);
+
+    auto OptimizeRange = [&](uint32_t indexStart, uint32_t indexCount) {
+        uint32_t* indices = modelData.indices.data() + indexStart;
+        std::vector<uint32_t> clusterStarts;
+        OptimizeVertexCache(indices, indexCount, modelData.vertices.size(), options.cacheSize,
+            options.optimizeOverdraw ? &clusterStarts : nullptr);
+        if (options.optimizeOverdraw) {
+            OptimizeOverdraw(indices, indexCount, modelData.vertices.data(), modelData.vertices.size(),
+                clusterStarts, options.cacheSize, options.overdrawThreshold);
+        }
+    };
+    if (modelData.submeshes.empty()) {
+        OptimizeRange(0, static_cast<uint32_t>(modelData.indices.size()));
+    } else {
+        for (const ModelData::Submesh& submesh : modelData.submeshes) {
+            OptimizeRange(submesh.indexStart, submesh.indexCount);
+        }
+    }
+    OptimizeVertexFetch(modelData);
+
+    const CacheStatistics after = AnalyzeVertexCache(modelData, options.cacheSize);
+    modelData.cacheMetrics = { before.acmr, after.acmr, before.atvr, after.atvr };
+}
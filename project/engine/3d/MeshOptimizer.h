@@ -0,0 +1,46 @@
+#pragma once
+#include "ModelData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 取り込み時に頂点番号と頂点の並びを GPU 向けに並べ替える
+//   1. 頂点キャッシュ: Tipsify (Sander ら 2007) で、最近使った頂点を使う三角形から順に出す
+//   2. オーバードロー: 1 で区切られたまとまりを、外側を向いているものが先になるように並べる
+//   3. 頂点の読み込み: 頂点番号で最初に参照された順に頂点を並べ直す
+// 三角形の集合とサブメッシュの範囲は変えない (並べ替えはサブメッシュの中だけで行う)
+namespace MeshOptimizer {
+    struct Options {
+        // 想定する頂点キャッシュ (FIFO) の大きさ
+        uint32_t cacheSize = 16;
+        bool optimizeOverdraw = true;
+        // オーバードロー用に区切るとき、ACMR がこの倍率までは悪くなってよい
+        float overdrawThreshold = 1.05f;
+    };
+
+    // FIFO の頂点キャッシュで描いたときの変換回数
+    struct CacheStatistics {
+        uint32_t transformedVertexCount = 0;
+        // 三角形あたりの変換回数 (0.5 に近いほど良い、最悪 3)
+        float acmr = 0.0f;
+        // 参照される頂点あたりの変換回数 (1 が最良)
+        float atvr = 0.0f;
+    };
+
+    CacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16);
+    // ModelData 全体 (全てのサブメッシュ) を調べる
+    CacheStatistics AnalyzeVertexCache(const ModelData& modelData, uint32_t cacheSize = 16);
+
+    // 頂点番号 [0, vertexCount) の三角形の並びを Tipsify で並べ替える
+    // clusterStarts を渡すと、キャッシュが途切れた位置 (三角形の番号) を追加する
+    void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16,
+        std::vector<uint32_t>* clusterStarts = nullptr);
+    // OptimizeVertexCache の後に、まとまりを外側を向いているものから順に並べる
+    void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const ModelData::VertexData* vertices, size_t vertexCount,
+        const std::vector<uint32_t>& clusterStarts, uint32_t cacheSize = 16, float threshold = 1.05f);
+    // 頂点を最初に参照された順に並べ直す (参照されない頂点は末尾へ)
+    void OptimizeVertexFetch(ModelData& modelData);
+
+    // サブメッシュごとに 1 〜 3 を行い、前後の ACMR / ATVR を modelData.cacheMetrics に残す
+    void Optimize(ModelData& modelData, const Options& options = {});
+}
@@ -0,0 +1,417 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+    constexpr uint32_t kInvalidIndex = 0xffffffffu;
+
+    // 平面までの距離の二乗の和 (面積で重み付け) を表す対称 4x4 行列
+    struct Quadric {
+        double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+        double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+        double c = 0.0;
+        double weight = 0.0;
+
+        void AddPlane(double nx, double ny, double nz, double d, double w) {
+            a00 += w * nx * nx; a11 += w * ny * ny; a22 += w * nz * nz;
+            a01 += w * nx * ny; a02 += w * nx * nz; a12 += w * ny * nz;
+            b0 += w * nx * d; b1 += w * ny * d; b2 += w * nz * d;
+            c += w * d * d;
+            weight += w;
+        }
+
+        void Add(const Quadric& other) {
+            a00 += other.a00; a11 += other.a11; a22 += other.a22;
+            a01 += other.a01; a02 += other.a02; a12 += other.a12;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+        }
+
+        double Evaluate(const Vector4& p) const {
+            const double x = p.x, y = p.y, z = p.z;
+            const double value =
+                a00 * x * x + a11 * y * y + a22 * z * z +
+                2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            return (std::max)(value, 0.0);
+        }
+    };
+
+    Vector3 TriangleNormal(const Vector4& p0, const Vector4& p1, const Vector4& p2) {
+        const Vector3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+        const Vector3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+        return { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+    }
+
+    // 位置が同じ頂点に同じ番号を振る
+    std::vector<uint32_t> BuildPositionIds(const ModelData::VertexData* vertices, size_t vertexCount) {
+        std::vector<uint32_t> order(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            order[v] = static_cast<uint32_t>(v);
+        }
+        auto Less = [&](uint32_t a, uint32_t b) {
+            const Vector4& p = vertices[a].position;
+            const Vector4& q = vertices[b].position;
+            if (p.x != q.x) return p.x < q.x;
+            if (p.y != q.y) return p.y < q.y;
+            return p.z < q.z;
+        };
+        std::sort(order.begin(), order.end(), Less);
+
+        std::vector<uint32_t> positionIds(vertexCount);
+        uint32_t positionCount = 0;
+        for (size_t i = 0; i < vertexCount; ++i) {
+            if (i > 0 && Less(order[i - 1], order[i])) {
+                ++positionCount;
+            }
+            positionIds[order[i]] = positionCount;
+        }
+        return positionIds;
+    }
+
+    // 動かしてはいけない頂点 (UV の継ぎ目・穴の縁・3 枚以上の三角形が共有する辺)
+    std::vector<bool> FindLockedVertices(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+        const std::vector<uint32_t>& positionIds) {
+        std::vector<bool> isLocked(vertexCount, false);
+
+        // 同じ位置で別の頂点が使われていれば継ぎ目
+        std::vector<uint32_t> firstVertex(vertexCount, kInvalidIndex);
+        for (size_t i = 0; i < indexCount; ++i) {
+            const uint32_t vertex = indices[i];
+            uint32_t& first = firstVertex[positionIds[vertex]];
+            if (first == kInvalidIndex) {
+                first = vertex;
+            } else if (first != vertex) {
+                isLocked[first] = true;
+                isLocked[vertex] = true;
+            }
+        }
+        for (size_t i = 0; i < indexCount; ++i) {
+            if (isLocked[firstVertex[positionIds[indices[i]]]]) {
+                isLocked[indices[i]] = true;
+            }
+        }
+
+        // 位置で見た辺を数え、1 枚 (縁) か 3 枚以上 (非多様体) の辺の両端を止める
+        std::vector<uint64_t> edges;
+        edges.reserve(indexCount);
+        for (size_t t = 0; t + 2 < indexCount; t += 3) {
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t a = positionIds[indices[t + c]];
+                const uint32_t b = positionIds[indices[t + (c + 1) % 3]];
+                if (a != b) {
+                    edges.push_back((static_cast<uint64_t>((std::min)(a, b)) << 32) | (std::max)(a, b));
+                }
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        std::vector<bool> isLockedPosition(vertexCount, false);
+        for (size_t begin = 0; begin < edges.size();) {
+            size_t end = begin + 1;
+            while (end < edges.size() && edges[end] == edges[begin]) {
+                ++end;
+            }
+            if (end - begin != 2) {
+                isLockedPosition[static_cast<uint32_t>(edges[begin] >> 32)] = true;
+                isLockedPosition[static_cast<uint32_t>(edges[begin])] = true;
+            }
+            begin = end;
+        }
+        for (size_t i = 0; i < indexCount; ++i) {
+            if (isLockedPosition[positionIds[indices[i]]]) {
+                isLocked[indices[i]] = true;
+            }
+        }
+        return isLocked;
+    }
+
+    // 辺を縮めていく途中の状態 (続けて呼ぶと前の結果からさらに減らす)
+    class EdgeCollapser {
+    public:
+        EdgeCollapser(const uint32_t* indices, size_t indexCount, const ModelData::VertexData* vertices, size_t vertexCount)
+            : vertices_(vertices), vertexCount_(vertexCount),
+            current_(indices, indices + (indexCount - indexCount % 3)),
+            positionIds_(BuildPositionIds(vertices, vertexCount)),
+            isLocked_(FindLockedVertices(current_.data(), current_.size(), vertexCount, positionIds_)),
+            quadrics_(vertexCount), bestTargets_(vertexCount), bestCosts_(vertexCount), isTouched_(vertexCount) {
+            // 位置ごとの二次誤差 (元の三角形の平面から)
+            for (size_t t = 0; t < current_.size(); t += 3) {
+                const Vector4& p0 = vertices_[current_[t + 0]].position;
+                const Vector3 normal = TriangleNormal(p0, vertices_[current_[t + 1]].position, vertices_[current_[t + 2]].position);
+                const double length = std::sqrt(static_cast<double>(normal.x) * normal.x + static_cast<double>(normal.y) * normal.y + static_cast<double>(normal.z) * normal.z);
+                if (length <= 0.0) {
+                    continue;
+                }
+                const double nx = normal.x / length, ny = normal.y / length, nz = normal.z / length;
+                const double d = -(nx * p0.x + ny * p0.y + nz * p0.z);
+                const double area = length * 0.5;
+                for (int c = 0; c < 3; ++c) {
+                    quadrics_[positionIds_[current_[t + c]]].AddPlane(nx, ny, nz, d, area);
+                }
+            }
+        }
+
+        // 頂点番号が targetIndexCount 以下になるか、誤差 targetError を超えないと縮められなくなるまで減らす
+        void Run(size_t targetIndexCount, float targetError) {
+            const double targetCost = static_cast<double>(targetError) * targetError;
+            while (current_.size() > targetIndexCount) {
+                if (!RunPass(targetIndexCount, targetCost)) {
+                    break;
+                }
+            }
+        }
+
+        const std::vector<uint32_t>& GetIndices() const { return current_; }
+        float GetError() const { return static_cast<float>(std::sqrt(maxCost_)); }
+
+    private:
+        double Cost(uint32_t from, uint32_t to) const {
+            Quadric quadric = quadrics_[positionIds_[from]];
+            quadric.Add(quadrics_[positionIds_[to]]);
+            return quadric.weight > 0.0 ? quadric.Evaluate(vertices_[to].position) / quadric.weight : 0.0;
+        }
+
+        // 1 回の走査で、互いに離れた辺をまとめて縮める (縮めたものが無ければ false)
+        bool RunPass(size_t targetIndexCount, double targetCost) {
+            // 頂点ごとの三角形の一覧
+            const size_t triangleCount = current_.size() / 3;
+            adjacencyOffsets_.assign(vertexCount_ + 1, 0);
+            for (uint32_t vertex : current_) {
+                ++adjacencyOffsets_[vertex + 1];
+            }
+            for (size_t v = 0; v < vertexCount_; ++v) {
+                adjacencyOffsets_[v + 1] += adjacencyOffsets_[v];
+            }
+            adjacency_.resize(current_.size());
+            cursor_.assign(adjacencyOffsets_.begin(), adjacencyOffsets_.end() - 1);
+            for (size_t i = 0; i < current_.size(); ++i) {
+                adjacency_[cursor_[current_[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+
+            // 動かせる頂点ごとに、最も誤差の小さい寄せ先 (同じ三角形の頂点) を選び、誤差の小さい順に並べる
+            std::fill(bestTargets_.begin(), bestTargets_.end(), kInvalidIndex);
+            for (size_t t = 0; t < triangleCount; ++t) {
+                for (int c = 0; c < 3; ++c) {
+                    const uint32_t from = current_[t * 3 + c];
+                    if (isLocked_[from]) {
+                        continue;
+                    }
+                    for (int k = 1; k < 3; ++k) {
+                        const uint32_t to = current_[t * 3 + (c + k) % 3];
+                        const double cost = Cost(from, to);
+                        if (cost <= targetCost && (bestTargets_[from] == kInvalidIndex || cost < bestCosts_[from])) {
+                            bestTargets_[from] = to;
+                            bestCosts_[from] = cost;
+                        }
+                    }
+                }
+            }
+            candidates_.clear();
+            for (size_t v = 0; v < vertexCount_; ++v) {
+                if (bestTargets_[v] != kInvalidIndex) {
+                    candidates_.push_back(static_cast<uint32_t>(v));
+                }
+            }
+            if (candidates_.empty()) {
+                return false;
+            }
+            std::sort(candidates_.begin(), candidates_.end(), [&](uint32_t a, uint32_t b) { return bestCosts_[a] < bestCosts_[b]; });
+
+            // 縮めた辺の周りの頂点は、この走査ではもう触らない (一覧が古くなるため)
+            std::fill(isTouched_.begin(), isTouched_.end(), false);
+            const size_t removeGoal = (current_.size() - targetIndexCount) / 3;
+            size_t removedCount = 0;
+            size_t collapseCount = 0;
+            for (uint32_t from : candidates_) {
+                const uint32_t to = bestTargets_[from];
+                if (isTouched_[from] || isTouched_[to]) {
+                    continue;
+                }
+                size_t sharedCount = 0;
+                if (!CanCollapse(from, to, sharedCount) || sharedCount == 0) {
+                    continue;
+                }
+
+                for (uint32_t a = adjacencyOffsets_[from]; a < adjacencyOffsets_[from + 1]; ++a) {
+                    uint32_t* triangle = &current_[adjacency_[a] * 3];
+                    for (int c = 0; c < 3; ++c) {
+                        isTouched_[triangle[c]] = true;
+                        if (triangle[c] == from) {
+                            triangle[c] = to;
+                        }
+                    }
+                }
+                quadrics_[positionIds_[to]].Add(quadrics_[positionIds_[from]]);
+                maxCost_ = (std::max)(maxCost_, bestCosts_[from]);
+                removedCount += sharedCount;
+                ++collapseCount;
+                if (removedCount >= removeGoal) {
+                    break;
+                }
+            }
+            if (collapseCount == 0) {
+                return false;
+            }
+
+            // 潰れた三角形を取り除く
+            size_t writeIndex = 0;
+            for (size_t t = 0; t < triangleCount; ++t) {
+                const uint32_t v0 = current_[t * 3 + 0];
+                const uint32_t v1 = current_[t * 3 + 1];
+                const uint32_t v2 = current_[t * 3 + 2];
+                if (v0 != v1 && v1 != v2 && v0 != v2) {
+                    current_[writeIndex++] = v0;
+                    current_[writeIndex++] = v1;
+                    current_[writeIndex++] = v2;
+                }
+            }
+            current_.resize(writeIndex);
+            return true;
+        }
+
+        // 向きが反転する・潰れる三角形ができるなら false (sharedCount には消える三角形の数を返す)
+        bool CanCollapse(uint32_t from, uint32_t to, size_t& sharedCount) const {
+            for (uint32_t a = adjacencyOffsets_[from]; a < adjacencyOffsets_[from + 1]; ++a) {
+                const uint32_t* triangle = &current_[adjacency_[a] * 3];
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                    ++sharedCount;
+                    continue;
+                }
+                const Vector4* positions[3];
+                for (int c = 0; c < 3; ++c) {
+                    positions[c] = &vertices_[triangle[c]].position;
+                }
+                const Vector3 before = TriangleNormal(*positions[0], *positions[1], *positions[2]);
+                for (int c = 0; c < 3; ++c) {
+                    if (triangle[c] == from) {
+                        positions[c] = &vertices_[to].position;
+                    }
+                }
+                const Vector3 after = TriangleNormal(*positions[0], *positions[1], *positions[2]);
+                const float beforeLengthSq = before.x * before.x + before.y * before.y + before.z * before.z;
+                const float afterLengthSq = after.x * after.x + after.y * after.y + after.z * after.z;
+                const float dot = before.x * after.x + before.y * after.y + before.z * after.z;
+                // 面積がほぼ 0 になるか、向きが 75 度以上変わる場合
+                if (!(afterLengthSq > beforeLengthSq * 1.0e-6f && dot > 0.25f * std::sqrt(beforeLengthSq * afterLengthSq))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        const ModelData::VertexData* vertices_;
+        size_t vertexCount_;
+        std::vector<uint32_t> current_;
+        std::vector<uint32_t> positionIds_;
+        std::vector<bool> isLocked_;
+        std::vector<Quadric> quadrics_;
+        double maxCost_ = 0.0;
+
+        // 走査ごとに作り直す作業領域
+        std::vector<uint32_t> adjacencyOffsets_;
+        std::vector<uint32_t> adjacency_;
+        std::vector<uint32_t> cursor_;
+        std::vector<uint32_t> bestTargets_;
+        std::vector<double> bestCosts_;
+        std::vector<uint32_t> candidates_;
+        std::vector<bool> isTouched_;
+    };
+}
+
+size_t MeshSimplifier::Simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+    const ModelData::VertexData* vertices, size_t vertexCount,
+    size_t targetIndexCount, float targetError, float* resultError) {
+    EdgeCollapser collapser(indices, indexCount, vertices, vertexCount);
+    collapser.Run(targetIndexCount, targetError);
+    const std::vector<uint32_t>& result = collapser.GetIndices();
+    if (!result.empty()) {
+        std::memcpy(destination, result.data(), sizeof(uint32_t) * result.size());
+    }
+    if (resultError) {
+        *resultError = collapser.GetError();
+    }
+    return result.size();
+}
+
+void MeshSimplifier::BuildLodChain(ModelData& modelData, const LodOptions& options) {
+    modelData.lods.clear();
+    if (modelData.vertices.empty() || modelData.indices.empty()) {
+        return;
+    }
+
+    // 頂点を包む球の半径 (AABB の中心から)
+    Vector3 minimum = { modelData.vertices[0].position.x, modelData.vertices[0].position.y, modelData.vertices[0].position.z };
+    Vector3 maximum = minimum;
+    for (const ModelData::VertexData& vertex : modelData.vertices) {
+        minimum = { (std::min)(minimum.x, vertex.position.x), (std::min)(minimum.y, vertex.position.y), (std::min)(minimum.z, vertex.position.z) };
+        maximum = { (std::max)(maximum.x, vertex.position.x), (std::max)(maximum.y, vertex.position.y), (std::max)(maximum.z, vertex.position.z) };
+    }
+    const Vector3 center = { (minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f };
+    float radiusSq = 0.0f;
+    for (const ModelData::VertexData& vertex : modelData.vertices) {
+        const float dx = vertex.position.x - center.x, dy = vertex.position.y - center.y, dz = vertex.position.z - center.z;
+        radiusSq = (std::max)(radiusSq, dx * dx + dy * dy + dz * dz);
+    }
+    const float errorLimit = options.maxError * std::sqrt(radiusSq);
+
+    std::vector<ModelData::Submesh> baseSubmeshes = modelData.submeshes;
+    if (baseSubmeshes.empty()) {
+        baseSubmeshes.push_back({ "", 0, static_cast<uint32_t>(modelData.indices.size()), 0 });
+    }
+    size_t previousTriangleCount = 0;
+    for (const ModelData::Submesh& submesh : baseSubmeshes) {
+        previousTriangleCount += submesh.indexCount / 3;
+    }
+
+    // サブメッシュごとに続けて減らしながら、各段の結果を控える (二次誤差は元の三角形のものなので、誤差は元のメッシュからのずれになる)
+    struct LevelResult {
+        std::vector<uint32_t> indices;
+        float error = 0.0f;
+    };
+    std::vector<std::vector<LevelResult>> levels(baseSubmeshes.size());
+    for (size_t s = 0; s < baseSubmeshes.size(); ++s) {
+        const ModelData::Submesh& submesh = baseSubmeshes[s];
+        EdgeCollapser collapser(modelData.indices.data() + submesh.indexStart, submesh.indexCount,
+            modelData.vertices.data(), modelData.vertices.size());
+        float ratio = 1.0f;
+        for (uint32_t level = 0; level < options.maxLodCount; ++level) {
+            ratio *= options.reductionRatio;
+            const size_t targetIndexCount = static_cast<size_t>(static_cast<float>(submesh.indexCount / 3) * ratio) * 3;
+            collapser.Run(targetIndexCount, errorLimit);
+            levels[s].push_back({ collapser.GetIndices(), collapser.GetError() });
+        }
+    }
+
+    for (uint32_t level = 0; level < options.maxLodCount; ++level) {
+        ModelData::Lod lod;
+        std::vector<uint32_t> lodIndices;
+        for (size_t s = 0; s < baseSubmeshes.size(); ++s) {
+            LevelResult& result = levels[s][level];
+            MeshOptimizer::OptimizeVertexCache(result.indices.data(), result.indices.size(), modelData.vertices.size());
+
+            ModelData::Submesh lodSubmesh = baseSubmeshes[s];
+            lodSubmesh.indexStart = static_cast<uint32_t>(modelData.indices.size() + lodIndices.size());
+            lodSubmesh.indexCount = static_cast<uint32_t>(result.indices.size());
+            lod.submeshes.push_back(lodSubmesh);
+            lod.error = (std::max)(lod.error, result.error);
+            lodIndices.insert(lodIndices.end(), result.indices.begin(), result.indices.end());
+        }
+
+        // 減らせなくなったら (継ぎ目や縁ばかりになった、誤差の上限に達した) 打ち切る
+        const size_t triangleCount = lodIndices.size() / 3;
+        if (triangleCount < options.minTriangleCount ||
+            static_cast<float>(triangleCount) > static_cast<float>(previousTriangleCount) * options.minReduction) {
+            break;
+        }
+        if (!modelData.lods.empty()) {
+            lod.error = (std::max)(lod.error, modelData.lods.back().error);
+        }
+        modelData.indices.insert(modelData.indices.end(), lodIndices.begin(), lodIndices.end());
+        modelData.lods.push_back(std::move(lod));
+        previousTriangleCount = triangleCount;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "ModelData.h"
+#include <cstddef>
+#include <cstdint>
+
+// 二次誤差 (Garland & Heckbert 1997) で辺を縮めて三角形を減らす
+// 頂点は動かさず、辺の片方の頂点をもう片方へ寄せるので、詳細度を下げた頂点番号も元の頂点バッファを共有できる
+// UV の継ぎ目 (同じ位置に別の頂点がある) と穴の縁の頂点は動かさない
+namespace MeshSimplifier {
+    // indices (三角形のリスト) を targetIndexCount 以下まで、誤差 targetError (距離) 以下の範囲で減らして destination に書く
+    // 戻り値は書いた頂点番号の数 (destination は indexCount 個分の大きさが要る)、resultError には最大の誤差を返す
+    size_t Simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+        const ModelData::VertexData* vertices, size_t vertexCount,
+        size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+    struct LodOptions {
+        // 元のメッシュを除いた段数の上限
+        uint32_t maxLodCount = 4;
+        // 1 段ごとに三角形をこの割合まで減らす
+        float reductionRatio = 0.5f;
+        // 許す誤差 (頂点を包む球の半径に対する割合)
+        float maxError = 0.05f;
+        // 前の段からこの割合までしか減らなければ打ち切る
+        float minReduction = 0.85f;
+        // 三角形がこれより少なくなる段は作らない
+        uint32_t minTriangleCount = 8;
+    };
+
+    // サブメッシュごとに詳細度を下げた頂点番号を作って indices の末尾に足し、modelData.lods に記録する
+    // 足した範囲は MeshOptimizer で頂点キャッシュ向けに並べ替える
+    void BuildLodChain(ModelData& modelData, const LodOptions& options = {});
+}
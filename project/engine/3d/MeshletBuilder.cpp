@@ -0,0 +1,374 @@
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+    constexpr uint32_t kInvalidIndex = 0xffffffffu;
+    // つながった三角形が無いとき、近い三角形を探す範囲 (まだ出していない三角形の数)
+    constexpr uint32_t kFallbackWindow = 64;
+
+    Vector3 Subtract(const Vector4& a, const Vector4& b) {
+        return { a.x - b.x, a.y - b.y, a.z - b.z };
+    }
+
+    float Dot(const Vector3& a, const Vector3& b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    // 面の法線 (頂点の法線の側へ向けて正規化したもの、面積が 0 なら 0)
+    // 巻き方向がモデルごとに揃っていないので、表は陰影に使う頂点の法線で決める
+    Vector3 FaceNormal(const ModelData::VertexData& v0, const ModelData::VertexData& v1, const ModelData::VertexData& v2) {
+        const Vector3 e1 = Subtract(v1.position, v0.position);
+        const Vector3 e2 = Subtract(v2.position, v0.position);
+        Vector3 normal = { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+        const Vector3 vertexNormal = {
+            v0.normal.x + v1.normal.x + v2.normal.x,
+            v0.normal.y + v1.normal.y + v2.normal.y,
+            v0.normal.z + v1.normal.z + v2.normal.z
+        };
+        const float length = std::sqrt(Dot(normal, normal));
+        if (length <= 0.0f) {
+            return { 0.0f, 0.0f, 0.0f };
+        }
+        const float scale = (Dot(normal, vertexNormal) < 0.0f ? -1.0f : 1.0f) / length;
+        return { normal.x * scale, normal.y * scale, normal.z * scale };
+    }
+
+    // 位置が同じ頂点に同じ番号を振る (UV の継ぎ目で分かれた頂点も隣として扱うため)
+    std::vector<uint32_t> BuildPositionIds(const std::vector<ModelData::VertexData>& vertices, uint32_t& positionCount) {
+        std::vector<uint32_t> order(vertices.size());
+        for (size_t v = 0; v < vertices.size(); ++v) {
+            order[v] = static_cast<uint32_t>(v);
+        }
+        auto Less = [&](uint32_t a, uint32_t b) {
+            const Vector4& p = vertices[a].position;
+            const Vector4& q = vertices[b].position;
+            if (p.x != q.x) return p.x < q.x;
+            if (p.y != q.y) return p.y < q.y;
+            return p.z < q.z;
+        };
+        std::sort(order.begin(), order.end(), Less);
+
+        std::vector<uint32_t> positionIds(vertices.size());
+        positionCount = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (i > 0 && Less(order[i - 1], order[i])) {
+                ++positionCount;
+            }
+            positionIds[order[i]] = positionCount;
+        }
+        ++positionCount;
+        return positionIds;
+    }
+
+    // 10 ビットずつの座標のビットを交互に並べた値 (範囲 [minimum, maximum] で量子化する)
+    uint32_t MortonCode(const Vector3& p, const Vector3& minimum, const Vector3& maximum) {
+        auto Quantize = [](float value, float low, float high) {
+            return high > low ? static_cast<uint32_t>((value - low) / (high - low) * 1023.0f + 0.5f) : 0u;
+        };
+        auto Spread = [](uint32_t v) {
+            v = (v | (v << 16)) & 0x030000ffu;
+            v = (v | (v << 8)) & 0x0300f00fu;
+            v = (v | (v << 4)) & 0x030c30c3u;
+            v = (v | (v << 2)) & 0x09249249u;
+            return v;
+        };
+        return Spread(Quantize(p.x, minimum.x, maximum.x)) | (Spread(Quantize(p.y, minimum.y, maximum.y)) << 1) |
+            (Spread(Quantize(p.z, minimum.z, maximum.z)) << 2);
+    }
+
+    // 三角形の番号の列から、包む球と面の向きを包む円錐を求める
+    void ComputeBounds(ModelData::Meshlet& meshlet, const uint32_t* triangles, const ModelData& modelData,
+        const std::vector<Vector3>& faceNormals) {
+        const std::vector<ModelData::VertexData>& vertices = modelData.vertices;
+        Vector3 minimum = { vertices[modelData.indices[triangles[0] * 3]].position.x, vertices[modelData.indices[triangles[0] * 3]].position.y, vertices[modelData.indices[triangles[0] * 3]].position.z };
+        Vector3 maximum = minimum;
+        Vector3 normalSum = { 0.0f, 0.0f, 0.0f };
+        for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                const Vector4& p = vertices[modelData.indices[triangles[i] * 3 + c]].position;
+                minimum = { (std::min)(minimum.x, p.x), (std::min)(minimum.y, p.y), (std::min)(minimum.z, p.z) };
+                maximum = { (std::max)(maximum.x, p.x), (std::max)(maximum.y, p.y), (std::max)(maximum.z, p.z) };
+            }
+            const Vector3& normal = faceNormals[triangles[i]];
+            normalSum = { normalSum.x + normal.x, normalSum.y + normal.y, normalSum.z + normal.z };
+        }
+        meshlet.center = { (minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f };
+        float radiusSq = 0.0f;
+        for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                const Vector4& p = vertices[modelData.indices[triangles[i] * 3 + c]].position;
+                const Vector3 d = { p.x - meshlet.center.x, p.y - meshlet.center.y, p.z - meshlet.center.z };
+                radiusSq = (std::max)(radiusSq, Dot(d, d));
+            }
+        }
+        meshlet.radius = std::sqrt(radiusSq);
+
+        // 軸は法線の平均、半角は軸から最も離れた法線までの角度
+        meshlet.coneAxis = { 0.0f, 0.0f, 0.0f };
+        meshlet.coneCutoff = 1.0f;
+        const float length = std::sqrt(Dot(normalSum, normalSum));
+        if (length <= 0.0f) {
+            return;
+        }
+        meshlet.coneAxis = { normalSum.x / length, normalSum.y / length, normalSum.z / length };
+        float minimumDot = 1.0f;
+        for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+            const Vector3& normal = faceNormals[triangles[i]];
+            if (normal.x != 0.0f || normal.y != 0.0f || normal.z != 0.0f) {
+                minimumDot = (std::min)(minimumDot, Dot(normal, meshlet.coneAxis));
+            }
+        }
+        // 半角が 90 度以上なら、どこから見ても表の三角形がありうる
+        if (minimumDot > 0.0f) {
+            meshlet.coneCutoff = std::sqrt((std::max)(0.0f, 1.0f - minimumDot * minimumDot));
+        }
+    }
+}
+
+void MeshletBuilder::Build(ModelData& modelData, const Options& options) {
+    modelData.meshlets.clear();
+    if (modelData.vertices.empty() || modelData.indices.empty()) {
+        return;
+    }
+
+    // 詳細度を下げた段は元のメッシュの後ろにある
+    size_t baseIndexCount = modelData.indices.size();
+    for (const ModelData::Lod& lod : modelData.lods) {
+        for (const ModelData::Submesh& submesh : lod.submeshes) {
+            baseIndexCount = (std::min)(baseIndexCount, static_cast<size_t>(submesh.indexStart));
+        }
+    }
+    std::vector<ModelData::Submesh> submeshes = modelData.submeshes;
+    if (submeshes.empty()) {
+        submeshes.push_back({ "", 0, static_cast<uint32_t>(baseIndexCount), 0 });
+    }
+    const size_t vertexCount = modelData.vertices.size();
+    const size_t triangleCount = baseIndexCount / 3;
+
+    // 位置ごとの、それを使う三角形の一覧
+    uint32_t positionCount = 0;
+    const std::vector<uint32_t> positionIds = BuildPositionIds(modelData.vertices, positionCount);
+    std::vector<uint32_t> adjacencyOffsets(positionCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++adjacencyOffsets[positionIds[modelData.indices[i]] + 1];
+    }
+    for (size_t p = 0; p < positionCount; ++p) {
+        adjacencyOffsets[p + 1] += adjacencyOffsets[p];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            adjacency[cursor[positionIds[modelData.indices[i]]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+    std::vector<Vector3> faceNormals(triangleCount);
+    std::vector<Vector3> centroids(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const ModelData::VertexData& v0 = modelData.vertices[modelData.indices[t * 3]];
+        const ModelData::VertexData& v1 = modelData.vertices[modelData.indices[t * 3 + 1]];
+        const ModelData::VertexData& v2 = modelData.vertices[modelData.indices[t * 3 + 2]];
+        faceNormals[t] = FaceNormal(v0, v1, v2);
+        centroids[t] = {
+            (v0.position.x + v1.position.x + v2.position.x) / 3.0f,
+            (v0.position.y + v1.position.y + v2.position.y) / 3.0f,
+            (v0.position.z + v1.position.z + v2.position.z) / 3.0f
+        };
+    }
+
+    std::vector<bool> isEmitted(triangleCount, false);
+    // 今の塊に入っている頂点・候補に入れた三角形は、塊の番号で印を付ける
+    std::vector<uint32_t> vertexStamps(vertexCount, kInvalidIndex);
+    std::vector<uint32_t> positionStamps(positionCount, kInvalidIndex);
+    std::vector<uint32_t> candidateStamps(triangleCount, kInvalidIndex);
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> meshletTriangles;
+    std::vector<uint32_t> reordered;
+    std::vector<uint32_t> localIndices;
+    std::vector<uint32_t> localToVertex;
+    uint32_t meshletId = 0;
+
+    for (uint32_t submeshIndex = 0; submeshIndex < submeshes.size(); ++submeshIndex) {
+        const ModelData::Submesh& submesh = submeshes[submeshIndex];
+        const uint32_t triangleStart = submesh.indexStart / 3;
+        const uint32_t triangleEnd = triangleStart + submesh.indexCount / 3;
+
+        // 塊ごとの三角形は meshletTriangles の [firstTriangles[m], firstTriangles[m] + triangleCount) に置く
+        std::vector<ModelData::Meshlet> meshlets;
+        std::vector<uint32_t> firstTriangles;
+        meshletTriangles.clear();
+
+        uint32_t scan = triangleStart;
+        while (true) {
+            while (scan < triangleEnd && isEmitted[scan]) {
+                ++scan;
+            }
+            if (scan == triangleEnd) {
+                break;
+            }
+
+            ModelData::Meshlet meshlet;
+            meshlet.submeshIndex = submeshIndex;
+            firstTriangles.push_back(static_cast<uint32_t>(meshletTriangles.size()));
+            candidates.clear();
+            Vector3 normalSum = { 0.0f, 0.0f, 0.0f };
+            // 塊の三角形の重心を包む AABB (つながっていない三角形を足すかどうかの目安)
+            Vector3 minimum = centroids[scan];
+            Vector3 maximum = centroids[scan];
+
+            auto AddTriangle = [&](uint32_t triangle) {
+                isEmitted[triangle] = true;
+                meshletTriangles.push_back(triangle);
+                ++meshlet.triangleCount;
+                const Vector3& normal = faceNormals[triangle];
+                normalSum = { normalSum.x + normal.x, normalSum.y + normal.y, normalSum.z + normal.z };
+                const Vector3& centroid = centroids[triangle];
+                minimum = { (std::min)(minimum.x, centroid.x), (std::min)(minimum.y, centroid.y), (std::min)(minimum.z, centroid.z) };
+                maximum = { (std::max)(maximum.x, centroid.x), (std::max)(maximum.y, centroid.y), (std::max)(maximum.z, centroid.z) };
+                for (int c = 0; c < 3; ++c) {
+                    const uint32_t vertex = modelData.indices[triangle * 3 + c];
+                    if (vertexStamps[vertex] == meshletId) {
+                        continue;
+                    }
+                    vertexStamps[vertex] = meshletId;
+                    ++meshlet.vertexCount;
+                    const uint32_t position = positionIds[vertex];
+                    if (positionStamps[position] == meshletId) {
+                        continue;
+                    }
+                    positionStamps[position] = meshletId;
+                    // 新しい位置を共有する三角形を候補にする
+                    for (uint32_t a = adjacencyOffsets[position]; a < adjacencyOffsets[position + 1]; ++a) {
+                        const uint32_t neighbor = adjacency[a];
+                        if (neighbor >= triangleStart && neighbor < triangleEnd && !isEmitted[neighbor] && candidateStamps[neighbor] != meshletId) {
+                            candidateStamps[neighbor] = meshletId;
+                            candidates.push_back(neighbor);
+                        }
+                    }
+                }
+            };
+            AddTriangle(scan);
+
+            while (meshlet.triangleCount < options.maxTriangleCount) {
+                const float normalLength = std::sqrt(Dot(normalSum, normalSum));
+                const Vector3 axis = normalLength > 0.0f
+                    ? Vector3{ normalSum.x / normalLength, normalSum.y / normalLength, normalSum.z / normalLength }
+                    : Vector3{ 0.0f, 0.0f, 0.0f };
+
+                // 出した三角形を候補から除きながら、最も点数の低いものを選ぶ
+                uint32_t best = kInvalidIndex;
+                float bestScore = 0.0f;
+                size_t writeIndex = 0;
+                for (uint32_t candidate : candidates) {
+                    if (isEmitted[candidate]) {
+                        continue;
+                    }
+                    candidates[writeIndex++] = candidate;
+                    uint32_t newVertexCount = 0;
+                    for (int c = 0; c < 3; ++c) {
+                        newVertexCount += vertexStamps[modelData.indices[candidate * 3 + c]] == meshletId ? 0 : 1;
+                    }
+                    if (meshlet.vertexCount + newVertexCount > options.maxVertexCount) {
+                        continue;
+                    }
+                    const float score = static_cast<float>(newVertexCount) + options.coneWeight * (1.0f - Dot(faceNormals[candidate], axis));
+                    if (best == kInvalidIndex || score < bestScore) {
+                        best = candidate;
+                        bestScore = score;
+                    }
+                }
+                candidates.resize(writeIndex);
+
+                // 隣の三角形が残っていなければ (つながりが切れた)、まだ出していない三角形を並び順に少しだけ見て、近いものを足す
+                // (塊の大きさの範囲にあるものだけ、つながっていない小さな部品が 1 つずつの塊にならないように)
+                if (best == kInvalidIndex && candidates.empty() && meshlet.vertexCount + 3 <= options.maxVertexCount) {
+                    const Vector3 center = { (minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f };
+                    const Vector3 extent = { maximum.x - minimum.x, maximum.y - minimum.y, maximum.z - minimum.z };
+                    // 三角形 1 枚の塊でも隣の部品を拾えるよう、最初の三角形の大きさも見る
+                    const ModelData::VertexData& seed = modelData.vertices[modelData.indices[meshletTriangles[firstTriangles.back()] * 3]];
+                    const Vector3 seedOffset = { seed.position.x - centroids[meshletTriangles[firstTriangles.back()]].x,
+                        seed.position.y - centroids[meshletTriangles[firstTriangles.back()]].y, seed.position.z - centroids[meshletTriangles[firstTriangles.back()]].z };
+                    const float reachSq = (std::max)(Dot(extent, extent), 4.0f * Dot(seedOffset, seedOffset)) * 4.0f;
+                    float bestDistanceSq = reachSq;
+                    uint32_t looked = 0;
+                    for (uint32_t t = scan; t < triangleEnd && looked < kFallbackWindow; ++t) {
+                        if (isEmitted[t]) {
+                            continue;
+                        }
+                        ++looked;
+                        const Vector3 offset = { centroids[t].x - center.x, centroids[t].y - center.y, centroids[t].z - center.z };
+                        const float distanceSq = Dot(offset, offset);
+                        if (distanceSq <= bestDistanceSq) {
+                            best = t;
+                            bestDistanceSq = distanceSq;
+                        }
+                    }
+                }
+                if (best == kInvalidIndex) {
+                    break;
+                }
+                AddTriangle(best);
+            }
+
+            ComputeBounds(meshlet, meshletTriangles.data() + firstTriangles.back(), modelData, faceNormals);
+            meshlets.push_back(meshlet);
+            ++meshletId;
+        }
+        if (meshlets.empty()) {
+            continue;
+        }
+
+        // 塊は中心の Morton 順に並べる (近い塊が続くので、見える塊をまとめて描く回数が少なくなる)
+        Vector3 minimum = meshlets.front().center;
+        Vector3 maximum = minimum;
+        for (const ModelData::Meshlet& meshlet : meshlets) {
+            minimum = { (std::min)(minimum.x, meshlet.center.x), (std::min)(minimum.y, meshlet.center.y), (std::min)(minimum.z, meshlet.center.z) };
+            maximum = { (std::max)(maximum.x, meshlet.center.x), (std::max)(maximum.y, meshlet.center.y), (std::max)(maximum.z, meshlet.center.z) };
+        }
+        std::vector<uint32_t> order(meshlets.size());
+        std::vector<uint32_t> sortKeys(meshlets.size());
+        for (uint32_t m = 0; m < meshlets.size(); ++m) {
+            order[m] = m;
+            sortKeys[m] = MortonCode(meshlets[m].center, minimum, maximum);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] < sortKeys[b]; });
+
+        // 塊の順に頂点番号を書き直す (塊の中は、塊の中だけの頂点番号にして Tipsify で並べる)
+        reordered.clear();
+        for (uint32_t m : order) {
+            ModelData::Meshlet meshlet = meshlets[m];
+            const uint32_t* triangles = meshletTriangles.data() + firstTriangles[m];
+            localIndices.clear();
+            localToVertex.clear();
+            for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+                for (int c = 0; c < 3; ++c) {
+                    const uint32_t vertex = modelData.indices[triangles[i] * 3 + c];
+                    auto found = std::find(localToVertex.begin(), localToVertex.end(), vertex);
+                    localIndices.push_back(static_cast<uint32_t>(found - localToVertex.begin()));
+                    if (found == localToVertex.end()) {
+                        localToVertex.push_back(vertex);
+                    }
+                }
+            }
+            MeshOptimizer::OptimizeVertexCache(localIndices.data(), localIndices.size(), localToVertex.size(), options.cacheSize);
+
+            meshlet.indexStart = submesh.indexStart + static_cast<uint32_t>(reordered.size());
+            for (uint32_t localIndex : localIndices) {
+                reordered.push_back(localToVertex[localIndex]);
+            }
+            modelData.meshlets.push_back(meshlet);
+        }
+        std::copy(reordered.begin(), reordered.end(), modelData.indices.begin() + submesh.indexStart);
+    }
+
+    MeshOptimizer::OptimizeVertexFetch(modelData);
+    // 取り込み時に並べ替えていれば (MeshOptimizer::Optimize)、この並びでの値に直す
+    if (modelData.cacheMetrics.acmrBefore > 0.0f) {
+        const MeshOptimizer::CacheStatistics after = MeshOptimizer::AnalyzeVertexCache(modelData.indices.data(), baseIndexCount, vertexCount, options.cacheSize);
+        modelData.cacheMetrics.acmrAfter = after.acmr;
+        modelData.cacheMetrics.atvrAfter = after.atvr;
+    }
+}
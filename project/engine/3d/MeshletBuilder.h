@@ -0,0 +1,22 @@
+#pragma once
+#include "ModelData.h"
+#include <cstdint>
+
+// 元のメッシュの三角形を、頂点 maxVertexCount 個・三角形 maxTriangleCount 個までの塊 (メッシュレット) に分ける
+// 塊は頂点を共有する三角形を、新しい頂点が少なく向きの揃ったものから順に足して育てる
+// 頂点番号は塊ごとに続くように並べ替え、塊ごとに包む球と面の向きを包む円錐を modelData.meshlets に残す
+// 詳細度を下げた段の範囲 (modelData.lods) は変えない
+namespace MeshletBuilder {
+    struct Options {
+        uint32_t maxVertexCount = 64;
+        uint32_t maxTriangleCount = 124;
+        // 足す三角形を選ぶとき、向きのずれ (1 - cos) を新しく増える頂点の数に対してどれだけ重く見るか
+        float coneWeight = 0.5f;
+        // 頂点キャッシュ (FIFO) の大きさ (塊の中の三角形の並べ替えに使う)
+        uint32_t cacheSize = 16;
+    };
+
+    // 塊の中は Tipsify で並べ、塊はサブメッシュの中で中心の Morton 順に並べる (見える塊の頂点番号の範囲が続きやすい)
+    // 最後に頂点を最初に参照された順に並べ直し、modelData.cacheMetrics の並べ替え後の値を更新する
+    void Build(ModelData& modelData, const Options& options = {});
+}
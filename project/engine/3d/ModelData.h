@@ -0,0 +1,85 @@
+#pragma once
+#include "Culling.h"
+#include "Matrix4x4.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// モデルの CPU 側のデータ (グラフィックス API に依存しない)
+// Model は Model::ModelData などの名前でこの型を使う
+struct ModelData {
+    struct VertexData {
+        Vector4 position;
+        Vector2 texcoord;
+        Vector3 normal;
+    };
+
+    struct MaterialData {
+        std::string name;
+        std::string textureFilePath;
+        uint32_t textureIndex = 0;
+    };
+
+    // 頂点番号の [indexStart, indexStart + indexCount) を materials[materialIndex] で描く
+    struct Submesh {
+        std::string name;
+        uint32_t indexStart = 0;
+        uint32_t indexCount = 0;
+        uint32_t materialIndex = 0;
+    };
+
+    // 詳細度を下げた段 (頂点は共有し、頂点番号の範囲だけが違う)
+    struct Lod {
+        // 元のメッシュからの最大のずれ (モデルのローカル座標の距離)
+        float error = 0.0f;
+        // submeshes と同じ並び・同じマテリアルで、範囲だけ詳細度を下げたもの
+        std::vector<Submesh> submeshes;
+    };
+
+    // 元のメッシュの頂点番号の [indexStart, indexStart + triangleCount * 3) をまとめた塊 (MeshletBuilder)
+    // 塊ごとに視錐台・裏向きで判定して、見えるものだけを描く (ClusterCulling)
+    struct Meshlet {
+        uint32_t indexStart = 0;
+        uint32_t triangleCount = 0;
+        // 使う頂点の数 (重複を除く)
+        uint32_t vertexCount = 0;
+        uint32_t submeshIndex = 0;
+        // 三角形を包む球
+        Vector3 center = { 0.0f, 0.0f, 0.0f };
+        float radius = 0.0f;
+        // 三角形の面の向きを包む円錐 (coneCutoff は半角の sin、1 なら向きがばらばらで裏向きの判定はしない)
+        Vector3 coneAxis = { 0.0f, 0.0f, 0.0f };
+        float coneCutoff = 1.0f;
+    };
+
+    // 頂点を包むローカル座標の境界 (BoundingVolume)
+    struct Bounds {
+        Aabb aabb = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+        BoundingSphere sphere = { { 0.0f, 0.0f, 0.0f }, 0.0f };
+        Obb obb = { { 0.0f, 0.0f, 0.0f }, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { 0.0f, 0.0f, 0.0f } };
+    };
+
+    // 取り込み時の並べ替え (MeshOptimizer) の前後の頂点キャッシュの効率 (並べ替えていなければ 0)
+    struct CacheMetrics {
+        float acmrBefore = 0.0f;
+        float acmrAfter = 0.0f;
+        float atvrBefore = 0.0f;
+        float atvrAfter = 0.0f;
+    };
+
+    // 重複を除いた頂点と、3 つずつで三角形になる頂点番号 (全てのサブメッシュで共有する)
+    std::vector<VertexData> vertices;
+    std::vector<uint32_t> indices;
+    // 空なら頂点番号全体を 1 つのサブメッシュとして materials[0] で描く
+    std::vector<Submesh> submeshes;
+    std::vector<MaterialData> materials;
+    // lods[0] が元のメッシュの 1 段下 (MeshSimplifier)、空なら元のメッシュだけ
+    std::vector<Lod> lods;
+    // サブメッシュの順に並び、同じサブメッシュの塊は頂点番号の範囲が続いている (空なら塊ごとの判定はしない)
+    std::vector<Meshlet> meshlets;
+    CacheMetrics cacheMetrics;
+    // 全ての頂点の境界と、サブメッシュごとの境界 (submeshes と同じ並び、空なら作っていない)
+    // 読み込み時には作らず、Model が BoundingVolume::Build で作る (キャッシュにも書かない)
+    Bounds bounds;
+    std::vector<Bounds> submeshBounds;
+};
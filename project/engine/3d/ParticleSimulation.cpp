@@ -0,0 +1,203 @@
+#include "ParticleSimulation.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace MatrixMath;
+
+ParticleSimulation::ParticleSimulation()
+    : random_(std::random_device{}()) {
+}
+
+uint32_t ParticleSimulation::Update(float deltaTime, const Matrix4x4& viewProjection, const Matrix4x4& billboard, ParticleForGPU* instances, uint32_t maxInstance) {
+    uint32_t numInstance = 0;
+    instanceTransforms_.Clear();
+    for (auto it = particles_.begin(); it != particles_.end();) {
+        it->currentTime += deltaTime;
+        if (it->currentTime >= it->lifeTime) {
+            it = particles_.erase(it);
+            continue;
+        }
+
+        it->transform.translate.x += it->velocity.x;
+        it->transform.translate.y += it->velocity.y;
+        it->transform.translate.z += it->velocity.z;
+
+        float alpha = 1.0f - (it->currentTime / it->lifeTime);
+        it->color.w = alpha;
+
+        if (numInstance < maxInstance) {
+            // ビルボードなので回転は Z のみ使う
+            Transform transform = it->transform;
+            transform.rotate = { 0.0f, 0.0f, transform.rotate.z };
+            instanceTransforms_.PushBack(transform);
+
+            instances[numInstance].color = it->color;
+            numInstance++;
+        }
+        ++it;
+    }
+
+    if (numInstance == 0) {
+        return 0;
+    }
+
+    // World = S * Rz * Billboard * T と WVP をまとめて計算する
+    AffineBatchOutput output;
+    output.worlds = { &instances[0].World, sizeof(ParticleForGPU) };
+    output.wvps = { &instances[0].WVP, sizeof(ParticleForGPU) };
+    MakeAffineBatch(instanceTransforms_.GetStreams(), &viewProjection, &billboard, output);
+    return numInstance;
+}
+
+void ParticleSimulation::Emit(const std::string& name, const Vector3& pos, uint32_t count) {
+    std::mt19937& gen = random_;
+    auto RandomRange = [&gen](float minValue, float maxValue) {
+        if (minValue > maxValue) {
+            std::swap(minValue, maxValue);
+        }
+        std::uniform_real_distribution<float> dist(minValue, maxValue);
+        return dist(gen);
+        };
+    auto Normalize = [](const Vector3& value) {
+        float lengthSq = value.x * value.x + value.y * value.y + value.z * value.z;
+        if (lengthSq <= 0.0001f) {
+            return Vector3{ 0.0f, 0.0f, 1.0f };
+        }
+        float invLength = 1.0f / std::sqrt(lengthSq);
+        return Vector3{ value.x * invLength, value.y * invLength, value.z * invLength };
+        };
+    auto RandomUnitDirection = [&]() {
+        return Normalize({
+            RandomRange(-1.0f, 1.0f),
+            RandomRange(-1.0f, 1.0f),
+            RandomRange(-1.0f, 1.0f)
+            });
+        };
+    auto RandomColor = [&](const EffectParams& params) {
+        return Vector4{
+            RandomRange(params.colorRRange.x, params.colorRRange.y),
+            RandomRange(params.colorGRange.x, params.colorGRange.y),
+            RandomRange(params.colorBRange.x, params.colorBRange.y),
+            1.0f
+        };
+        };
+    auto PushParticle = [&](const EffectParams& params, const Vector3& spawnPos, const Vector3& velocity, float scaleX, float scaleY, float rotateZ, const Vector4& color) {
+        Particle particle;
+        particle.transform = {
+            { scaleX, scaleY, 1.0f },
+            { 0.0f, 0.0f, rotateZ },
+            spawnPos
+        };
+        particle.velocity = velocity;
+        particle.color = color;
+        particle.lifeTime = RandomRange(params.lifeTimeRange.x, params.lifeTimeRange.y);
+        particle.currentTime = 0.0f;
+        particles_.push_back(particle);
+        };
+
+    if (name == "Hit") {
+        uint32_t emitCount = count > 0 ? count : hitEffectParams_.spawnCount;
+        for (uint32_t i = 0; i < emitCount; ++i) {
+            // Plane billboard particles are stretched into short-lived streaks
+            // and emitted radially to form the assignment-style hit effect.
+            Vector3 direction = RandomUnitDirection();
+            float speed = RandomRange(hitEffectParams_.speedRange.x, hitEffectParams_.speedRange.y);
+            PushParticle(
+                hitEffectParams_,
+                pos,
+                { direction.x * speed, direction.y * speed, direction.z * speed },
+                RandomRange(hitEffectParams_.scaleXRange.x, hitEffectParams_.scaleXRange.y),
+                RandomRange(hitEffectParams_.scaleYRange.x, hitEffectParams_.scaleYRange.y),
+                RandomRange(hitEffectParams_.rotateZRange.x, hitEffectParams_.rotateZRange.y),
+                RandomColor(hitEffectParams_));
+        }
+        return;
+    }
+
+    if (name == "Fireball") {
+        uint32_t emitCount = count > 0 ? count : fireballEffectParams_.spawnCount;
+        for (uint32_t i = 0; i < emitCount; ++i) {
+            bool isCore = i < (emitCount * 2 / 3);
+            Vector3 offset = {
+                RandomRange(-0.12f, 0.12f),
+                RandomRange(-0.12f, 0.12f),
+                RandomRange(-0.08f, 0.08f)
+            };
+            Vector3 direction = Normalize({
+                RandomRange(-0.28f, 0.28f),
+                RandomRange(-0.18f, 0.28f),
+                1.0f + RandomRange(0.0f, 0.35f)
+                });
+            float speed = RandomRange(fireballEffectParams_.speedRange.x, fireballEffectParams_.speedRange.y);
+            if (isCore) {
+                speed *= 0.45f;
+                offset.x *= 0.35f;
+                offset.y *= 0.35f;
+                offset.z *= 0.35f;
+            }
+
+            Vector4 color = RandomColor(fireballEffectParams_);
+            if (isCore) {
+                color.x = 1.0f;
+                color.y = (std::min)(1.0f, color.y + 0.2f);
+            }
+
+            float scaleX = RandomRange(fireballEffectParams_.scaleXRange.x, fireballEffectParams_.scaleXRange.y);
+            float scaleY = RandomRange(fireballEffectParams_.scaleYRange.x, fireballEffectParams_.scaleYRange.y);
+            if (!isCore) {
+                scaleX *= 0.55f;
+                scaleY *= 0.75f;
+            }
+
+            PushParticle(
+                fireballEffectParams_,
+                { pos.x + offset.x, pos.y + offset.y, pos.z + offset.z },
+                { direction.x * speed, direction.y * speed, direction.z * speed },
+                scaleX,
+                scaleY,
+                RandomRange(fireballEffectParams_.rotateZRange.x, fireballEffectParams_.rotateZRange.y),
+                color);
+        }
+        return;
+    }
+
+    if (name == "Wind") {
+        uint32_t emitCount = count > 0 ? count : windEffectParams_.spawnCount;
+        for (uint32_t i = 0; i < emitCount; ++i) {
+            Vector3 spawnPos = {
+                pos.x + RandomRange(-0.25f, 0.25f),
+                pos.y + RandomRange(-0.35f, 0.35f),
+                pos.z + RandomRange(-0.25f, 0.25f)
+            };
+            Vector3 direction = Normalize({
+                1.0f,
+                RandomRange(-0.15f, 0.15f),
+                RandomRange(-0.10f, 0.10f)
+                });
+            float speed = RandomRange(windEffectParams_.speedRange.x, windEffectParams_.speedRange.y);
+            PushParticle(
+                windEffectParams_,
+                spawnPos,
+                { direction.x * speed, direction.y * speed, direction.z * speed },
+                RandomRange(windEffectParams_.scaleXRange.x, windEffectParams_.scaleXRange.y),
+                RandomRange(windEffectParams_.scaleYRange.x, windEffectParams_.scaleYRange.y),
+                RandomRange(windEffectParams_.rotateZRange.x, windEffectParams_.rotateZRange.y),
+                RandomColor(windEffectParams_));
+        }
+        return;
+    }
+
+    std::uniform_real_distribution<float> distVelocity(-0.05f, 0.05f);
+    std::uniform_real_distribution<float> distColor(0.0f, 1.0f);
+    std::uniform_real_distribution<float> distTime(1.0f, 3.0f);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        Particle particle;
+        particle.transform = { {1.0f, 1.0f, 1.0f}, {0,0,0}, pos };
+        particle.velocity = { distVelocity(gen), distVelocity(gen), distVelocity(gen) };
+        particle.color = { distColor(gen), distColor(gen), distColor(gen), 1.0f };
+        particle.lifeTime = distTime(gen);
+        particle.currentTime = 0.0f;
+        particles_.push_back(particle);
+    }
+}
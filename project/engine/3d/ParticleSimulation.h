@@ -0,0 +1,66 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "TransformBatch.h"
+#include <cstdint>
+#include <list>
+#include <random>
+#include <string>
+
+// パーティクルの発生と移動 (描画リソースを持たない CPU 側の処理)
+// ParticleManager はこれを持ち、Update で書き出した行列を GPU のバッファへ渡す
+class ParticleSimulation {
+public:
+    struct Particle {
+        Transform transform;
+        Vector3 velocity;
+        Vector4 color;
+        float lifeTime;
+        float currentTime;
+    };
+
+    struct EffectParams {
+        Vector2 scaleXRange{ 0.08f, 0.18f };
+        Vector2 scaleYRange{ 0.6f, 1.4f };
+        Vector2 rotateZRange{ 0.0f, 6.2831853f };
+        Vector2 lifeTimeRange{ 0.2f, 0.5f };
+        Vector2 speedRange{ 0.08f, 0.2f };
+        Vector2 colorRRange{ 1.0f, 1.0f };
+        Vector2 colorGRange{ 0.55f, 1.0f };
+        Vector2 colorBRange{ 0.15f, 0.35f };
+        uint32_t spawnCount = 24;
+    };
+
+    struct ParticleForGPU {
+        Matrix4x4 WVP;
+        Matrix4x4 World;
+        Vector4 color;
+    };
+
+public:
+    ParticleSimulation();
+
+    // name が "Hit" / "Fireball" / "Wind" ならそのエフェクト、それ以外は汎用の粒子を count 個出す
+    void Emit(const std::string& name, const Vector3& pos, uint32_t count);
+    // 粒子を deltaTime 進めて寿命の尽きたものを消し、先頭 maxInstance 個の行列と色を instances へ書き込む
+    // 書き込んだ個数を返す
+    uint32_t Update(float deltaTime, const Matrix4x4& viewProjection, const Matrix4x4& billboard, ParticleForGPU* instances, uint32_t maxInstance);
+    void Clear() { particles_.clear(); }
+
+    // 乱数の種を固定する (計測で同じ粒子列を再現する用)
+    void SetSeed(uint32_t seed) { random_.seed(seed); }
+
+    size_t GetParticleCount() const { return particles_.size(); }
+    EffectParams& GetHitEffectParams() { return hitEffectParams_; }
+    EffectParams& GetFireballEffectParams() { return fireballEffectParams_; }
+    EffectParams& GetWindEffectParams() { return windEffectParams_; }
+
+private:
+    std::list<Particle> particles_;
+    // 描画する粒子の SRT (行列はまとめて書き込み先へ計算する)
+    TransformSoA instanceTransforms_;
+    std::mt19937 random_;
+
+    EffectParams hitEffectParams_{ {0.03f, 0.06f}, {1.5f, 2.8f}, {0.0f, 6.2831853f}, {0.08f, 0.14f}, {0.18f, 0.30f}, {1.0f, 1.0f}, {0.78f, 1.0f}, {0.12f, 0.25f}, 16 };
+    EffectParams fireballEffectParams_{ {0.14f, 0.28f}, {0.18f, 0.36f}, {0.0f, 6.2831853f}, {0.22f, 0.40f}, {0.06f, 0.14f}, {0.95f, 1.0f}, {0.35f, 0.65f}, {0.05f, 0.16f}, 16 };
+    EffectParams windEffectParams_{ {0.03f, 0.07f}, {0.7f, 1.5f}, {-0.2f, 0.2f}, {0.35f, 0.70f}, {0.12f, 0.24f}, {0.85f, 1.0f}, {0.90f, 1.0f}, {0.95f, 1.0f}, 20 };
+};
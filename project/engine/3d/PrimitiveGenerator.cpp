@@ -0,0 +1,468 @@
+#include "PrimitiveGenerator.h"
+#include "MeshBuilder.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace {
+    constexpr float kPi = 3.14159265359f;
+
+    float Length(const Vector3& v) {
+        return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+    }
+
+    Vector3 Normalize(const Vector3& v, const Vector3& fallback = { 0.0f, 1.0f, 0.0f }) {
+        float length = Length(v);
+        if (length <= 0.00001f) {
+            return fallback;
+        }
+        return { v.x / length, v.y / length, v.z / length };
+    }
+
+    ModelData::VertexData MakeVertex(float x, float y, float z, float u, float v, float nx, float ny, float nz) {
+        return { {x, y, z, 1.0f}, {u, v}, {nx, ny, nz} };
+    }
+
+    uint32_t ClampSubdivision(uint32_t subdivision) {
+        return (subdivision < 3) ? 3 : subdivision;
+    }
+
+    // [startAngle, endAngle] を segments 等分した segments + 1 個の角度の割合 (0 から 1) と sin / cos
+    // 一周する場合は最後を最初と同じ値にして、継ぎ目の位置をそろえる
+    struct AngleTable {
+        std::vector<float> ratios;
+        std::vector<float> sinValues;
+        std::vector<float> cosValues;
+    };
+
+    AngleTable MakeAngleTable(float startAngle, float endAngle, uint32_t segments, bool isClosed) {
+        AngleTable table;
+        table.ratios.resize(segments + 1);
+        table.sinValues.resize(segments + 1);
+        table.cosValues.resize(segments + 1);
+        std::vector<float> angles(segments + 1);
+        for (uint32_t i = 0; i <= segments; ++i) {
+            table.ratios[i] = static_cast<float>(i) / static_cast<float>(segments);
+            angles[i] = std::lerp(startAngle, endAngle, table.ratios[i]);
+        }
+        // 精度は FastMath のポリシーに従う
+        FastMath::SinCosArray(angles.data(), table.sinValues.data(), table.cosValues.data(), angles.size(), FastMath::GetTrigPrecision());
+        if (isClosed) {
+            table.sinValues[segments] = table.sinValues[0];
+            table.cosValues[segments] = table.cosValues[0];
+        }
+        return table;
+    }
+
+    // 書き込み先へ頂点と頂点番号を順に書く
+    struct MeshWriter {
+        ModelData::VertexData* vertices = nullptr;
+        uint16_t* shortIndices = nullptr;
+        uint32_t* indices = nullptr;
+        uint32_t baseVertex = 0;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+
+        explicit MeshWriter(const PrimitiveGenerator::MeshOutput& output)
+            : vertices(output.vertices), baseVertex(output.baseVertex) {
+            if (output.isShortIndex) {
+                shortIndices = static_cast<uint16_t*>(output.indices);
+            } else {
+                indices = static_cast<uint32_t*>(output.indices);
+            }
+        }
+
+        uint32_t AddVertex(const ModelData::VertexData& vertex) {
+            vertices[vertexCount] = vertex;
+            return vertexCount++;
+        }
+
+        void AddTriangle(uint32_t v0, uint32_t v1, uint32_t v2) {
+            if (shortIndices) {
+                assert(baseVertex + (std::max)({ v0, v1, v2 }) <= 0xffff);
+                shortIndices[indexCount + 0] = static_cast<uint16_t>(baseVertex + v0);
+                shortIndices[indexCount + 1] = static_cast<uint16_t>(baseVertex + v1);
+                shortIndices[indexCount + 2] = static_cast<uint16_t>(baseVertex + v2);
+            } else {
+                indices[indexCount + 0] = baseVertex + v0;
+                indices[indexCount + 1] = baseVertex + v1;
+                indices[indexCount + 2] = baseVertex + v2;
+            }
+            indexCount += 3;
+        }
+
+        // MeshBuilder 版の PushQuad と同じ巻き順
+        void AddQuad(uint32_t v00, uint32_t v01, uint32_t v10, uint32_t v11) {
+            AddTriangle(v00, v01, v10);
+            AddTriangle(v01, v11, v10);
+        }
+    };
+
+    // 書き込み先をちょうどの大きさで確保した ModelData を作り、write で埋める (頂点番号は 32 ビット)
+    template<typename Write>
+    ModelData CreateIndexed(const PrimitiveGenerator::MeshSize& size, Write&& write) {
+        ModelData data;
+        data.vertices.resize(size.vertexCount);
+        data.indices.resize(size.indexCount);
+        write(PrimitiveGenerator::MeshOutput{ data.vertices.data(), data.indices.data(), false, 0 });
+        return data;
+    }
+
+    void PushTriangle(MeshBuilder& builder,
+        const ModelData::VertexData& v0,
+        const ModelData::VertexData& v1,
+        const ModelData::VertexData& v2) {
+        builder.AddTriangle(v0, v1, v2);
+    }
+
+    void PushQuad(MeshBuilder& builder,
+        const ModelData::VertexData& v00,
+        const ModelData::VertexData& v01,
+        const ModelData::VertexData& v10,
+        const ModelData::VertexData& v11) {
+        PushTriangle(builder, v00, v01, v10);
+        PushTriangle(builder, v01, v11, v10);
+    }
+}
+
+PrimitiveGenerator::MeshSize PrimitiveGenerator::GetSphereSize(uint32_t subdivision) {
+    subdivision = ClampSubdivision(subdivision);
+    return { (subdivision + 1) * (subdivision + 1), 6 * subdivision * subdivision };
+}
+
+void PrimitiveGenerator::WriteSphereData(const MeshOutput& output, uint32_t subdivision) {
+    subdivision = ClampSubdivision(subdivision);
+    const AngleTable latTable = MakeAngleTable(0.0f, kPi, subdivision, false);
+    const AngleTable lonTable = MakeAngleTable(0.0f, 2.0f * kPi, subdivision, true);
+    MeshWriter writer(output);
+
+    // 緯度 lat・経度 lon の頂点は lat * (subdivision + 1) + lon 番目
+    for (uint32_t lat = 0; lat <= subdivision; ++lat) {
+        const float y = latTable.cosValues[lat];
+        const float r = latTable.sinValues[lat];
+        const float v = latTable.ratios[lat];
+        for (uint32_t lon = 0; lon <= subdivision; ++lon) {
+            const float x = r * lonTable.cosValues[lon];
+            const float z = r * lonTable.sinValues[lon];
+            writer.AddVertex({ {x, y, z, 1.0f}, {lonTable.ratios[lon], v}, {x, y, z} });
+        }
+    }
+    const uint32_t rowSize = subdivision + 1;
+    for (uint32_t lat = 0; lat < subdivision; ++lat) {
+        for (uint32_t lon = 0; lon < subdivision; ++lon) {
+            const uint32_t v00 = lat * rowSize + lon;
+            writer.AddQuad(v00, v00 + 1, v00 + rowSize, v00 + rowSize + 1);
+        }
+    }
+}
+
+ModelData PrimitiveGenerator::CreateSphereData(uint32_t subdivision) {
+    return CreateIndexed(GetSphereSize(subdivision), [&](const MeshOutput& output) { WriteSphereData(output, subdivision); });
+}
+
+ModelData PrimitiveGenerator::CreatePlaneData() {
+    ModelData data;
+    MeshBuilder builder(data);
+
+    const Vector3 normal = { 0.0f, 1.0f, 0.0f };
+    PushQuad(builder,
+        MakeVertex(-1.0f, 0.0f, 1.0f, 0.0f, 0.0f, normal.x, normal.y, normal.z),
+        MakeVertex(1.0f, 0.0f, 1.0f, 1.0f, 0.0f, normal.x, normal.y, normal.z),
+        MakeVertex(-1.0f, 0.0f, -1.0f, 0.0f, 1.0f, normal.x, normal.y, normal.z),
+        MakeVertex(1.0f, 0.0f, -1.0f, 1.0f, 1.0f, normal.x, normal.y, normal.z));
+
+    return data;
+}
+
+ModelData PrimitiveGenerator::CreateCircleData(uint32_t subdivision) {
+    subdivision = ClampSubdivision(subdivision);
+    return CreateIndexed({ subdivision + 2, 3 * subdivision }, [&](const MeshOutput& output) {
+        const AngleTable table = MakeAngleTable(0.0f, 2.0f * kPi, subdivision, true);
+        MeshWriter writer(output);
+        const uint32_t center = writer.AddVertex(MakeVertex(0.0f, 0.0f, 0.0f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f));
+        for (uint32_t i = 0; i <= subdivision; ++i) {
+            const float x = table.cosValues[i];
+            const float z = table.sinValues[i];
+            writer.AddVertex(MakeVertex(x, 0.0f, z, x * 0.5f + 0.5f, -z * 0.5f + 0.5f, 0.0f, 1.0f, 0.0f));
+        }
+        for (uint32_t i = 0; i < subdivision; ++i) {
+            writer.AddTriangle(center, center + 2 + i, center + 1 + i);
+        }
+    });
+}
+
+PrimitiveGenerator::MeshSize PrimitiveGenerator::GetRingSize(uint32_t subdivision) {
+    subdivision = ClampSubdivision(subdivision);
+    return { 2 * (subdivision + 1), 6 * subdivision };
+}
+
+void PrimitiveGenerator::WriteRingData(
+    const MeshOutput& output,
+    uint32_t subdivision,
+    float innerRadius,
+    float outerRadius,
+    float startAngle,
+    float endAngle,
+    float startRadius,
+    float endRadius) {
+    subdivision = ClampSubdivision(subdivision);
+    if (innerRadius < 0.0f) {
+        innerRadius = 0.0f;
+    }
+    if (outerRadius <= innerRadius) {
+        outerRadius = innerRadius + 0.5f;
+    }
+    if (endAngle < startAngle) {
+        std::swap(startAngle, endAngle);
+    }
+    startRadius = (std::max)(0.0f, startRadius);
+    endRadius = (std::max)(0.0f, endRadius);
+
+    const bool isClosed = std::fabs(endAngle - startAngle - 2.0f * kPi) < 1.0e-5f;
+    const AngleTable table = MakeAngleTable(startAngle, endAngle, subdivision, isClosed);
+    MeshWriter writer(output);
+
+    // 分割点 i の内側の頂点は 2 * i 番目、外側は 2 * i + 1 番目
+    for (uint32_t i = 0; i <= subdivision; ++i) {
+        const float t = table.ratios[i];
+        const float radiusScale = std::lerp(startRadius, endRadius, t);
+        const float x = -table.sinValues[i];
+        const float y = table.cosValues[i];
+        writer.AddVertex(MakeVertex(x * (innerRadius * radiusScale), y * (innerRadius * radiusScale), 0.0f, t, 1.0f, 0.0f, 0.0f, -1.0f));
+        writer.AddVertex(MakeVertex(x * (outerRadius * radiusScale), y * (outerRadius * radiusScale), 0.0f, t, 0.0f, 0.0f, 0.0f, -1.0f));
+    }
+    for (uint32_t i = 0; i < subdivision; ++i) {
+        writer.AddQuad(2 * i, 2 * i + 1, 2 * i + 2, 2 * i + 3);
+    }
+}
+
+ModelData PrimitiveGenerator::CreateRingData(
+    uint32_t subdivision,
+    float innerRadius,
+    float outerRadius,
+    float startAngle,
+    float endAngle,
+    float startRadius,
+    float endRadius) {
+    return CreateIndexed(GetRingSize(subdivision), [&](const MeshOutput& output) {
+        WriteRingData(output, subdivision, innerRadius, outerRadius, startAngle, endAngle, startRadius, endRadius);
+    });
+}
+
+PrimitiveGenerator::MeshSize PrimitiveGenerator::GetTorusSize(uint32_t majorSubdivision, uint32_t minorSubdivision) {
+    majorSubdivision = ClampSubdivision(majorSubdivision);
+    minorSubdivision = ClampSubdivision(minorSubdivision);
+    return { (majorSubdivision + 1) * (minorSubdivision + 1), 6 * majorSubdivision * minorSubdivision };
+}
+
+void PrimitiveGenerator::WriteTorusData(const MeshOutput& output, uint32_t majorSubdivision, uint32_t minorSubdivision, float majorRadius, float minorRadius) {
+    majorSubdivision = ClampSubdivision(majorSubdivision);
+    minorSubdivision = ClampSubdivision(minorSubdivision);
+    const AngleTable thetaTable = MakeAngleTable(0.0f, 2.0f * kPi, majorSubdivision, true);
+    const AngleTable phiTable = MakeAngleTable(0.0f, 2.0f * kPi, minorSubdivision, true);
+    MeshWriter writer(output);
+
+    // 大円 major・小円 minor の頂点は major * (minorSubdivision + 1) + minor 番目
+    for (uint32_t major = 0; major <= majorSubdivision; ++major) {
+        const float cosTheta = thetaTable.cosValues[major];
+        const float sinTheta = thetaTable.sinValues[major];
+        for (uint32_t minor = 0; minor <= minorSubdivision; ++minor) {
+            const float cosPhi = phiTable.cosValues[minor];
+            const float sinPhi = phiTable.sinValues[minor];
+            const float radius = majorRadius + minorRadius * cosPhi;
+            const Vector3 normal = Normalize({ cosPhi * cosTheta, sinPhi, cosPhi * sinTheta }, { 0.0f, 1.0f, 0.0f });
+            writer.AddVertex(MakeVertex(radius * cosTheta, minorRadius * sinPhi, radius * sinTheta,
+                thetaTable.ratios[major], phiTable.ratios[minor], normal.x, normal.y, normal.z));
+        }
+    }
+    const uint32_t rowSize = minorSubdivision + 1;
+    for (uint32_t major = 0; major < majorSubdivision; ++major) {
+        for (uint32_t minor = 0; minor < minorSubdivision; ++minor) {
+            const uint32_t v00 = major * rowSize + minor;
+            writer.AddQuad(v00, v00 + rowSize, v00 + 1, v00 + rowSize + 1);
+        }
+    }
+}
+
+ModelData PrimitiveGenerator::CreateTorusData(uint32_t majorSubdivision, uint32_t minorSubdivision, float majorRadius, float minorRadius) {
+    return CreateIndexed(GetTorusSize(majorSubdivision, minorSubdivision), [&](const MeshOutput& output) {
+        WriteTorusData(output, majorSubdivision, minorSubdivision, majorRadius, minorRadius);
+    });
+}
+
+PrimitiveGenerator::MeshSize PrimitiveGenerator::GetCylinderSize(uint32_t subdivision) {
+    subdivision = ClampSubdivision(subdivision);
+    // 側面 (上下 2 列) と、上下の蓋 (中心と周)
+    return { 4 * subdivision + 6, 12 * subdivision };
+}
+
+void PrimitiveGenerator::WriteCylinderData(const MeshOutput& output, uint32_t subdivision, float radius, float height) {
+    subdivision = ClampSubdivision(subdivision);
+    const AngleTable table = MakeAngleTable(0.0f, 2.0f * kPi, subdivision, true);
+    MeshWriter writer(output);
+    const float halfHeight = height * 0.5f;
+
+    const uint32_t sideTop = writer.vertexCount;
+    for (uint32_t i = 0; i <= subdivision; ++i) {
+        const float c = table.cosValues[i];
+        const float s = table.sinValues[i];
+        writer.AddVertex(MakeVertex(c * radius, halfHeight, s * radius, table.ratios[i], 0.0f, c, 0.0f, s));
+    }
+    const uint32_t sideBottom = writer.vertexCount;
+    for (uint32_t i = 0; i <= subdivision; ++i) {
+        const float c = table.cosValues[i];
+        const float s = table.sinValues[i];
+        writer.AddVertex(MakeVertex(c * radius, -halfHeight, s * radius, table.ratios[i], 1.0f, c, 0.0f, s));
+    }
+    // 蓋の UV は上から見た位置 (下の蓋は裏から見るので v を反転しない)
+    const uint32_t topCenter = writer.AddVertex(MakeVertex(0.0f, halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f));
+    for (uint32_t i = 0; i <= subdivision; ++i) {
+        const float c = table.cosValues[i];
+        const float s = table.sinValues[i];
+        writer.AddVertex(MakeVertex(c * radius, halfHeight, s * radius, c * 0.5f + 0.5f, -s * 0.5f + 0.5f, 0.0f, 1.0f, 0.0f));
+    }
+    const uint32_t bottomCenter = writer.AddVertex(MakeVertex(0.0f, -halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, -1.0f, 0.0f));
+    for (uint32_t i = 0; i <= subdivision; ++i) {
+        const float c = table.cosValues[i];
+        const float s = table.sinValues[i];
+        writer.AddVertex(MakeVertex(c * radius, -halfHeight, s * radius, c * 0.5f + 0.5f, s * 0.5f + 0.5f, 0.0f, -1.0f, 0.0f));
+    }
+
+    for (uint32_t i = 0; i < subdivision; ++i) {
+        writer.AddQuad(sideTop + i, sideTop + i + 1, sideBottom + i, sideBottom + i + 1);
+        writer.AddTriangle(topCenter, topCenter + 2 + i, topCenter + 1 + i);
+        writer.AddTriangle(bottomCenter, bottomCenter + 1 + i, bottomCenter + 2 + i);
+    }
+}
+
+ModelData PrimitiveGenerator::CreateCylinderData(uint32_t subdivision, float radius, float height) {
+    return CreateIndexed(GetCylinderSize(subdivision), [&](const MeshOutput& output) { WriteCylinderData(output, subdivision, radius, height); });
+}
+
+ModelData PrimitiveGenerator::CreateEffectCylinderData(uint32_t subdivision, float topRadius, float bottomRadius, float height) {
+    subdivision = ClampSubdivision(subdivision);
+    return CreateIndexed({ 2 * (subdivision + 1), 6 * subdivision }, [&](const MeshOutput& output) {
+        const AngleTable table = MakeAngleTable(0.0f, 2.0f * kPi, subdivision, true);
+        MeshWriter writer(output);
+        // 分割点 i の上の頂点は 2 * i 番目、下は 2 * i + 1 番目 (v は上が 1)
+        for (uint32_t i = 0; i <= subdivision; ++i) {
+            const float x = -table.sinValues[i];
+            const float z = table.cosValues[i];
+            const float u = table.ratios[i];
+            writer.AddVertex(MakeVertex(x * topRadius, height, z * topRadius, u, 1.0f, x, 0.0f, z));
+            writer.AddVertex(MakeVertex(x * bottomRadius, 0.0f, z * bottomRadius, u, 0.0f, x, 0.0f, z));
+        }
+        for (uint32_t i = 0; i < subdivision; ++i) {
+            const uint32_t top = 2 * i;
+            const uint32_t bottom = 2 * i + 1;
+            writer.AddTriangle(top, top + 2, bottom);
+            writer.AddTriangle(bottom, top + 2, bottom + 2);
+        }
+    });
+}
+
+PrimitiveGenerator::MeshSize PrimitiveGenerator::GetConeSize(uint32_t subdivision) {
+    subdivision = ClampSubdivision(subdivision);
+    // 頂点は分割ごと (法線が違う)、側面の周・底の中心と周
+    return { 3 * subdivision + 3, 6 * subdivision };
+}
+
+void PrimitiveGenerator::WriteConeData(const MeshOutput& output, uint32_t subdivision, float radius, float height) {
+    subdivision = ClampSubdivision(subdivision);
+    const AngleTable table = MakeAngleTable(0.0f, 2.0f * kPi, subdivision, true);
+    // 分割の中央の角度 (頂点の法線用)
+    const float halfStep = kPi / static_cast<float>(subdivision);
+    const AngleTable midTable = MakeAngleTable(halfStep, 2.0f * kPi + halfStep, subdivision, false);
+    MeshWriter writer(output);
+    const float halfHeight = height * 0.5f;
+    const float slope = radius / height;
+
+    const uint32_t apex = writer.vertexCount;
+    for (uint32_t i = 0; i < subdivision; ++i) {
+        const Vector3 normal = Normalize({ midTable.cosValues[i], slope, midTable.sinValues[i] }, { 0.0f, 1.0f, 0.0f });
+        writer.AddVertex(MakeVertex(0.0f, halfHeight, 0.0f, 0.5f, 0.0f, normal.x, normal.y, normal.z));
+    }
+    const uint32_t side = writer.vertexCount;
+    for (uint32_t i = 0; i <= subdivision; ++i) {
+        const float c = table.cosValues[i];
+        const float s = table.sinValues[i];
+        const Vector3 normal = Normalize({ c, slope, s }, { 1.0f, 0.0f, 0.0f });
+        writer.AddVertex(MakeVertex(c * radius, -halfHeight, s * radius, table.ratios[i], 1.0f, normal.x, normal.y, normal.z));
+    }
+    const uint32_t bottomCenter = writer.AddVertex(MakeVertex(0.0f, -halfHeight, 0.0f, 0.5f, 0.5f, 0.0f, -1.0f, 0.0f));
+    for (uint32_t i = 0; i <= subdivision; ++i) {
+        const float c = table.cosValues[i];
+        const float s = table.sinValues[i];
+        writer.AddVertex(MakeVertex(c * radius, -halfHeight, s * radius, c * 0.5f + 0.5f, s * 0.5f + 0.5f, 0.0f, -1.0f, 0.0f));
+    }
+
+    for (uint32_t i = 0; i < subdivision; ++i) {
+        writer.AddTriangle(apex + i, side + i + 1, side + i);
+        writer.AddTriangle(bottomCenter, bottomCenter + 1 + i, bottomCenter + 2 + i);
+    }
+}
+
+ModelData PrimitiveGenerator::CreateConeData(uint32_t subdivision, float radius, float height) {
+    return CreateIndexed(GetConeSize(subdivision), [&](const MeshOutput& output) { WriteConeData(output, subdivision, radius, height); });
+}
+
+ModelData PrimitiveGenerator::CreateTriangleData() {
+    ModelData data;
+    MeshBuilder builder(data);
+
+    const Vector3 normal = { 0.0f, 1.0f, 0.0f };
+    PushTriangle(builder,
+        MakeVertex(-1.0f, 0.0f, -1.0f, 0.0f, 1.0f, normal.x, normal.y, normal.z),
+        MakeVertex(0.0f, 0.0f, 1.0f, 0.5f, 0.0f, normal.x, normal.y, normal.z),
+        MakeVertex(1.0f, 0.0f, -1.0f, 1.0f, 1.0f, normal.x, normal.y, normal.z));
+
+    return data;
+}
+
+ModelData PrimitiveGenerator::CreateBoxData() {
+    ModelData data;
+    MeshBuilder builder(data);
+
+    const float min = -1.0f;
+    const float max = 1.0f;
+
+    PushQuad(builder,
+        MakeVertex(min, max, max, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f),
+        MakeVertex(max, max, max, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f),
+        MakeVertex(min, min, max, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f),
+        MakeVertex(max, min, max, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f));
+
+    PushQuad(builder,
+        MakeVertex(max, max, min, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f),
+        MakeVertex(min, max, min, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f),
+        MakeVertex(max, min, min, 0.0f, 1.0f, 0.0f, 0.0f, -1.0f),
+        MakeVertex(min, min, min, 1.0f, 1.0f, 0.0f, 0.0f, -1.0f));
+
+    PushQuad(builder,
+        MakeVertex(min, max, min, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f),
+        MakeVertex(min, max, max, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f),
+        MakeVertex(min, min, min, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f),
+        MakeVertex(min, min, max, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f));
+
+    PushQuad(builder,
+        MakeVertex(max, max, max, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f),
+        MakeVertex(max, max, min, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f),
+        MakeVertex(max, min, max, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f),
+        MakeVertex(max, min, min, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f));
+
+    PushQuad(builder,
+        MakeVertex(min, max, min, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f),
+        MakeVertex(max, max, min, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f),
+        MakeVertex(min, max, max, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f),
+        MakeVertex(max, max, max, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f));
+
+    PushQuad(builder,
+        MakeVertex(min, min, max, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f),
+        MakeVertex(max, min, max, 1.0f, 0.0f, 0.0f, -1.0f, 0.0f),
+        MakeVertex(min, min, min, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f),
+        MakeVertex(max, min, min, 1.0f, 1.0f, 0.0f, -1.0f, 0.0f));
+
+    return data;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "ModelData.h"
+
+// 基本図形のモデルデータを生成する
+// マテリアルは空のまま返す (テクスチャの割り当ては Model::Create*Data で行う)
+// 曲面の図形は角度の sin / cos を表にして 1 度だけ求め、格子・扇の頂点を共有して頂点番号で三角形を作る
+class PrimitiveGenerator {
+public:
+    // 頂点・頂点番号の数 (Write*Data の書き込み先に必要な大きさ)
+    struct MeshSize {
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+    };
+
+    // 呼び出し側が用意した書き込み先 (GPU のアップロードバッファへ直接書く場合など)
+    // indices は isShortIndex なら uint16_t、それ以外は uint32_t の配列で、各番号に baseVertex を足して書く
+    struct MeshOutput {
+        ModelData::VertexData* vertices = nullptr;
+        void* indices = nullptr;
+        bool isShortIndex = false;
+        uint32_t baseVertex = 0;
+    };
+
+    // 三角形ポリゴンで球のモデルデータを生成する関数
+    static ModelData CreateSphereData(uint32_t subdivision = 16);
+    static MeshSize GetSphereSize(uint32_t subdivision = 16);
+    static void WriteSphereData(const MeshOutput& output, uint32_t subdivision = 16);
+    static ModelData CreatePlaneData();
+    static ModelData CreateCircleData(uint32_t subdivision = 32);
+    static ModelData CreateRingData(
+        uint32_t subdivision = 32,
+        float innerRadius = 0.5f,
+        float outerRadius = 1.0f,
+        float startAngle = 0.0f,
+        float endAngle = 6.2831853f,
+        float startRadius = 1.0f,
+        float endRadius = 1.0f);
+    static MeshSize GetRingSize(uint32_t subdivision = 32);
+    static void WriteRingData(
+        const MeshOutput& output,
+        uint32_t subdivision = 32,
+        float innerRadius = 0.5f,
+        float outerRadius = 1.0f,
+        float startAngle = 0.0f,
+        float endAngle = 6.2831853f,
+        float startRadius = 1.0f,
+        float endRadius = 1.0f);
+    static ModelData CreateTorusData(uint32_t majorSubdivision = 32, uint32_t minorSubdivision = 16, float majorRadius = 0.7f, float minorRadius = 0.3f);
+    static MeshSize GetTorusSize(uint32_t majorSubdivision = 32, uint32_t minorSubdivision = 16);
+    static void WriteTorusData(const MeshOutput& output, uint32_t majorSubdivision = 32, uint32_t minorSubdivision = 16,
+        float majorRadius = 0.7f, float minorRadius = 0.3f);
+    static ModelData CreateCylinderData(uint32_t subdivision = 32, float radius = 1.0f, float height = 2.0f);
+    static MeshSize GetCylinderSize(uint32_t subdivision = 32);
+    static void WriteCylinderData(const MeshOutput& output, uint32_t subdivision = 32, float radius = 1.0f, float height = 2.0f);
+    static ModelData CreateEffectCylinderData(uint32_t subdivision = 32, float topRadius = 1.0f, float bottomRadius = 1.0f, float height = 3.0f);
+    static ModelData CreateConeData(uint32_t subdivision = 32, float radius = 1.0f, float height = 2.0f);
+    static MeshSize GetConeSize(uint32_t subdivision = 32);
+    static void WriteConeData(const MeshOutput& output, uint32_t subdivision = 32, float radius = 1.0f, float height = 2.0f);
+    static ModelData CreateTriangleData();
+    static ModelData CreateBoxData();
+};
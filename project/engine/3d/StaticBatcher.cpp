@@ -0,0 +1,114 @@
+#include "StaticBatcher.h"
+#include <cmath>
+
+namespace {
+    // サブメッシュの無いデータは頂点番号全体を materials[0] で描く (Model::Initialize と同じ)
+    ModelData::Submesh GetWholeSubmesh(const ModelData& modelData) {
+        return { "", 0, static_cast<uint32_t>(modelData.indices.size()), 0 };
+    }
+
+    uint32_t GetTextureIndex(const ModelData& modelData, uint32_t materialIndex) {
+        return materialIndex < modelData.materials.size() ? modelData.materials[materialIndex].textureIndex : 0;
+    }
+}
+
+ModelData StaticBatcher::Build(const Instance* instances, size_t count, Stats* stats) {
+    ModelData batch;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    uint32_t drawCallCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ModelData& modelData = *instances[i].modelData;
+        vertexCount += modelData.vertices.size();
+        indexCount += modelData.indices.size();
+        drawCallCount += modelData.submeshes.empty() ? 1 : static_cast<uint32_t>(modelData.submeshes.size());
+    }
+    batch.vertices.resize(vertexCount);
+    batch.indices.reserve(indexCount);
+
+    // --- 頂点をワールド座標へ (法線は逆転置行列で変換し、拡大で伸びた長さを戻す) ---
+    std::vector<uint32_t> baseVertices(count);
+    std::vector<uint8_t> isMirrored(count);
+    uint32_t baseVertex = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ModelData& modelData = *instances[i].modelData;
+        const float (*m)[4] = instances[i].worldMatrix.m;
+        const Matrix4x4 normalMatrix = MatrixMath::InverseTransposeAffine(instances[i].worldMatrix);
+        const float (*n)[4] = normalMatrix.m;
+        baseVertices[i] = baseVertex;
+        isMirrored[i] = MatrixMath::Determinant3x3(instances[i].worldMatrix) < 0.0f;
+        for (size_t v = 0; v < modelData.vertices.size(); ++v) {
+            const ModelData::VertexData& source = modelData.vertices[v];
+            ModelData::VertexData& vertex = batch.vertices[baseVertex + v];
+            const Vector4& p = source.position;
+            vertex.position = {
+                p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0],
+                p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1],
+                p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2],
+                1.0f };
+            const Vector3& normal = source.normal;
+            const Vector3 transformed = {
+                normal.x * n[0][0] + normal.y * n[1][0] + normal.z * n[2][0],
+                normal.x * n[0][1] + normal.y * n[1][1] + normal.z * n[2][1],
+                normal.x * n[0][2] + normal.y * n[1][2] + normal.z * n[2][2] };
+            const float length = std::sqrt(transformed.x * transformed.x + transformed.y * transformed.y + transformed.z * transformed.z);
+            // 長さ 0 の法線 (法線の無いデータ) はそのまま
+            vertex.normal = length > 0.0f ? Vector3{ transformed.x / length, transformed.y / length, transformed.z / length } : transformed;
+            vertex.texcoord = source.texcoord;
+        }
+        baseVertex += static_cast<uint32_t>(modelData.vertices.size());
+    }
+
+    // --- テクスチャごとに頂点番号を続けて並べる (同じテクスチャの中はオブジェクト・サブメッシュの順) ---
+    std::vector<uint32_t> textureIndices;
+    for (size_t i = 0; i < count; ++i) {
+        const ModelData& modelData = *instances[i].modelData;
+        const size_t submeshCount = modelData.submeshes.empty() ? 1 : modelData.submeshes.size();
+        for (size_t s = 0; s < submeshCount; ++s) {
+            const ModelData::Submesh submesh = modelData.submeshes.empty() ? GetWholeSubmesh(modelData) : modelData.submeshes[s];
+            const uint32_t textureIndex = GetTextureIndex(modelData, submesh.materialIndex);
+            bool isFound = false;
+            for (uint32_t textureIndexInBatch : textureIndices) {
+                isFound = isFound || textureIndexInBatch == textureIndex;
+            }
+            if (!isFound) {
+                textureIndices.push_back(textureIndex);
+            }
+        }
+    }
+    for (uint32_t textureIndex : textureIndices) {
+        ModelData::MaterialData& material = batch.materials.emplace_back();
+        material.textureIndex = textureIndex;
+        ModelData::Submesh range;
+        range.indexStart = static_cast<uint32_t>(batch.indices.size());
+        range.materialIndex = static_cast<uint32_t>(batch.materials.size() - 1);
+        for (size_t i = 0; i < count; ++i) {
+            const ModelData& modelData = *instances[i].modelData;
+            const size_t submeshCount = modelData.submeshes.empty() ? 1 : modelData.submeshes.size();
+            for (size_t s = 0; s < submeshCount; ++s) {
+                const ModelData::Submesh submesh = modelData.submeshes.empty() ? GetWholeSubmesh(modelData) : modelData.submeshes[s];
+                if (GetTextureIndex(modelData, submesh.materialIndex) != textureIndex) {
+                    continue;
+                }
+                // 鏡映されたオブジェクトは 1 つ目と 3 つ目の角を入れ替えて巻き順を戻す
+                const uint32_t* corner = modelData.indices.data() + submesh.indexStart;
+                for (uint32_t k = 0; k + 2 < submesh.indexCount; k += 3) {
+                    batch.indices.push_back(baseVertices[i] + corner[k + (isMirrored[i] ? 2 : 0)]);
+                    batch.indices.push_back(baseVertices[i] + corner[k + 1]);
+                    batch.indices.push_back(baseVertices[i] + corner[k + (isMirrored[i] ? 0 : 2)]);
+                }
+            }
+        }
+        range.indexCount = static_cast<uint32_t>(batch.indices.size()) - range.indexStart;
+        batch.submeshes.push_back(range);
+    }
+
+    if (stats) {
+        stats->instanceCount = static_cast<uint32_t>(count);
+        stats->drawCallCountBefore = drawCallCount;
+        stats->drawCallCountAfter = static_cast<uint32_t>(batch.submeshes.size());
+        stats->vertexCount = batch.vertices.size();
+        stats->indexCount = batch.indices.size();
+    }
+    return batch;
+}
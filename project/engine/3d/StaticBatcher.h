@@ -0,0 +1,30 @@
+#pragma once
+#include "ModelData.h"
+#include <cstddef>
+#include <cstdint>
+
+// 動かないオブジェクトをまとめて 1 つのモデルにする (読み込み時に 1 度だけ行う)
+// 頂点はワールド座標へ変換済みにし (法線は逆転置行列で変換して正規化するので、不均一な拡大でも正しい向きになる)、
+// 同じテクスチャのサブメッシュの頂点番号を続けて並べ、テクスチャごとに 1 つのサブメッシュ (描く範囲の表) にする
+// 鏡映を含む (左上 3x3 の行列式が負の) ワールド行列のオブジェクトは、表の向きが変わらないよう三角形の巻き順を逆にする
+// まとめたモデルは単位行列で 1 回の Model::Draw で描く (描く回数はテクスチャの種類の数になる)
+// 渡すオブジェクトは同じブレンドモード・同じマテリアルの定数 (色・ライティング・UV 変換) で描くものに限る
+namespace StaticBatcher {
+    struct Instance {
+        // 元のメッシュ (詳細度を下げた段・塊は使わない) をまとめる
+        const ModelData* modelData = nullptr;
+        Matrix4x4 worldMatrix;
+    };
+
+    struct Stats {
+        uint32_t instanceCount = 0;
+        // まとめる前のサブメッシュごとの描画の回数と、まとめた後の回数
+        uint32_t drawCallCountBefore = 0;
+        uint32_t drawCallCountAfter = 0;
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+    };
+
+    // マテリアルはテクスチャごとに 1 つ (テクスチャが最初に現れた順)、サブメッシュはマテリアルと同じ並び
+    ModelData Build(const Instance* instances, size_t count, Stats* stats = nullptr);
+}
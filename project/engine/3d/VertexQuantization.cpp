@@ -0,0 +1,261 @@
+#include "VertexQuantization.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+    constexpr float kSnorm16Max = 32767.0f;
+    constexpr float kHalfMax = 65504.0f;
+
+    float SignNotZero(float value) {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    // 八面体の座標 ([-1, 1] の 2 つ) から単位ベクトルへ (シェーダーの DecodeOctahedral と同じ)
+    Vector3 DecodeOctahedralFloat(float x, float y) {
+        Vector3 normal = { x, y, 1.0f - std::fabs(x) - std::fabs(y) };
+        const float t = (std::max)(-normal.z, 0.0f);
+        normal.x += normal.x >= 0.0f ? -t : t;
+        normal.y += normal.y >= 0.0f ? -t : t;
+        const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        return { normal.x / length, normal.y / length, normal.z / length };
+    }
+
+    // 2 つの向きのなす角 (度)
+    double AngleDegrees(const Vector3& a, const Vector3& b) {
+        const double crossX = static_cast<double>(a.y) * b.z - static_cast<double>(a.z) * b.y;
+        const double crossY = static_cast<double>(a.z) * b.x - static_cast<double>(a.x) * b.z;
+        const double crossZ = static_cast<double>(a.x) * b.y - static_cast<double>(a.y) * b.x;
+        const double dot = static_cast<double>(a.x) * b.x + static_cast<double>(a.y) * b.y + static_cast<double>(a.z) * b.z;
+        return std::atan2(std::sqrt(crossX * crossX + crossY * crossY + crossZ * crossZ), dot) * (180.0 / 3.14159265358979323846);
+    }
+
+    Vector3 Normalize(const Vector3& v, bool& isValid) {
+        const float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        isValid = length > 0.0f;
+        return isValid ? Vector3{ v.x / length, v.y / length, v.z / length } : Vector3{ 0.0f, 0.0f, 1.0f };
+    }
+}
+
+uint16_t VertexQuantization::FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    bits &= 0x7fffffff;
+
+    // 無限大と NaN
+    if (bits >= 0x7f800000) {
+        return sign | 0x7c00 | (bits > 0x7f800000 ? 0x0200 : 0);
+    }
+    // 65520 以上は丸めると 65504 を超えるので無限大
+    if (bits >= 0x477ff000) {
+        return sign | 0x7c00;
+    }
+    // 2^-14 未満は非正規化数 (2^-24 単位)
+    if (bits < 0x38800000) {
+        if (bits < 0x33000000) {
+            return sign;
+        }
+        const uint32_t exponent = bits >> 23;
+        const uint32_t mantissa = (bits & 0x007fffff) | 0x00800000;
+        const uint32_t shift = 126 - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            ++half;
+        }
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    // 指数の偏りを 127 から 15 に付け替え、仮数の下 13 ビットを偶数丸めで落とす (繰り上がりは指数へ)
+    uint32_t half = (bits - 0x38000000) >> 13;
+    const uint32_t remainder = bits & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        ++half;
+    }
+    return sign | static_cast<uint16_t>(half);
+}
+
+float VertexQuantization::HalfToFloat(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1f;
+    const uint32_t mantissa = value & 0x03ff;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        const float magnitude = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+        bits |= sign;
+    } else if (exponent == 31) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void VertexQuantization::EncodeOctahedral(const Vector3& normal, int16_t encoded[2]) {
+    const float sum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    if (!(sum > 0.0f)) {
+        encoded[0] = 0;
+        encoded[1] = 0;
+        return;
+    }
+    float x = normal.x / sum;
+    float y = normal.y / sum;
+    if (normal.z < 0.0f) {
+        const float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+        const float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    // 切り捨てと切り上げの 4 通りから、復元した向きが元に最も近いものを選ぶ
+    bool isValid;
+    const Vector3 target = Normalize(normal, isValid);
+    const float baseX = std::floor(std::clamp(x, -1.0f, 1.0f) * kSnorm16Max);
+    const float baseY = std::floor(std::clamp(y, -1.0f, 1.0f) * kSnorm16Max);
+    float bestDot = -2.0f;
+    for (int i = 0; i < 4; ++i) {
+        const float candidateX = (std::min)(baseX + static_cast<float>(i & 1), kSnorm16Max);
+        const float candidateY = (std::min)(baseY + static_cast<float>(i >> 1), kSnorm16Max);
+        const Vector3 decoded = DecodeOctahedralFloat(candidateX / kSnorm16Max, candidateY / kSnorm16Max);
+        const float dot = decoded.x * target.x + decoded.y * target.y + decoded.z * target.z;
+        if (dot > bestDot) {
+            bestDot = dot;
+            encoded[0] = static_cast<int16_t>(candidateX);
+            encoded[1] = static_cast<int16_t>(candidateY);
+        }
+    }
+}
+
+Vector3 VertexQuantization::DecodeOctahedral(const int16_t encoded[2]) {
+    // DXGI の SNORM と同じく -32768 は -1 として扱う
+    const float x = (std::max)(static_cast<float>(encoded[0]) / kSnorm16Max, -1.0f);
+    const float y = (std::max)(static_cast<float>(encoded[1]) / kSnorm16Max, -1.0f);
+    return DecodeOctahedralFloat(x, y);
+}
+
+uint32_t VertexQuantization::GetVertexStride(VertexFormat format) {
+    switch (format) {
+    case VertexFormat::kFloat:
+        return sizeof(ModelData::VertexData);
+    case VertexFormat::kPackedFloat:
+        return sizeof(PackedFloatVertex);
+    case VertexFormat::kPackedHalf:
+        return sizeof(PackedHalfVertex);
+    default:
+        assert(false);
+        return 0;
+    }
+}
+
+bool VertexQuantization::CanUseHalfPosition(const ModelData::VertexData* vertices, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const Vector4& position = vertices[i].position;
+        if (!(std::fabs(position.x) <= kHalfMax && std::fabs(position.y) <= kHalfMax && std::fabs(position.z) <= kHalfMax)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void VertexQuantization::Encode(VertexFormat format, const ModelData::VertexData* vertices, size_t count, void* destination) {
+    switch (format) {
+    case VertexFormat::kFloat:
+        std::memcpy(destination, vertices, sizeof(ModelData::VertexData) * count);
+        break;
+    case VertexFormat::kPackedFloat: {
+        PackedFloatVertex* packed = static_cast<PackedFloatVertex*>(destination);
+        for (size_t i = 0; i < count; ++i) {
+            PackedFloatVertex vertex;
+            vertex.position[0] = vertices[i].position.x;
+            vertex.position[1] = vertices[i].position.y;
+            vertex.position[2] = vertices[i].position.z;
+            EncodeOctahedral(vertices[i].normal, vertex.normal);
+            vertex.texcoord[0] = FloatToHalf(vertices[i].texcoord.x);
+            vertex.texcoord[1] = FloatToHalf(vertices[i].texcoord.y);
+            // 書き込み結合されるアップロードヒープへは 1 頂点ずつまとめて書く
+            std::memcpy(&packed[i], &vertex, sizeof(vertex));
+        }
+        break;
+    }
+    case VertexFormat::kPackedHalf: {
+        PackedHalfVertex* packed = static_cast<PackedHalfVertex*>(destination);
+        for (size_t i = 0; i < count; ++i) {
+            PackedHalfVertex vertex;
+            vertex.position[0] = FloatToHalf(vertices[i].position.x);
+            vertex.position[1] = FloatToHalf(vertices[i].position.y);
+            vertex.position[2] = FloatToHalf(vertices[i].position.z);
+            vertex.position[3] = FloatToHalf(1.0f);
+            EncodeOctahedral(vertices[i].normal, vertex.normal);
+            vertex.texcoord[0] = FloatToHalf(vertices[i].texcoord.x);
+            vertex.texcoord[1] = FloatToHalf(vertices[i].texcoord.y);
+            std::memcpy(&packed[i], &vertex, sizeof(vertex));
+        }
+        break;
+    }
+    default:
+        assert(false);
+        break;
+    }
+}
+
+void VertexQuantization::Decode(VertexFormat format, const void* source, size_t count, ModelData::VertexData* vertices) {
+    switch (format) {
+    case VertexFormat::kFloat:
+        std::memcpy(vertices, source, sizeof(ModelData::VertexData) * count);
+        break;
+    case VertexFormat::kPackedFloat: {
+        const PackedFloatVertex* packed = static_cast<const PackedFloatVertex*>(source);
+        for (size_t i = 0; i < count; ++i) {
+            vertices[i].position = { packed[i].position[0], packed[i].position[1], packed[i].position[2], 1.0f };
+            vertices[i].normal = DecodeOctahedral(packed[i].normal);
+            vertices[i].texcoord = { HalfToFloat(packed[i].texcoord[0]), HalfToFloat(packed[i].texcoord[1]) };
+        }
+        break;
+    }
+    case VertexFormat::kPackedHalf: {
+        const PackedHalfVertex* packed = static_cast<const PackedHalfVertex*>(source);
+        for (size_t i = 0; i < count; ++i) {
+            vertices[i].position = {
+                HalfToFloat(packed[i].position[0]), HalfToFloat(packed[i].position[1]), HalfToFloat(packed[i].position[2]), 1.0f };
+            vertices[i].normal = DecodeOctahedral(packed[i].normal);
+            vertices[i].texcoord = { HalfToFloat(packed[i].texcoord[0]), HalfToFloat(packed[i].texcoord[1]) };
+        }
+        break;
+    }
+    default:
+        assert(false);
+        break;
+    }
+}
+
+VertexQuantization::QuantizationError VertexQuantization::MeasureError(VertexFormat format, const ModelData::VertexData* vertices, size_t count) {
+    QuantizationError error;
+    std::vector<uint8_t> encoded(static_cast<size_t>(GetVertexStride(format)) * count);
+    std::vector<ModelData::VertexData> decoded(count);
+    Encode(format, vertices, count, encoded.data());
+    Decode(format, encoded.data(), count, decoded.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        const ModelData::VertexData& a = vertices[i];
+        const ModelData::VertexData& b = decoded[i];
+        error.position = (std::max)({ error.position,
+            std::fabs(a.position.x - b.position.x), std::fabs(a.position.y - b.position.y), std::fabs(a.position.z - b.position.z) });
+        error.texcoord = (std::max)({ error.texcoord, std::fabs(a.texcoord.x - b.texcoord.x), std::fabs(a.texcoord.y - b.texcoord.y) });
+        bool isValid;
+        const Vector3 normal = Normalize(a.normal, isValid);
+        if (isValid) {
+            bool isDecodedValid;
+            const Vector3 decodedNormal = Normalize(b.normal, isDecodedValid);
+            error.normalDegrees = (std::max)(error.normalDegrees, static_cast<float>(AngleDegrees(normal, decodedNormal)));
+        }
+    }
+    return error;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "ModelData.h"
+#include <cstddef>
+#include <cstdint>
+
+// 頂点の GPU 上の並び (モデルごとに選ぶ)
+enum class VertexFormat : uint32_t {
+    // ModelData::VertexData そのまま (36 バイト)
+    kFloat,
+    // float3 位置 + 八面体符号化の snorm16x2 法線 + half2 UV (20 バイト)
+    kPackedFloat,
+    // half4 位置 (w = 1) + 八面体符号化の snorm16x2 法線 + half2 UV (16 バイト)
+    kPackedHalf,
+    kCountOf,
+};
+
+// 頂点の量子化 (符号化と復元、誤差の計測)
+//
+// 誤差の上限 (round to nearest)
+//   half       : 絶対値 |x| に対して |x| * 2^-11 (|x| < 2^-14 では 2^-25)、表せるのは |x| <= 65504
+//   八面体法線 : 角度で 0.008 度以下 (16 ビットの格子のうち、復元した向きが最も近い点を選ぶ)
+// UV を half にするので、[0, 1] の UV なら誤差は 2^-12 (4096 ピクセルのテクスチャで 1 ピクセル) 以下
+namespace VertexQuantization {
+    struct PackedFloatVertex {
+        float position[3];
+        int16_t normal[2];
+        uint16_t texcoord[2];
+    };
+    static_assert(sizeof(PackedFloatVertex) == 20);
+
+    struct PackedHalfVertex {
+        uint16_t position[4];
+        int16_t normal[2];
+        uint16_t texcoord[2];
+    };
+    static_assert(sizeof(PackedHalfVertex) == 16);
+
+    uint16_t FloatToHalf(float value);
+    float HalfToFloat(uint16_t value);
+
+    // 単位ベクトルを八面体に写して 2 つの snorm16 にする (長さ 0 なら (0, 0) = +Z)
+    void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]);
+    Vector3 DecodeOctahedral(const int16_t encoded[2]);
+
+    uint32_t GetVertexStride(VertexFormat format);
+    // 位置が half で表せる範囲に収まっているか (kPackedHalf を選べるか)
+    bool CanUseHalfPosition(const ModelData::VertexData* vertices, size_t count);
+
+    // destination に GetVertexStride(format) * count バイト書く
+    void Encode(VertexFormat format, const ModelData::VertexData* vertices, size_t count, void* destination);
+    void Decode(VertexFormat format, const void* source, size_t count, ModelData::VertexData* vertices);
+
+    // 符号化して戻したときの最大誤差
+    struct QuantizationError {
+        float position = 0.0f;
+        // 度
+        float normalDegrees = 0.0f;
+        float texcoord = 0.0f;
+    };
+    QuantizationError MeasureError(VertexFormat format, const ModelData::VertexData* vertices, size_t count);
+}
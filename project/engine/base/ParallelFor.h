@@ -0,0 +1,50 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// 番号で分けられる処理を複数のスレッドで回す
+// 処理は空いたスレッドから順に取るので、重さに偏りがあっても待ちが少ない
+namespace Parallel {
+    // 論理コア数 (取れなければ 1)
+    inline uint32_t GetDefaultThreadCount() {
+        const unsigned int count = std::thread::hardware_concurrency();
+        return count > 0 ? count : 1;
+    }
+
+    // function(taskIndex) を taskIndex = 0 .. taskCount - 1 で呼ぶ
+    // threadCount は呼び出し元を含むスレッド数 (0 なら論理コア数)、1 ならその場で順に呼ぶ
+    template<typename Function>
+    void For(size_t taskCount, uint32_t threadCount, Function&& function) {
+        if (threadCount == 0) {
+            threadCount = GetDefaultThreadCount();
+        }
+        const size_t workerCount = (std::min)(static_cast<size_t>(threadCount), taskCount);
+        if (workerCount <= 1) {
+            for (size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex) {
+                function(taskIndex);
+            }
+            return;
+        }
+
+        std::atomic<size_t> nextTask{ 0 };
+        auto Work = [&]() {
+            for (size_t taskIndex = nextTask.fetch_add(1); taskIndex < taskCount; taskIndex = nextTask.fetch_add(1)) {
+                function(taskIndex);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workerCount - 1);
+        for (size_t i = 1; i < workerCount; ++i) {
+            threads.emplace_back(Work);
+        }
+        Work();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+}
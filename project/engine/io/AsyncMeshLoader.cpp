@@ -0,0 +1,90 @@
+#include "AsyncMeshLoader.h"
+#include "MeshCache.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <iterator>
+
+AsyncMeshLoader::AsyncMeshLoader(uint32_t threadCount) {
+    if (threadCount == 0) {
+        // 呼び出し元 (描画スレッド) の分を空けておく
+        threadCount = (std::max)(Parallel::GetDefaultThreadCount(), 2u) - 1;
+    }
+    threads_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads_.emplace_back(&AsyncMeshLoader::WorkerMain, this);
+    }
+}
+
+AsyncMeshLoader::~AsyncMeshLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStopping_ = true;
+        pendingCount_ -= jobs_.size();
+        jobs_.clear();
+    }
+    jobCondition_.notify_all();
+    completedCondition_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+uint64_t AsyncMeshLoader::Request(const std::string& directoryPath, const std::string& filename) {
+    uint64_t ticket = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ticket = nextTicket_++;
+        jobs_.push_back({ ticket, directoryPath, filename });
+        ++pendingCount_;
+    }
+    jobCondition_.notify_one();
+    return ticket;
+}
+
+size_t AsyncMeshLoader::TakeCompleted(std::vector<Result>& results) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t count = completed_.size();
+    results.insert(results.end(), std::make_move_iterator(completed_.begin()), std::make_move_iterator(completed_.end()));
+    completed_.clear();
+    pendingCount_ -= count;
+    return count;
+}
+
+void AsyncMeshLoader::WaitForCompleted() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    completedCondition_.wait(lock, [this]() { return !completed_.empty() || pendingCount_ == 0 || isStopping_; });
+}
+
+size_t AsyncMeshLoader::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pendingCount_;
+}
+
+void AsyncMeshLoader::WorkerMain() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobCondition_.wait(lock, [this]() { return !jobs_.empty() || isStopping_; });
+            if (isStopping_) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        // ロックを外して読む (別のファイルなら同時に読んでよい)
+        Result result;
+        result.ticket = job.ticket;
+        result.modelData = MeshCache::LoadModelFile(job.directoryPath, job.filename);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (isStopping_) {
+                return;
+            }
+            completed_.push_back(std::move(result));
+        }
+        completedCondition_.notify_all();
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "ModelData.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// OBJ / GLB の読み込み (MeshCache::LoadModelFile、並べ替え・塊・詳細度の段まで) をワーカースレッドで行い、
+// 結果は TakeCompleted を呼んだスレッドで受け取る
+// GPU のバッファ作成など描画スレッドでしかできない処理は、受け取った後に呼び出し元で行う
+class AsyncMeshLoader {
+public:
+    struct Result {
+        // Request が返した番号
+        uint64_t ticket = 0;
+        ModelData modelData;
+    };
+
+public:
+    // threadCount が 0 なら (論理コア数 - 1) 個、少なくとも 1 個のワーカースレッドを作る
+    explicit AsyncMeshLoader(uint32_t threadCount = 0);
+    // 始まっていない読み込みは捨て、読み込み中のものが終わるのを待つ
+    ~AsyncMeshLoader();
+
+    AsyncMeshLoader(const AsyncMeshLoader&) = delete;
+    AsyncMeshLoader& operator=(const AsyncMeshLoader&) = delete;
+
+    // 読み込みを頼み、結果と対応させる番号を返す (頼んだ順に空いたスレッドが始める)
+    uint64_t Request(const std::string& directoryPath, const std::string& filename);
+    // 読み終わったものを results の後ろに移し、移した数を返す (待たない)
+    size_t TakeCompleted(std::vector<Result>& results);
+    // 読み終わって受け取っていないものができるか、頼んだものが全て受け取り済みになるまで待つ
+    void WaitForCompleted();
+
+    // 頼んだが、まだ TakeCompleted で受け取っていない数
+    size_t GetPendingCount() const;
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(threads_.size()); }
+
+private:
+    struct Job {
+        uint64_t ticket;
+        std::string directoryPath;
+        std::string filename;
+    };
+
+    void WorkerMain();
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable jobCondition_;
+    std::condition_variable completedCondition_;
+    std::deque<Job> jobs_;
+    std::vector<Result> completed_;
+    std::vector<std::thread> threads_;
+    uint64_t nextTicket_ = 1;
+    size_t pendingCount_ = 0;
+    bool isStopping_ = false;
+};
@@ -0,0 +1,442 @@
+#include "GltfLoader.h"
+#include "Quaternion.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    constexpr uint32_t kGlbMagic = 0x46546c67;     // "glTF"
+    constexpr uint32_t kJsonChunkType = 0x4e4f534a; // "JSON"
+    constexpr uint32_t kBinaryChunkType = 0x004e4942; // "BIN\0"
+    constexpr uint32_t kTriangles = 4;
+    // ノードの入れ子の上限 (循環した壊れたファイルで止まらなくならないように)
+    constexpr int kMaxNodeDepth = 64;
+
+    uint32_t ReadU32(const uint8_t* data) {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint32_t GetComponentSize(uint32_t componentType) {
+        switch (componentType) {
+        case GltfLoader::kByte:
+        case GltfLoader::kUnsignedByte:
+            return 1;
+        case GltfLoader::kShort:
+        case GltfLoader::kUnsignedShort:
+            return 2;
+        case GltfLoader::kUnsignedInt:
+        case GltfLoader::kFloat:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    uint32_t GetComponentCount(std::string_view type) {
+        if (type == "SCALAR") { return 1; }
+        if (type == "VEC2") { return 2; }
+        if (type == "VEC3") { return 3; }
+        if (type == "VEC4") { return 4; }
+        return 0;
+    }
+
+    // JSON の数を [0, limit) の整数として読む (小数・負・範囲外・NaN はキャストする前に false)
+    bool ToInteger(double number, double limit, uint64_t& value) {
+        if (!(number >= 0.0 && number < limit) || number != std::floor(number)) {
+            return false;
+        }
+        value = static_cast<uint64_t>(number);
+        return true;
+    }
+
+    // 整数として読めなければ UINT32_MAX (どの配列の範囲にも入らない)
+    uint32_t ToIndex(const JsonValue* value) {
+        uint64_t index = 0;
+        return (value && value->IsNumber() && ToInteger(value->number, 4294967296.0, index)) ? static_cast<uint32_t>(index) : UINT32_MAX;
+    }
+
+    // object[key] をバイト数・要素数として読む (無ければ defaultValue、size_t に入らない値は false)
+    bool GetSize(const JsonValue& object, std::string_view key, size_t defaultValue, size_t& value) {
+        const JsonValue* member = object.Find(key);
+        if (!member) {
+            value = defaultValue;
+            return true;
+        }
+        uint64_t size = 0;
+        if (!member->IsNumber() || !ToInteger(member->number, std::ldexp(1.0, std::numeric_limits<size_t>::digits), size)) {
+            return false;
+        }
+        value = static_cast<size_t>(size);
+        return true;
+    }
+
+    Vector3 ReadVector3(const JsonValue* array, const Vector3& defaultValue) {
+        if (!array || !array->IsArray() || array->GetSize() != 3) {
+            return defaultValue;
+        }
+        return { static_cast<float>(array->elements[0].number), static_cast<float>(array->elements[1].number), static_cast<float>(array->elements[2].number) };
+    }
+
+    // ノードの親に対する変換 (glTF の列ベクトル規約の列優先の配列は、そのまま並べると行ベクトル規約の行列になる)
+    Matrix4x4 MakeNodeMatrix(const JsonValue& node) {
+        const JsonValue* matrix = node.Find("matrix");
+        if (matrix && matrix->IsArray() && matrix->GetSize() == 16) {
+            Matrix4x4 result;
+            for (int i = 0; i < 16; ++i) {
+                result.m[i / 4][i % 4] = static_cast<float>(matrix->elements[i].number);
+            }
+            return result;
+        }
+        const Vector3 scale = ReadVector3(node.Find("scale"), { 1.0f, 1.0f, 1.0f });
+        const Vector3 translate = ReadVector3(node.Find("translation"), { 0.0f, 0.0f, 0.0f });
+        Quaternion rotate = QuaternionMath::IdentityQuaternion();
+        const JsonValue* rotation = node.Find("rotation");
+        if (rotation && rotation->IsArray() && rotation->GetSize() == 4) {
+            rotate = QuaternionMath::Normalize({ static_cast<float>(rotation->elements[0].number), static_cast<float>(rotation->elements[1].number),
+                static_cast<float>(rotation->elements[2].number), static_cast<float>(rotation->elements[3].number) });
+        }
+        return QuaternionMath::MakeAffine(scale, rotate, translate);
+    }
+
+    bool IsIdentity(const Matrix4x4& m) {
+        const Matrix4x4 identity = MatrixMath::MakeIdentity4x4();
+        return std::memcmp(&m, &identity, sizeof(Matrix4x4)) == 0;
+    }
+
+    float ReadNormalizedComponent(const uint8_t* data, uint32_t componentType, uint32_t component) {
+        switch (componentType) {
+        case GltfLoader::kUnsignedByte:
+            return data[component] / 255.0f;
+        case GltfLoader::kUnsignedShort: {
+            uint16_t value;
+            std::memcpy(&value, data + component * 2, sizeof(value));
+            return value / 65535.0f;
+        }
+        default: {
+            float value;
+            std::memcpy(&value, data + component * 4, sizeof(value));
+            return value;
+        }
+        }
+    }
+
+    uint32_t ReadIndex(const GltfLoader::AccessorView& view, size_t i) {
+        const uint8_t* element = view.GetElement(i);
+        switch (view.componentType) {
+        case GltfLoader::kUnsignedByte:
+            return *element;
+        case GltfLoader::kUnsignedShort: {
+            uint16_t value;
+            std::memcpy(&value, element, sizeof(value));
+            return value;
+        }
+        default:
+            return ReadU32(element);
+        }
+    }
+
+    // 1 つのファイルから ModelData を組み立てる
+    class MeshAssembler {
+    public:
+        MeshAssembler(const GltfLoader::GlbFile& file, const std::string& directoryPath, ModelData& modelData)
+            : file_(file), json_(file.GetJson()), directoryPath_(directoryPath), modelData_(modelData) {}
+
+        void LoadMaterials() {
+            const JsonValue* materials = json_.Find("materials");
+            if (!materials || !materials->IsArray()) {
+                return;
+            }
+            for (const JsonValue& material : materials->elements) {
+                ModelData::MaterialData& data = modelData_.materials.emplace_back();
+                data.name = material.GetString("name");
+                const JsonValue* pbr = material.Find("pbrMetallicRoughness");
+                const JsonValue* baseColor = pbr ? pbr->Find("baseColorTexture") : nullptr;
+                if (baseColor) {
+                    data.textureFilePath = GetImagePath(ToIndex(baseColor->Find("index")));
+                }
+            }
+        }
+
+        void LoadScene() {
+            const JsonValue* scenes = json_.Find("scenes");
+            const JsonValue* scene = scenes ? scenes->At(ToIndex(json_.Find("scene")) == UINT32_MAX ? 0 : ToIndex(json_.Find("scene"))) : nullptr;
+            if (!scene) {
+                // シーンが無ければメッシュをそのまま並べる
+                const JsonValue* meshes = json_.Find("meshes");
+                for (size_t i = 0; meshes && i < meshes->GetSize(); ++i) {
+                    AppendMesh(meshes->elements[i], MatrixMath::MakeIdentity4x4());
+                }
+                return;
+            }
+            const JsonValue* nodes = scene->Find("nodes");
+            for (size_t i = 0; nodes && i < nodes->GetSize(); ++i) {
+                AppendNode(ToIndex(&nodes->elements[i]), MatrixMath::MakeIdentity4x4(), 0);
+            }
+        }
+
+    private:
+        // textures[textureIndex].source の画像のファイル名 (埋め込み画像・data URI は扱わず空)
+        std::string GetImagePath(uint32_t textureIndex) const {
+            const JsonValue* textures = json_.Find("textures");
+            const JsonValue* texture = textures ? textures->At(textureIndex) : nullptr;
+            const JsonValue* images = json_.Find("images");
+            const JsonValue* image = (texture && images) ? images->At(ToIndex(texture->Find("source"))) : nullptr;
+            const std::string_view uri = image ? image->GetString("uri") : std::string_view();
+            if (uri.empty() || uri.starts_with("data:")) {
+                return {};
+            }
+            return directoryPath_ + "/" + std::string(uri);
+        }
+
+        void AppendNode(uint32_t nodeIndex, const Matrix4x4& parentMatrix, int depth) {
+            const JsonValue* nodes = json_.Find("nodes");
+            const JsonValue* node = nodes ? nodes->At(nodeIndex) : nullptr;
+            if (!node || depth > kMaxNodeDepth) {
+                return;
+            }
+            const Matrix4x4 worldMatrix = MatrixMath::Multipty(MakeNodeMatrix(*node), parentMatrix);
+            const JsonValue* meshes = json_.Find("meshes");
+            const JsonValue* mesh = meshes ? meshes->At(ToIndex(node->Find("mesh"))) : nullptr;
+            if (mesh) {
+                AppendMesh(*mesh, worldMatrix);
+            }
+            const JsonValue* children = node->Find("children");
+            for (size_t i = 0; children && i < children->GetSize(); ++i) {
+                AppendNode(ToIndex(&children->elements[i]), worldMatrix, depth + 1);
+            }
+        }
+
+        // マテリアルの無いプリミティブ用 (最初に使うときに足す)
+        uint32_t GetDefaultMaterial() {
+            if (defaultMaterial_ == UINT32_MAX) {
+                defaultMaterial_ = static_cast<uint32_t>(modelData_.materials.size());
+                modelData_.materials.emplace_back();
+            }
+            return defaultMaterial_;
+        }
+
+        void AppendMesh(const JsonValue& mesh, const Matrix4x4& worldMatrix) {
+            const JsonValue* primitives = mesh.Find("primitives");
+            for (size_t i = 0; primitives && i < primitives->GetSize(); ++i) {
+                AppendPrimitive(primitives->elements[i], mesh.GetString("name"), worldMatrix);
+            }
+        }
+
+        // 頂点の数が POSITION と違う・型が扱えない属性は使わない
+        bool GetAttribute(const JsonValue& attributes, std::string_view name, size_t count, GltfLoader::AccessorView& view) const {
+            return file_.GetAccessor(ToIndex(attributes.Find(name)), view) && (count == SIZE_MAX || view.count == count);
+        }
+
+        void AppendPrimitive(const JsonValue& primitive, std::string_view meshName, const Matrix4x4& worldMatrix) {
+            const JsonValue* attributes = primitive.Find("attributes");
+            GltfLoader::AccessorView positions;
+            const JsonValue* mode = primitive.Find("mode");
+            if ((mode ? ToIndex(mode) : kTriangles) != kTriangles || !attributes ||
+                !GetAttribute(*attributes, "POSITION", SIZE_MAX, positions) ||
+                positions.componentType != GltfLoader::kFloat || positions.componentCount != 3) {
+                return;
+            }
+            const size_t vertexCount = positions.count;
+            GltfLoader::AccessorView normals;
+            const bool hasNormal = GetAttribute(*attributes, "NORMAL", vertexCount, normals) &&
+                normals.componentType == GltfLoader::kFloat && normals.componentCount == 3;
+            GltfLoader::AccessorView texcoords;
+            const bool hasTexcoord = GetAttribute(*attributes, "TEXCOORD_0", vertexCount, texcoords) && texcoords.componentCount == 2 &&
+                (texcoords.componentType == GltfLoader::kFloat || (texcoords.isNormalized &&
+                    (texcoords.componentType == GltfLoader::kUnsignedByte || texcoords.componentType == GltfLoader::kUnsignedShort)));
+
+            GltfLoader::AccessorView indices;
+            const bool hasIndex = file_.GetAccessor(ToIndex(primitive.Find("indices")), indices);
+            if (hasIndex && (indices.componentCount != 1 || (indices.componentType != GltfLoader::kUnsignedByte &&
+                indices.componentType != GltfLoader::kUnsignedShort && indices.componentType != GltfLoader::kUnsignedInt))) {
+                return;
+            }
+            const size_t indexCount = hasIndex ? indices.count : vertexCount;
+            for (size_t i = 0; hasIndex && i < indexCount; ++i) {
+                if (ReadIndex(indices, i) >= vertexCount) {
+                    return;
+                }
+            }
+
+            // 頂点を VertexData に詰め直す (x 反転で左手系へ)
+            const bool isIdentity = IsIdentity(worldMatrix);
+            const Matrix4x4 normalMatrix = MatrixMath::InverseTransposeAffine(worldMatrix);
+            const uint32_t baseVertex = static_cast<uint32_t>(modelData_.vertices.size());
+            modelData_.vertices.resize(baseVertex + vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v) {
+                ModelData::VertexData& vertex = modelData_.vertices[baseVertex + v];
+                float p[3];
+                std::memcpy(p, positions.GetElement(v), sizeof(p));
+                if (!isIdentity) {
+                    const float (*m)[4] = worldMatrix.m;
+                    const float x = p[0] * m[0][0] + p[1] * m[1][0] + p[2] * m[2][0] + m[3][0];
+                    const float y = p[0] * m[0][1] + p[1] * m[1][1] + p[2] * m[2][1] + m[3][1];
+                    const float z = p[0] * m[0][2] + p[1] * m[1][2] + p[2] * m[2][2] + m[3][2];
+                    p[0] = x;
+                    p[1] = y;
+                    p[2] = z;
+                }
+                vertex.position = { -p[0], p[1], p[2], 1.0f };
+
+                float n[3] = { 0.0f, 0.0f, 0.0f };
+                if (hasNormal) {
+                    std::memcpy(n, normals.GetElement(v), sizeof(n));
+                    if (!isIdentity) {
+                        const float (*m)[4] = normalMatrix.m;
+                        const float x = n[0] * m[0][0] + n[1] * m[1][0] + n[2] * m[2][0];
+                        const float y = n[0] * m[0][1] + n[1] * m[1][1] + n[2] * m[2][1];
+                        const float z = n[0] * m[0][2] + n[1] * m[1][2] + n[2] * m[2][2];
+                        const float length = std::sqrt(x * x + y * y + z * z);
+                        const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+                        n[0] = x * scale;
+                        n[1] = y * scale;
+                        n[2] = z * scale;
+                    }
+                }
+                vertex.normal = { -n[0], n[1], n[2] };
+
+                vertex.texcoord = { 0.0f, 0.0f };
+                if (hasTexcoord) {
+                    const uint8_t* element = texcoords.GetElement(v);
+                    vertex.texcoord = { ReadNormalizedComponent(element, texcoords.componentType, 0), ReadNormalizedComponent(element, texcoords.componentType, 1) };
+                }
+            }
+
+            // x 反転に合わせて巻き順を逆にする (ノードの変換が鏡映を含めば元から逆なのでそのまま)
+            const bool isFlipped = MatrixMath::Determinant3x3(worldMatrix) >= 0.0f;
+            const uint32_t indexStart = static_cast<uint32_t>(modelData_.indices.size());
+            const size_t triangleCount = indexCount / 3;
+            modelData_.indices.resize(indexStart + triangleCount * 3);
+            uint32_t* output = modelData_.indices.data() + indexStart;
+            for (size_t t = 0; t < triangleCount; ++t) {
+                uint32_t corner[3];
+                for (int k = 0; k < 3; ++k) {
+                    corner[k] = baseVertex + (hasIndex ? ReadIndex(indices, t * 3 + k) : static_cast<uint32_t>(t * 3 + k));
+                }
+                output[t * 3 + 0] = isFlipped ? corner[2] : corner[0];
+                output[t * 3 + 1] = corner[1];
+                output[t * 3 + 2] = isFlipped ? corner[0] : corner[2];
+            }
+
+            const JsonValue* materials = json_.Find("materials");
+            const uint32_t materialIndex = ToIndex(primitive.Find("material"));
+            ModelData::Submesh submesh;
+            submesh.name = meshName;
+            submesh.indexStart = indexStart;
+            submesh.indexCount = static_cast<uint32_t>(triangleCount * 3);
+            submesh.materialIndex = (materials && materialIndex < materials->GetSize()) ? materialIndex : GetDefaultMaterial();
+            modelData_.submeshes.push_back(std::move(submesh));
+        }
+
+    private:
+        const GltfLoader::GlbFile& file_;
+        const JsonValue& json_;
+        const std::string& directoryPath_;
+        ModelData& modelData_;
+        uint32_t defaultMaterial_ = UINT32_MAX;
+    };
+}
+
+bool GltfLoader::GlbFile::Open(const std::string& path) {
+    json_ = JsonValue{};
+    binaryChunk_ = {};
+    if (!file_.Open(path) || file_.GetSize() < 20) {
+        return false;
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file_.GetData());
+    const uint32_t length = ReadU32(data + 8);
+    if (ReadU32(data) != kGlbMagic || ReadU32(data + 4) != 2 || length > file_.GetSize()) {
+        return false;
+    }
+
+    // 最初のチャンクが JSON、続けばバイナリ
+    const uint32_t jsonLength = ReadU32(data + 12);
+    if (ReadU32(data + 16) != kJsonChunkType || jsonLength > length - 20) {
+        return false;
+    }
+    const std::string_view jsonText(reinterpret_cast<const char*>(data + 20), jsonLength);
+    if (!Json::Parse(jsonText, json_) || !json_.IsObject()) {
+        return false;
+    }
+    const size_t binaryHeader = 20 + static_cast<size_t>(jsonLength);
+    if (binaryHeader + 8 <= length) {
+        const uint32_t binaryLength = ReadU32(data + binaryHeader);
+        if (ReadU32(data + binaryHeader + 4) != kBinaryChunkType || binaryLength > length - binaryHeader - 8) {
+            return false;
+        }
+        binaryChunk_ = { data + binaryHeader + 8, binaryLength };
+    }
+    return true;
+}
+
+std::span<const uint8_t> GltfLoader::GlbFile::GetBufferView(uint32_t index) const {
+    const JsonValue* bufferViews = json_.Find("bufferViews");
+    const JsonValue* bufferView = bufferViews ? bufferViews->At(index) : nullptr;
+    // GLB のバイナリチャンクは buffer 0 (uri を持たない)
+    if (!bufferView || ToIndex(bufferView->Find("buffer")) != 0) {
+        return {};
+    }
+    size_t offset = 0;
+    size_t length = 0;
+    if (!bufferView->Find("byteLength") || !GetSize(*bufferView, "byteOffset", 0, offset) || !GetSize(*bufferView, "byteLength", 0, length) ||
+        offset > binaryChunk_.size() || length > binaryChunk_.size() - offset) {
+        return {};
+    }
+    return binaryChunk_.subspan(offset, length);
+}
+
+bool GltfLoader::GlbFile::GetAccessor(uint32_t index, AccessorView& view) const {
+    const JsonValue* accessors = json_.Find("accessors");
+    const JsonValue* accessor = accessors ? accessors->At(index) : nullptr;
+    if (!accessor || accessor->Find("sparse")) {
+        return false;
+    }
+    const JsonValue* bufferViews = json_.Find("bufferViews");
+    const uint32_t bufferViewIndex = ToIndex(accessor->Find("bufferView"));
+    const JsonValue* bufferView = bufferViews ? bufferViews->At(bufferViewIndex) : nullptr;
+    const std::span<const uint8_t> bytes = GetBufferView(bufferViewIndex);
+    if (!bufferView || bytes.data() == nullptr) {
+        return false;
+    }
+
+    view.componentType = ToIndex(accessor->Find("componentType"));
+    view.componentCount = GetComponentCount(accessor->GetString("type"));
+    const uint32_t componentSize = GetComponentSize(view.componentType);
+    if (componentSize == 0 || view.componentCount == 0) {
+        return false;
+    }
+    const size_t elementSize = static_cast<size_t>(componentSize) * view.componentCount;
+    const JsonValue* normalized = accessor->Find("normalized");
+    view.isNormalized = normalized && normalized->type == JsonValue::Type::kBool && normalized->boolean;
+    size_t offset = 0;
+    if (!GetSize(*accessor, "count", 0, view.count) || !GetSize(*bufferView, "byteStride", 0, view.stride) ||
+        !GetSize(*accessor, "byteOffset", 0, offset)) {
+        return false;
+    }
+    if (view.stride == 0) {
+        view.stride = elementSize;
+    }
+    if (view.stride < elementSize) {
+        return false;
+    }
+    // 最後の要素の終わりまでが bufferView に収まること
+    if (view.count > 0 && (offset + elementSize > bytes.size() || view.count - 1 > (bytes.size() - offset - elementSize) / view.stride)) {
+        return false;
+    }
+    view.data = bytes.data() + offset;
+    return true;
+}
+
+ModelData GltfLoader::LoadGlbFile(const std::string& directoryPath, const std::string& filename) {
+    ModelData modelData;
+    GlbFile file;
+    if (!file.Open(directoryPath + "/" + filename)) {
+        return modelData;
+    }
+    MeshAssembler assembler(file, directoryPath, modelData);
+    assembler.LoadMaterials();
+    assembler.LoadScene();
+    return modelData;
+}
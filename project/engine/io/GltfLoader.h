@@ -0,0 +1,61 @@
+#pragma once
+#include "Json.h"
+#include "MappedFile.h"
+#include "ModelData.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// GLB (glTF 2.0 のバイナリ形式) の読み込み
+// ファイルをメモリにマップし、bufferView / accessor はバイナリチャンクを直接指す (コピーしない)
+// ModelData へは VertexData の並びに詰め直すときだけ変換する
+// 右手系の glTF を左手系へ変換する (OBJ と同じく x 反転・巻き順反転、UV は glTF も左上が原点なのでそのまま)
+namespace GltfLoader {
+    // accessor.componentType
+    enum ComponentType : uint32_t {
+        kByte = 5120,
+        kUnsignedByte = 5121,
+        kShort = 5122,
+        kUnsignedShort = 5123,
+        kUnsignedInt = 5125,
+        kFloat = 5126,
+    };
+
+    // accessor の要素の並び (要素 i は data + i * stride から componentCount 個の成分)
+    struct AccessorView {
+        const uint8_t* data = nullptr;
+        size_t count = 0;
+        size_t stride = 0;
+        uint32_t componentType = 0;
+        // SCALAR = 1, VEC2 = 2, VEC3 = 3, VEC4 = 4
+        uint32_t componentCount = 0;
+        bool isNormalized = false;
+
+        const uint8_t* GetElement(size_t index) const { return data + index * stride; }
+    };
+
+    class GlbFile {
+    public:
+        // 開けない・GLB でない・チャンクや JSON が壊れている場合は false
+        bool Open(const std::string& path);
+
+        const JsonValue& GetJson() const { return json_; }
+        std::span<const uint8_t> GetBinaryChunk() const { return binaryChunk_; }
+        // buffer 0 (バイナリチャンク) を指す bufferView の範囲 (他の buffer や範囲外なら空)
+        std::span<const uint8_t> GetBufferView(uint32_t index) const;
+        // 範囲が bufferView に収まっていなければ false (sparse と bufferView の無い accessor は扱わない)
+        bool GetAccessor(uint32_t index, AccessorView& view) const;
+
+    private:
+        MappedFile file_;
+        JsonValue json_;
+        std::span<const uint8_t> binaryChunk_;
+    };
+
+    // 既定のシーン (無ければ最初のシーン) のノードをたどり、三角形のプリミティブを 1 つずつサブメッシュにして
+    // 1 つの頂点・頂点番号にまとめる (ノードの変換は頂点に焼き込む)
+    // マテリアルは baseColorTexture の画像ファイル (URI) をテクスチャとして使う
+    // 読めなければ空の ModelData を返す
+    ModelData LoadGlbFile(const std::string& directoryPath, const std::string& filename);
+}
@@ -0,0 +1,167 @@
+#include "Json.h"
+#include <charconv>
+
+namespace {
+    constexpr int kMaxDepth = 64;
+
+    struct JsonParser {
+        const char* current;
+        const char* end;
+
+        void SkipSpaces() {
+            while (current < end && (*current == ' ' || *current == '\t' || *current == '\n' || *current == '\r')) {
+                ++current;
+            }
+        }
+
+        bool Consume(char c) {
+            SkipSpaces();
+            if (current < end && *current == c) {
+                ++current;
+                return true;
+            }
+            return false;
+        }
+
+        bool ConsumeWord(std::string_view word) {
+            if (static_cast<size_t>(end - current) < word.size() || std::string_view(current, word.size()) != word) {
+                return false;
+            }
+            current += word.size();
+            return true;
+        }
+
+        // 引用符の中身 (エスケープは読み飛ばすだけで戻さない)
+        bool ParseString(std::string_view& text) {
+            if (!Consume('"')) {
+                return false;
+            }
+            const char* begin = current;
+            while (current < end && *current != '"') {
+                if (*current == '\\') {
+                    ++current;
+                }
+                ++current;
+            }
+            if (current >= end) {
+                return false;
+            }
+            text = { begin, static_cast<size_t>(current - begin) };
+            ++current;
+            return true;
+        }
+
+        bool ParseNumber(double& number) {
+            const char* begin = current;
+            // from_chars は先頭の '+' を受け付けないが、JSON でも '+' は使えない
+            const std::from_chars_result result = std::from_chars(begin, end, number);
+            if (result.ec != std::errc() || result.ptr == begin) {
+                return false;
+            }
+            current = result.ptr;
+            return true;
+        }
+
+        bool ParseValue(JsonValue& value, int depth) {
+            if (depth > kMaxDepth) {
+                return false;
+            }
+            SkipSpaces();
+            if (current >= end) {
+                return false;
+            }
+            switch (*current) {
+            case '{': {
+                ++current;
+                value.type = JsonValue::Type::kObject;
+                if (Consume('}')) {
+                    return true;
+                }
+                do {
+                    std::string_view key;
+                    if (!ParseString(key) || !Consume(':')) {
+                        return false;
+                    }
+                    value.keys.push_back(key);
+                    value.elements.emplace_back();
+                    if (!ParseValue(value.elements.back(), depth + 1)) {
+                        return false;
+                    }
+                } while (Consume(','));
+                return Consume('}');
+            }
+            case '[': {
+                ++current;
+                value.type = JsonValue::Type::kArray;
+                if (Consume(']')) {
+                    return true;
+                }
+                do {
+                    value.elements.emplace_back();
+                    if (!ParseValue(value.elements.back(), depth + 1)) {
+                        return false;
+                    }
+                } while (Consume(','));
+                return Consume(']');
+            }
+            case '"':
+                value.type = JsonValue::Type::kString;
+                return ParseString(value.string);
+            case 't':
+                value.type = JsonValue::Type::kBool;
+                value.boolean = true;
+                return ConsumeWord("true");
+            case 'f':
+                value.type = JsonValue::Type::kBool;
+                value.boolean = false;
+                return ConsumeWord("false");
+            case 'n':
+                value.type = JsonValue::Type::kNull;
+                return ConsumeWord("null");
+            default:
+                value.type = JsonValue::Type::kNumber;
+                return ParseNumber(value.number);
+            }
+        }
+    };
+}
+
+const JsonValue* JsonValue::Find(std::string_view key) const {
+    if (type != Type::kObject) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] == key) {
+            return &elements[i];
+        }
+    }
+    return nullptr;
+}
+
+const JsonValue* JsonValue::At(size_t index) const {
+    if (type != Type::kArray || index >= elements.size()) {
+        return nullptr;
+    }
+    return &elements[index];
+}
+
+double JsonValue::GetNumber(std::string_view key, double defaultValue) const {
+    const JsonValue* member = Find(key);
+    return (member && member->IsNumber()) ? member->number : defaultValue;
+}
+
+std::string_view JsonValue::GetString(std::string_view key, std::string_view defaultValue) const {
+    const JsonValue* member = Find(key);
+    return (member && member->IsString()) ? member->string : defaultValue;
+}
+
+bool Json::Parse(std::string_view text, JsonValue& value) {
+    value = JsonValue{};
+    JsonParser parser{ text.data(), text.data() + text.size() };
+    if (!parser.ParseValue(value, 0)) {
+        return false;
+    }
+    // 後ろに空白以外 (GLB のチャンクの詰め物の空白は許す) が残っていれば誤り
+    parser.SkipSpaces();
+    return parser.current == parser.end;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// JSON の値 (読み取り専用)
+// 文字列とキーは元のテキストを指す (コピーしない、エスケープはそのまま残す) ので、テキストより長く使わない
+struct JsonValue {
+    enum class Type : uint8_t {
+        kNull,
+        kBool,
+        kNumber,
+        kString,
+        kArray,
+        kObject,
+    };
+
+    Type type = Type::kNull;
+    bool boolean = false;
+    double number = 0.0;
+    std::string_view string;
+    // 配列の要素、オブジェクトの値 (オブジェクトは keys と同じ順)
+    std::vector<JsonValue> elements;
+    std::vector<std::string_view> keys;
+
+    bool IsNumber() const { return type == Type::kNumber; }
+    bool IsString() const { return type == Type::kString; }
+    bool IsArray() const { return type == Type::kArray; }
+    bool IsObject() const { return type == Type::kObject; }
+    size_t GetSize() const { return elements.size(); }
+
+    // オブジェクトのメンバー (無い・オブジェクトでなければ nullptr)
+    const JsonValue* Find(std::string_view key) const;
+    // 配列の要素 (範囲外・配列でなければ nullptr)
+    const JsonValue* At(size_t index) const;
+    // メンバーが数・文字列ならその値、無ければ defaultValue
+    double GetNumber(std::string_view key, double defaultValue) const;
+    std::string_view GetString(std::string_view key, std::string_view defaultValue = {}) const;
+};
+
+namespace Json {
+    // 文法の誤りがあれば false (深すぎる入れ子も誤りとして扱う)
+    bool Parse(std::string_view text, JsonValue& value);
+}
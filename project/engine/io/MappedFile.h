@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// ファイルを読み取り専用でメモリにマップする
+// 中身はコピーせずに GetData() から直接読む (閉じるまで有効)
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { Open(path); }
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // 開けなければ false を返す (空のファイルは開けたものとして大きさ 0 になる)
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return isOpen_; }
+    const char* GetData() const { return data_; }
+    size_t GetSize() const { return size_; }
+    std::string_view GetView() const { return { data_, size_ }; }
+
+private:
+    void MoveFrom(MappedFile& other);
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool isOpen_ = false;
+#if defined(_WIN32)
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
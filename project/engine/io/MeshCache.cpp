@@ -0,0 +1,499 @@
+#include "MeshCache.h"
+#include "GltfLoader.h"
+#include "MappedFile.h"
+#include "MeshCodec.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    constexpr char kMagic[4] = { 'M', 'S', 'H', 'C' };
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceHash;
+        uint64_t fileSize;
+        uint32_t vertexStride;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t submeshCount;
+        uint32_t materialCount;
+        uint32_t dependencyCount;
+        uint32_t lodCount;
+        uint32_t meshletCount;
+        MeshCache::Compression compression;
+        uint32_t reserved;
+        uint64_t vertexOffset;
+        uint64_t vertexDataSize;
+        uint64_t indexOffset;
+        uint64_t indexDataSize;
+        uint64_t submeshOffset;
+        uint64_t lodOffset;
+        uint64_t meshletOffset;
+        uint64_t materialOffset;
+        uint64_t dependencyOffset;
+        uint64_t stringOffset;
+        uint64_t stringSize;
+        ModelData::CacheMetrics cacheMetrics;
+    };
+
+    // 文字列表の中の位置
+    struct StringEntry {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct SubmeshEntry {
+        StringEntry name;
+        uint32_t indexStart;
+        uint32_t indexCount;
+        uint32_t materialIndex;
+        uint32_t reserved;
+    };
+
+    // サブメッシュ表の [submeshStart, submeshStart + submeshCount) がこの段のもの
+    struct LodEntry {
+        float error;
+        uint32_t submeshStart;
+        uint32_t submeshCount;
+        uint32_t reserved;
+    };
+
+    // メッシュレットはそのまま書き出す
+    static_assert(sizeof(ModelData::Meshlet) == 48);
+
+    struct MaterialEntry {
+        StringEntry name;
+        StringEntry texture;
+    };
+
+    struct DependencyEntry {
+        StringEntry name;
+        uint64_t fileSize;
+        int64_t writeTime;
+    };
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    uint64_t RotateLeft(uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    constexpr uint64_t kPrime1 = 0x9e3779b185ebca87ull;
+    constexpr uint64_t kPrime2 = 0xc2b2ae3d27d4eb4full;
+    constexpr uint64_t kPrime3 = 0x165667b19e3779f9ull;
+
+    uint64_t MixWord(uint64_t lane, uint64_t word) {
+        return RotateLeft(lane + word * kPrime2, 31) * kPrime1;
+    }
+
+    // 8 バイトずつ 4 本の列で混ぜるハッシュ (改ざん検出ではなく変更検出用)
+    uint64_t HashBytes(const char* data, size_t size, uint64_t seed) {
+        uint64_t lanes[4] = { seed + kPrime1 + kPrime2, seed + kPrime2, seed, seed - kPrime1 };
+        size_t offset = 0;
+        for (; offset + 32 <= size; offset += 32) {
+            for (int i = 0; i < 4; ++i) {
+                uint64_t word;
+                std::memcpy(&word, data + offset + i * 8, sizeof(word));
+                lanes[i] = MixWord(lanes[i], word);
+            }
+        }
+
+        uint64_t hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+        hash += static_cast<uint64_t>(size);
+        for (; offset < size; ++offset) {
+            hash = RotateLeft(hash ^ (static_cast<uint8_t>(data[offset]) * kPrime3), 11) * kPrime1;
+        }
+        hash ^= hash >> 33;
+        hash *= kPrime2;
+        hash ^= hash >> 29;
+        hash *= kPrime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    // ファイルの範囲 [offset, offset + count * elementSize) が収まっているか
+    bool IsInside(const FileHeader& header, uint64_t offset, uint64_t count, uint64_t elementSize) {
+        return offset <= header.fileSize && count <= (header.fileSize - offset) / elementSize;
+    }
+
+    // texturePath が directoryPath 以下なら相対パスにする
+    std::string MakeRelativePath(const std::string& directoryPath, const std::string& path) {
+        const std::string prefix = directoryPath + "/";
+        if (path.compare(0, prefix.size(), prefix) == 0) {
+            return path.substr(prefix.size());
+        }
+        return path;
+    }
+
+    // 大きさと更新時刻 (取れなければ false)
+    bool GetFileStamp(const std::string& path, uint64_t& fileSize, int64_t& writeTime) {
+        std::error_code error;
+        fileSize = static_cast<uint64_t>(std::filesystem::file_size(path, error));
+        if (error) {
+            return false;
+        }
+        writeTime = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+        return !error;
+    }
+
+    void WritePadding(std::ofstream& stream, uint64_t targetOffset) {
+        static const char zeros[MeshCache::kBlobAlignment] = {};
+        const uint64_t current = static_cast<uint64_t>(stream.tellp());
+        if (current < targetOffset) {
+            stream.write(zeros, static_cast<std::streamsize>(targetOffset - current));
+        }
+    }
+}
+
+std::string MeshCache::GetCachePath(const std::string& directoryPath, const std::string& filename) {
+    return directoryPath + "/" + filename + ".meshcache";
+}
+
+bool MeshCache::HashSourceFiles(const std::string& directoryPath, const std::vector<std::string>& dependencies, uint64_t& hash) {
+    hash = kVersion;
+    for (const std::string& dependency : dependencies) {
+        MappedFile file;
+        if (!file.Open(directoryPath + "/" + dependency)) {
+            return false;
+        }
+        hash = HashBytes(file.GetData(), file.GetSize(), hash);
+    }
+    return true;
+}
+
+bool MeshCache::Write(const std::string& cachePath, const std::string& directoryPath, const ModelData& modelData,
+    const std::vector<std::string>& dependencies, uint64_t sourceHash, Compression compression) {
+    // 文字列表 (マテリアルのテクスチャ → 依存ファイルの順)
+    std::string strings;
+    auto AddString = [&strings](const std::string& text) {
+        const StringEntry entry{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size()) };
+        strings += text;
+        return entry;
+    };
+
+    std::vector<SubmeshEntry> submeshEntries;
+    for (const ModelData::Submesh& submesh : modelData.submeshes) {
+        submeshEntries.push_back({ AddString(submesh.name), submesh.indexStart, submesh.indexCount, submesh.materialIndex, 0 });
+    }
+    // 詳細度を下げた段のサブメッシュは元のサブメッシュの後ろに続ける
+    std::vector<LodEntry> lodEntries;
+    for (const ModelData::Lod& lod : modelData.lods) {
+        lodEntries.push_back({ lod.error, static_cast<uint32_t>(submeshEntries.size()), static_cast<uint32_t>(lod.submeshes.size()), 0 });
+        for (const ModelData::Submesh& submesh : lod.submeshes) {
+            submeshEntries.push_back({ AddString(submesh.name), submesh.indexStart, submesh.indexCount, submesh.materialIndex, 0 });
+        }
+    }
+    std::vector<MaterialEntry> materialEntries;
+    for (const ModelData::MaterialData& material : modelData.materials) {
+        const StringEntry name = AddString(material.name);
+        const StringEntry texture = AddString(material.textureFilePath.empty()
+            ? std::string() : MakeRelativePath(directoryPath, material.textureFilePath));
+        materialEntries.push_back({ name, texture });
+    }
+    std::vector<DependencyEntry> dependencyEntries;
+    for (const std::string& dependency : dependencies) {
+        DependencyEntry entry{ AddString(dependency), 0, 0 };
+        GetFileStamp(directoryPath + "/" + dependency, entry.fileSize, entry.writeTime);
+        dependencyEntries.push_back(entry);
+    }
+
+    // 縮める場合は先に縮めて大きさを決める
+    std::vector<uint8_t> vertexBlob;
+    std::vector<uint8_t> indexBlob;
+    const char* vertexData = reinterpret_cast<const char*>(modelData.vertices.data());
+    const char* indexData = reinterpret_cast<const char*>(modelData.indices.data());
+    uint64_t vertexDataSize = sizeof(ModelData::VertexData) * modelData.vertices.size();
+    uint64_t indexDataSize = sizeof(uint32_t) * modelData.indices.size();
+    if (compression == Compression::kMeshCodec) {
+        MeshCodec::EncodeVertexBuffer(vertexBlob, modelData.vertices.data(), modelData.vertices.size(), sizeof(ModelData::VertexData));
+        MeshCodec::EncodeIndexBuffer(indexBlob, modelData.indices.data(), modelData.indices.size());
+        vertexData = reinterpret_cast<const char*>(vertexBlob.data());
+        indexData = reinterpret_cast<const char*>(indexBlob.data());
+        vertexDataSize = vertexBlob.size();
+        indexDataSize = indexBlob.size();
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.sourceHash = sourceHash;
+    header.vertexStride = sizeof(ModelData::VertexData);
+    header.vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+    header.indexCount = static_cast<uint32_t>(modelData.indices.size());
+    header.submeshCount = static_cast<uint32_t>(submeshEntries.size());
+    header.materialCount = static_cast<uint32_t>(materialEntries.size());
+    header.dependencyCount = static_cast<uint32_t>(dependencyEntries.size());
+    header.lodCount = static_cast<uint32_t>(lodEntries.size());
+    header.meshletCount = static_cast<uint32_t>(modelData.meshlets.size());
+    header.compression = compression;
+    header.vertexOffset = AlignUp(sizeof(FileHeader), kBlobAlignment);
+    header.vertexDataSize = vertexDataSize;
+    header.indexOffset = AlignUp(header.vertexOffset + vertexDataSize, kBlobAlignment);
+    header.indexDataSize = indexDataSize;
+    header.submeshOffset = AlignUp(header.indexOffset + indexDataSize, 16);
+    header.lodOffset = header.submeshOffset + sizeof(SubmeshEntry) * header.submeshCount;
+    header.meshletOffset = header.lodOffset + sizeof(LodEntry) * header.lodCount;
+    header.materialOffset = header.meshletOffset + sizeof(ModelData::Meshlet) * header.meshletCount;
+    header.dependencyOffset = header.materialOffset + sizeof(MaterialEntry) * header.materialCount;
+    header.stringOffset = header.dependencyOffset + sizeof(DependencyEntry) * header.dependencyCount;
+    header.stringSize = strings.size();
+    header.fileSize = header.stringOffset + header.stringSize;
+    header.cacheMetrics = modelData.cacheMetrics;
+
+    const std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            return false;
+        }
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        WritePadding(stream, header.vertexOffset);
+        stream.write(vertexData, static_cast<std::streamsize>(vertexDataSize));
+        WritePadding(stream, header.indexOffset);
+        stream.write(indexData, static_cast<std::streamsize>(indexDataSize));
+        WritePadding(stream, header.submeshOffset);
+        stream.write(reinterpret_cast<const char*>(submeshEntries.data()), static_cast<std::streamsize>(sizeof(SubmeshEntry) * submeshEntries.size()));
+        stream.write(reinterpret_cast<const char*>(lodEntries.data()), static_cast<std::streamsize>(sizeof(LodEntry) * lodEntries.size()));
+        stream.write(reinterpret_cast<const char*>(modelData.meshlets.data()), static_cast<std::streamsize>(sizeof(ModelData::Meshlet) * modelData.meshlets.size()));
+        stream.write(reinterpret_cast<const char*>(materialEntries.data()), static_cast<std::streamsize>(sizeof(MaterialEntry) * materialEntries.size()));
+        stream.write(reinterpret_cast<const char*>(dependencyEntries.data()), static_cast<std::streamsize>(sizeof(DependencyEntry) * dependencyEntries.size()));
+        stream.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!stream.good()) {
+            stream.close();
+            std::filesystem::remove(temporaryPath);
+            return false;
+        }
+    }
+
+    // 読み込み中のプロセスが書きかけのファイルを見ないように置き換える
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool MeshCache::Read(const std::string& cachePath, const std::string& directoryPath, ModelData& modelData) {
+    MappedFile file;
+    if (!file.Open(cachePath) || file.GetSize() < sizeof(FileHeader)) {
+        return false;
+    }
+    const char* data = file.GetData();
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.vertexStride != sizeof(ModelData::VertexData) || header.fileSize != file.GetSize()) {
+        return false;
+    }
+    const bool isCompressed = header.compression == Compression::kMeshCodec;
+    if (!isCompressed && (header.compression != Compression::kNone ||
+        header.vertexDataSize != sizeof(ModelData::VertexData) * static_cast<uint64_t>(header.vertexCount) ||
+        header.indexDataSize != sizeof(uint32_t) * static_cast<uint64_t>(header.indexCount))) {
+        return false;
+    }
+    if (!IsInside(header, header.vertexOffset, header.vertexDataSize, 1) ||
+        !IsInside(header, header.indexOffset, header.indexDataSize, 1) ||
+        !IsInside(header, header.submeshOffset, header.submeshCount, sizeof(SubmeshEntry)) ||
+        !IsInside(header, header.lodOffset, header.lodCount, sizeof(LodEntry)) ||
+        !IsInside(header, header.meshletOffset, header.meshletCount, sizeof(ModelData::Meshlet)) ||
+        !IsInside(header, header.materialOffset, header.materialCount, sizeof(MaterialEntry)) ||
+        !IsInside(header, header.dependencyOffset, header.dependencyCount, sizeof(DependencyEntry)) ||
+        !IsInside(header, header.stringOffset, header.stringSize, 1)) {
+        return false;
+    }
+
+    auto GetString = [&](const StringEntry& entry, std::string& text) {
+        if (static_cast<uint64_t>(entry.offset) + entry.length > header.stringSize) {
+            return false;
+        }
+        text.assign(data + header.stringOffset + entry.offset, entry.length);
+        return true;
+    };
+
+    // 元ファイルが変わっていれば使わない (大きさと更新時刻が同じなら中身は読まない)
+    std::vector<std::string> dependencies(header.dependencyCount);
+    bool isStampSame = true;
+    for (uint32_t i = 0; i < header.dependencyCount; ++i) {
+        DependencyEntry entry;
+        std::memcpy(&entry, data + header.dependencyOffset + sizeof(DependencyEntry) * i, sizeof(entry));
+        if (!GetString(entry.name, dependencies[i])) {
+            return false;
+        }
+        uint64_t fileSize = 0;
+        int64_t writeTime = 0;
+        if (!GetFileStamp(directoryPath + "/" + dependencies[i], fileSize, writeTime) || fileSize != entry.fileSize) {
+            return false;
+        }
+        isStampSame = isStampSame && writeTime == entry.writeTime;
+    }
+    if (dependencies.empty()) {
+        return false;
+    }
+    if (!isStampSame) {
+        uint64_t sourceHash = 0;
+        if (!HashSourceFiles(directoryPath, dependencies, sourceHash) || sourceHash != header.sourceHash) {
+            return false;
+        }
+    }
+
+    ModelData result;
+    result.cacheMetrics = header.cacheMetrics;
+    result.materials.resize(header.materialCount);
+    for (uint32_t i = 0; i < header.materialCount; ++i) {
+        MaterialEntry entry;
+        std::memcpy(&entry, data + header.materialOffset + sizeof(MaterialEntry) * i, sizeof(entry));
+        std::string textureName;
+        if (!GetString(entry.name, result.materials[i].name) || !GetString(entry.texture, textureName)) {
+            return false;
+        }
+        if (!textureName.empty()) {
+            result.materials[i].textureFilePath = directoryPath + "/" + textureName;
+        }
+    }
+    std::vector<ModelData::Submesh> submeshes(header.submeshCount);
+    for (uint32_t i = 0; i < header.submeshCount; ++i) {
+        SubmeshEntry entry;
+        std::memcpy(&entry, data + header.submeshOffset + sizeof(SubmeshEntry) * i, sizeof(entry));
+        ModelData::Submesh& submesh = submeshes[i];
+        if (!GetString(entry.name, submesh.name) || entry.materialIndex >= header.materialCount ||
+            entry.indexStart > header.indexCount || entry.indexCount > header.indexCount - entry.indexStart) {
+            return false;
+        }
+        submesh.indexStart = entry.indexStart;
+        submesh.indexCount = entry.indexCount;
+        submesh.materialIndex = entry.materialIndex;
+    }
+    // 先頭の段の手前までが元のメッシュのサブメッシュ
+    uint32_t baseSubmeshCount = header.submeshCount;
+    result.lods.resize(header.lodCount);
+    for (uint32_t i = 0; i < header.lodCount; ++i) {
+        LodEntry entry;
+        std::memcpy(&entry, data + header.lodOffset + sizeof(LodEntry) * i, sizeof(entry));
+        if (entry.submeshStart > header.submeshCount || entry.submeshCount > header.submeshCount - entry.submeshStart) {
+            return false;
+        }
+        baseSubmeshCount = (std::min)(baseSubmeshCount, entry.submeshStart);
+        result.lods[i].error = entry.error;
+        result.lods[i].submeshes.assign(submeshes.begin() + entry.submeshStart, submeshes.begin() + entry.submeshStart + entry.submeshCount);
+    }
+    result.submeshes.assign(submeshes.begin(), submeshes.begin() + baseSubmeshCount);
+    // 塊は元のメッシュのサブメッシュの範囲の中にあること
+    result.meshlets.resize(header.meshletCount);
+    if (header.meshletCount > 0) {
+        std::memcpy(result.meshlets.data(), data + header.meshletOffset, sizeof(ModelData::Meshlet) * header.meshletCount);
+    }
+    for (const ModelData::Meshlet& meshlet : result.meshlets) {
+        const uint64_t indexEnd = static_cast<uint64_t>(meshlet.indexStart) + static_cast<uint64_t>(meshlet.triangleCount) * 3;
+        if (baseSubmeshCount == 0) {
+            if (meshlet.submeshIndex != 0 || indexEnd > header.indexCount) {
+                return false;
+            }
+        } else if (meshlet.submeshIndex >= baseSubmeshCount || meshlet.indexStart < submeshes[meshlet.submeshIndex].indexStart ||
+            indexEnd > static_cast<uint64_t>(submeshes[meshlet.submeshIndex].indexStart) + submeshes[meshlet.submeshIndex].indexCount) {
+            return false;
+        }
+    }
+    result.vertices.resize(header.vertexCount);
+    result.indices.resize(header.indexCount);
+    if (isCompressed) {
+        const uint8_t* vertexBlob = reinterpret_cast<const uint8_t*>(data + header.vertexOffset);
+        const uint8_t* indexBlob = reinterpret_cast<const uint8_t*>(data + header.indexOffset);
+        if (!MeshCodec::DecodeVertexBuffer(result.vertices.data(), header.vertexCount, sizeof(ModelData::VertexData), vertexBlob, header.vertexDataSize) ||
+            !MeshCodec::DecodeIndexBuffer(result.indices.data(), header.indexCount, indexBlob, header.indexDataSize)) {
+            return false;
+        }
+    } else {
+        std::memcpy(result.vertices.data(), data + header.vertexOffset, sizeof(ModelData::VertexData) * header.vertexCount);
+        std::memcpy(result.indices.data(), data + header.indexOffset, sizeof(uint32_t) * header.indexCount);
+    }
+    for (uint32_t index : result.indices) {
+        if (index >= header.vertexCount) {
+            return false;
+        }
+    }
+
+    modelData = std::move(result);
+    if (!isStampSame) {
+        // チェックアウトなどで更新時刻だけ変わった場合 (マップを閉じてから置き換える)
+        file.Close();
+        Write(cachePath, directoryPath, modelData, dependencies, header.sourceHash, header.compression);
+    }
+    return true;
+}
+
+namespace {
+    // 読み込んだメッシュに取り込み時の処理をしてキャッシュへ書き出す
+    void ImportAndWrite(const std::string& cachePath, const std::string& directoryPath, ModelData& modelData,
+        const std::vector<std::string>& dependencies, MeshCache::Compression compression) {
+        // 並べ替え・塊・詳細度の段も保存するので、次回からはその時間もかからない
+        MeshOptimizer::Optimize(modelData);
+        MeshletBuilder::Build(modelData);
+        MeshSimplifier::BuildLodChain(modelData);
+
+        // 書き出せなくても (読み取り専用の場所など) 読み込み自体は成功として扱う
+        uint64_t sourceHash = 0;
+        if (MeshCache::HashSourceFiles(directoryPath, dependencies, sourceHash)) {
+            MeshCache::Write(cachePath, directoryPath, modelData, dependencies, sourceHash, compression);
+        }
+    }
+
+    bool HasExtension(const std::string& filename, std::string_view extension) {
+        if (filename.size() < extension.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < extension.size(); ++i) {
+            const char c = filename[filename.size() - extension.size() + i];
+            if (std::tolower(static_cast<unsigned char>(c)) != extension[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+ModelData MeshCache::LoadObjFile(const std::string& directoryPath, const std::string& filename, Compression compression) {
+    const std::string cachePath = GetCachePath(directoryPath, filename);
+    ModelData modelData;
+    if (Read(cachePath, directoryPath, modelData)) {
+        return modelData;
+    }
+
+    std::vector<std::string> dependencies{ filename };
+    modelData = ObjLoader::LoadObjFileParallel(directoryPath, filename, 0, &dependencies);
+    ImportAndWrite(cachePath, directoryPath, modelData, dependencies, compression);
+    return modelData;
+}
+
+ModelData MeshCache::LoadGlbFile(const std::string& directoryPath, const std::string& filename, Compression compression) {
+    const std::string cachePath = GetCachePath(directoryPath, filename);
+    ModelData modelData;
+    if (Read(cachePath, directoryPath, modelData)) {
+        return modelData;
+    }
+
+    // GLB は 1 つのファイルに全部入っている (画像はテクスチャとして別に読む)
+    const std::vector<std::string> dependencies{ filename };
+    modelData = GltfLoader::LoadGlbFile(directoryPath, filename);
+    ImportAndWrite(cachePath, directoryPath, modelData, dependencies, compression);
+    return modelData;
+}
+
+ModelData MeshCache::LoadModelFile(const std::string& directoryPath, const std::string& filename, Compression compression) {
+    if (HasExtension(filename, ".glb")) {
+        return LoadGlbFile(directoryPath, filename, compression);
+    }
+    return LoadObjFile(directoryPath, filename, compression);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "ModelData.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 読み込んだメッシュをバイナリで保存し、次回からはメモリマップして読む
+// キャッシュは元ファイルの隣に "<元ファイル名>.meshcache" として書き出す
+//
+// ファイルの並び (リトルエンディアン、オフセットはファイル先頭から)
+//   ヘッダー         : 識別子 "MSHC"・バージョン・元ファイルのハッシュ・各表の数とオフセット・並べ替えの前後の ACMR / ATVR
+//   頂点             : ModelData::VertexData の配列 (kBlobAlignment 境界、GPU へそのままコピーできる)
+//   頂点番号         : uint32_t の配列 (kBlobAlignment 境界)
+//                      Compression::kMeshCodec で書いた場合は、頂点・頂点番号とも MeshCodec で縮めたバイト列
+//   サブメッシュ表   : 名前・頂点番号の範囲・マテリアル番号 (元のメッシュ、続いて詳細度を下げた段の分)
+//   詳細度の段の表   : 誤差とサブメッシュ表の範囲
+//   メッシュレット表 : ModelData::Meshlet の配列 (頂点番号の範囲・包む球・面の向きの円錐)
+//   マテリアル表     : 名前とテクスチャのファイル名 (文字列表の位置)
+//   依存ファイル表   : 元ファイル名と、書き出した時の大きさ・更新時刻 (先頭が OBJ / GLB、OBJ なら続いて MTL)
+//   文字列表         : ディレクトリからの相対パスを連結したもの
+// 元ファイルの大きさと更新時刻が記録と同じなら中身は読まずに使う
+// 違う場合は中身のハッシュで判定し、一致しなければ (バージョンや頂点の大きさが違う場合も) 使わない
+namespace MeshCache {
+    constexpr uint32_t kVersion = 6;
+    constexpr uint64_t kBlobAlignment = 256;
+
+    // 頂点・頂点番号の保存の仕方 (kMeshCodec はファイルが 35% ほどになるが、ページキャッシュから読むと kNone の 3〜6 倍の時間がかかる)
+    enum class Compression : uint32_t {
+        kNone,
+        kMeshCodec,
+    };
+
+    std::string GetCachePath(const std::string& directoryPath, const std::string& filename);
+
+    // 依存ファイル (directoryPath からの相対) の中身を順に混ぜたハッシュ
+    // 読めないファイルがあれば false を返す
+    bool HashSourceFiles(const std::string& directoryPath, const std::vector<std::string>& dependencies, uint64_t& hash);
+
+    // 一時ファイルに書いてから置き換える (書けなければ false)
+    bool Write(const std::string& cachePath, const std::string& directoryPath, const ModelData& modelData,
+        const std::vector<std::string>& dependencies, uint64_t sourceHash, Compression compression = Compression::kNone);
+    // キャッシュが無い・壊れている・元ファイルが変わっている場合は false
+    // 縮めたキャッシュは modelData の頂点・頂点番号へ直接復元する
+    // 中身は同じで更新時刻だけ変わっていた場合は、次回ハッシュを取らずに済むよう記録を (同じ保存の仕方で) 書き直す
+    bool Read(const std::string& cachePath, const std::string& directoryPath, ModelData& modelData);
+
+    // 有効なキャッシュがあればそれを読み、無ければ OBJ を (大きければ並列で) 読み、MeshOptimizer で並べ替え、
+    // MeshletBuilder で塊に分け、MeshSimplifier で詳細度の段を作ってキャッシュを compression で書き出す
+    ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename, Compression compression = Compression::kNone);
+    // LoadObjFile と同じ処理を GLB (GltfLoader) で行う
+    ModelData LoadGlbFile(const std::string& directoryPath, const std::string& filename, Compression compression = Compression::kNone);
+    // 拡張子 (大文字小文字は区別しない) が .glb なら LoadGlbFile、それ以外は LoadObjFile
+    ModelData LoadModelFile(const std::string& directoryPath, const std::string& filename, Compression compression = Compression::kNone);
+}
@@ -0,0 +1,427 @@
+#include "MeshCodec.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace {
+    // 先頭の 1 バイト (種類と形式の版)
+    constexpr uint8_t kVertexHeader = 0xa1;
+    constexpr uint8_t kIndexHeader = 0xe1;
+
+    // 値はこの数ずつの塊に分け、塊の中を列・バイトの桁ごとの面にして書く
+    constexpr size_t kBlockRowCount = 256;
+    constexpr size_t kGroupSize = 16;
+    constexpr size_t kMaxColumnCount = 64;
+    // 組の形式ごとの固定部分のバイト数 (0・2・4・8 ビット)
+    constexpr size_t kGroupDataSize[4] = { 0, 4, 8, 16 };
+    // 2・4 ビットの形式で、入りきらない値の印 (値は組の後ろに 1 バイトで続ける)
+    constexpr uint8_t kEscape2 = 3;
+    constexpr uint8_t kEscape4 = 15;
+
+    // 頂点番号: 最近使った頂点の FIFO の大きさ (符号 1..kIndexFifoSize が FIFO の位置)
+    constexpr uint32_t kIndexFifoSize = 15;
+
+    uint32_t ZigZag(int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int32_t UnZigZag(uint32_t value) {
+        return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1u)));
+    }
+
+    size_t AlignGroup(size_t count) {
+        return (count + kGroupSize - 1) / kGroupSize * kGroupSize;
+    }
+
+    // byteCount (16 の倍数) バイトを、組ごとの 2 ビットの形式の表と中身に分けて書く
+    // 形式は入りきらない値の分も含めて最も小さくなるものを選ぶ
+    void EncodeBytes(const uint8_t* bytes, size_t byteCount, std::vector<uint8_t>& buffer) {
+        const size_t groupCount = byteCount / kGroupSize;
+        const size_t headerOffset = buffer.size();
+        buffer.resize(headerOffset + (groupCount + 3) / 4, 0);
+        for (size_t g = 0; g < groupCount; ++g) {
+            const uint8_t* group = bytes + g * kGroupSize;
+            uint8_t bits = 0;
+            size_t escape2Count = 0;
+            size_t escape4Count = 0;
+            for (size_t i = 0; i < kGroupSize; ++i) {
+                bits |= group[i];
+                escape2Count += group[i] >= kEscape2;
+                escape4Count += group[i] >= kEscape4;
+            }
+            uint32_t mode = 3;
+            if (bits == 0) {
+                mode = 0;
+            } else if (kGroupDataSize[1] + escape2Count <= (std::min)(kGroupDataSize[2] + escape4Count, kGroupDataSize[3])) {
+                mode = 1;
+            } else if (kGroupDataSize[2] + escape4Count < kGroupDataSize[3]) {
+                mode = 2;
+            }
+            buffer[headerOffset + g / 4] |= static_cast<uint8_t>(mode << ((g % 4) * 2));
+            if (mode == 1) {
+                for (size_t i = 0; i < kGroupSize; i += 4) {
+                    uint8_t packed = 0;
+                    for (size_t k = 0; k < 4; ++k) {
+                        packed |= static_cast<uint8_t>((std::min)(group[i + k], kEscape2) << (k * 2));
+                    }
+                    buffer.push_back(packed);
+                }
+                for (size_t i = 0; i < kGroupSize; ++i) {
+                    if (group[i] >= kEscape2) {
+                        buffer.push_back(group[i]);
+                    }
+                }
+            } else if (mode == 2) {
+                for (size_t i = 0; i < kGroupSize; i += 2) {
+                    buffer.push_back(static_cast<uint8_t>((std::min)(group[i], kEscape4) | ((std::min)(group[i + 1], kEscape4) << 4)));
+                }
+                for (size_t i = 0; i < kGroupSize; ++i) {
+                    if (group[i] >= kEscape4) {
+                        buffer.push_back(group[i]);
+                    }
+                }
+            } else if (mode == 3) {
+                buffer.insert(buffer.end(), group, group + kGroupSize);
+            }
+        }
+    }
+
+    // 32 ビットの値 (rowCount 行 columnCount 列) を塊ごとに列・桁の面に分けて書く
+    void EncodeWords(const std::vector<uint32_t>& words, size_t rowCount, size_t columnCount, std::vector<uint8_t>& buffer) {
+        uint8_t plane[kBlockRowCount];
+        for (size_t blockStart = 0; blockStart < rowCount; blockStart += kBlockRowCount) {
+            const size_t blockRowCount = (std::min)(kBlockRowCount, rowCount - blockStart);
+            const size_t paddedRowCount = AlignGroup(blockRowCount);
+            for (size_t column = 0; column < columnCount; ++column) {
+                for (uint32_t shift = 0; shift < 32; shift += 8) {
+                    std::memset(plane, 0, sizeof(plane));
+                    for (size_t row = 0; row < blockRowCount; ++row) {
+                        plane[row] = static_cast<uint8_t>(words[(blockStart + row) * columnCount + column] >> shift);
+                    }
+                    EncodeBytes(plane, paddedRowCount, buffer);
+                }
+            }
+        }
+    }
+
+#if defined(MATH_SIMD_X86)
+    // 組を 16 バイトに展開し、続きの位置を返す (足りなければ nullptr、SSE2)
+    const uint8_t* DecodeGroup(uint32_t mode, const uint8_t* data, const uint8_t* end, uint8_t* bytes) {
+        __m128i values;
+        __m128i escape;
+        switch (mode) {
+        case 0:
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), _mm_setzero_si128());
+            return data;
+        case 1: {
+            int32_t packed;
+            std::memcpy(&packed, data, sizeof(packed));
+            const __m128i source = _mm_cvtsi32_si128(packed);
+            const __m128i mask = _mm_set1_epi8(3);
+            const __m128i a0 = _mm_and_si128(source, mask);
+            const __m128i a1 = _mm_and_si128(_mm_srli_epi16(source, 2), mask);
+            const __m128i a2 = _mm_and_si128(_mm_srli_epi16(source, 4), mask);
+            const __m128i a3 = _mm_and_si128(_mm_srli_epi16(source, 6), mask);
+            values = _mm_unpacklo_epi16(_mm_unpacklo_epi8(a0, a1), _mm_unpacklo_epi8(a2, a3));
+            escape = _mm_set1_epi8(kEscape2);
+            break;
+        }
+        case 2: {
+            const __m128i source = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+            const __m128i mask = _mm_set1_epi8(15);
+            const __m128i low = _mm_and_si128(source, mask);
+            const __m128i high = _mm_and_si128(_mm_srli_epi16(source, 4), mask);
+            values = _mm_unpacklo_epi8(low, high);
+            escape = _mm_set1_epi8(kEscape4);
+            break;
+        }
+        default:
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+            return data + kGroupSize;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), values);
+        data += kGroupDataSize[mode];
+
+        // 印の付いた値は後ろのバイトで置き換える
+        uint32_t escapeMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(values, escape)));
+        if (escapeMask != 0) {
+            if (static_cast<size_t>(end - data) < static_cast<size_t>(std::popcount(escapeMask))) {
+                return nullptr;
+            }
+            for (; escapeMask != 0; escapeMask &= escapeMask - 1) {
+                bytes[std::countr_zero(escapeMask)] = *data++;
+            }
+        }
+        return data;
+    }
+
+    // 4 つの桁の面の 16 行分を 32 ビットの値にする (4 行ずつ 4 つ)
+    void CombinePlanes(const uint8_t* planes, size_t row, __m128i values[4]) {
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + row));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + kBlockRowCount + row));
+        const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + kBlockRowCount * 2 + row));
+        const __m128i b3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + kBlockRowCount * 3 + row));
+        const __m128i low01 = _mm_unpacklo_epi8(b0, b1);
+        const __m128i high01 = _mm_unpackhi_epi8(b0, b1);
+        const __m128i low23 = _mm_unpacklo_epi8(b2, b3);
+        const __m128i high23 = _mm_unpackhi_epi8(b2, b3);
+        values[0] = _mm_unpacklo_epi16(low01, low23);
+        values[1] = _mm_unpackhi_epi16(low01, low23);
+        values[2] = _mm_unpacklo_epi16(high01, high23);
+        values[3] = _mm_unpackhi_epi16(high01, high23);
+    }
+
+    // 前の値との XOR を戻して元の値にする (last は前の塊の最後の値)
+    void DecodeXorColumn(const uint8_t* planes, size_t paddedRowCount, uint32_t& last, uint32_t* words) {
+        __m128i carry = _mm_set1_epi32(static_cast<int32_t>(last));
+        for (size_t row = 0; row < paddedRowCount; row += kGroupSize) {
+            __m128i values[4];
+            CombinePlanes(planes, row, values);
+            for (int i = 0; i < 4; ++i) {
+                // 4 つの中で前から順に XOR を重ね、前の値と XOR する
+                __m128i prefix = _mm_xor_si128(values[i], _mm_slli_si128(values[i], 4));
+                prefix = _mm_xor_si128(prefix, _mm_slli_si128(prefix, 8));
+                prefix = _mm_xor_si128(prefix, carry);
+                carry = _mm_shuffle_epi32(prefix, _MM_SHUFFLE(3, 3, 3, 3));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(words + row + i * 4), prefix);
+            }
+        }
+        last = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+    }
+
+    void DecodeWordColumn(const uint8_t* planes, size_t paddedRowCount, uint32_t* words) {
+        for (size_t row = 0; row < paddedRowCount; row += kGroupSize) {
+            __m128i values[4];
+            CombinePlanes(planes, row, values);
+            for (int i = 0; i < 4; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(words + row + i * 4), values[i]);
+            }
+        }
+    }
+#else
+    const uint8_t* DecodeGroup(uint32_t mode, const uint8_t* data, const uint8_t* end, uint8_t* bytes) {
+        uint8_t escape = 0;
+        switch (mode) {
+        case 0:
+            std::memset(bytes, 0, kGroupSize);
+            return data;
+        case 1:
+            for (size_t i = 0; i < kGroupSize; ++i) {
+                bytes[i] = static_cast<uint8_t>((data[i / 4] >> ((i % 4) * 2)) & 3);
+            }
+            escape = kEscape2;
+            break;
+        case 2:
+            for (size_t i = 0; i < kGroupSize; ++i) {
+                bytes[i] = static_cast<uint8_t>((data[i / 2] >> ((i % 2) * 4)) & 15);
+            }
+            escape = kEscape4;
+            break;
+        default:
+            std::memcpy(bytes, data, kGroupSize);
+            return data + kGroupSize;
+        }
+        data += kGroupDataSize[mode];
+        for (size_t i = 0; i < kGroupSize; ++i) {
+            if (bytes[i] == escape) {
+                if (data == end) {
+                    return nullptr;
+                }
+                bytes[i] = *data++;
+            }
+        }
+        return data;
+    }
+
+    uint32_t CombinePlanes(const uint8_t* planes, size_t row) {
+        return static_cast<uint32_t>(planes[row]) | (static_cast<uint32_t>(planes[kBlockRowCount + row]) << 8) |
+            (static_cast<uint32_t>(planes[kBlockRowCount * 2 + row]) << 16) | (static_cast<uint32_t>(planes[kBlockRowCount * 3 + row]) << 24);
+    }
+
+    void DecodeXorColumn(const uint8_t* planes, size_t paddedRowCount, uint32_t& last, uint32_t* words) {
+        for (size_t row = 0; row < paddedRowCount; ++row) {
+            last ^= CombinePlanes(planes, row);
+            words[row] = last;
+        }
+    }
+
+    void DecodeWordColumn(const uint8_t* planes, size_t paddedRowCount, uint32_t* words) {
+        for (size_t row = 0; row < paddedRowCount; ++row) {
+            words[row] = CombinePlanes(planes, row);
+        }
+    }
+#endif
+
+    // EncodeBytes で書いた byteCount バイトを戻し、続きの位置を返す (足りなければ nullptr)
+    const uint8_t* DecodeBytes(const uint8_t* data, const uint8_t* end, uint8_t* bytes, size_t byteCount) {
+        const size_t groupCount = byteCount / kGroupSize;
+        const size_t headerSize = (groupCount + 3) / 4;
+        if (static_cast<size_t>(end - data) < headerSize) {
+            return nullptr;
+        }
+        const uint8_t* header = data;
+        data += headerSize;
+        for (size_t g = 0; g < groupCount && data; ++g) {
+            const uint32_t mode = (header[g / 4] >> ((g % 4) * 2)) & 3u;
+            if (static_cast<size_t>(end - data) < kGroupDataSize[mode]) {
+                return nullptr;
+            }
+            data = DecodeGroup(mode, data, end, bytes + g * kGroupSize);
+        }
+        return data;
+    }
+
+    // 塊の 1 つの列の 4 つの桁の面を planes ([4][kBlockRowCount]) に戻す
+    const uint8_t* DecodePlanes(const uint8_t* data, const uint8_t* end, uint8_t* planes, size_t paddedRowCount) {
+        for (size_t plane = 0; plane < 4 && data; ++plane) {
+            data = DecodeBytes(data, end, planes + kBlockRowCount * plane, paddedRowCount);
+        }
+        return data;
+    }
+
+    // 最近使った頂点番号 (符号化と復元で同じ順に入れる)
+    struct IndexFifo {
+        uint32_t entries[kIndexFifoSize] = {};
+        uint32_t head = 0;
+
+        void Push(uint32_t index) {
+            entries[head % kIndexFifoSize] = index;
+            ++head;
+        }
+        // 新しいものから数えて position 番目 (0 から)
+        uint32_t Get(uint32_t position) const {
+            return entries[(head + kIndexFifoSize - 1 - position) % kIndexFifoSize];
+        }
+        uint32_t GetCount() const {
+            return (std::min)(head, kIndexFifoSize);
+        }
+    };
+}
+
+void MeshCodec::EncodeVertexBuffer(std::vector<uint8_t>& buffer, const void* vertices, size_t vertexCount, size_t vertexStride) {
+    assert(vertexStride > 0 && vertexStride % 4 == 0 && vertexStride / 4 <= kMaxColumnCount);
+    const size_t columnCount = vertexStride / 4;
+    const uint8_t* source = static_cast<const uint8_t*>(vertices);
+
+    // 列ごとに前の頂点との XOR (浮動小数点数は符号・指数が同じなら上位の桁が 0 になる)
+    std::vector<uint32_t> words(vertexCount * columnCount);
+    uint32_t last[kMaxColumnCount] = {};
+    for (size_t v = 0; v < vertexCount; ++v) {
+        for (size_t column = 0; column < columnCount; ++column) {
+            uint32_t value;
+            std::memcpy(&value, source + v * vertexStride + column * 4, sizeof(value));
+            words[v * columnCount + column] = value ^ last[column];
+            last[column] = value;
+        }
+    }
+    buffer.push_back(kVertexHeader);
+    EncodeWords(words, vertexCount, columnCount, buffer);
+}
+
+bool MeshCodec::DecodeVertexBuffer(void* vertices, size_t vertexCount, size_t vertexStride, const uint8_t* data, size_t size) {
+    if (vertexStride == 0 || vertexStride % 4 != 0 || vertexStride / 4 > kMaxColumnCount || size == 0 || data[0] != kVertexHeader) {
+        return false;
+    }
+    const size_t columnCount = vertexStride / 4;
+    const uint8_t* end = data + size;
+    data += 1;
+    uint8_t* destination = static_cast<uint8_t*>(vertices);
+
+    alignas(16) uint8_t planes[4 * kBlockRowCount];
+    alignas(16) uint32_t words[kBlockRowCount];
+    uint32_t last[kMaxColumnCount] = {};
+    for (size_t blockStart = 0; blockStart < vertexCount; blockStart += kBlockRowCount) {
+        const size_t blockRowCount = (std::min)(kBlockRowCount, vertexCount - blockStart);
+        const size_t paddedRowCount = AlignGroup(blockRowCount);
+        uint8_t* blockDestination = destination + blockStart * vertexStride;
+        for (size_t column = 0; column < columnCount; ++column) {
+            data = DecodePlanes(data, end, planes, paddedRowCount);
+            if (!data) {
+                return false;
+            }
+            // 埋めた分は 0 なので、最後の値は実際の最後の頂点のものになる
+            DecodeXorColumn(planes, paddedRowCount, last[column], words);
+            uint8_t* columnDestination = blockDestination + column * 4;
+            for (size_t row = 0; row < blockRowCount; ++row) {
+                std::memcpy(columnDestination + row * vertexStride, &words[row], sizeof(uint32_t));
+            }
+        }
+    }
+    return data == end;
+}
+
+void MeshCodec::EncodeIndexBuffer(std::vector<uint8_t>& buffer, const uint32_t* indices, size_t indexCount) {
+    // 0 はまだ使っていない次の頂点、1..kIndexFifoSize は最近使った頂点、それ以外は前の頂点番号との差
+    std::vector<uint32_t> words(indexCount);
+    IndexFifo fifo;
+    uint32_t next = 0;
+    uint32_t last = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        const uint32_t index = indices[i];
+        if (index == next) {
+            words[i] = 0;
+            fifo.Push(index);
+            ++next;
+        } else {
+            uint32_t position = 0;
+            while (position < fifo.GetCount() && fifo.Get(position) != index) {
+                ++position;
+            }
+            if (position < fifo.GetCount()) {
+                words[i] = 1 + position;
+            } else {
+                words[i] = kIndexFifoSize + 1 + ZigZag(static_cast<int32_t>(index - last));
+                fifo.Push(index);
+                next = (std::max)(next, index + 1);
+            }
+        }
+        last = index;
+    }
+    buffer.push_back(kIndexHeader);
+    EncodeWords(words, indexCount, 1, buffer);
+}
+
+bool MeshCodec::DecodeIndexBuffer(uint32_t* indices, size_t indexCount, const uint8_t* data, size_t size) {
+    if (size == 0 || data[0] != kIndexHeader) {
+        return false;
+    }
+    const uint8_t* end = data + size;
+    data += 1;
+
+    alignas(16) uint8_t planes[4 * kBlockRowCount];
+    alignas(16) uint32_t words[kBlockRowCount];
+    IndexFifo fifo;
+    uint32_t next = 0;
+    uint32_t last = 0;
+    for (size_t blockStart = 0; blockStart < indexCount; blockStart += kBlockRowCount) {
+        const size_t blockRowCount = (std::min)(kBlockRowCount, indexCount - blockStart);
+        const size_t paddedRowCount = AlignGroup(blockRowCount);
+        data = DecodePlanes(data, end, planes, paddedRowCount);
+        if (!data) {
+            return false;
+        }
+        DecodeWordColumn(planes, paddedRowCount, words);
+        for (size_t row = 0; row < blockRowCount; ++row) {
+            const uint32_t code = words[row];
+            uint32_t index;
+            if (code == 0) {
+                index = next++;
+                fifo.Push(index);
+            } else if (code <= kIndexFifoSize) {
+                if (code > fifo.GetCount()) {
+                    return false;
+                }
+                index = fifo.Get(code - 1);
+            } else {
+                index = last + static_cast<uint32_t>(UnZigZag(code - kIndexFifoSize - 1));
+                fifo.Push(index);
+                next = (std::max)(next, index + 1);
+            }
+            indices[blockStart + row] = index;
+            last = index;
+        }
+    }
+    return data == end;
+}
@@ -0,0 +1,507 @@
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include "MeshBuilder.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+namespace {
+    bool IsSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // 1 行 (改行を含まない) を先頭から読み進める
+    struct LineReader {
+        const char* current;
+        const char* end;
+
+        void SkipSpaces() {
+            while (current < end && IsSpace(*current)) {
+                ++current;
+            }
+        }
+
+        // 空白で区切られた次のトークン (無ければ空)
+        std::string_view NextToken() {
+            SkipSpaces();
+            const char* begin = current;
+            while (current < end && !IsSpace(*current)) {
+                ++current;
+            }
+            return { begin, static_cast<size_t>(current - begin) };
+        }
+
+        // 読めなければ 0 (istream と同様、足りない成分は 0 のまま)
+        float NextFloat() {
+            const std::string_view token = NextToken();
+            const char* begin = token.data();
+            const char* tokenEnd = begin + token.size();
+            if (begin < tokenEnd && *begin == '+') {
+                ++begin;
+            }
+            float value = 0.0f;
+            std::from_chars(begin, tokenEnd, value);
+            return value;
+        }
+    };
+
+    // [begin, end) を改行ごとに切り出して渡す
+    template<typename LineFunction>
+    void ForEachLine(const char* begin, const char* end, LineFunction&& function) {
+        const char* current = begin;
+        while (current < end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(current, '\n', static_cast<size_t>(end - current)));
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            LineReader line{ current, lineEnd };
+            function(line);
+            current = lineEnd + 1;
+        }
+    }
+
+    template<typename LineFunction>
+    void ForEachLine(const MappedFile& file, LineFunction&& function) {
+        ForEachLine(file.GetData(), file.GetData() + file.GetSize(), function);
+    }
+
+    // 各要素の数 (配列を先に確保して、読み込み中の再確保を無くす)
+    struct ObjCounts {
+        size_t positionCount = 0;
+        size_t texcoordCount = 0;
+        size_t normalCount = 0;
+        size_t faceCount = 0;
+        // 扇形に分けた後の三角形の数
+        size_t triangleCount = 0;
+    };
+
+    // 並列で読むときは各範囲の先頭位置をこの数から決めるので、読み込みと同じ判定で数える
+    ObjCounts CountElements(const char* begin, const char* end) {
+        ObjCounts counts;
+        ForEachLine(begin, end, [&counts](LineReader& line) {
+            const std::string_view identifier = line.NextToken();
+            if (identifier.empty() || identifier.size() > 2 || identifier[0] == '#') {
+                return;
+            }
+            if (identifier == "v") {
+                ++counts.positionCount;
+            } else if (identifier == "vt") {
+                ++counts.texcoordCount;
+            } else if (identifier == "vn") {
+                ++counts.normalCount;
+            } else if (identifier == "f") {
+                ++counts.faceCount;
+                size_t vertexCount = 0;
+                while (!line.NextToken().empty()) {
+                    ++vertexCount;
+                }
+                counts.triangleCount += vertexCount > 2 ? vertexCount - 2 : 0;
+            }
+        });
+        return counts;
+    }
+
+    // OBJ の番号 (1 始まり、負なら末尾から数える) を配列の添字にする
+    // count はその行までに現れた要素の数。省略されていたり範囲外なら -1
+    int64_t ResolveIndex(std::string_view text, size_t count) {
+        if (text.empty()) {
+            return -1;
+        }
+        int64_t index = 0;
+        const auto [ptr, error] = std::from_chars(text.data(), text.data() + text.size(), index);
+        if (error != std::errc()) {
+            return -1;
+        }
+        index = (index < 0) ? static_cast<int64_t>(count) + index : index - 1;
+        return (index >= 0 && index < static_cast<int64_t>(count)) ? index : -1;
+    }
+
+    Vector4 ParsePosition(LineReader& line) {
+        Vector4 p{};
+        p.x = line.NextFloat();
+        p.y = line.NextFloat();
+        p.z = line.NextFloat();
+        p.w = 1.0f;
+        return p;
+    }
+
+    Vector2 ParseTexcoord(LineReader& line) {
+        Vector2 uv{};
+        uv.x = line.NextFloat();
+        uv.y = line.NextFloat();
+        uv.y = 1.0f - uv.y;
+        return uv;
+    }
+
+    Vector3 ParseNormal(LineReader& line) {
+        Vector3 n{};
+        n.x = line.NextFloat();
+        n.y = line.NextFloat();
+        n.z = line.NextFloat();
+        n.x *= -1.0f;
+        return n;
+    }
+
+    // 面から参照できる頂点要素 (各 count はその行までに現れた数)
+    struct FaceAttributes {
+        const Vector4* positions;
+        size_t positionCount;
+        const Vector2* texcoords;
+        size_t texcoordCount;
+        const Vector3* normals;
+        size_t normalCount;
+    };
+
+    // 面の頂点 "p/t/n" を頂点データにする (t / n が無ければ 0)
+    ModelData::VertexData MakeFaceVertex(std::string_view definition, const FaceAttributes& attributes) {
+        std::string_view fields[3];
+        for (int e = 0; e < 3; ++e) {
+            const size_t slash = definition.find('/');
+            fields[e] = definition.substr(0, slash);
+            if (slash == std::string_view::npos) {
+                break;
+            }
+            definition.remove_prefix(slash + 1);
+        }
+
+        ModelData::VertexData vertex{ { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+        const int64_t positionIndex = ResolveIndex(fields[0], attributes.positionCount);
+        const int64_t texcoordIndex = ResolveIndex(fields[1], attributes.texcoordCount);
+        const int64_t normalIndex = ResolveIndex(fields[2], attributes.normalCount);
+        if (positionIndex >= 0) {
+            vertex.position = attributes.positions[positionIndex];
+            vertex.position.x *= -1.0f;
+        }
+        if (texcoordIndex >= 0) {
+            vertex.texcoord = attributes.texcoords[texcoordIndex];
+        }
+        if (normalIndex >= 0) {
+            vertex.normal = attributes.normals[normalIndex];
+        }
+        return vertex;
+    }
+
+    // 面の行 (識別子の後) を扇形に三角形へ分け、x 反転に合わせて巻き順を逆にして渡す
+    // 頂点が 2 つ未満の行は面として扱わず false を返す
+    template<typename TriangleFunction>
+    bool ForEachFaceTriangle(LineReader& line, const FaceAttributes& attributes, TriangleFunction&& function) {
+        const std::string_view first = line.NextToken();
+        std::string_view previous = line.NextToken();
+        if (first.empty() || previous.empty()) {
+            return false;
+        }
+        const ModelData::VertexData v0 = MakeFaceVertex(first, attributes);
+        ModelData::VertexData v1 = MakeFaceVertex(previous, attributes);
+        for (std::string_view token = line.NextToken(); !token.empty(); token = line.NextToken()) {
+            const ModelData::VertexData v2 = MakeFaceVertex(token, attributes);
+            function(v2, v1, v0);
+            v1 = v2;
+        }
+        return true;
+    }
+
+    // o / g / usemtl / mtllib によるサブメッシュとマテリアルの組み立て
+    // o / g / usemtl の後、最初の面でサブメッシュを始める (面の無い区切りは作らない)
+    class SubmeshTracker {
+    public:
+        SubmeshTracker(ModelData& modelData, const std::string& directoryPath, std::vector<std::string>* materialLibraries)
+            : modelData_(modelData), directoryPath_(directoryPath), materialLibraries_(materialLibraries) {}
+
+        void SetName(std::string_view name) {
+            currentName_ = name;
+            isSubmeshChanged_ = true;
+        }
+
+        // usemtl の名前からマテリアル番号を引く (MTL に無ければテクスチャ無しで追加する)
+        void UseMaterial(std::string_view name) {
+            currentMaterial_ = static_cast<uint32_t>(modelData_.materials.size());
+            for (size_t i = 0; i < modelData_.materials.size(); ++i) {
+                if (modelData_.materials[i].name == name) {
+                    currentMaterial_ = static_cast<uint32_t>(i);
+                    break;
+                }
+            }
+            if (currentMaterial_ == modelData_.materials.size()) {
+                modelData_.materials.emplace_back().name = name;
+            }
+            isSubmeshChanged_ = true;
+        }
+
+        void AddMaterialLibrary(std::string_view filename) {
+            const std::string materialFilename(filename);
+            if (materialLibraries_) {
+                materialLibraries_->push_back(materialFilename);
+            }
+            for (ModelData::MaterialData& material : ObjLoader::LoadMaterialTemplateFile(directoryPath_, materialFilename)) {
+                modelData_.materials.push_back(std::move(material));
+            }
+        }
+
+        // 面の最初の頂点番号の位置
+        void BeginFace(size_t indexStart) {
+            if (isSubmeshChanged_) {
+                modelData_.submeshes.push_back({ currentName_, static_cast<uint32_t>(indexStart), 0, currentMaterial_ });
+                isSubmeshChanged_ = false;
+            }
+        }
+
+        // サブメッシュの範囲を次のサブメッシュの先頭 (最後は全体の末尾) までにする
+        void Finish() {
+            for (size_t i = 0; i < modelData_.submeshes.size(); ++i) {
+                const size_t end = (i + 1 < modelData_.submeshes.size()) ? modelData_.submeshes[i + 1].indexStart : modelData_.indices.size();
+                modelData_.submeshes[i].indexCount = static_cast<uint32_t>(end) - modelData_.submeshes[i].indexStart;
+            }
+            // usemtl の無い面は 0 番のマテリアルで描く
+            if (modelData_.materials.empty()) {
+                modelData_.materials.emplace_back();
+            }
+        }
+
+    private:
+        ModelData& modelData_;
+        const std::string& directoryPath_;
+        std::vector<std::string>* materialLibraries_;
+        std::string currentName_;
+        uint32_t currentMaterial_ = 0;
+        bool isSubmeshChanged_ = true;
+    };
+
+    // 並列で読むときの 1 範囲 (行の途中では切らない)
+    struct ObjChunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        ObjCounts counts;
+        // この範囲より前にある要素の数
+        size_t positionStart = 0;
+        size_t texcoordStart = 0;
+        size_t normalStart = 0;
+        size_t cornerStart = 0;
+
+        // サブメッシュに関わる行 (後で先頭から順に SubmeshTracker へ渡す)
+        enum class EventType { Name, Material, Library, Face };
+        struct Event {
+            EventType type;
+            std::string_view text;
+            size_t cornerIndex;
+        };
+        std::vector<Event> events;
+    };
+
+    // 1 範囲の大きさの下限 (これより小さいファイルは 1 スレッドで読む)
+    constexpr size_t kMinChunkBytes = 1024 * 1024;
+}
+
+std::vector<ModelData::MaterialData> ObjLoader::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
+    std::vector<ModelData::MaterialData> materials;
+    MappedFile file;
+    if (!file.Open(directoryPath + "/" + filename)) return materials;
+
+    ForEachLine(file, [&](LineReader& line) {
+        const std::string_view identifier = line.NextToken();
+        if (identifier == "newmtl") {
+            materials.emplace_back().name = line.NextToken();
+        } else if (identifier == "map_Kd") {
+            if (materials.empty()) {
+                materials.emplace_back();
+            }
+            const std::string_view textureFilename = line.NextToken();
+            materials.back().textureFilePath = directoryPath + "/";
+            materials.back().textureFilePath.append(textureFilename);
+        }
+    });
+    return materials;
+}
+
+ModelData ObjLoader::LoadObjFile(const std::string& directoryPath, const std::string& filename, std::vector<std::string>* materialLibraries) {
+    ModelData modelData;
+    MappedFile file;
+    const bool isOpen = file.Open(directoryPath + "/" + filename);
+    assert(isOpen);
+    if (!isOpen) {
+        return modelData;
+    }
+
+    const ObjCounts counts = CountElements(file.GetData(), file.GetData() + file.GetSize());
+    std::vector<Vector4> positions;
+    std::vector<Vector3> normals;
+    std::vector<Vector2> texcoords;
+    positions.reserve(counts.positionCount);
+    normals.reserve(counts.normalCount);
+    texcoords.reserve(counts.texcoordCount);
+    modelData.indices.reserve(counts.triangleCount * 3);
+    // 同じ位置・UV・法線の組は 1 つの頂点にまとめる (サブメッシュをまたいでも共有する)
+    MeshBuilder builder(modelData, (std::max)({ counts.positionCount, counts.texcoordCount, counts.normalCount }));
+    SubmeshTracker submeshTracker(modelData, directoryPath, materialLibraries);
+
+    ForEachLine(file, [&](LineReader& line) {
+        const std::string_view identifier = line.NextToken();
+
+        if (identifier == "v") {
+            positions.push_back(ParsePosition(line));
+        } else if (identifier == "vt") {
+            texcoords.push_back(ParseTexcoord(line));
+        } else if (identifier == "vn") {
+            normals.push_back(ParseNormal(line));
+        } else if (identifier == "f") {
+            const FaceAttributes attributes{ positions.data(), positions.size(), texcoords.data(), texcoords.size(), normals.data(), normals.size() };
+            const size_t indexStart = modelData.indices.size();
+            if (ForEachFaceTriangle(line, attributes, [&builder](const ModelData::VertexData& v0, const ModelData::VertexData& v1, const ModelData::VertexData& v2) {
+                builder.AddTriangle(v0, v1, v2);
+            })) {
+                submeshTracker.BeginFace(indexStart);
+            }
+        } else if (identifier == "o" || identifier == "g") {
+            submeshTracker.SetName(line.NextToken());
+        } else if (identifier == "usemtl") {
+            submeshTracker.UseMaterial(line.NextToken());
+        } else if (identifier == "mtllib") {
+            submeshTracker.AddMaterialLibrary(line.NextToken());
+        }
+    });
+
+    submeshTracker.Finish();
+    return modelData;
+}
+
+ModelData ObjLoader::LoadObjFileParallel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount, std::vector<std::string>* materialLibraries) {
+    if (threadCount == 0) {
+        threadCount = Parallel::GetDefaultThreadCount();
+    }
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(directoryPath + "/" + filename, error);
+    if (error || threadCount <= 1 || fileSize < kMinChunkBytes * 2) {
+        return LoadObjFile(directoryPath, filename, materialLibraries);
+    }
+
+    ModelData modelData;
+    MappedFile file;
+    const bool isOpen = file.Open(directoryPath + "/" + filename);
+    assert(isOpen);
+    if (!isOpen) {
+        return modelData;
+    }
+
+    // 空いたスレッドが次の範囲を取れるよう、スレッド数より多めに分ける
+    const char* const fileBegin = file.GetData();
+    const char* const fileEnd = fileBegin + file.GetSize();
+    const size_t chunkCount = (std::min)(file.GetSize() / kMinChunkBytes, static_cast<size_t>(threadCount) * 4);
+    std::vector<ObjChunk> chunks(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const char* begin = fileBegin + file.GetSize() * i / chunkCount;
+        if (i > 0) {
+            // 直前の改行の次から始める (前の範囲の終わりと同じ位置)
+            const char* newline = static_cast<const char*>(std::memchr(begin - 1, '\n', static_cast<size_t>(fileEnd - (begin - 1))));
+            begin = newline ? newline + 1 : fileEnd;
+        }
+        chunks[i].begin = begin;
+        if (i > 0) {
+            chunks[i - 1].end = begin;
+        }
+    }
+    chunks.back().end = fileEnd;
+
+    // 1. 範囲ごとに要素を数え、前の範囲までの合計から書き込む位置を決める
+    Parallel::For(chunkCount, threadCount, [&](size_t i) {
+        chunks[i].counts = CountElements(chunks[i].begin, chunks[i].end);
+    });
+    ObjCounts total;
+    for (ObjChunk& chunk : chunks) {
+        chunk.positionStart = total.positionCount;
+        chunk.texcoordStart = total.texcoordCount;
+        chunk.normalStart = total.normalCount;
+        chunk.cornerStart = total.triangleCount * 3;
+        total.positionCount += chunk.counts.positionCount;
+        total.texcoordCount += chunk.counts.texcoordCount;
+        total.normalCount += chunk.counts.normalCount;
+        total.triangleCount += chunk.counts.triangleCount;
+    }
+
+    // 2. v / vt / vn を範囲ごとに読む
+    std::vector<Vector4> positions(total.positionCount);
+    std::vector<Vector2> texcoords(total.texcoordCount);
+    std::vector<Vector3> normals(total.normalCount);
+    Parallel::For(chunkCount, threadCount, [&](size_t i) {
+        Vector4* position = positions.data() + chunks[i].positionStart;
+        Vector2* texcoord = texcoords.data() + chunks[i].texcoordStart;
+        Vector3* normal = normals.data() + chunks[i].normalStart;
+        ForEachLine(chunks[i].begin, chunks[i].end, [&](LineReader& line) {
+            const std::string_view identifier = line.NextToken();
+            if (identifier == "v") {
+                *position++ = ParsePosition(line);
+            } else if (identifier == "vt") {
+                *texcoord++ = ParseTexcoord(line);
+            } else if (identifier == "vn") {
+                *normal++ = ParseNormal(line);
+            }
+        });
+    });
+
+    // 3. f を範囲ごとに三角形の頂点へ展開する
+    // 参照できる要素は、1 つの順で読んだときと同じくその行までに現れたものに限る
+    std::vector<ModelData::VertexData> corners(total.triangleCount * 3);
+    Parallel::For(chunkCount, threadCount, [&](size_t i) {
+        ObjChunk& chunk = chunks[i];
+        FaceAttributes attributes{ positions.data(), chunk.positionStart, texcoords.data(), chunk.texcoordStart, normals.data(), chunk.normalStart };
+        size_t cornerIndex = chunk.cornerStart;
+        // 前の範囲で区切りが変わっているかもしれないので、範囲の最初の面も記録する
+        bool isFaceEventNeeded = true;
+        ForEachLine(chunk.begin, chunk.end, [&](LineReader& line) {
+            const std::string_view identifier = line.NextToken();
+            if (identifier == "v") {
+                ++attributes.positionCount;
+            } else if (identifier == "vt") {
+                ++attributes.texcoordCount;
+            } else if (identifier == "vn") {
+                ++attributes.normalCount;
+            } else if (identifier == "f") {
+                const size_t faceStart = cornerIndex;
+                if (ForEachFaceTriangle(line, attributes, [&](const ModelData::VertexData& v0, const ModelData::VertexData& v1, const ModelData::VertexData& v2) {
+                    corners[cornerIndex++] = v0;
+                    corners[cornerIndex++] = v1;
+                    corners[cornerIndex++] = v2;
+                }) && isFaceEventNeeded) {
+                    chunk.events.push_back({ ObjChunk::EventType::Face, {}, faceStart });
+                    isFaceEventNeeded = false;
+                }
+            } else if (identifier == "o" || identifier == "g") {
+                chunk.events.push_back({ ObjChunk::EventType::Name, line.NextToken(), cornerIndex });
+                isFaceEventNeeded = true;
+            } else if (identifier == "usemtl") {
+                chunk.events.push_back({ ObjChunk::EventType::Material, line.NextToken(), cornerIndex });
+                isFaceEventNeeded = true;
+            } else if (identifier == "mtllib") {
+                chunk.events.push_back({ ObjChunk::EventType::Library, line.NextToken(), cornerIndex });
+            }
+        });
+    });
+
+    // 4. サブメッシュとマテリアルはファイルの順に組み立てる
+    SubmeshTracker submeshTracker(modelData, directoryPath, materialLibraries);
+    for (const ObjChunk& chunk : chunks) {
+        for (const ObjChunk::Event& event : chunk.events) {
+            switch (event.type) {
+            case ObjChunk::EventType::Name:
+                submeshTracker.SetName(event.text);
+                break;
+            case ObjChunk::EventType::Material:
+                submeshTracker.UseMaterial(event.text);
+                break;
+            case ObjChunk::EventType::Library:
+                submeshTracker.AddMaterialLibrary(event.text);
+                break;
+            case ObjChunk::EventType::Face:
+                submeshTracker.BeginFace(event.cornerIndex);
+                break;
+            }
+        }
+    }
+
+    // 5. 頂点をまとめる (1 つの順で読んだときと同じ番号になる)
+    MeshBuilder::BuildIndexedParallel(corners.data(), corners.size(), modelData, threadCount);
+    submeshTracker.Finish();
+    return modelData;
+}
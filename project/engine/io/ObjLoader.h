@@ -0,0 +1,20 @@
+#pragma once
+#include "ModelData.h"
+#include <string>
+#include <vector>
+
+// OBJ / MTL の読み込み
+// ファイルをメモリにマップし、行ごとのコピーをせずに std::from_chars で直接数値を読む
+// 右手系の OBJ を左手系へ変換する (x 反転・巻き順反転・v 反転)
+namespace ObjLoader {
+    // newmtl ごとのマテリアル (ファイルの順)
+    std::vector<ModelData::MaterialData> LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename);
+    // 4 頂点以上の面は扇形に三角形へ分ける
+    // o / g / usemtl が変わるたびに新しいサブメッシュを始める (頂点と頂点番号は全体で 1 つ)
+    // materialLibraries を渡すと、mtllib で参照した MTL のファイル名 (directoryPath からの相対) を追加する
+    ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename, std::vector<std::string>* materialLibraries = nullptr);
+    // LoadObjFile と同じ結果を複数のスレッドで作る (threadCount が 0 なら論理コア数)
+    // ファイルを行の境目で分け、v / vt / vn を読んだ後に、範囲ごとの要素数の累積から f の番号を解決する
+    // 小さいファイル (2 MB 未満) は LoadObjFile で読む
+    ModelData LoadObjFileParallel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount = 0, std::vector<std::string>* materialLibraries = nullptr);
+}
@@ -0,0 +1,88 @@
+#include "CpuFeature.h"
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_FEATURE_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+    struct Features {
+        bool sse2 = false;
+        bool sse41 = false;
+        bool avx = false;
+        bool avx2 = false;
+        bool fma = false;
+    };
+
+#if defined(CPU_FEATURE_X86)
+    void CpuId(int leaf, int subLeaf, int regs[4]) {
+#if defined(_MSC_VER)
+        __cpuidex(regs, leaf, subLeaf);
+#else
+        unsigned int a = 0, b = 0, c = 0, d = 0;
+        __cpuid_count(static_cast<unsigned int>(leaf), static_cast<unsigned int>(subLeaf), a, b, c, d);
+        regs[0] = static_cast<int>(a);
+        regs[1] = static_cast<int>(b);
+        regs[2] = static_cast<int>(c);
+        regs[3] = static_cast<int>(d);
+#endif
+    }
+
+    uint64_t ReadXcr0() {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax = 0, edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+#endif
+
+    Features Detect() {
+        Features features;
+#if defined(CPU_FEATURE_X86)
+        int regs[4] = {};
+        CpuId(0, 0, regs);
+        const int maxLeaf = regs[0];
+        if (maxLeaf < 1) {
+            return features;
+        }
+
+        CpuId(1, 0, regs);
+        features.sse2 = (regs[3] & (1 << 26)) != 0;
+        features.sse41 = (regs[2] & (1 << 19)) != 0;
+
+        // AVX は CPU だけでなく OS が YMM レジスタを保存している必要がある
+        const bool osxsave = (regs[2] & (1 << 27)) != 0;
+        const bool cpuAvx = (regs[2] & (1 << 28)) != 0;
+        const bool cpuFma = (regs[2] & (1 << 12)) != 0;
+        const bool osYmm = osxsave && ((ReadXcr0() & 0x6) == 0x6);
+        features.avx = cpuAvx && osYmm;
+        features.fma = cpuFma && osYmm;
+
+        if (maxLeaf >= 7) {
+            CpuId(7, 0, regs);
+            features.avx2 = features.avx && (regs[1] & (1 << 5)) != 0;
+        }
+#endif
+        return features;
+    }
+
+    const Features& GetFeatures() {
+        static const Features features = Detect();
+        return features;
+    }
+}
+
+bool CpuFeature::HasSSE2() { return GetFeatures().sse2; }
+bool CpuFeature::HasSSE41() { return GetFeatures().sse41; }
+bool CpuFeature::HasAVX() { return GetFeatures().avx; }
+bool CpuFeature::HasAVX2() { return GetFeatures().avx2; }
+bool CpuFeature::HasFMA() { return GetFeatures().fma; }
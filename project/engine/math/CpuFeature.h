@@ -0,0 +1,10 @@
+#pragma once
+
+// 実行中の CPU が対応している命令セット
+namespace CpuFeature {
+    bool HasSSE2();
+    bool HasSSE41();
+    bool HasAVX();
+    bool HasAVX2();
+    bool HasFMA();
+}
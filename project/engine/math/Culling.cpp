@@ -0,0 +1,519 @@
+#include "Culling.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+using namespace MatrixMath;
+
+void AabbSoA::Clear() {
+    for (std::vector<float>* stream : { &minX_, &minY_, &minZ_, &maxX_, &maxY_, &maxZ_ }) {
+        stream->clear();
+    }
+}
+
+void AabbSoA::Reserve(size_t count) {
+    for (std::vector<float>* stream : { &minX_, &minY_, &minZ_, &maxX_, &maxY_, &maxZ_ }) {
+        stream->reserve(count);
+    }
+}
+
+void AabbSoA::PushBack(const Aabb& aabb) {
+    minX_.push_back(aabb.min.x);
+    minY_.push_back(aabb.min.y);
+    minZ_.push_back(aabb.min.z);
+    maxX_.push_back(aabb.max.x);
+    maxY_.push_back(aabb.max.y);
+    maxZ_.push_back(aabb.max.z);
+}
+
+AabbStreams AabbSoA::GetStreams() const {
+    AabbStreams streams;
+    streams.minX = minX_.data();
+    streams.minY = minY_.data();
+    streams.minZ = minZ_.data();
+    streams.maxX = maxX_.data();
+    streams.maxY = maxY_.data();
+    streams.maxZ = maxZ_.data();
+    streams.count = Size();
+    return streams;
+}
+
+void SphereSoA::Clear() {
+    for (std::vector<float>* stream : { &centerX_, &centerY_, &centerZ_, &radius_ }) {
+        stream->clear();
+    }
+}
+
+void SphereSoA::Reserve(size_t count) {
+    for (std::vector<float>* stream : { &centerX_, &centerY_, &centerZ_, &radius_ }) {
+        stream->reserve(count);
+    }
+}
+
+void SphereSoA::PushBack(const BoundingSphere& sphere) {
+    centerX_.push_back(sphere.center.x);
+    centerY_.push_back(sphere.center.y);
+    centerZ_.push_back(sphere.center.z);
+    radius_.push_back(sphere.radius);
+}
+
+SphereStreams SphereSoA::GetStreams() const {
+    SphereStreams streams;
+    streams.centerX = centerX_.data();
+    streams.centerY = centerY_.data();
+    streams.centerZ = centerZ_.data();
+    streams.radius = radius_.data();
+    streams.count = Size();
+    return streams;
+}
+
+namespace {
+    // 平面を法線の長さで正規化して frustum の index 番目に書き込む
+    void SetPlane(Frustum& frustum, size_t index, float a, float b, float c, float d) {
+        const float lengthSquared = a * a + b * b + c * c;
+        const float inverseLength = (lengthSquared <= 0.000001f) ? 1.0f : 1.0f / std::sqrt(lengthSquared);
+        frustum.normalX[index] = a * inverseLength;
+        frustum.normalY[index] = b * inverseLength;
+        frustum.normalZ[index] = c * inverseLength;
+        frustum.distance[index] = d * inverseLength;
+    }
+
+    // AABB は中心と半径 (extent) で判定する
+    // 平面から最も内側にある頂点までの距離 = n・center + |n|・extent
+    bool IsAabbVisibleScalar(const Frustum& frustum, float minX, float minY, float minZ, float maxX, float maxY, float maxZ) {
+        const float centerX = (minX + maxX) * 0.5f;
+        const float centerY = (minY + maxY) * 0.5f;
+        const float centerZ = (minZ + maxZ) * 0.5f;
+        const float extentX = (maxX - minX) * 0.5f;
+        const float extentY = (maxY - minY) * 0.5f;
+        const float extentZ = (maxZ - minZ) * 0.5f;
+        for (size_t i = 0; i < Frustum::kPlaneCount; ++i) {
+            const float distance = frustum.normalX[i] * centerX + frustum.normalY[i] * centerY + frustum.normalZ[i] * centerZ + frustum.distance[i];
+            const float radius = std::fabs(frustum.normalX[i]) * extentX + std::fabs(frustum.normalY[i]) * extentY + std::fabs(frustum.normalZ[i]) * extentZ;
+            if (distance + radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool IsSphereVisibleScalar(const Frustum& frustum, float centerX, float centerY, float centerZ, float radius) {
+        for (size_t i = 0; i < Frustum::kPlaneCount; ++i) {
+            const float distance = frustum.normalX[i] * centerX + frustum.normalY[i] * centerY + frustum.normalZ[i] * centerZ + frustum.distance[i];
+            if (distance + radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void SetMaskBits(uint64_t* visibleMask, size_t first, uint64_t bits) {
+        // first は 4 の倍数なので 64 ビット境界をまたがない
+        visibleMask[first / 64] |= bits << (first % 64);
+    }
+
+    // 行ベクトル規約のアフィン変換 (点は平行移動を含め、向きは 3x3 部分だけ)
+    Vector3 TransformPointScalar(const Vector3& p, const Matrix4x4& matrix) {
+        const float (*m)[4] = matrix.m;
+        return {
+            p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0],
+            p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1],
+            p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2] };
+    }
+
+    Vector3 TransformDirectionScalar(const Vector3& d, const Matrix4x4& matrix) {
+        const float (*m)[4] = matrix.m;
+        return {
+            d.x * m[0][0] + d.y * m[1][0] + d.z * m[2][0],
+            d.x * m[0][1] + d.y * m[1][1] + d.z * m[2][1],
+            d.x * m[0][2] + d.y * m[1][2] + d.z * m[2][2] };
+    }
+
+    Aabb TransformAabbScalar(const Aabb& aabb, const Matrix4x4& matrix) {
+        // 中心は点として変換し、半径は 3x3 部分の絶対値で広げる
+        const float center[3] = { (aabb.min.x + aabb.max.x) * 0.5f, (aabb.min.y + aabb.max.y) * 0.5f, (aabb.min.z + aabb.max.z) * 0.5f };
+        const float extent[3] = { (aabb.max.x - aabb.min.x) * 0.5f, (aabb.max.y - aabb.min.y) * 0.5f, (aabb.max.z - aabb.min.z) * 0.5f };
+        float worldCenter[3];
+        float worldExtent[3];
+        for (int col = 0; col < 3; ++col) {
+            worldCenter[col] = matrix.m[3][col];
+            worldExtent[col] = 0.0f;
+            for (int row = 0; row < 3; ++row) {
+                worldCenter[col] += center[row] * matrix.m[row][col];
+                worldExtent[col] += extent[row] * std::fabs(matrix.m[row][col]);
+            }
+        }
+        return {
+            { worldCenter[0] - worldExtent[0], worldCenter[1] - worldExtent[1], worldCenter[2] - worldExtent[2] },
+            { worldCenter[0] + worldExtent[0], worldCenter[1] + worldExtent[1], worldCenter[2] + worldExtent[2] }
+        };
+    }
+
+    BoundingSphere TransformSphereScalar(const BoundingSphere& sphere, const Matrix4x4& matrix) {
+        const float (*m)[4] = matrix.m;
+        // 行どうしの内積 g[i][j] の行列 (M * M^T) の最大固有値が拡大率の最大の 2 乗
+        float g[3][3];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                g[i][j] = m[i][0] * m[j][0] + m[i][1] * m[j][1] + m[i][2] * m[j][2];
+            }
+        }
+        // Gershgorin の評価 (行の絶対値の和の最大) と、固有値の和 (フロベニウスノルムの 2 乗) の小さい方
+        float maxScaleSq = 0.0f;
+        for (int i = 0; i < 3; ++i) {
+            maxScaleSq = (std::max)(maxScaleSq, std::fabs(g[i][0]) + std::fabs(g[i][1]) + std::fabs(g[i][2]));
+        }
+        maxScaleSq = (std::min)(maxScaleSq, g[0][0] + g[1][1] + g[2][2]);
+        return { TransformPointScalar(sphere.center, matrix), sphere.radius * std::sqrt(maxScaleSq) };
+    }
+
+    Obb TransformObbScalar(const Obb& obb, const Matrix4x4& matrix) {
+        Obb result;
+        result.center = TransformPointScalar(obb.center, matrix);
+        const float halfExtent[3] = { obb.halfExtent.x, obb.halfExtent.y, obb.halfExtent.z };
+        float worldHalfExtent[3];
+        for (int i = 0; i < 3; ++i) {
+            const Vector3 axis = TransformDirectionScalar(obb.axis[i], matrix);
+            const float length = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+            // 潰れた軸は向きを残し、長さ 0 にする
+            result.axis[i] = length > 0.0f ? Vector3{ axis.x / length, axis.y / length, axis.z / length } : obb.axis[i];
+            worldHalfExtent[i] = halfExtent[i] * length;
+        }
+        result.halfExtent = { worldHalfExtent[0], worldHalfExtent[1], worldHalfExtent[2] };
+        return result;
+    }
+
+#if defined(MATH_SIMD_X86)
+    // first から 4 要素ずつ判定し、処理済みの要素数を返す
+    size_t CullAabbsSSE(const Frustum& frustum, const AabbStreams& aabbs, size_t first, uint64_t* visibleMask) {
+        const __m128 half = _mm_set1_ps(0.5f);
+        size_t i = first;
+        for (; i + 4 <= aabbs.count; i += 4) {
+            const __m128 minX = _mm_loadu_ps(aabbs.minX + i);
+            const __m128 minY = _mm_loadu_ps(aabbs.minY + i);
+            const __m128 minZ = _mm_loadu_ps(aabbs.minZ + i);
+            const __m128 maxX = _mm_loadu_ps(aabbs.maxX + i);
+            const __m128 maxY = _mm_loadu_ps(aabbs.maxY + i);
+            const __m128 maxZ = _mm_loadu_ps(aabbs.maxZ + i);
+            const __m128 centerX = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+            const __m128 centerY = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+            const __m128 centerZ = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+            const __m128 extentX = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+            const __m128 extentY = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+            const __m128 extentZ = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+            __m128 outside = _mm_setzero_ps();
+            for (size_t p = 0; p < Frustum::kPlaneCount; ++p) {
+                const __m128 distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(frustum.normalX[p]), centerX), _mm_mul_ps(_mm_set1_ps(frustum.normalY[p]), centerY)),
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(frustum.normalZ[p]), centerZ), _mm_set1_ps(frustum.distance[p])));
+                const __m128 radius = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::fabs(frustum.normalX[p])), extentX), _mm_mul_ps(_mm_set1_ps(std::fabs(frustum.normalY[p])), extentY)),
+                    _mm_mul_ps(_mm_set1_ps(std::fabs(frustum.normalZ[p])), extentZ));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+            SetMaskBits(visibleMask, i, static_cast<uint64_t>(~_mm_movemask_ps(outside) & 0xF));
+        }
+        return i;
+    }
+
+    size_t CullSpheresSSE(const Frustum& frustum, const SphereStreams& spheres, size_t first, uint64_t* visibleMask) {
+        size_t i = first;
+        for (; i + 4 <= spheres.count; i += 4) {
+            const __m128 centerX = _mm_loadu_ps(spheres.centerX + i);
+            const __m128 centerY = _mm_loadu_ps(spheres.centerY + i);
+            const __m128 centerZ = _mm_loadu_ps(spheres.centerZ + i);
+            const __m128 radius = _mm_loadu_ps(spheres.radius + i);
+
+            __m128 outside = _mm_setzero_ps();
+            for (size_t p = 0; p < Frustum::kPlaneCount; ++p) {
+                const __m128 distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(frustum.normalX[p]), centerX), _mm_mul_ps(_mm_set1_ps(frustum.normalY[p]), centerY)),
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(frustum.normalZ[p]), centerZ), _mm_set1_ps(frustum.distance[p])));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+            SetMaskBits(visibleMask, i, static_cast<uint64_t>(~_mm_movemask_ps(outside) & 0xF));
+        }
+        return i;
+    }
+
+    // first から 8 要素ずつ判定し、処理済みの要素数を返す
+    MATH_TARGET_AVX size_t CullAabbsAVX(const Frustum& frustum, const AabbStreams& aabbs, size_t first, uint64_t* visibleMask) {
+        const __m256 half = _mm256_set1_ps(0.5f);
+        size_t i = first;
+        for (; i + 8 <= aabbs.count; i += 8) {
+            const __m256 minX = _mm256_loadu_ps(aabbs.minX + i);
+            const __m256 minY = _mm256_loadu_ps(aabbs.minY + i);
+            const __m256 minZ = _mm256_loadu_ps(aabbs.minZ + i);
+            const __m256 maxX = _mm256_loadu_ps(aabbs.maxX + i);
+            const __m256 maxY = _mm256_loadu_ps(aabbs.maxY + i);
+            const __m256 maxZ = _mm256_loadu_ps(aabbs.maxZ + i);
+            const __m256 centerX = _mm256_mul_ps(_mm256_add_ps(minX, maxX), half);
+            const __m256 centerY = _mm256_mul_ps(_mm256_add_ps(minY, maxY), half);
+            const __m256 centerZ = _mm256_mul_ps(_mm256_add_ps(minZ, maxZ), half);
+            const __m256 extentX = _mm256_mul_ps(_mm256_sub_ps(maxX, minX), half);
+            const __m256 extentY = _mm256_mul_ps(_mm256_sub_ps(maxY, minY), half);
+            const __m256 extentZ = _mm256_mul_ps(_mm256_sub_ps(maxZ, minZ), half);
+
+            __m256 outside = _mm256_setzero_ps();
+            for (size_t p = 0; p < Frustum::kPlaneCount; ++p) {
+                const __m256 distance = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(frustum.normalX[p]), centerX), _mm256_mul_ps(_mm256_set1_ps(frustum.normalY[p]), centerY)),
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(frustum.normalZ[p]), centerZ), _mm256_set1_ps(frustum.distance[p])));
+                const __m256 radius = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::fabs(frustum.normalX[p])), extentX), _mm256_mul_ps(_mm256_set1_ps(std::fabs(frustum.normalY[p])), extentY)),
+                    _mm256_mul_ps(_mm256_set1_ps(std::fabs(frustum.normalZ[p])), extentZ));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+            SetMaskBits(visibleMask, i, static_cast<uint64_t>(~_mm256_movemask_ps(outside) & 0xFF));
+        }
+        _mm256_zeroupper();
+        return i;
+    }
+
+    MATH_TARGET_AVX size_t CullSpheresAVX(const Frustum& frustum, const SphereStreams& spheres, size_t first, uint64_t* visibleMask) {
+        size_t i = first;
+        for (; i + 8 <= spheres.count; i += 8) {
+            const __m256 centerX = _mm256_loadu_ps(spheres.centerX + i);
+            const __m256 centerY = _mm256_loadu_ps(spheres.centerY + i);
+            const __m256 centerZ = _mm256_loadu_ps(spheres.centerZ + i);
+            const __m256 radius = _mm256_loadu_ps(spheres.radius + i);
+
+            __m256 outside = _mm256_setzero_ps();
+            for (size_t p = 0; p < Frustum::kPlaneCount; ++p) {
+                const __m256 distance = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(frustum.normalX[p]), centerX), _mm256_mul_ps(_mm256_set1_ps(frustum.normalY[p]), centerY)),
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(frustum.normalZ[p]), centerZ), _mm256_set1_ps(frustum.distance[p])));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+            SetMaskBits(visibleMask, i, static_cast<uint64_t>(~_mm256_movemask_ps(outside) & 0xFF));
+        }
+        _mm256_zeroupper();
+        return i;
+    }
+
+    // 行列の 4 行をそのまま読む (行ベクトル規約なので、行 i は入力の成分 i に掛かる)
+    struct MatrixRowsSSE {
+        __m128 row[4];
+
+        explicit MatrixRowsSSE(const Matrix4x4& matrix) {
+            for (int i = 0; i < 4; ++i) {
+                row[i] = _mm_loadu_ps(matrix.m[i]);
+            }
+        }
+
+        __m128 TransformDirection(const Vector3& d) const {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(d.x), row[0]), _mm_mul_ps(_mm_set1_ps(d.y), row[1])),
+                _mm_mul_ps(_mm_set1_ps(d.z), row[2]));
+        }
+
+        __m128 TransformPoint(const Vector3& p) const {
+            return _mm_add_ps(TransformDirection(p), row[3]);
+        }
+    };
+
+    Vector3 StoreVector3(__m128 v) {
+        alignas(16) float value[4];
+        _mm_store_ps(value, v);
+        return { value[0], value[1], value[2] };
+    }
+
+    // a0・b0, a1・b1, a2・b2 の xyz の内積を 0, 1, 2 番目の成分に並べる
+    __m128 Dot3(__m128 a0, __m128 b0, __m128 a1, __m128 b1, __m128 a2, __m128 b2) {
+        __m128 x = _mm_mul_ps(a0, b0);
+        __m128 y = _mm_mul_ps(a1, b1);
+        __m128 z = _mm_mul_ps(a2, b2);
+        __m128 w = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        return _mm_add_ps(_mm_add_ps(x, y), z);
+    }
+
+    // a, b, c の xyz の長さの 2 乗を 0, 1, 2 番目の成分に並べる
+    __m128 LengthSquared3(__m128 a, __m128 b, __m128 c) {
+        return Dot3(a, a, b, b, c, c);
+    }
+
+    Aabb TransformAabbSSE(const Aabb& aabb, const Matrix4x4& matrix) {
+        const MatrixRowsSSE rows(matrix);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const Vector3 center = { (aabb.min.x + aabb.max.x) * 0.5f, (aabb.min.y + aabb.max.y) * 0.5f, (aabb.min.z + aabb.max.z) * 0.5f };
+        const __m128 worldCenter = rows.TransformPoint(center);
+        const __m128 worldExtent = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(_mm_set1_ps((aabb.max.x - aabb.min.x) * 0.5f), _mm_and_ps(rows.row[0], absMask)),
+            _mm_mul_ps(_mm_set1_ps((aabb.max.y - aabb.min.y) * 0.5f), _mm_and_ps(rows.row[1], absMask))),
+            _mm_mul_ps(_mm_set1_ps((aabb.max.z - aabb.min.z) * 0.5f), _mm_and_ps(rows.row[2], absMask)));
+        return { StoreVector3(_mm_sub_ps(worldCenter, worldExtent)), StoreVector3(_mm_add_ps(worldCenter, worldExtent)) };
+    }
+
+    BoundingSphere TransformSphereSSE(const BoundingSphere& sphere, const Matrix4x4& matrix) {
+        const MatrixRowsSSE rows(matrix);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        // 行どうしの内積の行列の対角 (g00, g11, g22, 0) と、絶対値にした対角の外 (|g01|, |g12|, |g20|, 0)
+        const __m128 diagonal = LengthSquared3(rows.row[0], rows.row[1], rows.row[2]);
+        const __m128 offDiagonal = _mm_and_ps(Dot3(rows.row[0], rows.row[1], rows.row[1], rows.row[2], rows.row[2], rows.row[0]), absMask);
+        // Gershgorin の評価: 行 i は g_ii + |g_i(i+1)| + |g_(i-1)i| (4 番目は 0)
+        __m128 scaleSq = _mm_add_ps(_mm_add_ps(diagonal, offDiagonal), _mm_shuffle_ps(offDiagonal, offDiagonal, _MM_SHUFFLE(3, 1, 0, 2)));
+        scaleSq = _mm_max_ps(scaleSq, _mm_shuffle_ps(scaleSq, scaleSq, _MM_SHUFFLE(1, 0, 3, 2)));
+        scaleSq = _mm_max_ss(scaleSq, _mm_shuffle_ps(scaleSq, scaleSq, _MM_SHUFFLE(2, 3, 0, 1)));
+        // 固有値の和 (フロベニウスノルムの 2 乗) の方が小さければそちら
+        __m128 trace = _mm_add_ps(diagonal, _mm_shuffle_ps(diagonal, diagonal, _MM_SHUFFLE(1, 0, 3, 2)));
+        trace = _mm_add_ss(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+        scaleSq = _mm_min_ss(scaleSq, trace);
+        return { StoreVector3(rows.TransformPoint(sphere.center)), sphere.radius * _mm_cvtss_f32(_mm_sqrt_ss(scaleSq)) };
+    }
+
+    Obb TransformObbSSE(const Obb& obb, const Matrix4x4& matrix) {
+        const MatrixRowsSSE rows(matrix);
+        const __m128 axis[3] = { rows.TransformDirection(obb.axis[0]), rows.TransformDirection(obb.axis[1]), rows.TransformDirection(obb.axis[2]) };
+        const __m128 length = _mm_sqrt_ps(LengthSquared3(axis[0], axis[1], axis[2]));
+        const __m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.0f), length);
+        const __m128 inverseLengths[3] = {
+            _mm_shuffle_ps(inverseLength, inverseLength, _MM_SHUFFLE(0, 0, 0, 0)),
+            _mm_shuffle_ps(inverseLength, inverseLength, _MM_SHUFFLE(1, 1, 1, 1)),
+            _mm_shuffle_ps(inverseLength, inverseLength, _MM_SHUFFLE(2, 2, 2, 2)) };
+        const int isCollapsed = _mm_movemask_ps(_mm_cmple_ps(length, _mm_setzero_ps()));
+        Obb result;
+        result.center = StoreVector3(rows.TransformPoint(obb.center));
+        for (int i = 0; i < 3; ++i) {
+            // 潰れた軸は向きを残し、長さ 0 にする
+            result.axis[i] = (isCollapsed & (1 << i)) ? obb.axis[i] : StoreVector3(_mm_mul_ps(axis[i], inverseLengths[i]));
+        }
+        result.halfExtent = StoreVector3(_mm_mul_ps(_mm_setr_ps(obb.halfExtent.x, obb.halfExtent.y, obb.halfExtent.z, 0.0f), length));
+        return result;
+    }
+#endif
+
+    size_t CountVisible(const uint64_t* visibleMask, size_t count) {
+        size_t visibleCount = 0;
+        for (size_t word = 0; word < Culling::GetMaskWordCount(count); ++word) {
+            visibleCount += static_cast<size_t>(std::popcount(visibleMask[word]));
+        }
+        return visibleCount;
+    }
+}
+
+Frustum Culling::ExtractFrustum(const Matrix4x4& viewProjection) {
+    // 行ベクトル規約なので行列の列から平面を取り出す
+    const Matrix4x4& m = viewProjection;
+    Frustum frustum;
+    SetPlane(frustum, 0, m.m[0][3] + m.m[0][0], m.m[1][3] + m.m[1][0], m.m[2][3] + m.m[2][0], m.m[3][3] + m.m[3][0]);
+    SetPlane(frustum, 1, m.m[0][3] - m.m[0][0], m.m[1][3] - m.m[1][0], m.m[2][3] - m.m[2][0], m.m[3][3] - m.m[3][0]);
+    SetPlane(frustum, 2, m.m[0][3] + m.m[0][1], m.m[1][3] + m.m[1][1], m.m[2][3] + m.m[2][1], m.m[3][3] + m.m[3][1]);
+    SetPlane(frustum, 3, m.m[0][3] - m.m[0][1], m.m[1][3] - m.m[1][1], m.m[2][3] - m.m[2][1], m.m[3][3] - m.m[3][1]);
+    SetPlane(frustum, 4, m.m[0][2], m.m[1][2], m.m[2][2], m.m[3][2]);
+    SetPlane(frustum, 5, m.m[0][3] - m.m[0][2], m.m[1][3] - m.m[1][2], m.m[2][3] - m.m[2][2], m.m[3][3] - m.m[3][2]);
+    return frustum;
+}
+
+Vector4 Culling::GetPlane(const Frustum& frustum, size_t index) {
+    return { frustum.normalX[index], frustum.normalY[index], frustum.normalZ[index], frustum.distance[index] };
+}
+
+bool Culling::IsVisible(const Frustum& frustum, const Aabb& aabb) {
+    return IsAabbVisibleScalar(frustum, aabb.min.x, aabb.min.y, aabb.min.z, aabb.max.x, aabb.max.y, aabb.max.z);
+}
+
+bool Culling::IsVisible(const Frustum& frustum, const BoundingSphere& sphere) {
+    return IsSphereVisibleScalar(frustum, sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius);
+}
+
+bool Culling::IntersectRay(const Ray& ray, const Aabb& aabb, float& hitDistance) {
+    // スラブ法 (direction の成分が 0 の場合は 1/0 = inf で処理される)
+    const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+    const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+    const float boxMin[3] = { aabb.min.x, aabb.min.y, aabb.min.z };
+    const float boxMax[3] = { aabb.max.x, aabb.max.y, aabb.max.z };
+
+    float tMin = 0.0f;
+    float tMax = ray.maxDistance;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (direction[axis] == 0.0f) {
+            if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) {
+                return false;
+            }
+            continue;
+        }
+        const float inverseDirection = 1.0f / direction[axis];
+        float t0 = (boxMin[axis] - origin[axis]) * inverseDirection;
+        float t1 = (boxMax[axis] - origin[axis]) * inverseDirection;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        tMin = (std::max)(tMin, t0);
+        tMax = (std::min)(tMax, t1);
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+    hitDistance = tMin;
+    return true;
+}
+
+Aabb Culling::TransformAabb(const Aabb& aabb, const Matrix4x4& matrix) {
+#if defined(MATH_SIMD_X86)
+    if (GetSimdLevel() != SimdLevel::Scalar) {
+        return TransformAabbSSE(aabb, matrix);
+    }
+#endif
+    return TransformAabbScalar(aabb, matrix);
+}
+
+BoundingSphere Culling::TransformSphere(const BoundingSphere& sphere, const Matrix4x4& matrix) {
+#if defined(MATH_SIMD_X86)
+    if (GetSimdLevel() != SimdLevel::Scalar) {
+        return TransformSphereSSE(sphere, matrix);
+    }
+#endif
+    return TransformSphereScalar(sphere, matrix);
+}
+
+Obb Culling::TransformObb(const Obb& obb, const Matrix4x4& matrix) {
+#if defined(MATH_SIMD_X86)
+    if (GetSimdLevel() != SimdLevel::Scalar) {
+        return TransformObbSSE(obb, matrix);
+    }
+#endif
+    return TransformObbScalar(obb, matrix);
+}
+
+size_t Culling::CullAabbs(const Frustum& frustum, const AabbStreams& aabbs, uint64_t* visibleMask) {
+    std::memset(visibleMask, 0, sizeof(uint64_t) * GetMaskWordCount(aabbs.count));
+
+    size_t i = 0;
+#if defined(MATH_SIMD_X86)
+    if (GetSimdLevel() == SimdLevel::AVX) {
+        i = CullAabbsAVX(frustum, aabbs, i, visibleMask);
+    }
+    if (GetSimdLevel() != SimdLevel::Scalar) {
+        i = CullAabbsSSE(frustum, aabbs, i, visibleMask);
+    }
+#endif
+    for (; i < aabbs.count; ++i) {
+        if (IsAabbVisibleScalar(frustum, aabbs.minX[i], aabbs.minY[i], aabbs.minZ[i], aabbs.maxX[i], aabbs.maxY[i], aabbs.maxZ[i])) {
+            visibleMask[i / 64] |= uint64_t{ 1 } << (i % 64);
+        }
+    }
+    return CountVisible(visibleMask, aabbs.count);
+}
+
+size_t Culling::CullSpheres(const Frustum& frustum, const SphereStreams& spheres, uint64_t* visibleMask) {
+    std::memset(visibleMask, 0, sizeof(uint64_t) * GetMaskWordCount(spheres.count));
+
+    size_t i = 0;
+#if defined(MATH_SIMD_X86)
+    if (GetSimdLevel() == SimdLevel::AVX) {
+        i = CullSpheresAVX(frustum, spheres, i, visibleMask);
+    }
+    if (GetSimdLevel() != SimdLevel::Scalar) {
+        i = CullSpheresSSE(frustum, spheres, i, visibleMask);
+    }
+#endif
+    for (; i < spheres.count; ++i) {
+        if (IsSphereVisibleScalar(frustum, spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i], spheres.radius[i])) {
+            visibleMask[i / 64] |= uint64_t{ 1 } << (i % 64);
+        }
+    }
+    return CountVisible(visibleMask, spheres.count);
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "Matrix4x4.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 軸平行境界ボックス
+struct Aabb {
+    Vector3 min;
+    Vector3 max;
+};
+
+// 境界球
+struct BoundingSphere {
+    Vector3 center;
+    float radius;
+};
+
+// 有向境界ボックス (center + Σ t[i] * halfExtent[i] * axis[i], -1 <= t[i] <= 1)
+// axis は正規化済み (ローカルで作ったものは直交する)
+struct Obb {
+    Vector3 center;
+    Vector3 axis[3];
+    Vector3 halfExtent;
+};
+
+// 半直線 (origin + direction * t, 0 <= t <= maxDistance)
+// direction は正規化しなくてよい (t は direction の長さ単位になる)
+struct Ray {
+    Vector3 origin;
+    Vector3 direction;
+    float maxDistance;
+};
+
+// 視錐台 (平面の係数を成分ごとに並べた SoA)
+// 平面 i は normalX[i] * x + normalY[i] * y + normalZ[i] * z + distance[i] >= 0 が内側 (法線は正規化済み)
+struct Frustum {
+    static constexpr size_t kPlaneCount = 6; // 左, 右, 下, 上, 近, 遠
+    float normalX[kPlaneCount];
+    float normalY[kPlaneCount];
+    float normalZ[kPlaneCount];
+    float distance[kPlaneCount];
+};
+
+// SoA 形式の AABB 列への参照 (各配列は count 要素)
+struct AabbStreams {
+    const float* minX = nullptr;
+    const float* minY = nullptr;
+    const float* minZ = nullptr;
+    const float* maxX = nullptr;
+    const float* maxY = nullptr;
+    const float* maxZ = nullptr;
+    size_t count = 0;
+};
+
+// SoA 形式の境界球列への参照 (各配列は count 要素)
+struct SphereStreams {
+    const float* centerX = nullptr;
+    const float* centerY = nullptr;
+    const float* centerZ = nullptr;
+    const float* radius = nullptr;
+    size_t count = 0;
+};
+
+// SoA 形式で AABB を保持するコンテナ
+class AabbSoA {
+public:
+    size_t Size() const { return minX_.size(); }
+    void Clear();
+    void Reserve(size_t count);
+    void PushBack(const Aabb& aabb);
+
+    AabbStreams GetStreams() const;
+
+private:
+    std::vector<float> minX_, minY_, minZ_;
+    std::vector<float> maxX_, maxY_, maxZ_;
+};
+
+// SoA 形式で境界球を保持するコンテナ
+class SphereSoA {
+public:
+    size_t Size() const { return centerX_.size(); }
+    void Clear();
+    void Reserve(size_t count);
+    void PushBack(const BoundingSphere& sphere);
+
+    SphereStreams GetStreams() const;
+
+private:
+    std::vector<float> centerX_, centerY_, centerZ_;
+    std::vector<float> radius_;
+};
+
+namespace Culling {
+    // ビュープロジェクション行列 (行ベクトル規約、D3D の 0 <= z <= w) から視錐台を作る
+    Frustum ExtractFrustum(const Matrix4x4& viewProjection);
+    // 平面 index の係数 (x, y, z, w)
+    Vector4 GetPlane(const Frustum& frustum, size_t index);
+
+    // 1 個ずつの判定 (どれかの平面の完全に外側なら false)
+    bool IsVisible(const Frustum& frustum, const Aabb& aabb);
+    bool IsVisible(const Frustum& frustum, const BoundingSphere& sphere);
+
+    // 半直線と AABB の交差判定 (交差すれば入る位置の t を hitDistance に入れる、始点が内側なら 0)
+    bool IntersectRay(const Ray& ray, const Aabb& aabb, float& hitDistance);
+
+    // ローカルの境界をアフィン行列で変換する (頂点は使わず、行列の行を SSE で 4 成分まとめて掛ける)
+    // ローカル AABB をアフィン行列で変換したものを包む AABB
+    Aabb TransformAabb(const Aabb& aabb, const Matrix4x4& matrix);
+    // 半径は 3x3 部分の拡大率の最大 (最大特異値) の上限で広げる
+    // 上限は 3 行の内積の行列の Gershgorin の評価とフロベニウスノルムの小さい方 (S * R なら行の長さの最大と一致し、せん断があっても小さくならない)
+    BoundingSphere TransformSphere(const BoundingSphere& sphere, const Matrix4x4& matrix);
+    // 変換した箱そのもの (軸を正規化し、伸びた長さは halfExtent へ移す)
+    // 不均一な拡大とボックスの軸がずれていると、変換後の軸は直交しない
+    Obb TransformObb(const Obb& obb, const Matrix4x4& matrix);
+
+    // 可視判定結果のビットマスク (要素 i は word[i / 64] の bit (i % 64))
+    constexpr size_t GetMaskWordCount(size_t count) { return (count + 63) / 64; }
+    inline bool TestMask(const uint64_t* mask, size_t index) { return ((mask[index / 64] >> (index % 64)) & 1) != 0; }
+
+    // まとめて判定し、見える要素のビットを立てる (visibleMask は GetMaskWordCount(count) 要素)
+    // 戻り値は見える要素の数。MatrixMath::GetSimdLevel に応じて 8 / 4 要素単位で処理する
+    size_t CullAabbs(const Frustum& frustum, const AabbStreams& aabbs, uint64_t* visibleMask);
+    size_t CullSpheres(const Frustum& frustum, const SphereStreams& spheres, uint64_t* visibleMask);
+}
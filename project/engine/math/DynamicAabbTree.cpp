@@ -0,0 +1,522 @@
+#include "DynamicAabbTree.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    // fat AABB を移動方向へ伸ばす倍率
+    constexpr float kDisplacementMultiplier = 4.0f;
+
+    Aabb Union(const Aabb& a, const Aabb& b) {
+        return {
+            { (std::min)(a.min.x, b.min.x), (std::min)(a.min.y, b.min.y), (std::min)(a.min.z, b.min.z) },
+            { (std::max)(a.max.x, b.max.x), (std::max)(a.max.y, b.max.y), (std::max)(a.max.z, b.max.z) }
+        };
+    }
+
+    // 表面積の 1/2 (比較にしか使わないので係数は省く)
+    float Area(const Aabb& aabb) {
+        const float dx = aabb.max.x - aabb.min.x;
+        const float dy = aabb.max.y - aabb.min.y;
+        const float dz = aabb.max.z - aabb.min.z;
+        return dx * dy + dy * dz + dz * dx;
+    }
+
+    bool Contains(const Aabb& outer, const Aabb& inner) {
+        return
+            outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+            inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    bool Overlaps(const Aabb& a, const Aabb& b) {
+        return
+            a.min.x <= b.max.x && b.min.x <= a.max.x &&
+            a.min.y <= b.max.y && b.min.y <= a.max.y &&
+            a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+
+    Aabb Expand(const Aabb& aabb, float margin) {
+        return {
+            { aabb.min.x - margin, aabb.min.y - margin, aabb.min.z - margin },
+            { aabb.max.x + margin, aabb.max.y + margin, aabb.max.z + margin }
+        };
+    }
+
+    // 視錐台に対する AABB の位置関係
+    enum class FrustumTest {
+        Outside,
+        Intersect,
+        Inside,
+    };
+
+    FrustumTest TestFrustum(const Frustum& frustum, const Aabb& aabb) {
+        const float centerX = (aabb.min.x + aabb.max.x) * 0.5f;
+        const float centerY = (aabb.min.y + aabb.max.y) * 0.5f;
+        const float centerZ = (aabb.min.z + aabb.max.z) * 0.5f;
+        const float extentX = (aabb.max.x - aabb.min.x) * 0.5f;
+        const float extentY = (aabb.max.y - aabb.min.y) * 0.5f;
+        const float extentZ = (aabb.max.z - aabb.min.z) * 0.5f;
+
+        FrustumTest result = FrustumTest::Inside;
+        for (size_t i = 0; i < Frustum::kPlaneCount; ++i) {
+            const float distance = frustum.normalX[i] * centerX + frustum.normalY[i] * centerY + frustum.normalZ[i] * centerZ + frustum.distance[i];
+            const float radius = std::fabs(frustum.normalX[i]) * extentX + std::fabs(frustum.normalY[i]) * extentY + std::fabs(frustum.normalZ[i]) * extentZ;
+            if (distance + radius < 0.0f) {
+                return FrustumTest::Outside;
+            }
+            if (distance - radius < 0.0f) {
+                result = FrustumTest::Intersect;
+            }
+        }
+        return result;
+    }
+}
+
+DynamicAabbTree::DynamicAabbTree(float margin)
+    : margin_(margin) {
+}
+
+int32_t DynamicAabbTree::AllocateNode() {
+    if (freeList_ == kNullNode) {
+        // 空きが無ければ末尾に追加する
+        nodes_.emplace_back();
+        nodes_.back().height = -1;
+        freeList_ = static_cast<int32_t>(nodes_.size() - 1);
+        nodes_.back().parent = kNullNode;
+    }
+
+    const int32_t nodeId = freeList_;
+    Node& node = nodes_[nodeId];
+    freeList_ = node.parent;
+    node.parent = kNullNode;
+    node.child1 = kNullNode;
+    node.child2 = kNullNode;
+    node.height = 0;
+    node.userData = nullptr;
+    return nodeId;
+}
+
+void DynamicAabbTree::FreeNode(int32_t nodeId) {
+    Node& node = nodes_[nodeId];
+    node.parent = freeList_;
+    node.height = -1;
+    freeList_ = nodeId;
+}
+
+int32_t DynamicAabbTree::CreateProxy(const Aabb& aabb, void* userData) {
+    const int32_t proxyId = AllocateNode();
+    Node& node = nodes_[proxyId];
+    node.aabb = Expand(aabb, margin_);
+    node.tightAabb = aabb;
+    node.userData = userData;
+
+    InsertLeaf(proxyId);
+    ++proxyCount_;
+    return proxyId;
+}
+
+void DynamicAabbTree::DestroyProxy(int32_t proxyId) {
+    assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+    assert(nodes_[proxyId].IsLeaf());
+
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    --proxyCount_;
+}
+
+bool DynamicAabbTree::MoveProxy(int32_t proxyId, const Aabb& aabb, const Vector3& displacement) {
+    assert(0 <= proxyId && proxyId < static_cast<int32_t>(nodes_.size()));
+    Node& node = nodes_[proxyId];
+    assert(node.IsLeaf());
+    node.tightAabb = aabb;
+
+    // 予測移動量の方向へ伸ばした fat AABB
+    Aabb fatAabb = Expand(aabb, margin_);
+    const float dx = kDisplacementMultiplier * displacement.x;
+    const float dy = kDisplacementMultiplier * displacement.y;
+    const float dz = kDisplacementMultiplier * displacement.z;
+    (dx < 0.0f ? fatAabb.min.x : fatAabb.max.x) += dx;
+    (dy < 0.0f ? fatAabb.min.y : fatAabb.max.y) += dy;
+    (dz < 0.0f ? fatAabb.min.z : fatAabb.max.z) += dz;
+
+    if (Contains(node.aabb, aabb)) {
+        // まだ fat AABB に収まっていて、fat AABB が大きすぎなければ何もしない
+        const Aabb hugeAabb = Expand(fatAabb, 4.0f * margin_);
+        if (Contains(hugeAabb, node.aabb)) {
+            return false;
+        }
+    }
+
+    RemoveLeaf(proxyId);
+    nodes_[proxyId].aabb = fatAabb;
+    InsertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAabbTree::InsertLeaf(int32_t leaf) {
+    if (root_ == kNullNode) {
+        root_ = leaf;
+        nodes_[root_].parent = kNullNode;
+        return;
+    }
+
+    // SAH コストが最も小さくなる兄弟を上から探す
+    const Aabb leafAabb = nodes_[leaf].aabb;
+    int32_t index = root_;
+    while (!nodes_[index].IsLeaf()) {
+        const Node& node = nodes_[index];
+        const float area = Area(node.aabb);
+        const float combinedArea = Area(Union(node.aabb, leafAabb));
+
+        // ここで新しい親を作る場合のコスト
+        const float cost = 2.0f * combinedArea;
+        // 子へ降りる場合に、このノードが広がる分のコスト
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto ChildCost = [&](int32_t child) {
+            const Aabb combined = Union(leafAabb, nodes_[child].aabb);
+            if (nodes_[child].IsLeaf()) {
+                return Area(combined) + inheritanceCost;
+            }
+            return Area(combined) - Area(nodes_[child].aabb) + inheritanceCost;
+            };
+        const float cost1 = ChildCost(node.child1);
+        const float cost2 = ChildCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = (cost1 < cost2) ? node.child1 : node.child2;
+    }
+
+    // 兄弟と新しい葉をまとめる親を作る
+    const int32_t sibling = index;
+    const int32_t oldParent = nodes_[sibling].parent;
+    const int32_t newParent = AllocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].aabb = Union(leafAabb, nodes_[sibling].aabb);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].child1 = sibling;
+    nodes_[newParent].child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent != kNullNode) {
+        if (nodes_[oldParent].child1 == sibling) {
+            nodes_[oldParent].child1 = newParent;
+        } else {
+            nodes_[oldParent].child2 = newParent;
+        }
+    } else {
+        root_ = newParent;
+    }
+
+    RefitAncestors(nodes_[leaf].parent);
+}
+
+void DynamicAabbTree::RemoveLeaf(int32_t leaf) {
+    if (leaf == root_) {
+        root_ = kNullNode;
+        return;
+    }
+
+    // 親を消して兄弟を祖父につなぎ直す
+    const int32_t parent = nodes_[leaf].parent;
+    const int32_t grandParent = nodes_[parent].parent;
+    const int32_t sibling = (nodes_[parent].child1 == leaf) ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent != kNullNode) {
+        if (nodes_[grandParent].child1 == parent) {
+            nodes_[grandParent].child1 = sibling;
+        } else {
+            nodes_[grandParent].child2 = sibling;
+        }
+        nodes_[sibling].parent = grandParent;
+        FreeNode(parent);
+        RefitAncestors(grandParent);
+    } else {
+        root_ = sibling;
+        nodes_[sibling].parent = kNullNode;
+        FreeNode(parent);
+    }
+    nodes_[leaf].parent = kNullNode;
+}
+
+void DynamicAabbTree::RefitAncestors(int32_t index) {
+    while (index != kNullNode) {
+        Node& node = nodes_[index];
+        const Node& child1 = nodes_[node.child1];
+        const Node& child2 = nodes_[node.child2];
+        node.aabb = Union(child1.aabb, child2.aabb);
+        node.height = 1 + (std::max)(child1.height, child2.height);
+
+        Rotate(index);
+        index = nodes_[index].parent;
+    }
+}
+
+void DynamicAabbTree::Rotate(int32_t index) {
+    // 子 B, C と孫 (B の子 D, E / C の子 F, G) を入れ替えて、
+    // 入れ替えで作り直される子の表面積が最も減るものを選ぶ
+    //          A
+    //      +---+---+
+    //      B       C
+    //    +-+-+   +-+-+
+    //    D   E   F   G
+    const int32_t b = nodes_[index].child1;
+    const int32_t c = nodes_[index].child2;
+
+    enum class Rotation { None, BF, BG, CD, CE };
+    Rotation best = Rotation::None;
+    float bestGain = 0.0f;
+
+    if (!nodes_[c].IsLeaf()) {
+        const int32_t f = nodes_[c].child1;
+        const int32_t g = nodes_[c].child2;
+        const float areaC = Area(nodes_[c].aabb);
+        // B と F を入れ替えると C = B + G になる
+        const float gainBF = areaC - Area(Union(nodes_[b].aabb, nodes_[g].aabb));
+        if (gainBF > bestGain) {
+            bestGain = gainBF;
+            best = Rotation::BF;
+        }
+        const float gainBG = areaC - Area(Union(nodes_[b].aabb, nodes_[f].aabb));
+        if (gainBG > bestGain) {
+            bestGain = gainBG;
+            best = Rotation::BG;
+        }
+    }
+    if (!nodes_[b].IsLeaf()) {
+        const int32_t d = nodes_[b].child1;
+        const int32_t e = nodes_[b].child2;
+        const float areaB = Area(nodes_[b].aabb);
+        const float gainCD = areaB - Area(Union(nodes_[c].aabb, nodes_[e].aabb));
+        if (gainCD > bestGain) {
+            bestGain = gainCD;
+            best = Rotation::CD;
+        }
+        const float gainCE = areaB - Area(Union(nodes_[c].aabb, nodes_[d].aabb));
+        if (gainCE > bestGain) {
+            bestGain = gainCE;
+            best = Rotation::CE;
+        }
+    }
+
+    // index の子 child と、その兄弟 other の子 grandChild を入れ替える
+    auto Swap = [this, index](int32_t child, int32_t other, int32_t grandChild) {
+        Node& parentNode = nodes_[index];
+        if (parentNode.child1 == child) {
+            parentNode.child1 = grandChild;
+        } else {
+            parentNode.child2 = grandChild;
+        }
+        nodes_[grandChild].parent = index;
+
+        Node& otherNode = nodes_[other];
+        if (otherNode.child1 == grandChild) {
+            otherNode.child1 = child;
+        } else {
+            otherNode.child2 = child;
+        }
+        nodes_[child].parent = other;
+
+        otherNode.aabb = Union(nodes_[otherNode.child1].aabb, nodes_[otherNode.child2].aabb);
+        otherNode.height = 1 + (std::max)(nodes_[otherNode.child1].height, nodes_[otherNode.child2].height);
+        parentNode.height = 1 + (std::max)(nodes_[parentNode.child1].height, nodes_[parentNode.child2].height);
+        };
+
+    switch (best) {
+    case Rotation::BF: Swap(b, c, nodes_[c].child1); break;
+    case Rotation::BG: Swap(b, c, nodes_[c].child2); break;
+    case Rotation::CD: Swap(c, b, nodes_[b].child1); break;
+    case Rotation::CE: Swap(c, b, nodes_[b].child2); break;
+    default: break;
+    }
+}
+
+float DynamicAabbTree::GetAreaRatio() const {
+    if (root_ == kNullNode) {
+        return 0.0f;
+    }
+    const float rootArea = Area(nodes_[root_].aabb);
+    if (rootArea <= 0.0f) {
+        return 0.0f;
+    }
+    float totalArea = 0.0f;
+    for (const Node& node : nodes_) {
+        if (node.height > 0) {
+            totalArea += Area(node.aabb);
+        }
+    }
+    return totalArea / rootArea;
+}
+
+bool DynamicAabbTree::Validate() const {
+    size_t leafCount = 0;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const Node& node = nodes_[i];
+        if (node.height < 0) {
+            continue;
+        }
+        const int32_t nodeId = static_cast<int32_t>(i);
+        if (nodeId == root_ ? node.parent != kNullNode : node.parent == kNullNode) {
+            return false;
+        }
+        if (node.IsLeaf()) {
+            if (node.height != 0 || !Contains(node.aabb, node.tightAabb)) {
+                return false;
+            }
+            ++leafCount;
+            continue;
+        }
+        const Node& child1 = nodes_[node.child1];
+        const Node& child2 = nodes_[node.child2];
+        if (child1.parent != nodeId || child2.parent != nodeId) {
+            return false;
+        }
+        if (node.height != 1 + (std::max)(child1.height, child2.height)) {
+            return false;
+        }
+        if (!Contains(node.aabb, child1.aabb) || !Contains(node.aabb, child2.aabb)) {
+            return false;
+        }
+    }
+    return leafCount == proxyCount_;
+}
+
+void DynamicAabbTree::AddLeaves(int32_t nodeId, std::vector<int32_t>& proxyIds) const {
+    // 視錐台に完全に含まれる部分木は判定せずに葉を集める
+    const size_t base = stack_.size();
+    stack_.push_back(nodeId);
+    while (stack_.size() > base) {
+        const int32_t index = stack_.back();
+        stack_.pop_back();
+        const Node& node = nodes_[index];
+        if (node.IsLeaf()) {
+            proxyIds.push_back(index);
+        } else {
+            stack_.push_back(node.child1);
+            stack_.push_back(node.child2);
+        }
+    }
+}
+
+void DynamicAabbTree::QueryFrustum(const Frustum& frustum, std::vector<int32_t>& proxyIds) const {
+    if (root_ == kNullNode) {
+        return;
+    }
+    stack_.clear();
+    stack_.push_back(root_);
+    while (!stack_.empty()) {
+        const int32_t index = stack_.back();
+        stack_.pop_back();
+        const Node& node = nodes_[index];
+
+        const FrustumTest test = TestFrustum(frustum, node.aabb);
+        if (test == FrustumTest::Outside) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            // 葉は登録された AABB で判定し直す
+            if (Culling::IsVisible(frustum, node.tightAabb)) {
+                proxyIds.push_back(index);
+            }
+        } else if (test == FrustumTest::Inside) {
+            AddLeaves(index, proxyIds);
+        } else {
+            stack_.push_back(node.child1);
+            stack_.push_back(node.child2);
+        }
+    }
+}
+
+void DynamicAabbTree::QueryOverlap(const Aabb& aabb, std::vector<int32_t>& proxyIds) const {
+    if (root_ == kNullNode) {
+        return;
+    }
+    stack_.clear();
+    stack_.push_back(root_);
+    while (!stack_.empty()) {
+        const int32_t index = stack_.back();
+        stack_.pop_back();
+        const Node& node = nodes_[index];
+        if (!Overlaps(node.aabb, aabb)) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            if (Overlaps(node.tightAabb, aabb)) {
+                proxyIds.push_back(index);
+            }
+        } else {
+            stack_.push_back(node.child1);
+            stack_.push_back(node.child2);
+        }
+    }
+}
+
+void DynamicAabbTree::QueryOverlaps(const Aabb* aabbs, size_t count, std::vector<OverlapPair>& pairs) const {
+    std::vector<int32_t> proxyIds;
+    for (size_t i = 0; i < count; ++i) {
+        proxyIds.clear();
+        QueryOverlap(aabbs[i], proxyIds);
+        for (int32_t proxyId : proxyIds) {
+            pairs.push_back({ static_cast<uint32_t>(i), proxyId });
+        }
+    }
+}
+
+DynamicAabbTree::RayHit DynamicAabbTree::RayCast(const Ray& ray) const {
+    RayHit hit;
+    if (root_ == kNullNode) {
+        return hit;
+    }
+
+    // 当たった距離で半直線を縮めながら、近い子から順に調べる
+    Ray clipped = ray;
+    stack_.clear();
+    stack_.push_back(root_);
+    while (!stack_.empty()) {
+        const int32_t index = stack_.back();
+        stack_.pop_back();
+        const Node& node = nodes_[index];
+
+        float distance;
+        if (!Culling::IntersectRay(clipped, node.aabb, distance)) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            if (Culling::IntersectRay(clipped, node.tightAabb, distance)) {
+                hit.proxyId = index;
+                hit.distance = distance;
+                clipped.maxDistance = distance;
+            }
+            continue;
+        }
+
+        float distance1 = 0.0f;
+        float distance2 = 0.0f;
+        const bool isHit1 = Culling::IntersectRay(clipped, nodes_[node.child1].aabb, distance1);
+        const bool isHit2 = Culling::IntersectRay(clipped, nodes_[node.child2].aabb, distance2);
+        // スタックなので遠い方を先に積む
+        if (isHit1 && isHit2) {
+            if (distance1 <= distance2) {
+                stack_.push_back(node.child2);
+                stack_.push_back(node.child1);
+            } else {
+                stack_.push_back(node.child1);
+                stack_.push_back(node.child2);
+            }
+        } else if (isHit1) {
+            stack_.push_back(node.child1);
+        } else if (isHit2) {
+            stack_.push_back(node.child2);
+        }
+    }
+    return hit;
+}
+
+void DynamicAabbTree::RayCastBatch(const Ray* rays, size_t count, RayHit* hits) const {
+    for (size_t i = 0; i < count; ++i) {
+        hits[i] = RayCast(rays[i]);
+    }
+}
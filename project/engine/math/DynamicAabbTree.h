@@ -0,0 +1,90 @@
+#pragma once
+#include "Culling.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 動的 AABB ツリー (シーン内オブジェクトの広域判定用)
+// 葉には余白を付けた fat AABB を持たせ、少しの移動ではツリーを組み替えない
+// 挿入は表面積コスト (SAH) で兄弟を選び、更新した経路上で回転を行って品質を保つ
+class DynamicAabbTree {
+public:
+    static constexpr int32_t kNullNode = -1;
+
+    // 半直線クエリの結果
+    struct RayHit {
+        int32_t proxyId = kNullNode; // 当たらなかった場合は kNullNode
+        float distance = 0.0f;
+    };
+
+    // 重なりクエリの結果 (queryIndex 番目のボックスと proxyId が重なっている)
+    struct OverlapPair {
+        uint32_t queryIndex;
+        int32_t proxyId;
+    };
+
+public:
+    // margin は fat AABB の余白
+    explicit DynamicAabbTree(float margin = 0.1f);
+
+    // 登録して proxyId を返す
+    int32_t CreateProxy(const Aabb& aabb, void* userData);
+    void DestroyProxy(int32_t proxyId);
+    // AABB を更新する。fat AABB からはみ出した場合のみ組み替えて true を返す
+    // displacement は次の更新までの予測移動量 (その方向に fat AABB を伸ばす)
+    bool MoveProxy(int32_t proxyId, const Aabb& aabb, const Vector3& displacement);
+
+    void* GetUserData(int32_t proxyId) const { return nodes_[proxyId].userData; }
+    const Aabb& GetAabb(int32_t proxyId) const { return nodes_[proxyId].tightAabb; }
+    const Aabb& GetFatAabb(int32_t proxyId) const { return nodes_[proxyId].aabb; }
+
+    size_t GetProxyCount() const { return proxyCount_; }
+    int32_t GetHeight() const { return root_ == kNullNode ? 0 : nodes_[root_].height; }
+    // 全内部ノードの表面積の和 / ルートの表面積 (ツリーの品質の目安、小さいほど良い)
+    float GetAreaRatio() const;
+    // 親子関係・高さ・包含関係が正しいか確かめる (デバッグ用)
+    bool Validate() const;
+
+    // 視錐台と交差する proxy を proxyIds に追加する
+    void QueryFrustum(const Frustum& frustum, std::vector<int32_t>& proxyIds) const;
+    // aabb と重なる proxy を proxyIds に追加する
+    void QueryOverlap(const Aabb& aabb, std::vector<int32_t>& proxyIds) const;
+    // 複数のボックスそれぞれと重なる proxy を pairs に追加する
+    void QueryOverlaps(const Aabb* aabbs, size_t count, std::vector<OverlapPair>& pairs) const;
+    // 最も近くで当たる proxy の AABB を求める
+    RayHit RayCast(const Ray& ray) const;
+    // 複数の半直線をまとめて調べる (hits は count 要素)
+    void RayCastBatch(const Ray* rays, size_t count, RayHit* hits) const;
+
+private:
+    struct Node {
+        Aabb aabb;      // fat AABB (内部ノードは子の和)
+        Aabb tightAabb; // 葉のみ: 登録された AABB
+        void* userData = nullptr;
+        int32_t parent = kNullNode; // 未使用ノードでは次の空きノード
+        int32_t child1 = kNullNode;
+        int32_t child2 = kNullNode;
+        int32_t height = 0; // 葉は 0、未使用は -1
+
+        bool IsLeaf() const { return child1 == kNullNode; }
+    };
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t nodeId);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    // index から根まで AABB と高さを更新しながら回転を行う
+    void RefitAncestors(int32_t index);
+    void Rotate(int32_t index);
+    void AddLeaves(int32_t nodeId, std::vector<int32_t>& proxyIds) const;
+
+private:
+    std::vector<Node> nodes_;
+    int32_t root_ = kNullNode;
+    int32_t freeList_ = kNullNode;
+    size_t proxyCount_ = 0;
+    float margin_;
+
+    // クエリ用の作業スタック (const クエリからも使うため mutable)
+    mutable std::vector<int32_t> stack_;
+};
@@ -0,0 +1,173 @@
+#include "FastMath.h"
+#include "FastMathSimd.h"
+#include "CpuFeature.h"
+#include "Matrix4x4.h"
+#include <cmath>
+#include <cstdint>
+
+using namespace FastMath::Simd;
+
+namespace {
+    FastMath::TrigPrecision gTrigPrecision = FastMath::TrigPrecision::Standard;
+
+#if defined(MATH_SIMD_X86)
+    MATH_TARGET_AVX2 void SinCos8AVX2(const float* x, float* sinValues, float* cosValues) {
+        __m256 s, c;
+        SinCos8(_mm256_loadu_ps(x), s, c);
+        _mm256_storeu_ps(sinValues, s);
+        _mm256_storeu_ps(cosValues, c);
+        _mm256_zeroupper();
+    }
+
+    // 8 要素単位で処理した要素数を返す
+    MATH_TARGET_AVX2 size_t SinCosArrayAVX2(const float* x, float* sinValues, float* cosValues, size_t count) {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 s, c;
+            SinCos8(_mm256_loadu_ps(x + i), s, c);
+            _mm256_storeu_ps(sinValues + i, s);
+            _mm256_storeu_ps(cosValues + i, c);
+        }
+        _mm256_zeroupper();
+        return i;
+    }
+#endif
+
+    // 8 要素版は AVX2 と AVX レベルの両方が有効な場合のみ使う
+    bool UseAVX2() {
+#if defined(MATH_SIMD_X86)
+        static const bool hasAVX2 = CpuFeature::HasAVX2();
+        return hasAVX2 && MatrixMath::GetSimdLevel() == MatrixMath::SimdLevel::AVX;
+#else
+        return false;
+#endif
+    }
+
+    bool UseSSE2() {
+#if defined(MATH_SIMD_X86)
+        return MatrixMath::GetSimdLevel() != MatrixMath::SimdLevel::Scalar;
+#else
+        return false;
+#endif
+    }
+}
+
+void FastMath::SinCos(float x, float& sinValue, float& cosValue) {
+    // SinCos4 / SinCos8 と同じ手順のスカラー版
+    const bool isNegative = x < 0.0f;
+    const float absX = isNegative ? -x : x;
+
+    int32_t j = static_cast<int32_t>(absX * kFourOverPi);
+    j = (j + 1) & ~1;
+    const float y = static_cast<float>(j);
+    const float z = ((absX - y * kDP1) - y * kDP2) - y * kDP3;
+    const float zz = z * z;
+
+    const float sinPoly = ((zz * kSinC0 + kSinC1) * zz + kSinC2) * zz * z + z;
+    const float cosPoly = ((zz * kCosC0 + kCosC1) * zz + kCosC2) * zz * zz - zz * 0.5f + 1.0f;
+
+    const bool isSwapped = (j & 2) != 0;
+    float s = isSwapped ? cosPoly : sinPoly;
+    float c = isSwapped ? sinPoly : cosPoly;
+    if (((j & 4) != 0) != isNegative) {
+        s = -s;
+    }
+    if (((j + 2) & 4) != 0) {
+        c = -c;
+    }
+    sinValue = s;
+    cosValue = c;
+}
+
+float FastMath::Sin(float x) {
+    float s, c;
+    SinCos(x, s, c);
+    return s;
+}
+
+float FastMath::Cos(float x) {
+    float s, c;
+    SinCos(x, s, c);
+    return c;
+}
+
+void FastMath::SinCos4(const float x[4], float sinValues[4], float cosValues[4]) {
+#if defined(MATH_SIMD_X86)
+    __m128 s, c;
+    Simd::SinCos4(_mm_loadu_ps(x), s, c);
+    _mm_storeu_ps(sinValues, s);
+    _mm_storeu_ps(cosValues, c);
+#else
+    for (int i = 0; i < 4; ++i) {
+        SinCos(x[i], sinValues[i], cosValues[i]);
+    }
+#endif
+}
+
+void FastMath::SinCos8(const float x[8], float sinValues[8], float cosValues[8]) {
+#if defined(MATH_SIMD_X86)
+    static const bool hasAVX2 = CpuFeature::HasAVX2();
+    if (hasAVX2) {
+        SinCos8AVX2(x, sinValues, cosValues);
+        return;
+    }
+#endif
+    SinCos4(x, sinValues, cosValues);
+    SinCos4(x + 4, sinValues + 4, cosValues + 4);
+}
+
+void FastMath::SinCosArray(const float* x, float* sinValues, float* cosValues, size_t count) {
+    size_t i = 0;
+#if defined(MATH_SIMD_X86)
+    if (UseAVX2()) {
+        i = SinCosArrayAVX2(x, sinValues, cosValues, count);
+    }
+    if (UseSSE2()) {
+        for (; i + 4 <= count; i += 4) {
+            __m128 s, c;
+            Simd::SinCos4(_mm_loadu_ps(x + i), s, c);
+            _mm_storeu_ps(sinValues + i, s);
+            _mm_storeu_ps(cosValues + i, c);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        SinCos(x[i], sinValues[i], cosValues[i]);
+    }
+}
+
+FastMath::TrigPrecision FastMath::GetTrigPrecision() {
+    return gTrigPrecision;
+}
+
+void FastMath::SetTrigPrecision(TrigPrecision precision) {
+    gTrigPrecision = precision;
+}
+
+float FastMath::Sin(float x, TrigPrecision precision) {
+    return precision == TrigPrecision::Fast ? Sin(x) : std::sin(x);
+}
+
+float FastMath::Cos(float x, TrigPrecision precision) {
+    return precision == TrigPrecision::Fast ? Cos(x) : std::cos(x);
+}
+
+void FastMath::SinCos(float x, float& sinValue, float& cosValue, TrigPrecision precision) {
+    if (precision == TrigPrecision::Fast) {
+        SinCos(x, sinValue, cosValue);
+    } else {
+        sinValue = std::sin(x);
+        cosValue = std::cos(x);
+    }
+}
+
+void FastMath::SinCosArray(const float* x, float* sinValues, float* cosValues, size_t count, TrigPrecision precision) {
+    if (precision == TrigPrecision::Fast) {
+        SinCosArray(x, sinValues, cosValues, count);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        sinValues[i] = std::sin(x[i]);
+        cosValues[i] = std::cos(x[i]);
+    }
+}
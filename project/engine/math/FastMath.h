@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+
+// 多項式近似による三角関数
+// 範囲縮約は π/4 単位 (Cody-Waite 3 分割)、近似は [-π/4, π/4] の最小近似多項式
+// 誤差: |x| <= 8192 で最大絶対誤差 1.2e-7 以下 (float の 1ulp 程度)
+//       それより大きい |x| では縮約誤差が増えるので std::sin / std::cos を使うこと
+// NaN / 無限大の入力は考慮しない
+namespace FastMath {
+    float Sin(float x);
+    float Cos(float x);
+    void SinCos(float x, float& sinValue, float& cosValue);
+
+    // 4 要素 / 8 要素を同時に計算する (SSE2 / AVX2、非対応の CPU ではスカラーで計算)
+    void SinCos4(const float x[4], float sinValues[4], float cosValues[4]);
+    void SinCos8(const float x[8], float sinValues[8], float cosValues[8]);
+
+    // 配列版 (MatrixMath::GetSimdLevel に応じて 8 / 4 要素単位で処理する)
+    void SinCosArray(const float* x, float* sinValues, float* cosValues, size_t count);
+
+    // 三角関数の精度ポリシー
+    // 既定は Standard。描画上の誤差が問題にならない箇所だけ Fast を選んで使う
+    enum class TrigPrecision {
+        Standard, // std::sin / std::cos
+        Fast,     // 上記の多項式近似
+    };
+    // MakeRotateX/Y/Z やプリミティブ生成などポリシーに従う処理の既定値
+    TrigPrecision GetTrigPrecision();
+    void SetTrigPrecision(TrigPrecision precision);
+
+    // ポリシーを指定して計算する
+    float Sin(float x, TrigPrecision precision);
+    float Cos(float x, TrigPrecision precision);
+    void SinCos(float x, float& sinValue, float& cosValue, TrigPrecision precision);
+    void SinCosArray(const float* x, float* sinValues, float* cosValues, size_t count, TrigPrecision precision);
+}
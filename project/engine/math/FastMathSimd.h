@@ -0,0 +1,90 @@
+#pragma once
+#include "SimdConfig.h"
+
+// FastMath の SIMD 実装 (他の SIMD カーネルからインライン展開して使う)
+namespace FastMath::Simd {
+    // 範囲縮約 (π/4 を 3 分割した Cody-Waite 定数) と最小近似多項式の係数
+    constexpr float kFourOverPi = 1.27323954473516f;
+    constexpr float kDP1 = 0.78515625f;
+    constexpr float kDP2 = 2.4187564849853515625e-4f;
+    constexpr float kDP3 = 3.77489497744594108e-8f;
+    constexpr float kSinC0 = -1.9515295891e-4f;
+    constexpr float kSinC1 = 8.3321608736e-3f;
+    constexpr float kSinC2 = -1.6666654611e-1f;
+    constexpr float kCosC0 = 2.443315711809948e-5f;
+    constexpr float kCosC1 = -1.388731625493765e-3f;
+    constexpr float kCosC2 = 4.166664568298827e-2f;
+
+#if defined(MATH_SIMD_X86)
+    // 4 要素の sin / cos (SSE2)
+    inline void SinCos4(__m128 x, __m128& sinValue, __m128& cosValue) {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 inputSign = _mm_and_ps(x, signMask);
+        const __m128 absX = _mm_andnot_ps(signMask, x);
+
+        // j = (|x| * 4/π を切り捨てた値を偶数に切り上げ)
+        __m128i j = _mm_cvttps_epi32(_mm_mul_ps(absX, _mm_set1_ps(kFourOverPi)));
+        j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+        const __m128 y = _mm_cvtepi32_ps(j);
+
+        __m128 z = _mm_sub_ps(absX, _mm_mul_ps(y, _mm_set1_ps(kDP1)));
+        z = _mm_sub_ps(z, _mm_mul_ps(y, _mm_set1_ps(kDP2)));
+        z = _mm_sub_ps(z, _mm_mul_ps(y, _mm_set1_ps(kDP3)));
+        const __m128 zz = _mm_mul_ps(z, z);
+
+        __m128 sinPoly = _mm_add_ps(_mm_mul_ps(zz, _mm_set1_ps(kSinC0)), _mm_set1_ps(kSinC1));
+        sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, zz), _mm_set1_ps(kSinC2));
+        sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, zz), z), z);
+
+        __m128 cosPoly = _mm_add_ps(_mm_mul_ps(zz, _mm_set1_ps(kCosC0)), _mm_set1_ps(kCosC1));
+        cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, zz), _mm_set1_ps(kCosC2));
+        cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, zz), zz);
+        cosPoly = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(zz, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+        // j & 2 の要素は sin と cos の多項式を入れ替える
+        const __m128 swapMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+        const __m128 s = _mm_or_ps(_mm_and_ps(swapMask, cosPoly), _mm_andnot_ps(swapMask, sinPoly));
+        const __m128 c = _mm_or_ps(_mm_and_ps(swapMask, sinPoly), _mm_andnot_ps(swapMask, cosPoly));
+
+        // bit2 を符号ビットの位置 (bit31) へ移して符号を決める
+        const __m128 sinSign = _mm_xor_ps(inputSign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+        const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+        sinValue = _mm_xor_ps(s, sinSign);
+        cosValue = _mm_xor_ps(c, cosSign);
+    }
+
+    // 8 要素の sin / cos (AVX2)。呼び出し側も MATH_TARGET_AVX2 であること
+    MATH_TARGET_AVX2 inline void SinCos8(__m256 x, __m256& sinValue, __m256& cosValue) {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 inputSign = _mm256_and_ps(x, signMask);
+        const __m256 absX = _mm256_andnot_ps(signMask, x);
+
+        __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(absX, _mm256_set1_ps(kFourOverPi)));
+        j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+        const __m256 y = _mm256_cvtepi32_ps(j);
+
+        __m256 z = _mm256_sub_ps(absX, _mm256_mul_ps(y, _mm256_set1_ps(kDP1)));
+        z = _mm256_sub_ps(z, _mm256_mul_ps(y, _mm256_set1_ps(kDP2)));
+        z = _mm256_sub_ps(z, _mm256_mul_ps(y, _mm256_set1_ps(kDP3)));
+        const __m256 zz = _mm256_mul_ps(z, z);
+
+        __m256 sinPoly = _mm256_add_ps(_mm256_mul_ps(zz, _mm256_set1_ps(kSinC0)), _mm256_set1_ps(kSinC1));
+        sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, zz), _mm256_set1_ps(kSinC2));
+        sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinPoly, zz), z), z);
+
+        __m256 cosPoly = _mm256_add_ps(_mm256_mul_ps(zz, _mm256_set1_ps(kCosC0)), _mm256_set1_ps(kCosC1));
+        cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, zz), _mm256_set1_ps(kCosC2));
+        cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, zz), zz);
+        cosPoly = _mm256_add_ps(_mm256_sub_ps(cosPoly, _mm256_mul_ps(zz, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.0f));
+
+        const __m256 swapMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(2)));
+        const __m256 s = _mm256_blendv_ps(sinPoly, cosPoly, swapMask);
+        const __m256 c = _mm256_blendv_ps(cosPoly, sinPoly, swapMask);
+
+        const __m256 sinSign = _mm256_xor_ps(inputSign, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29)));
+        const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+        sinValue = _mm256_xor_ps(s, sinSign);
+        cosValue = _mm256_xor_ps(c, cosSign);
+    }
+#endif
+}
@@ -1,11 +1,147 @@
 #define _USE_MATH_DEFINES 
 #include "Matrix4x4.h"
+#include "Matrix4x4Simd.h"
+#include "CpuFeature.h"
+#include "FastMath.h"
 #include <math.h>
 #include <cassert>
 #include <cmath>
 
 using namespace MatrixMath;
 
+namespace {
+    // 命令セットごとのカーネル
+    struct KernelTable {
+        SimdLevel level;
+        Matrix4x4(*multipty)(const Matrix4x4&, const Matrix4x4&);
+        Matrix4x4(*inverse)(const Matrix4x4&);
+        Matrix4x4(*transpoce)(const Matrix4x4&);
+    };
+
+    constexpr KernelTable kScalarKernels = { SimdLevel::Scalar, Kernels::MultiptyScalar, Kernels::InverseScalar, Kernels::TranspoceScalar };
+    constexpr KernelTable kSSEKernels = { SimdLevel::SSE2, Kernels::MultiptySSE, Kernels::InverseSSE, Kernels::TranspoceSSE };
+    constexpr KernelTable kAVXKernels = { SimdLevel::AVX, Kernels::MultiptyAVX, Kernels::InverseSSE, Kernels::TranspoceSSE };
+
+    SimdLevel DetectMaxSimdLevel() {
+        if (CpuFeature::HasAVX()) {
+            return SimdLevel::AVX;
+        }
+        if (CpuFeature::HasSSE2()) {
+            return SimdLevel::SSE2;
+        }
+        return SimdLevel::Scalar;
+    }
+
+    const KernelTable& SelectKernels(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX:
+            return kAVXKernels;
+        case SimdLevel::SSE2:
+            return kSSEKernels;
+        default:
+            return kScalarKernels;
+        }
+    }
+
+    // 静的初期化前に呼ばれてもスカラー版で動くようにしておく
+    KernelTable gKernels = kScalarKernels;
+
+    struct KernelSelector {
+        KernelSelector() { gKernels = SelectKernels(DetectMaxSimdLevel()); }
+    } gKernelSelector;
+
+    // MakeAffine と同じ X→Y→Z 順の回転行列 (3x3) を直接求める
+    void MakeRotateXYZ3x3(const Vector3& rotate, float r[3][3]) {
+        const FastMath::TrigPrecision precision = FastMath::GetTrigPrecision();
+        float sx, cx, sy, cy, sz, cz;
+        FastMath::SinCos(rotate.x, sx, cx, precision);
+        FastMath::SinCos(rotate.y, sy, cy, precision);
+        FastMath::SinCos(rotate.z, sz, cz, precision);
+
+        r[0][0] = cy * cz;
+        r[0][1] = cy * sz;
+        r[0][2] = -sy;
+        r[1][0] = sx * sy * cz - cx * sz;
+        r[1][1] = sx * sy * sz + cx * cz;
+        r[1][2] = sx * cy;
+        r[2][0] = cx * sy * cz + sx * sz;
+        r[2][1] = cx * sy * sz - sx * cz;
+        r[2][2] = cx * cy;
+    }
+
+    // 3x3 部分の逆行列 inv から逆行列の平行移動成分を求める
+    Vector3 InverseTranslation(const Vector3& translate, const float inv[3][3]) {
+        return {
+            -(translate.x * inv[0][0] + translate.y * inv[1][0] + translate.z * inv[2][0]),
+            -(translate.x * inv[0][1] + translate.y * inv[1][1] + translate.z * inv[2][1]),
+            -(translate.x * inv[0][2] + translate.y * inv[1][2] + translate.z * inv[2][2])
+        };
+    }
+
+    // 3x3 部分の逆行列を余因子で求める
+    void Inverse3x3(const Matrix4x4& m, float inv[3][3]) {
+        const float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+        const float c01 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+        const float c02 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+        const float c10 = m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2];
+        const float c11 = m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0];
+        const float c12 = m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1];
+        const float c20 = m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1];
+        const float c21 = m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2];
+        const float c22 = m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0];
+
+        // 行列式が 0 の場合は Inverse と同様に inf/NaN になる
+        const float invDet = 1.0f / (m.m[0][0] * c00 + m.m[0][1] * c01 + m.m[0][2] * c02);
+
+        // 余因子行列の転置 / det
+        inv[0][0] = c00 * invDet;
+        inv[0][1] = c10 * invDet;
+        inv[0][2] = c20 * invDet;
+        inv[1][0] = c01 * invDet;
+        inv[1][1] = c11 * invDet;
+        inv[1][2] = c21 * invDet;
+        inv[2][0] = c02 * invDet;
+        inv[2][1] = c12 * invDet;
+        inv[2][2] = c22 * invDet;
+    }
+
+    // 3x3 部分と平行移動から 4x4 行列を組み立てる
+    Matrix4x4 ComposeAffine(const float m3[3][3], const Vector3& translate) {
+        return {
+            m3[0][0], m3[0][1], m3[0][2], 0.0f,
+            m3[1][0], m3[1][1], m3[1][2], 0.0f,
+            m3[2][0], m3[2][1], m3[2][2], 0.0f,
+            translate.x, translate.y, translate.z, 1.0f
+        };
+    }
+
+    // ComposeAffine の結果を転置したもの
+    Matrix4x4 ComposeAffineTransposed(const float m3[3][3], const Vector3& translate) {
+        return {
+            m3[0][0], m3[1][0], m3[2][0], translate.x,
+            m3[0][1], m3[1][1], m3[2][1], translate.y,
+            m3[0][2], m3[1][2], m3[2][2], translate.z,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+    }
+}
+
+SimdLevel MatrixMath::GetSimdLevel() {
+    return gKernels.level;
+}
+
+SimdLevel MatrixMath::GetMaxSimdLevel() {
+    static const SimdLevel maxLevel = DetectMaxSimdLevel();
+    return maxLevel;
+}
+
+void MatrixMath::SetSimdLevel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(GetMaxSimdLevel())) {
+        level = GetMaxSimdLevel();
+    }
+    gKernels = SelectKernels(level);
+}
+
 // 行列の加法
 Matrix4x4 MatrixMath::Add(const Matrix4x4& m1, const Matrix4x4& m2) {
     Matrix4x4 result = {};
@@ -31,6 +167,18 @@ Matrix4x4 MatrixMath::Subtract(const Matrix4x4& m1, const Matrix4x4& m2) {
 }
 // 4x4行列の積
 Matrix4x4 MatrixMath::Multipty(const Matrix4x4& m1, const Matrix4x4& m2) {
+    return gKernels.multipty(m1, m2);
+}
+// 4x4行列の逆行列
+Matrix4x4 MatrixMath::Inverse(const Matrix4x4& m) {
+    return gKernels.inverse(m);
+}
+// 転置行列
+Matrix4x4 MatrixMath::Transpoce(const Matrix4x4& m) {
+    return gKernels.transpoce(m);
+}
+// 4x4行列の積 (スカラー版)
+Matrix4x4 MatrixMath::Kernels::MultiptyScalar(const Matrix4x4& m1, const Matrix4x4& m2) {
     Matrix4x4 result;
 
     for (int row = 0; row < 4; ++row) {
@@ -44,8 +192,8 @@ Matrix4x4 MatrixMath::Multipty(const Matrix4x4& m1, const Matrix4x4& m2) {
 
     return result;
 }
-// 4x4行列の逆行列
-Matrix4x4 MatrixMath::Inverse(const Matrix4x4& m) {
+// 4x4行列の逆行列 (スカラー版、掃き出し法)
+Matrix4x4 MatrixMath::Kernels::InverseScalar(const Matrix4x4& m) {
     float aug[4][8] = {};
     for (int row = 0; row < 4; row++) {
         for (int col = 0; col < 4; col++) {
@@ -101,8 +249,8 @@ Matrix4x4 MatrixMath::Inverse(const Matrix4x4& m) {
 
     return result;
 }
-// 転置行列
-Matrix4x4 MatrixMath::Transpoce(const Matrix4x4& m) {
+// 転置行列 (スカラー版)
+Matrix4x4 MatrixMath::Kernels::TranspoceScalar(const Matrix4x4& m) {
     Matrix4x4 result = {};
 
     for (int row = 0; row < 4; ++row) {
@@ -155,13 +303,16 @@ Matrix4x4 MatrixMath::MakeScale(const Vector3& scale) {
 //X軸の回転行列
 Matrix4x4 MatrixMath::MakeRotateX(float radian) {
 
+    float s, c;
+    FastMath::SinCos(radian, s, c, FastMath::GetTrigPrecision());
+
     Matrix4x4 result = {};
     // 3次元のX軸周りの回転行列
     result.m[0][0] = 1.0f;// X軸方向のベクトル変化しない
-    result.m[1][1] = std::cos(radian); // Y成分の回転
-    result.m[1][2] = std::sin(radian); // Z成分への影響
-    result.m[2][1] = -std::sin(radian);// Y成分への影響  
-    result.m[2][2] = std::cos(radian); // Z成分の回転
+    result.m[1][1] = c; // Y成分の回転
+    result.m[1][2] = s; // Z成分への影響
+    result.m[2][1] = -s;// Y成分への影響  
+    result.m[2][2] = c; // Z成分の回転
     result.m[3][3] = 1.0f;// 同時系列のw成分(固定値1)
 
     return result;// X軸の回転行列を返す
@@ -169,13 +320,16 @@ Matrix4x4 MatrixMath::MakeRotateX(float radian) {
 // Y軸の回転行列
 Matrix4x4 MatrixMath::MakeRotateY(float radian) {
 
+    float s, c;
+    FastMath::SinCos(radian, s, c, FastMath::GetTrigPrecision());
+
     Matrix4x4 result = {};
     // 3次元のY軸周りの回転行列
-    result.m[0][0] = std::cos(radian); // X成分の回転
-    result.m[0][2] = -std::sin(radian);// Z成分への影響
+    result.m[0][0] = c; // X成分の回転
+    result.m[0][2] = -s;// Z成分への影響
     result.m[1][1] = 1.0f;// Y軸は固定
-    result.m[2][0] = std::sin(radian); // X成分への影響
-    result.m[2][2] = std::cos(radian); // Z成分の回転
+    result.m[2][0] = s; // X成分への影響
+    result.m[2][2] = c; // Z成分の回転
     result.m[3][3] = 1.0f;// 同次座標系のw成分(固定値1)
 
     return result;// Y軸の回転行列を返す
@@ -183,12 +337,15 @@ Matrix4x4 MatrixMath::MakeRotateY(float radian) {
 // Z軸の回転行列
 Matrix4x4 MatrixMath::MakeRotateZ(float radian) {
 
+    float s, c;
+    FastMath::SinCos(radian, s, c, FastMath::GetTrigPrecision());
+
     Matrix4x4 result = {};
     // 3次元のZ軸周りの回転行列
-    result.m[0][0] = std::cos(radian); // X成分の回転
-    result.m[0][1] = std::sin(radian);  // Y成分への影響  
-    result.m[1][0] = -std::sin(radian); // X成分への影響
-    result.m[1][1] = std::cos(radian);  // Y成分の回転
+    result.m[0][0] = c; // X成分の回転
+    result.m[0][1] = s;  // Y成分への影響  
+    result.m[1][0] = -s; // X成分への影響
+    result.m[1][1] = c;  // Y成分の回転
     result.m[2][2] = 1.0f;// Z軸は固定
     result.m[3][3] = 1.0f;// 同時座標系のw成分(固定値1)
 
@@ -220,6 +377,48 @@ Matrix4x4 MatrixMath::MakeAffine(const Vector3& scale, const Vector3& rotate, co
 
     return result;
 }
+// アフィン行列の逆行列
+Matrix4x4 MatrixMath::InverseAffine(const Matrix4x4& m) {
+    float inv[3][3];
+    Inverse3x3(m, inv);
+    return ComposeAffine(inv, InverseTranslation({ m.m[3][0], m.m[3][1], m.m[3][2] }, inv));
+}
+// SRT から直接求めるアフィン行列の逆行列 (R^T * S^-1 と平行移動)
+Matrix4x4 MatrixMath::InverseAffine(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
+    float r[3][3];
+    MakeRotateXYZ3x3(rotate, r);
+
+    const float invScale[3] = { 1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z };
+    float inv[3][3];
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            inv[row][col] = r[col][row] * invScale[col];
+        }
+    }
+    return ComposeAffine(inv, InverseTranslation(translate, inv));
+}
+// 回転と平行移動のみの行列の逆行列
+Matrix4x4 MatrixMath::InverseRigid(const Matrix4x4& m) {
+    float inv[3][3];
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            inv[row][col] = m.m[col][row];
+        }
+    }
+    return ComposeAffine(inv, InverseTranslation({ m.m[3][0], m.m[3][1], m.m[3][2] }, inv));
+}
+// アフィン行列の逆転置行列
+Matrix4x4 MatrixMath::InverseTransposeAffine(const Matrix4x4& m) {
+    float inv[3][3];
+    Inverse3x3(m, inv);
+    return ComposeAffineTransposed(inv, InverseTranslation({ m.m[3][0], m.m[3][1], m.m[3][2] }, inv));
+}
+// 左上 3x3 の行列式
+float MatrixMath::Determinant3x3(const Matrix4x4& m) {
+    return m.m[0][0] * (m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1]) -
+        m.m[0][1] * (m.m[1][0] * m.m[2][2] - m.m[1][2] * m.m[2][0]) +
+        m.m[0][2] * (m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0]);
+}
 // 正射影行列
 Matrix4x4 MatrixMath::Orthographic(float left, float top, float right, float bottom, float nearClip, float farClip) {
 
@@ -267,12 +466,4 @@ Matrix4x4 MatrixMath::Viewport(float left, float top, float width, float height,
     result.m[3][3] = 1.0f;
 
     return result;
-}
-// クロス積
-Vector3 MatrixMath::Cross(const Vector3& v1, const Vector3& v2) {
-    return Vector3{
-        v1.y * v2.z - v1.z * v2.y,
-        v1.z * v2.x - v1.x * v2.z,
-        v1.x * v2.y - v1.y * v2.x
-    };
 }
\ No newline at end of file
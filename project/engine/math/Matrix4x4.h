@@ -38,6 +38,16 @@ namespace MatrixMath {
     Matrix4x4 Inverse(const Matrix4x4& m);
     // 転置行列
     Matrix4x4 Transpoce(const Matrix4x4& m);
+
+    // アフィン行列 (4列目が 0,0,0,1) の逆行列 (3x3 余因子 + 平行移動)
+    Matrix4x4 InverseAffine(const Matrix4x4& m);
+    Matrix4x4 InverseAffine(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
+    // 回転と平行移動のみの行列の逆行列 (3x3 部分の転置)
+    Matrix4x4 InverseRigid(const Matrix4x4& m);
+    // アフィン行列の逆転置行列 (法線変換用、Transpoce(Inverse(m)) と同じ結果)
+    Matrix4x4 InverseTransposeAffine(const Matrix4x4& m);
+    // 左上 3x3 の行列式 (負なら鏡映を含み、三角形の巻き順が逆になる)
+    float Determinant3x3(const Matrix4x4& m);
     // 単位行列
     Matrix4x4 MakeIdentity4x4();
     // 平行移動行列
@@ -64,6 +74,27 @@ namespace MatrixMath {
     Matrix4x4 Viewport(float left, float top, float width, float height,
         float minDepth, float maxDepth);
 
-    // クロス積
-    Vector3 Cross(const Vector3& v1, const Vector3& v2);
+    // クロス積 (BVH の走査などの内側でも展開されるようヘッダーで定義する)
+    inline Vector3 Cross(const Vector3& v1, const Vector3& v2) {
+        return Vector3{
+            v1.y * v2.z - v1.z * v2.y,
+            v1.z * v2.x - v1.x * v2.z,
+            v1.x * v2.y - v1.y * v2.x
+        };
+    }
+
+    // 積・逆行列・転置で使う命令セット
+    // 起動時に CPU が対応する最上位のものが選ばれる
+    enum class SimdLevel {
+        Scalar,
+        SSE2,
+        AVX,
+    };
+    // 現在使用している命令セット
+    SimdLevel GetSimdLevel();
+    // この CPU で使える最上位の命令セット
+    SimdLevel GetMaxSimdLevel();
+    // 命令セットを切り替える (非対応の場合は使える最上位に丸める)
+    // ベンチマーク・デバッグ用。描画スレッド以外から呼ばないこと
+    void SetSimdLevel(SimdLevel level);
 }
@@ -0,0 +1,170 @@
+#include "Matrix4x4Simd.h"
+#include "SimdConfig.h"
+
+using namespace MatrixMath;
+
+#if defined(MATH_SIMD_X86)
+
+namespace {
+    // _mm_shuffle_ps 用のマスク (x,y,z,w の順)
+    constexpr int ShuffleMask(int x, int y, int z, int w) {
+        return x | (y << 2) | (z << 4) | (w << 6);
+    }
+
+    template <int X, int Y, int Z, int W>
+    __m128 Swizzle(__m128 v) {
+        return _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), ShuffleMask(X, Y, Z, W)));
+    }
+
+    template <int X, int Y, int Z, int W>
+    __m128 Shuffle(__m128 v1, __m128 v2) {
+        return _mm_shuffle_ps(v1, v2, ShuffleMask(X, Y, Z, W));
+    }
+
+    // 2x2 行列 (x,y,z,w = m00,m01,m10,m11) の積 A*B
+    __m128 Mat2Mul(__m128 a, __m128 b) {
+        return _mm_add_ps(
+            _mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)),
+            _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+    }
+
+    // 余因子行列との積 adj(A)*B
+    __m128 Mat2AdjMul(__m128 a, __m128 b) {
+        return _mm_sub_ps(
+            _mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b),
+            _mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+    }
+
+    // 余因子行列との積 A*adj(B)
+    __m128 Mat2MulAdj(__m128 a, __m128 b) {
+        return _mm_sub_ps(
+            _mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)),
+            _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+    }
+}
+
+// 4x4行列の積 (1行ずつ、m2 の行を m1 の要素でスケールして加算)
+Matrix4x4 MatrixMath::Kernels::MultiptySSE(const Matrix4x4& m1, const Matrix4x4& m2) {
+    const __m128 b0 = _mm_loadu_ps(m2.m[0]);
+    const __m128 b1 = _mm_loadu_ps(m2.m[1]);
+    const __m128 b2 = _mm_loadu_ps(m2.m[2]);
+    const __m128 b3 = _mm_loadu_ps(m2.m[3]);
+
+    Matrix4x4 result;
+    for (int row = 0; row < 4; ++row) {
+        __m128 r = _mm_mul_ps(_mm_set1_ps(m1.m[row][0]), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[row][1]), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[row][2]), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m1.m[row][3]), b3));
+        _mm_storeu_ps(result.m[row], r);
+    }
+    return result;
+}
+
+// 4x4行列の逆行列 (2x2 ブロックの余因子展開)
+// 行列式が 0 の場合はスカラー版と同様に inf/NaN を含む結果になる
+Matrix4x4 MatrixMath::Kernels::InverseSSE(const Matrix4x4& m) {
+    const __m128 r0 = _mm_loadu_ps(m.m[0]);
+    const __m128 r1 = _mm_loadu_ps(m.m[1]);
+    const __m128 r2 = _mm_loadu_ps(m.m[2]);
+    const __m128 r3 = _mm_loadu_ps(m.m[3]);
+
+    // M = | A B |
+    //     | C D |
+    const __m128 a = _mm_movelh_ps(r0, r1);
+    const __m128 b = _mm_movehl_ps(r1, r0);
+    const __m128 c = _mm_movelh_ps(r2, r3);
+    const __m128 d = _mm_movehl_ps(r3, r2);
+
+    // (|A|, |B|, |C|, |D|)
+    const __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(Shuffle<0, 2, 0, 2>(r0, r2), Shuffle<1, 3, 1, 3>(r1, r3)),
+        _mm_mul_ps(Shuffle<1, 3, 1, 3>(r0, r2), Shuffle<0, 2, 0, 2>(r1, r3)));
+    const __m128 detA = Swizzle<0, 0, 0, 0>(detSub);
+    const __m128 detB = Swizzle<1, 1, 1, 1>(detSub);
+    const __m128 detC = Swizzle<2, 2, 2, 2>(detSub);
+    const __m128 detD = Swizzle<3, 3, 3, 3>(detSub);
+
+    const __m128 dc = Mat2AdjMul(d, c);
+    const __m128 ab = Mat2AdjMul(a, b);
+
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+    __m128 tr = _mm_mul_ps(ab, Swizzle<0, 2, 1, 3>(dc));
+    tr = _mm_add_ps(tr, Swizzle<2, 3, 0, 1>(tr));
+    tr = _mm_add_ps(tr, Swizzle<1, 0, 3, 2>(tr));
+    detM = _mm_sub_ps(detM, tr);
+
+    const __m128 rcpDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+    x = _mm_mul_ps(x, rcpDetM);
+    y = _mm_mul_ps(y, rcpDetM);
+    z = _mm_mul_ps(z, rcpDetM);
+    w = _mm_mul_ps(w, rcpDetM);
+
+    // 余因子の並べ替えと格納を同時に行う
+    Matrix4x4 result;
+    _mm_storeu_ps(result.m[0], Shuffle<3, 1, 3, 1>(x, y));
+    _mm_storeu_ps(result.m[1], Shuffle<2, 0, 2, 0>(x, y));
+    _mm_storeu_ps(result.m[2], Shuffle<3, 1, 3, 1>(z, w));
+    _mm_storeu_ps(result.m[3], Shuffle<2, 0, 2, 0>(z, w));
+    return result;
+}
+
+// 転置行列
+Matrix4x4 MatrixMath::Kernels::TranspoceSSE(const Matrix4x4& m) {
+    __m128 r0 = _mm_loadu_ps(m.m[0]);
+    __m128 r1 = _mm_loadu_ps(m.m[1]);
+    __m128 r2 = _mm_loadu_ps(m.m[2]);
+    __m128 r3 = _mm_loadu_ps(m.m[3]);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    Matrix4x4 result;
+    _mm_storeu_ps(result.m[0], r0);
+    _mm_storeu_ps(result.m[1], r1);
+    _mm_storeu_ps(result.m[2], r2);
+    _mm_storeu_ps(result.m[3], r3);
+    return result;
+}
+
+// 4x4行列の積 (2行ずつ 256bit で処理)
+MATH_TARGET_AVX Matrix4x4 MatrixMath::Kernels::MultiptyAVX(const Matrix4x4& m1, const Matrix4x4& m2) {
+    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[0]));
+    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[1]));
+    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[2]));
+    const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[3]));
+
+    const __m256 a01 = _mm256_loadu_ps(m1.m[0]);
+    const __m256 a23 = _mm256_loadu_ps(m1.m[2]);
+
+    __m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2));
+    r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3));
+
+    __m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2));
+    r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3));
+
+    Matrix4x4 result;
+    _mm256_storeu_ps(result.m[0], r01);
+    _mm256_storeu_ps(result.m[2], r23);
+    // 後続の SSE 命令との切り替えペナルティを避ける
+    _mm256_zeroupper();
+    return result;
+}
+
+#else
+
+// x86 以外ではスカラー版にフォールバックする
+Matrix4x4 MatrixMath::Kernels::MultiptySSE(const Matrix4x4& m1, const Matrix4x4& m2) { return MultiptyScalar(m1, m2); }
+Matrix4x4 MatrixMath::Kernels::InverseSSE(const Matrix4x4& m) { return InverseScalar(m); }
+Matrix4x4 MatrixMath::Kernels::TranspoceSSE(const Matrix4x4& m) { return TranspoceScalar(m); }
+Matrix4x4 MatrixMath::Kernels::MultiptyAVX(const Matrix4x4& m1, const Matrix4x4& m2) { return MultiptyScalar(m1, m2); }
+
+#endif
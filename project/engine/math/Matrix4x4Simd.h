@@ -0,0 +1,19 @@
+#pragma once
+#include "Matrix4x4.h"
+
+// MatrixMath の各カーネルの命令セット別実装
+// 通常は MatrixMath::Multipty 等から CPU に合わせて自動で選択される
+namespace MatrixMath::Kernels {
+    // スカラー版 (全プラットフォーム共通)
+    Matrix4x4 MultiptyScalar(const Matrix4x4& m1, const Matrix4x4& m2);
+    Matrix4x4 InverseScalar(const Matrix4x4& m);
+    Matrix4x4 TranspoceScalar(const Matrix4x4& m);
+
+    // SSE2 版 (x86/x64 のみ)
+    Matrix4x4 MultiptySSE(const Matrix4x4& m1, const Matrix4x4& m2);
+    Matrix4x4 InverseSSE(const Matrix4x4& m);
+    Matrix4x4 TranspoceSSE(const Matrix4x4& m);
+
+    // AVX 版 (x86/x64 のみ)
+    Matrix4x4 MultiptyAVX(const Matrix4x4& m1, const Matrix4x4& m2);
+}
@@ -0,0 +1,186 @@
+#include "Quaternion.h"
+#include <cmath>
+
+namespace {
+    // 正規化済みクォータニオンの回転行列 (3x3 部分) を行ベクトル規約で求める
+    void MakeRotate3x3(const Quaternion& q, float r[3][3]) {
+        const float xx = q.x * q.x;
+        const float yy = q.y * q.y;
+        const float zz = q.z * q.z;
+        const float xy = q.x * q.y;
+        const float xz = q.x * q.z;
+        const float yz = q.y * q.z;
+        const float wx = q.w * q.x;
+        const float wy = q.w * q.y;
+        const float wz = q.w * q.z;
+
+        r[0][0] = 1.0f - 2.0f * (yy + zz);
+        r[0][1] = 2.0f * (xy + wz);
+        r[0][2] = 2.0f * (xz - wy);
+        r[1][0] = 2.0f * (xy - wz);
+        r[1][1] = 1.0f - 2.0f * (xx + zz);
+        r[1][2] = 2.0f * (yz + wx);
+        r[2][0] = 2.0f * (xz + wy);
+        r[2][1] = 2.0f * (yz - wx);
+        r[2][2] = 1.0f - 2.0f * (xx + yy);
+    }
+}
+
+Quaternion QuaternionMath::IdentityQuaternion() {
+    return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Quaternion QuaternionMath::Multiply(const Quaternion& q1, const Quaternion& q2) {
+    return {
+        q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y,
+        q1.w * q2.y - q1.x * q2.z + q1.y * q2.w + q1.z * q2.x,
+        q1.w * q2.z + q1.x * q2.y - q1.y * q2.x + q1.z * q2.w,
+        q1.w * q2.w - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z
+    };
+}
+
+Quaternion QuaternionMath::Conjugate(const Quaternion& q) {
+    return { -q.x, -q.y, -q.z, q.w };
+}
+
+float QuaternionMath::Dot(const Quaternion& q1, const Quaternion& q2) {
+    return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+float QuaternionMath::Norm(const Quaternion& q) {
+    return std::sqrt(Dot(q, q));
+}
+
+Quaternion QuaternionMath::Normalize(const Quaternion& q) {
+    const float norm = Norm(q);
+    if (norm == 0.0f) {
+        return IdentityQuaternion();
+    }
+    const float invNorm = 1.0f / norm;
+    return { q.x * invNorm, q.y * invNorm, q.z * invNorm, q.w * invNorm };
+}
+
+Quaternion QuaternionMath::Inverse(const Quaternion& q) {
+    const float normSq = Dot(q, q);
+    if (normSq == 0.0f) {
+        return IdentityQuaternion();
+    }
+    const float invNormSq = 1.0f / normSq;
+    return { -q.x * invNormSq, -q.y * invNormSq, -q.z * invNormSq, q.w * invNormSq };
+}
+
+Quaternion QuaternionMath::MakeRotateAxisAngle(const Vector3& axis, float angle) {
+    const float s = std::sin(angle * 0.5f);
+    return { axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f) };
+}
+
+Quaternion QuaternionMath::MakeFromEuler(const Vector3& rotate) {
+    // Multiply(qz, Multiply(qy, qx)) を展開したもの
+    const float sx = std::sin(rotate.x * 0.5f);
+    const float cx = std::cos(rotate.x * 0.5f);
+    const float sy = std::sin(rotate.y * 0.5f);
+    const float cy = std::cos(rotate.y * 0.5f);
+    const float sz = std::sin(rotate.z * 0.5f);
+    const float cz = std::cos(rotate.z * 0.5f);
+
+    return {
+        sx * cy * cz - cx * sy * sz,
+        cx * sy * cz + sx * cy * sz,
+        cx * cy * sz - sx * sy * cz,
+        cx * cy * cz + sx * sy * sz
+    };
+}
+
+Vector3 QuaternionMath::RotateVector(const Vector3& vector, const Quaternion& q) {
+    // v' = v + 2w (u × v) + 2 u × (u × v)  (u は q の虚部)
+    const Vector3 u = { q.x, q.y, q.z };
+    const Vector3 t = MatrixMath::Cross(u, vector);
+    const Vector3 t2 = { 2.0f * t.x, 2.0f * t.y, 2.0f * t.z };
+    const Vector3 ut = MatrixMath::Cross(u, t2);
+    return {
+        vector.x + q.w * t2.x + ut.x,
+        vector.y + q.w * t2.y + ut.y,
+        vector.z + q.w * t2.z + ut.z
+    };
+}
+
+Quaternion QuaternionMath::Slerp(const Quaternion& q0, const Quaternion& q1, float t) {
+    Quaternion end = q1;
+    float dot = Dot(q0, q1);
+    // 反対向きの場合は符号を反転して最短経路にする
+    if (dot < 0.0f) {
+        end = { -q1.x, -q1.y, -q1.z, -q1.w };
+        dot = -dot;
+    }
+
+    // ほぼ同じ向きの場合は sin(θ) が 0 に近づき不安定になるので Nlerp で代用する
+    constexpr float kNlerpThreshold = 0.9995f;
+    if (dot > kNlerpThreshold) {
+        return Nlerp(q0, end, t);
+    }
+
+    const float theta = std::acos(dot);
+    const float invSinTheta = 1.0f / std::sin(theta);
+    const float scale0 = std::sin((1.0f - t) * theta) * invSinTheta;
+    const float scale1 = std::sin(t * theta) * invSinTheta;
+    return {
+        scale0 * q0.x + scale1 * end.x,
+        scale0 * q0.y + scale1 * end.y,
+        scale0 * q0.z + scale1 * end.z,
+        scale0 * q0.w + scale1 * end.w
+    };
+}
+
+Quaternion QuaternionMath::Nlerp(const Quaternion& q0, const Quaternion& q1, float t) {
+    // 最短経路になるよう q1 の符号を合わせる
+    const float sign = Dot(q0, q1) < 0.0f ? -1.0f : 1.0f;
+    const float scale0 = 1.0f - t;
+    const float scale1 = t * sign;
+    return Normalize({
+        scale0 * q0.x + scale1 * q1.x,
+        scale0 * q0.y + scale1 * q1.y,
+        scale0 * q0.z + scale1 * q1.z,
+        scale0 * q0.w + scale1 * q1.w
+        });
+}
+
+Matrix4x4 QuaternionMath::MakeRotateMatrix(const Quaternion& q) {
+    float r[3][3];
+    MakeRotate3x3(q, r);
+
+    Matrix4x4 result = {};
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            result.m[row][col] = r[row][col];
+        }
+    }
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+Matrix4x4 QuaternionMath::MakeAffine(const Vector3& scale, const Quaternion& rotate, const Vector3& translate) {
+    float r[3][3];
+    MakeRotate3x3(rotate, r);
+
+    const float s[3] = { scale.x, scale.y, scale.z };
+    Matrix4x4 result;
+    for (int row = 0; row < 3; ++row) {
+        result.m[row][0] = s[row] * r[row][0];
+        result.m[row][1] = s[row] * r[row][1];
+        result.m[row][2] = s[row] * r[row][2];
+        result.m[row][3] = 0.0f;
+    }
+    result.m[3][0] = translate.x;
+    result.m[3][1] = translate.y;
+    result.m[3][2] = translate.z;
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+Matrix4x4 QuaternionMath::MakeAffine(const QuaternionTransform& transform) {
+    return MakeAffine(transform.scale, transform.rotate, transform.translate);
+}
+
+QuaternionTransform QuaternionMath::MakeQuaternionTransform(const Transform& transform) {
+    return { transform.scale, MakeFromEuler(transform.rotate), transform.translate };
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Matrix4x4.h"
+
+// クォータニオン (x, y, z が虚部、w が実部)
+struct Quaternion {
+    float x, y, z, w;
+};
+
+// 回転をクォータニオンで持つ SRT
+// Transform (オイラー角) の代わりに使うと回転行列の合成と三角関数の計算が不要になる
+struct QuaternionTransform {
+    Vector3 scale;
+    Quaternion rotate;
+    Vector3 translate;
+};
+
+namespace QuaternionMath {
+    // 単位クォータニオン
+    Quaternion IdentityQuaternion();
+    // 積 (ハミルトン積)。行ベクトル規約の行列では Multiply(q1, q2) は Multipty(M(q2), M(q1)) に対応する
+    // つまり q2 の回転を先に、q1 の回転を後に適用する
+    Quaternion Multiply(const Quaternion& q1, const Quaternion& q2);
+    // 共役
+    Quaternion Conjugate(const Quaternion& q);
+    // 内積
+    float Dot(const Quaternion& q1, const Quaternion& q2);
+    // ノルム
+    float Norm(const Quaternion& q);
+    // 正規化 (ノルムが 0 の場合は単位クォータニオン)
+    Quaternion Normalize(const Quaternion& q);
+    // 逆クォータニオン
+    Quaternion Inverse(const Quaternion& q);
+
+    // 任意軸回転 (axis は正規化済みであること)
+    Quaternion MakeRotateAxisAngle(const Vector3& axis, float angle);
+    // MakeAffine と同じ X→Y→Z 順のオイラー角から作る
+    Quaternion MakeFromEuler(const Vector3& rotate);
+    // ベクトルを回転させる
+    Vector3 RotateVector(const Vector3& vector, const Quaternion& q);
+
+    // 球面線形補間 (最短経路を通る。角度が小さい場合は Nlerp に切り替える)
+    Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+    // 正規化線形補間 (Slerp より速いが角速度は一定にならない)
+    Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+    // 回転行列 (q は正規化済みであること)
+    Matrix4x4 MakeRotateMatrix(const Quaternion& q);
+    // アフィン変換 (S * R(q) * T を行列積なしで直接組み立てる)
+    Matrix4x4 MakeAffine(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+    Matrix4x4 MakeAffine(const QuaternionTransform& transform);
+
+    // オイラー角の Transform から変換する
+    QuaternionTransform MakeQuaternionTransform(const Transform& transform);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+// x86/x64 向け SIMD 組み込み関数の共通設定
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MATH_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC/Clang は AVX 命令を使う関数ごとに target 指定が必要 (MSVC は不要)
+#if defined(MATH_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MATH_TARGET_AVX __attribute__((target("avx")))
+#define MATH_TARGET_AVX2 __attribute__((target("avx2")))
+#define MATH_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#else
+#define MATH_TARGET_AVX
+#define MATH_TARGET_AVX2
+#define MATH_TARGET_AVX2_FMA
+#endif
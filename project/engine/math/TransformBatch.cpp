@@ -0,0 +1,327 @@
+#include "TransformBatch.h"
+#include "FastMath.h"
+#include "FastMathSimd.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace MatrixMath;
+
+void TransformSoA::Clear() {
+    Resize(0);
+}
+
+void TransformSoA::Reserve(size_t count) {
+    for (std::vector<float>* stream : { &scaleX_, &scaleY_, &scaleZ_, &rotateX_, &rotateY_, &rotateZ_, &translateX_, &translateY_, &translateZ_ }) {
+        stream->reserve(count);
+    }
+}
+
+void TransformSoA::Resize(size_t count) {
+    scaleX_.resize(count, 1.0f);
+    scaleY_.resize(count, 1.0f);
+    scaleZ_.resize(count, 1.0f);
+    rotateX_.resize(count, 0.0f);
+    rotateY_.resize(count, 0.0f);
+    rotateZ_.resize(count, 0.0f);
+    translateX_.resize(count, 0.0f);
+    translateY_.resize(count, 0.0f);
+    translateZ_.resize(count, 0.0f);
+}
+
+void TransformSoA::PushBack(const Transform& transform) {
+    Resize(Size() + 1);
+    Set(Size() - 1, transform);
+}
+
+void TransformSoA::Set(size_t index, const Transform& transform) {
+    scaleX_[index] = transform.scale.x;
+    scaleY_[index] = transform.scale.y;
+    scaleZ_[index] = transform.scale.z;
+    rotateX_[index] = transform.rotate.x;
+    rotateY_[index] = transform.rotate.y;
+    rotateZ_[index] = transform.rotate.z;
+    translateX_[index] = transform.translate.x;
+    translateY_[index] = transform.translate.y;
+    translateZ_[index] = transform.translate.z;
+}
+
+Transform TransformSoA::Get(size_t index) const {
+    return {
+        { scaleX_[index], scaleY_[index], scaleZ_[index] },
+        { rotateX_[index], rotateY_[index], rotateZ_[index] },
+        { translateX_[index], translateY_[index], translateZ_[index] }
+    };
+}
+
+TransformStreams TransformSoA::GetStreams() const {
+    TransformStreams streams;
+    streams.scaleX = scaleX_.data();
+    streams.scaleY = scaleY_.data();
+    streams.scaleZ = scaleZ_.data();
+    streams.rotateX = rotateX_.data();
+    streams.rotateY = rotateY_.data();
+    streams.rotateZ = rotateZ_.data();
+    streams.translateX = translateX_.data();
+    streams.translateY = translateY_.data();
+    streams.translateZ = translateZ_.data();
+    streams.count = Size();
+    return streams;
+}
+
+namespace {
+    // 回転の sin / cos は FastMath::GetTrigPrecision に従う (Standard なら std::sin / std::cos)
+    void ComputeSinCos(float x, float& sinValue, float& cosValue, FastMath::TrigPrecision precision) {
+        FastMath::SinCos(x, sinValue, cosValue, precision);
+    }
+
+#if defined(MATH_SIMD_X86)
+    // __m128 を演算子で扱うための薄いラッパー
+    struct F4 {
+        __m128 v;
+        F4() = default;
+        F4(__m128 value) : v(value) {}
+        F4(float value) : v(_mm_set1_ps(value)) {}
+    };
+    inline F4 operator+(F4 a, F4 b) { return _mm_add_ps(a.v, b.v); }
+    inline F4 operator-(F4 a, F4 b) { return _mm_sub_ps(a.v, b.v); }
+    inline F4 operator*(F4 a, F4 b) { return _mm_mul_ps(a.v, b.v); }
+    inline F4 operator/(F4 a, F4 b) { return _mm_div_ps(a.v, b.v); }
+    inline F4 operator-(F4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+    void ComputeSinCos(F4 x, F4& sinValue, F4& cosValue, FastMath::TrigPrecision precision) {
+        if (precision == FastMath::TrigPrecision::Fast) {
+            FastMath::Simd::SinCos4(x.v, sinValue.v, cosValue.v);
+            return;
+        }
+        alignas(16) float values[4], sinValues[4], cosValues[4];
+        _mm_store_ps(values, x.v);
+        for (int i = 0; i < 4; ++i) {
+            sinValues[i] = std::sin(values[i]);
+            cosValues[i] = std::cos(values[i]);
+        }
+        sinValue = _mm_load_ps(sinValues);
+        cosValue = _mm_load_ps(cosValues);
+    }
+#endif
+
+    // 行列ごとの書き込み先
+    Matrix4x4* StreamAt(const MatrixStream& stream, size_t index) {
+        return reinterpret_cast<Matrix4x4*>(reinterpret_cast<uint8_t*>(stream.data) + stream.strideBytes * index);
+    }
+
+    // V = float (1 要素) または F4 (4 要素) で World / WVP / 逆転置行列の各要素を求める
+    // 出力は行優先の 16 要素
+    template <typename V>
+    void ComputeBlock(const V in[9], const Matrix4x4* viewProjection, const Matrix4x4* postRotation, FastMath::TrigPrecision precision,
+        bool needsWvp, bool needsInverseTranspose, V world[16], V wvp[16], V inverseTranspose[16]) {
+        const V& scaleX = in[0];
+        const V& scaleY = in[1];
+        const V& scaleZ = in[2];
+        const V& translateX = in[6];
+        const V& translateY = in[7];
+        const V& translateZ = in[8];
+
+        V sinX, cosX, sinY, cosY, sinZ, cosZ;
+        ComputeSinCos(in[3], sinX, cosX, precision);
+        ComputeSinCos(in[4], sinY, cosY, precision);
+        ComputeSinCos(in[5], sinZ, cosZ, precision);
+
+        // S * Rx * Ry * Rz の 3x3 部分
+        V m[3][3];
+        m[0][0] = scaleX * (cosY * cosZ);
+        m[0][1] = scaleX * (cosY * sinZ);
+        m[0][2] = -(scaleX * sinY);
+        m[1][0] = scaleY * (sinX * sinY * cosZ - cosX * sinZ);
+        m[1][1] = scaleY * (sinX * sinY * sinZ + cosX * cosZ);
+        m[1][2] = scaleY * (sinX * cosY);
+        m[2][0] = scaleZ * (cosX * sinY * cosZ + sinX * sinZ);
+        m[2][1] = scaleZ * (cosX * sinY * sinZ - sinX * cosZ);
+        m[2][2] = scaleZ * (cosX * cosY);
+
+        if (postRotation) {
+            const Matrix4x4& b = *postRotation;
+            for (int row = 0; row < 3; ++row) {
+                const V m0 = m[row][0];
+                const V m1 = m[row][1];
+                const V m2 = m[row][2];
+                for (int col = 0; col < 3; ++col) {
+                    m[row][col] = m0 * V(b.m[0][col]) + m1 * V(b.m[1][col]) + m2 * V(b.m[2][col]);
+                }
+            }
+        }
+
+        for (int row = 0; row < 3; ++row) {
+            world[row * 4 + 0] = m[row][0];
+            world[row * 4 + 1] = m[row][1];
+            world[row * 4 + 2] = m[row][2];
+            world[row * 4 + 3] = V(0.0f);
+        }
+        world[12] = translateX;
+        world[13] = translateY;
+        world[14] = translateZ;
+        world[15] = V(1.0f);
+
+        if (needsWvp) {
+            if (viewProjection) {
+                const Matrix4x4& vp = *viewProjection;
+                for (int col = 0; col < 4; ++col) {
+                    const V vp0 = V(vp.m[0][col]);
+                    const V vp1 = V(vp.m[1][col]);
+                    const V vp2 = V(vp.m[2][col]);
+                    for (int row = 0; row < 3; ++row) {
+                        wvp[row * 4 + col] = m[row][0] * vp0 + m[row][1] * vp1 + m[row][2] * vp2;
+                    }
+                    wvp[12 + col] = translateX * vp0 + translateY * vp1 + translateZ * vp2 + V(vp.m[3][col]);
+                }
+            } else {
+                for (int i = 0; i < 16; ++i) {
+                    wvp[i] = world[i];
+                }
+            }
+        }
+
+        if (needsInverseTranspose) {
+            // 余因子 / det がそのまま逆行列の転置になる
+            V c[3][3];
+            c[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+            c[0][1] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+            c[0][2] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+            c[1][0] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+            c[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+            c[1][2] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+            c[2][0] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+            c[2][1] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+            c[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+            const V invDet = V(1.0f) / (m[0][0] * c[0][0] + m[0][1] * c[0][1] + m[0][2] * c[0][2]);
+
+            for (int row = 0; row < 3; ++row) {
+                const V c0 = c[row][0] * invDet;
+                const V c1 = c[row][1] * invDet;
+                const V c2 = c[row][2] * invDet;
+                inverseTranspose[row * 4 + 0] = c0;
+                inverseTranspose[row * 4 + 1] = c1;
+                inverseTranspose[row * 4 + 2] = c2;
+                // 逆行列の平行移動成分 (転置なので 4 列目に入る)
+                inverseTranspose[row * 4 + 3] = -(translateX * c0 + translateY * c1 + translateZ * c2);
+            }
+            inverseTranspose[12] = V(0.0f);
+            inverseTranspose[13] = V(0.0f);
+            inverseTranspose[14] = V(0.0f);
+            inverseTranspose[15] = V(1.0f);
+        }
+    }
+
+    void StoreScalar(const float values[16], Matrix4x4* destination) {
+        std::memcpy(destination->m, values, sizeof(float) * 16);
+    }
+
+    void MakeAffineBatchScalar(const TransformStreams& t, size_t first, const Matrix4x4* viewProjection,
+        const Matrix4x4* postRotation, const AffineBatchOutput& output) {
+        const bool needsWvp = output.wvps.data != nullptr;
+        const bool needsInverseTranspose = output.worldInverseTransposes.data != nullptr;
+        const FastMath::TrigPrecision precision = FastMath::GetTrigPrecision();
+
+        for (size_t i = first; i < t.count; ++i) {
+            const float in[9] = {
+                t.scaleX[i], t.scaleY[i], t.scaleZ[i],
+                t.rotateX[i], t.rotateY[i], t.rotateZ[i],
+                t.translateX[i], t.translateY[i], t.translateZ[i]
+            };
+            float world[16], wvp[16], inverseTranspose[16];
+            ComputeBlock(in, viewProjection, postRotation, precision, needsWvp, needsInverseTranspose, world, wvp, inverseTranspose);
+
+            if (output.worlds.data) {
+                StoreScalar(world, StreamAt(output.worlds, i));
+            }
+            if (needsWvp) {
+                StoreScalar(wvp, StreamAt(output.wvps, i));
+            }
+            if (needsInverseTranspose) {
+                StoreScalar(inverseTranspose, StreamAt(output.worldInverseTransposes, i));
+            }
+        }
+    }
+
+#if defined(MATH_SIMD_X86)
+    // 4 要素分の SoA 行列を転置しながら各行列へ書き込む
+    void StoreBlock4(const F4 values[16], const MatrixStream& stream, size_t first) {
+        Matrix4x4* destinations[4] = {
+            StreamAt(stream, first + 0),
+            StreamAt(stream, first + 1),
+            StreamAt(stream, first + 2),
+            StreamAt(stream, first + 3)
+        };
+        for (int row = 0; row < 4; ++row) {
+            __m128 r0 = values[row * 4 + 0].v;
+            __m128 r1 = values[row * 4 + 1].v;
+            __m128 r2 = values[row * 4 + 2].v;
+            __m128 r3 = values[row * 4 + 3].v;
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(destinations[0]->m[row], r0);
+            _mm_storeu_ps(destinations[1]->m[row], r1);
+            _mm_storeu_ps(destinations[2]->m[row], r2);
+            _mm_storeu_ps(destinations[3]->m[row], r3);
+        }
+    }
+
+    // 4 要素単位で処理した残りの要素数を返す
+    size_t MakeAffineBatchSSE(const TransformStreams& t, const Matrix4x4* viewProjection,
+        const Matrix4x4* postRotation, const AffineBatchOutput& output) {
+        const bool needsWvp = output.wvps.data != nullptr;
+        const bool needsInverseTranspose = output.worldInverseTransposes.data != nullptr;
+        const FastMath::TrigPrecision precision = FastMath::GetTrigPrecision();
+        const float* streams[9] = { t.scaleX, t.scaleY, t.scaleZ, t.rotateX, t.rotateY, t.rotateZ, t.translateX, t.translateY, t.translateZ };
+
+        size_t i = 0;
+        for (; i + 4 <= t.count; i += 4) {
+            F4 in[9];
+            for (int k = 0; k < 9; ++k) {
+                in[k] = _mm_loadu_ps(streams[k] + i);
+            }
+            F4 world[16], wvp[16], inverseTranspose[16];
+            ComputeBlock(in, viewProjection, postRotation, precision, needsWvp, needsInverseTranspose, world, wvp, inverseTranspose);
+
+            if (output.worlds.data) {
+                StoreBlock4(world, output.worlds, i);
+            }
+            if (needsWvp) {
+                StoreBlock4(wvp, output.wvps, i);
+            }
+            if (needsInverseTranspose) {
+                StoreBlock4(inverseTranspose, output.worldInverseTransposes, i);
+            }
+        }
+        return i;
+    }
+#endif
+}
+
+TransformStreams MatrixMath::MakeTransformStreams(const Transform& transform) {
+    TransformStreams streams;
+    streams.scaleX = &transform.scale.x;
+    streams.scaleY = &transform.scale.y;
+    streams.scaleZ = &transform.scale.z;
+    streams.rotateX = &transform.rotate.x;
+    streams.rotateY = &transform.rotate.y;
+    streams.rotateZ = &transform.rotate.z;
+    streams.translateX = &transform.translate.x;
+    streams.translateY = &transform.translate.y;
+    streams.translateZ = &transform.translate.z;
+    streams.count = 1;
+    return streams;
+}
+
+void MatrixMath::MakeAffineBatch(const TransformStreams& transforms,
+    const Matrix4x4* viewProjection,
+    const Matrix4x4* postRotation,
+    const AffineBatchOutput& output) {
+    size_t first = 0;
+#if defined(MATH_SIMD_X86)
+    if (GetSimdLevel() != SimdLevel::Scalar) {
+        first = MakeAffineBatchSSE(transforms, viewProjection, postRotation, output);
+    }
+#endif
+    // 端数 (または SIMD 非対応時は全要素) をスカラーで処理する
+    MakeAffineBatchScalar(transforms, first, viewProjection, postRotation, output);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "Matrix4x4.h"
+#include <cstddef>
+#include <vector>
+
+// SoA 形式の SRT 列への参照 (各配列は count 要素)
+struct TransformStreams {
+    const float* scaleX = nullptr;
+    const float* scaleY = nullptr;
+    const float* scaleZ = nullptr;
+    const float* rotateX = nullptr;
+    const float* rotateY = nullptr;
+    const float* rotateZ = nullptr;
+    const float* translateX = nullptr;
+    const float* translateY = nullptr;
+    const float* translateZ = nullptr;
+    size_t count = 0;
+};
+
+// SoA 形式で SRT を保持するコンテナ
+class TransformSoA {
+public:
+    size_t Size() const { return scaleX_.size(); }
+    void Clear();
+    void Reserve(size_t count);
+    void Resize(size_t count);
+    void PushBack(const Transform& transform);
+    void Set(size_t index, const Transform& transform);
+    Transform Get(size_t index) const;
+
+    TransformStreams GetStreams() const;
+
+private:
+    std::vector<float> scaleX_, scaleY_, scaleZ_;
+    std::vector<float> rotateX_, rotateY_, rotateZ_;
+    std::vector<float> translateX_, translateY_, translateZ_;
+};
+
+// 行列の出力先 (strideBytes ごとに書き込むので構造体配列のメンバへ直接書ける)
+struct MatrixStream {
+    Matrix4x4* data = nullptr;
+    size_t strideBytes = sizeof(Matrix4x4);
+};
+
+// MakeAffineBatch の出力先 (data が nullptr のものは計算しない)
+struct AffineBatchOutput {
+    MatrixStream worlds;
+    MatrixStream wvps;
+    MatrixStream worldInverseTransposes;
+};
+
+namespace MatrixMath {
+    // Transform 1 つ分を参照する TransformStreams
+    TransformStreams MakeTransformStreams(const Transform& transform);
+
+    // N 個の SRT から World / WVP / WorldInverseTranspose をまとめて作る
+    // World = S * R(XYZ) * B * T (B は全要素共通の回転、ビルボード用。nullptr なら単位行列で 3x3 部分のみ使う)
+    // viewProjection が nullptr の場合 WVP は World と同じになる
+    // 回転の sin / cos は FastMath::GetTrigPrecision の精度で求める
+    void MakeAffineBatch(const TransformStreams& transforms,
+        const Matrix4x4* viewProjection,
+        const Matrix4x4* postRotation,
+        const AffineBatchOutput& output);
+}
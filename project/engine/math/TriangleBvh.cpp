@@ -0,0 +1,453 @@
+#include "TriangleBvh.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // 木の深さの上限 (走査スタックがあふれないよう、これより深くは分割しない)
+    constexpr size_t kTraversalStackSize = 64;
+    // 三角形 1 つの交差判定に対するノード 1 つの走査コストの比 (SAH の葉を作るかの判断に使う)
+    constexpr float kTraversalCost = 1.0f;
+
+    Vector3 LoadPosition(const uint8_t* base, size_t strideBytes, size_t index) {
+        Vector3 position;
+        std::memcpy(&position, base + strideBytes * index, sizeof(Vector3));
+        return position;
+    }
+
+    Vector3 Subtract(const Vector3& a, const Vector3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    float Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    Aabb EmptyAabb() {
+        return { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+    }
+
+    void Grow(Aabb& aabb, const Vector3& p) {
+        aabb.min = { (std::min)(aabb.min.x, p.x), (std::min)(aabb.min.y, p.y), (std::min)(aabb.min.z, p.z) };
+        aabb.max = { (std::max)(aabb.max.x, p.x), (std::max)(aabb.max.y, p.y), (std::max)(aabb.max.z, p.z) };
+    }
+
+    void Grow(Aabb& aabb, const Aabb& other) {
+        aabb.min = { (std::min)(aabb.min.x, other.min.x), (std::min)(aabb.min.y, other.min.y), (std::min)(aabb.min.z, other.min.z) };
+        aabb.max = { (std::max)(aabb.max.x, other.max.x), (std::max)(aabb.max.y, other.max.y), (std::max)(aabb.max.z, other.max.z) };
+    }
+
+    // 表面積の 1/2 (空のボックスは 0)
+    float HalfArea(const Aabb& aabb) {
+        if (aabb.min.x > aabb.max.x) {
+            return 0.0f;
+        }
+        const float dx = aabb.max.x - aabb.min.x;
+        const float dy = aabb.max.y - aabb.min.y;
+        const float dz = aabb.max.z - aabb.min.z;
+        return dx * dy + dy * dz + dz * dx;
+    }
+
+    TriangleBvh::Node MakeNode(const Aabb& aabb, uint32_t leftFirst, uint32_t count) {
+        TriangleBvh::Node node;
+        node.minX = aabb.min.x;
+        node.minY = aabb.min.y;
+        node.minZ = aabb.min.z;
+        node.leftFirst = leftFirst;
+        node.maxX = aabb.max.x;
+        node.maxY = aabb.max.y;
+        node.maxZ = aabb.max.z;
+        node.count = count;
+        return node;
+    }
+
+    // 事前に逆数を求めた半直線
+    struct PreparedRay {
+        Vector3 origin;
+        Vector3 direction;
+        Vector3 inverseDirection;
+#if defined(MATH_SIMD_X86)
+        __m128 origin4;
+        __m128 inverseDirection4;
+#endif
+    };
+
+    PreparedRay PrepareRay(const Ray& ray) {
+        PreparedRay prepared;
+        prepared.origin = ray.origin;
+        prepared.direction = ray.direction;
+        prepared.inverseDirection = { 1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z };
+#if defined(MATH_SIMD_X86)
+        prepared.origin4 = _mm_setr_ps(ray.origin.x, ray.origin.y, ray.origin.z, 0.0f);
+        prepared.inverseDirection4 = _mm_setr_ps(prepared.inverseDirection.x, prepared.inverseDirection.y, prepared.inverseDirection.z, 0.0f);
+#endif
+        return prepared;
+    }
+
+    // ノードの AABB との交差距離 (当たらなければ FLT_MAX)
+    float IntersectNode(const PreparedRay& ray, const TriangleBvh::Node& node, float maxDistance) {
+#if defined(MATH_SIMD_X86)
+        // min / max を 1 回ずつ読み込み 3 軸を同時に計算する (4 要素目の leftFirst / count は捨てる)
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.minX), ray.origin4), ray.inverseDirection4);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&node.maxX), ray.origin4), ray.inverseDirection4);
+        const __m128 xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+        __m128 tNear = _mm_and_ps(_mm_min_ps(t0, t1), xyzMask);
+        __m128 tFar = _mm_or_ps(_mm_and_ps(_mm_max_ps(t0, t1), xyzMask), _mm_andnot_ps(xyzMask, _mm_set1_ps(maxDistance)));
+        tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(1, 0, 3, 2)));
+        tNear = _mm_max_ss(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(2, 3, 0, 1)));
+        tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(1, 0, 3, 2)));
+        tFar = _mm_min_ss(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(2, 3, 0, 1)));
+        const float tMin = _mm_cvtss_f32(tNear);
+        const float tMax = _mm_cvtss_f32(tFar);
+#else
+        const float tx0 = (node.minX - ray.origin.x) * ray.inverseDirection.x;
+        const float tx1 = (node.maxX - ray.origin.x) * ray.inverseDirection.x;
+        const float ty0 = (node.minY - ray.origin.y) * ray.inverseDirection.y;
+        const float ty1 = (node.maxY - ray.origin.y) * ray.inverseDirection.y;
+        const float tz0 = (node.minZ - ray.origin.z) * ray.inverseDirection.z;
+        const float tz1 = (node.maxZ - ray.origin.z) * ray.inverseDirection.z;
+        const float tMin = (std::max)((std::max)((std::min)(tx0, tx1), (std::min)(ty0, ty1)), (std::max)((std::min)(tz0, tz1), 0.0f));
+        const float tMax = (std::min)((std::min)((std::max)(tx0, tx1), (std::max)(ty0, ty1)), (std::min)((std::max)(tz0, tz1), maxDistance));
+#endif
+        return tMin <= tMax ? tMin : FLT_MAX;
+    }
+}
+
+void TriangleBvh::Clear() {
+    nodes_.clear();
+    triangles_.clear();
+    triangleIndices_.clear();
+}
+
+void TriangleBvh::Build(const void* positions, size_t strideBytes, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+    Clear();
+
+    const size_t triangleCount = indices ? indexCount / 3 : vertexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    assert(positions);
+    const uint8_t* base = static_cast<const uint8_t*>(positions);
+
+    auto GetVertex = [&](size_t triangle, size_t corner) {
+        const size_t index = indices ? indices[triangle * 3 + corner] : triangle * 3 + corner;
+        assert(index < vertexCount);
+        return LoadPosition(base, strideBytes, index);
+    };
+
+    // 三角形ごとの AABB と重心
+    std::vector<BuildTriangle> buildTriangles(triangleCount);
+    Aabb rootBounds = EmptyAabb();
+    for (size_t i = 0; i < triangleCount; ++i) {
+        const Vector3 p0 = GetVertex(i, 0);
+        const Vector3 p1 = GetVertex(i, 1);
+        const Vector3 p2 = GetVertex(i, 2);
+        Aabb triangleBounds = EmptyAabb();
+        Grow(triangleBounds, p0);
+        Grow(triangleBounds, p1);
+        Grow(triangleBounds, p2);
+        Grow(rootBounds, triangleBounds);
+
+        BuildTriangle& buildTriangle = buildTriangles[i];
+        buildTriangle = {
+            { triangleBounds.min.x, triangleBounds.min.y, triangleBounds.min.z, 0.0f },
+            { triangleBounds.max.x, triangleBounds.max.y, triangleBounds.max.z, 0.0f },
+            { (p0.x + p1.x + p2.x) / 3.0f, (p0.y + p1.y + p2.y) / 3.0f, (p0.z + p1.z + p2.z) / 3.0f },
+            static_cast<uint32_t>(i)
+        };
+    }
+
+    // ノード数は最大 2N - 1
+    nodes_.reserve(triangleCount * 2);
+    nodes_.push_back(MakeNode(rootBounds, 0, static_cast<uint32_t>(triangleCount)));
+
+    struct BuildEntry {
+        uint32_t nodeIndex;
+        uint32_t depth;
+    };
+    std::vector<BuildEntry> stack = { { 0, 0 } };
+    while (!stack.empty()) {
+        const BuildEntry entry = stack.back();
+        stack.pop_back();
+        if (entry.depth + 1 < kTraversalStackSize && Subdivide(entry.nodeIndex, buildTriangles)) {
+            stack.push_back({ nodes_[entry.nodeIndex].leftFirst, entry.depth + 1 });
+            stack.push_back({ nodes_[entry.nodeIndex].leftFirst + 1, entry.depth + 1 });
+        }
+    }
+    nodes_.shrink_to_fit();
+
+    // 交差判定でメモリを順に読めるよう、三角形を葉の順番に並べ替えて持つ
+    triangles_.resize(triangleCount);
+    triangleIndices_.resize(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        const uint32_t source = buildTriangles[i].index;
+        triangleIndices_[i] = source;
+        const Vector3 p0 = GetVertex(source, 0);
+        triangles_[i] = { p0, Subtract(GetVertex(source, 1), p0), Subtract(GetVertex(source, 2), p0) };
+    }
+}
+
+bool TriangleBvh::Subdivide(uint32_t nodeIndex, std::vector<BuildTriangle>& buildTriangles) {
+    const uint32_t first = nodes_[nodeIndex].leftFirst;
+    const uint32_t count = nodes_[nodeIndex].count;
+    if (count <= 1) {
+        return false;
+    }
+
+    const BuildTriangle* triangles = buildTriangles.data() + first;
+
+    // 重心の範囲でビンを切る
+    float centroidMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float centroidMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t i = 0; i < count; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            centroidMin[axis] = (std::min)(centroidMin[axis], triangles[i].centroid[axis]);
+            centroidMax[axis] = (std::max)(centroidMax[axis], triangles[i].centroid[axis]);
+        }
+    }
+    // 三角形が少ないノードではビンを減らす (下の方のノードは数が多いので固定の手間を抑える)
+    const uint32_t binCount = (std::min)(kBinCount, count);
+    float binMinimum[3];
+    float binScale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        binMinimum[axis] = centroidMin[axis];
+        const float extent = centroidMax[axis] - centroidMin[axis];
+        binScale[axis] = extent > 0.0f ? static_cast<float>(binCount) / extent : 0.0f;
+    }
+    auto BinIndex = [&](const BuildTriangle& triangle, int axis) {
+        return (std::min)(binCount - 1, static_cast<uint32_t>((triangle.centroid[axis] - binMinimum[axis]) * binScale[axis]));
+        };
+
+    // 3 軸分のビンを 1 回の走査で埋める
+    struct Bin {
+        Aabb bounds;
+        uint32_t count;
+    };
+    Bin bins[3][kBinCount];
+#if defined(MATH_SIMD_X86)
+    {
+        // 3 軸のビン番号を 1 回で求め、AABB は min / max を 1 命令ずつで広げる
+        // (重心の 4 要素目には index が入っているが、scale を 0 にして番号 0 に落とす)
+        const __m128 minimum4 = _mm_setr_ps(binMinimum[0], binMinimum[1], binMinimum[2], 0.0f);
+        const __m128 scale4 = _mm_setr_ps(binScale[0], binScale[1], binScale[2], 0.0f);
+        const __m128 lastBin4 = _mm_set1_ps(static_cast<float>(binCount - 1));
+        __m128 binMin[3][kBinCount];
+        __m128 binMax[3][kBinCount];
+        uint32_t binCounts[3][kBinCount] = {};
+        for (int axis = 0; axis < 3; ++axis) {
+            for (uint32_t b = 0; b < binCount; ++b) {
+                binMin[axis][b] = _mm_set1_ps(FLT_MAX);
+                binMax[axis][b] = _mm_set1_ps(-FLT_MAX);
+            }
+        }
+        alignas(16) int32_t binIndices[4];
+        for (uint32_t i = 0; i < count; ++i) {
+            const BuildTriangle& triangle = triangles[i];
+            const __m128 binFloat = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(_mm_load_ps(triangle.centroid), minimum4), scale4), lastBin4);
+            _mm_store_si128(reinterpret_cast<__m128i*>(binIndices), _mm_cvttps_epi32(binFloat));
+            const __m128 triangleMin = _mm_load_ps(triangle.boundsMin);
+            const __m128 triangleMax = _mm_load_ps(triangle.boundsMax);
+            for (int axis = 0; axis < 3; ++axis) {
+                const int32_t b = binIndices[axis];
+                binMin[axis][b] = _mm_min_ps(binMin[axis][b], triangleMin);
+                binMax[axis][b] = _mm_max_ps(binMax[axis][b], triangleMax);
+                ++binCounts[axis][b];
+            }
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            for (uint32_t b = 0; b < binCount; ++b) {
+                alignas(16) float minValues[4];
+                alignas(16) float maxValues[4];
+                _mm_store_ps(minValues, binMin[axis][b]);
+                _mm_store_ps(maxValues, binMax[axis][b]);
+                bins[axis][b] = { { { minValues[0], minValues[1], minValues[2] }, { maxValues[0], maxValues[1], maxValues[2] } }, binCounts[axis][b] };
+            }
+        }
+    }
+#else
+    for (auto& axisBins : bins) {
+        for (Bin& bin : axisBins) {
+            bin = { EmptyAabb(), 0 };
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        const BuildTriangle& triangle = triangles[i];
+        const Aabb triangleBounds = {
+            { triangle.boundsMin[0], triangle.boundsMin[1], triangle.boundsMin[2] },
+            { triangle.boundsMax[0], triangle.boundsMax[1], triangle.boundsMax[2] }
+        };
+        for (int axis = 0; axis < 3; ++axis) {
+            Bin& bin = bins[axis][BinIndex(triangle, axis)];
+            ++bin.count;
+            Grow(bin.bounds, triangleBounds);
+        }
+    }
+#endif
+
+    int bestAxis = -1;
+    uint32_t bestSplit = 0;
+    float bestCost = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (binScale[axis] == 0.0f) {
+            continue;
+        }
+
+        // 左右から累積して、各分割位置の (個数 x 表面積) を求める
+        float leftCosts[kBinCount - 1];
+        Aabb leftBounds = EmptyAabb();
+        uint32_t leftCount = 0;
+        for (uint32_t i = 0; i < binCount - 1; ++i) {
+            Grow(leftBounds, bins[axis][i].bounds);
+            leftCount += bins[axis][i].count;
+            leftCosts[i] = static_cast<float>(leftCount) * HalfArea(leftBounds);
+        }
+        Aabb rightBounds = EmptyAabb();
+        uint32_t rightCount = 0;
+        for (uint32_t i = binCount - 1; i > 0; --i) {
+            Grow(rightBounds, bins[axis][i].bounds);
+            rightCount += bins[axis][i].count;
+            if (rightCount == 0 || rightCount == count) {
+                continue;
+            }
+            const float cost = leftCosts[i - 1] + static_cast<float>(rightCount) * HalfArea(rightBounds);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = i;
+            }
+        }
+    }
+
+    // 重心が全て同じなどで分割できない
+    if (bestAxis < 0) {
+        return false;
+    }
+
+    // 分割しない場合 (葉) のコストと比べる。大きすぎる葉は作らない
+    const Node& node = nodes_[nodeIndex];
+    const Aabb nodeBounds = { { node.minX, node.minY, node.minZ }, { node.maxX, node.maxY, node.maxZ } };
+    const float nodeArea = HalfArea(nodeBounds);
+    const float leafCost = static_cast<float>(count) * nodeArea;
+    if (count <= kMaxLeafTriangles && bestCost + kTraversalCost * nodeArea >= leafCost) {
+        return false;
+    }
+
+    // ビンの境界で三角形の並びを分ける
+    BuildTriangle* begin = buildTriangles.data() + first;
+    BuildTriangle* middle = std::partition(begin, begin + count, [&](const BuildTriangle& triangle) {
+        return BinIndex(triangle, bestAxis) < bestSplit;
+        });
+    const uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+    if (leftCount == 0 || leftCount == count) {
+        return false;
+    }
+
+    // 子は 2 つ並べて確保し、AABB はビンの和から求める
+    Aabb childBounds[2] = { EmptyAabb(), EmptyAabb() };
+    for (uint32_t i = 0; i < binCount; ++i) {
+        Grow(childBounds[i < bestSplit ? 0 : 1], bins[bestAxis][i].bounds);
+    }
+    const uint32_t leftChild = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(MakeNode(childBounds[0], first, leftCount));
+    nodes_.push_back(MakeNode(childBounds[1], first + leftCount, count - leftCount));
+    nodes_[nodeIndex].leftFirst = leftChild;
+    nodes_[nodeIndex].count = 0;
+    return true;
+}
+
+bool TriangleBvh::RayCast(const Ray& ray, Hit& hit) const {
+    if (nodes_.empty()) {
+        return false;
+    }
+
+    const PreparedRay prepared = PrepareRay(ray);
+
+    float closest = ray.maxDistance;
+    bool isHit = false;
+    if (IntersectNode(prepared, nodes_[0], closest) == FLT_MAX) {
+        return false;
+    }
+
+    // 遠い子は当たった距離と一緒に積み、戻るときは距離の比較だけで枝刈りする
+    struct StackEntry {
+        uint32_t nodeIndex;
+        float distance;
+    };
+    StackEntry stack[kTraversalStackSize];
+    size_t stackSize = 0;
+    uint32_t nodeIndex = 0;
+    while (true) {
+        const Node& node = nodes_[nodeIndex];
+        if (node.count > 0) {
+            // Möller-Trumbore (両面)
+            for (uint32_t i = 0; i < node.count; ++i) {
+                const Triangle& triangle = triangles_[node.leftFirst + i];
+                const Vector3 p = MatrixMath::Cross(prepared.direction, triangle.edge2);
+                const float determinant = Dot(triangle.edge1, p);
+                if (std::fabs(determinant) < 1.0e-12f) {
+                    continue;
+                }
+                const float inverseDeterminant = 1.0f / determinant;
+                const Vector3 s = Subtract(prepared.origin, triangle.p0);
+                const float u = Dot(s, p) * inverseDeterminant;
+                if (u < 0.0f || u > 1.0f) {
+                    continue;
+                }
+                const Vector3 q = MatrixMath::Cross(s, triangle.edge1);
+                const float v = Dot(prepared.direction, q) * inverseDeterminant;
+                if (v < 0.0f || u + v > 1.0f) {
+                    continue;
+                }
+                const float t = Dot(triangle.edge2, q) * inverseDeterminant;
+                if (t >= 0.0f && t < closest) {
+                    closest = t;
+                    isHit = true;
+                    hit.distance = t;
+                    hit.triangleIndex = triangleIndices_[node.leftFirst + i];
+                    hit.u = u;
+                    hit.v = v;
+                }
+            }
+        } else {
+            // 近い子から先に進み、遠い子はスタックに積む
+            uint32_t nearChild = node.leftFirst;
+            uint32_t farChild = node.leftFirst + 1;
+            float nearDistance = IntersectNode(prepared, nodes_[nearChild], closest);
+            float farDistance = IntersectNode(prepared, nodes_[farChild], closest);
+            if (farDistance < nearDistance) {
+                std::swap(nearChild, farChild);
+                std::swap(nearDistance, farDistance);
+            }
+            if (nearDistance != FLT_MAX) {
+                if (farDistance != FLT_MAX) {
+                    assert(stackSize < kTraversalStackSize);
+                    stack[stackSize++] = { farChild, farDistance };
+                }
+                nodeIndex = nearChild;
+                continue;
+            }
+        }
+
+        // 積んだノードのうち、今の最短距離より手前で当たるものへ戻る
+        bool isFound = false;
+        while (stackSize > 0) {
+            const StackEntry& entry = stack[--stackSize];
+            if (entry.distance < closest) {
+                nodeIndex = entry.nodeIndex;
+                isFound = true;
+                break;
+            }
+        }
+        if (!isFound) {
+            break;
+        }
+    }
+    return isHit;
+}
+
+size_t TriangleBvh::RayCastBatch(const Ray* rays, size_t count, Hit* hits, bool* isHits) const {
+    size_t hitCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        isHits[i] = RayCast(rays[i], hits[i]);
+        hitCount += isHits[i] ? 1 : 0;
+    }
+    return hitCount;
+}
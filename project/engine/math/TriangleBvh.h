@@ -0,0 +1,75 @@
+#pragma once
+#include "Culling.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 三角形メッシュ用の BVH (モデル単位のレイピッキング用)
+// 構築は重心をビンに分けた表面積コスト (binned SAH) で分割する
+// ノードは 32 バイトの配列に平坦化し、左右の子は隣り合わせに並べる
+class TriangleBvh {
+public:
+    // レイクエリの結果
+    // 当たった点 = (1 - u - v) * p0 + u * p1 + v * p2
+    struct Hit {
+        float distance = 0.0f;
+        uint32_t triangleIndex = 0; // 構築時に渡した三角形の番号
+        float u = 0.0f;
+        float v = 0.0f;
+    };
+
+    // 平坦化したノード
+    // count > 0 なら葉で leftFirst は最初の三角形、count == 0 なら leftFirst は左の子 (右の子は leftFirst + 1)
+    struct alignas(32) Node {
+        float minX, minY, minZ;
+        uint32_t leftFirst;
+        float maxX, maxY, maxZ;
+        uint32_t count;
+    };
+
+    // 葉に入れる三角形の最大数
+    static constexpr uint32_t kMaxLeafTriangles = 4;
+    // SAH で評価する分割候補のビン数
+    static constexpr uint32_t kBinCount = 16;
+
+public:
+    // positions は strideBytes 間隔で並んだ頂点 (先頭 3 つの float を座標として使う)
+    // indices が nullptr なら頂点 3 つずつを三角形とみなす
+    void Build(const void* positions, size_t strideBytes, size_t vertexCount, const uint32_t* indices = nullptr, size_t indexCount = 0);
+    void Clear();
+
+    // 最も近くで当たる三角形を求める (ray.maxDistance より遠いものは無視する)
+    bool RayCast(const Ray& ray, Hit& hit) const;
+    // 複数のレイをまとめて調べる (hits / isHits は count 要素)
+    size_t RayCastBatch(const Ray* rays, size_t count, Hit* hits, bool* isHits) const;
+
+    bool IsEmpty() const { return nodes_.empty(); }
+    size_t GetTriangleCount() const { return triangleIndices_.size(); }
+    size_t GetNodeCount() const { return nodes_.size(); }
+    const std::vector<Node>& GetNodes() const { return nodes_; }
+
+private:
+    // 交差判定用に BVH の順番で並べ替えた三角形
+    struct Triangle {
+        Vector3 p0;
+        Vector3 edge1; // p1 - p0
+        Vector3 edge2; // p2 - p0
+    };
+
+    // 構築中の三角形 (ノードの範囲ごとに並べ替えるので、番号から辿らずに順に読めるよう中身を持たせる)
+    // 各配列は SIMD でまとめて読めるよう 4 要素 (boundsMin / boundsMax の 4 要素目は未使用)
+    struct alignas(16) BuildTriangle {
+        float boundsMin[4];
+        float boundsMax[4];
+        float centroid[3];
+        uint32_t index;
+    };
+
+    // 分割できたら true を返して子ノードを作る
+    bool Subdivide(uint32_t nodeIndex, std::vector<BuildTriangle>& buildTriangles);
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<Triangle> triangles_;
+    std::vector<uint32_t> triangleIndices_;
+};
@@ -0,0 +1,48 @@
+struct TransformationMatrix
+{
+    float4x4 WVP;
+    float4x4 World;
+    float4x4 WorldInverseTranspose;
+};
+
+ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
+
+// VertexQuantization で量子化した頂点 (位置は float3 / half4 のどちらでも w = 1 で入る)
+struct VertexShaderInput
+{
+    float4 pos : POSITION;
+    float2 normal : NORMAL;
+    float2 uv : TEXCOORD;
+};
+
+struct VertexShaderOutput
+{
+    float4 pos : SV_POSITION;
+    float2 uv : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 worldPos : TEXCOORD1;
+};
+
+// 八面体符号化した法線を戻す (VertexQuantization::DecodeOctahedral と同じ)
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+VertexShaderOutput main(VertexShaderInput input)
+{
+    VertexShaderOutput output;
+    
+    output.pos = mul(input.pos, gTransformationMatrix.WVP);
+    output.uv = input.uv;
+    
+    // 法線の変換に逆転置行列の3x3部分を使用
+    output.normal = normalize(mul(DecodeOctahedral(input.normal), (float3x3) gTransformationMatrix.WorldInverseTranspose));
+    output.worldPos = mul(input.pos, gTransformationMatrix.World).xyz;
+    
+    return output;
+}